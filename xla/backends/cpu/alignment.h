@@ -31,6 +31,11 @@ namespace xla::cpu {
 // behavior.
 inline constexpr size_t MinAlign() { return EIGEN_MAX_ALIGN_BYTES; }
 
+// The smallest alignment XLA:CPU can be asked to assume for entry computation
+// parameters (see `xla_cpu_parameter_alignment`). Eigen kernels used by the
+// XLA:CPU runtime (i.e. convolutions) require at least 16-byte aligned data.
+inline constexpr size_t MinParameterAlign() { return 16; }
+
 // Align to 64-bytes, to mimic tsl::Allocator::kAllocatorAlignment.
 //
 // Preferred XLA:CPU alignment for buffers. XLA:CPU itself aligns intermediate
@@ -16,9 +16,11 @@ limitations under the License.
 #include "xla/backends/cpu/nanort/nanort_client.h"
 
 #include <memory>
+#include <string>
 #include <utility>
 
 #include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
 #include "xla/backends/cpu/nanort/nanort_executable.h"
 #include "xla/debug_options_flags.h"
 #include "xla/hlo/builder/xla_computation.h"
@@ -86,4 +88,34 @@ absl::StatusOr<std::unique_ptr<NanoRtExecutable>> NanoRtClient::Compile(
   return NanoRtExecutable::Create(std::move(executable), intra_op_thread_pool_);
 }
 
+absl::StatusOr<std::string> NanoRtClient::Serialize(
+    const NanoRtExecutable& executable) {
+  TraceMe trace([&] {
+    return TraceMeEncode(
+        "NanoRtClient::Serialize",
+        {{"executable", executable.executable()->module().name()}});
+  });
+
+  cpu::CpuCompiler compiler;
+  TF_ASSIGN_OR_RETURN(std::unique_ptr<AotCompilationResult> aot_result,
+                      compiler.Export(executable.executable()));
+  return aot_result->SerializeAsString();
+}
+
+absl::StatusOr<std::unique_ptr<NanoRtExecutable>> NanoRtClient::Deserialize(
+    absl::string_view serialized) {
+  TraceMe trace("NanoRtClient::Deserialize");
+
+  cpu::CpuCompiler compiler;
+  TF_ASSIGN_OR_RETURN(
+      std::unique_ptr<AotCompilationResult> aot_result,
+      compiler.LoadAotCompilationResult(std::string(serialized)));
+
+  TF_ASSIGN_OR_RETURN(
+      std::unique_ptr<Executable> executable,
+      aot_result->LoadExecutable(&compiler, /*executor=*/nullptr));
+
+  return NanoRtExecutable::Create(std::move(executable), intra_op_thread_pool_);
+}
+
 }  // namespace xla::cpu
@@ -17,8 +17,10 @@ limitations under the License.
 #define XLA_BACKENDS_CPU_NANORT_NANORT_CLIENT_H_
 
 #include <memory>
+#include <string>
 
 #include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
 #include "xla/backends/cpu/nanort/nanort_executable.h"
 #include "xla/hlo/builder/xla_computation.h"
 #include "tsl/platform/threadpool.h"
@@ -35,6 +37,18 @@ class NanoRtClient {
   absl::StatusOr<std::unique_ptr<NanoRtExecutable>> Compile(
       const XlaComputation& computation);
 
+  // Serializes the executable (object files, thunk sequence and buffer
+  // assignment) so that it can be loaded later with `Deserialize` without
+  // recompiling it.
+  absl::StatusOr<std::string> Serialize(const NanoRtExecutable& executable);
+
+  // Deserializes an executable previously serialized with `Serialize`. Loading
+  // an executable only links serialized object files and does not run any of
+  // the XLA or LLVM compilation passes. Executables can only be loaded on
+  // machines compatible with the one that compiled them.
+  absl::StatusOr<std::unique_ptr<NanoRtExecutable>> Deserialize(
+      absl::string_view serialized);
+
  private:
   // Thread pool for running XLA:CPU compute tasks.
   std::shared_ptr<tsl::thread::ThreadPool> intra_op_thread_pool_;
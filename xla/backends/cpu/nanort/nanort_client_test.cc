@@ -18,6 +18,7 @@ limitations under the License.
 #include <cstdint>
 #include <memory>
 #include <optional>
+#include <string>
 #include <string_view>
 #include <vector>
 
@@ -194,6 +195,49 @@ TEST(NanoRtClientTest, CompileAndRunConditionalComputation) {
   EXPECT_EQ(r0_value, 8.0f);
 }
 
+TEST(NanoRtClientTest, SerializeAndDeserialize) {
+  constexpr std::string_view hlo = R"(
+    HloModule add
+
+    ENTRY e {
+      p0 = f32[] parameter(0)
+      p1 = f32[] parameter(1)
+      ROOT add = f32[] add(p0, p1)
+    }
+  )";
+
+  TF_ASSERT_OK_AND_ASSIGN(auto module, ParseAndReturnUnverifiedModule(hlo));
+  XlaComputation computation(module->ToProto());
+
+  NanoRtClient client;
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<NanoRtExecutable> executable,
+                          client.Compile(computation));
+  TF_ASSERT_OK_AND_ASSIGN(std::string serialized,
+                          client.Serialize(*executable));
+
+  // Load the executable into a different client to check that it doesn't
+  // depend on any state of the client that compiled it.
+  NanoRtClient loader;
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<NanoRtExecutable> loaded,
+                          loader.Deserialize(serialized));
+  EXPECT_EQ(loaded->temp_buffer_size(), executable->temp_buffer_size());
+
+  // Storage for executable parameters and results.
+  alignas(32) float p0_value = 1.0f;
+  alignas(32) float p1_value = 2.0f;
+  alignas(32) float r0_value = 0.0f;
+
+  // Prepare executable parameters, results and temp storage.
+  Arguments arguments = {{&p0_value, 1}, {&p1_value, 1}};
+  Results results = {{&r0_value, 1}};
+
+  auto event = loaded->Execute(arguments, results);
+  tsl::BlockUntilReady(event);
+
+  ASSERT_TRUE(event.IsConcrete());
+  EXPECT_EQ(r0_value, 3.0f);
+}
+
 //===----------------------------------------------------------------------===//
 // Performance benchmarks below
 //===----------------------------------------------------------------------===//
@@ -268,6 +312,32 @@ static void BM_NanoRtFibonacci(benchmark::State& state) {
 
 BENCHMARK(BM_NanoRtFibonacci);
 
+static void BM_NanoRtCompile(benchmark::State& state) {
+  NanoRtClient client;
+  auto computation = CreateFibonacciComputation();
+
+  for (auto _ : state) {
+    auto executable = client.Compile(*computation);
+    CHECK_OK(executable);
+  }
+}
+
+BENCHMARK(BM_NanoRtCompile);
+
+static void BM_NanoRtDeserialize(benchmark::State& state) {
+  NanoRtClient client;
+  auto computation = CreateFibonacciComputation();
+  auto executable = client.Compile(*computation);
+  auto serialized = client.Serialize(**executable);
+
+  for (auto _ : state) {
+    auto loaded = client.Deserialize(*serialized);
+    CHECK_OK(loaded);
+  }
+}
+
+BENCHMARK(BM_NanoRtDeserialize);
+
 static void BM_PjRtAddScalars(benchmark::State& state) {
   auto client = GetXlaPjrtCpuClient(/*options=*/{});
   PjRtDevice* device = (*client)->devices().front();
@@ -98,6 +98,9 @@ class NanoRtExecutable {
   // Returns the size of the temp buffer required to run the executable.
   size_t temp_buffer_size() const;
 
+  // Returns the underlying XLA executable.
+  Executable* executable() const { return executable_.get(); }
+
  private:
   NanoRtExecutable(std::unique_ptr<Executable> executable,
                    std::shared_ptr<tsl::thread::ThreadPool> thread_pool,
@@ -14,31 +14,44 @@ limitations under the License.
 ==============================================================================*/
 #include "xla/backends/cpu/runtime/fft_thunk.h"
 
+#include <algorithm>
+#include <atomic>
+#include <complex>
+#include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <utility>
+#include <vector>
 
-#include "absl/container/inlined_vector.h"
+#include "absl/base/optimization.h"
 #include "absl/memory/memory.h"
 #include "absl/status/statusor.h"
 #include "absl/types/span.h"
+#include "ducc/google/fft.h"
+#include "xla/backends/cpu/runtime/concurrency.h"
 #include "xla/backends/cpu/runtime/thunk.h"
 #include "xla/layout_util.h"
 #include "xla/runtime/buffer_use.h"
 #include "xla/service/buffer_assignment.h"
-#include "xla/service/cpu/runtime_fft.h"
-#include "xla/service/cpu/runtime_single_threaded_fft.h"
 #include "xla/shape.h"
+#include "xla/shape_util.h"
 #include "xla/status_macros.h"
 #include "xla/stream_executor/device_memory.h"
 #include "xla/tsl/concurrency/async_value_ref.h"
+#include "xla/util.h"
+#include "xla/xla_data.pb.h"
 #include "tsl/platform/statusor.h"
 #include "tsl/profiler/lib/traceme.h"
 
 namespace xla::cpu {
 
+// Batches are split into parallel tasks that transform at least this many
+// output elements each.
+static constexpr int64_t kMinParallelFftTaskSize = 16 * 1024;
+
 FftThunk::FftThunk(Info thunk_info, bool is_multi_thread_eigen,
                    int32_t fft_type, absl::Span<const int64_t> fft_length,
-                   BufferAllocation::Slice input_buffer,
+                   Plan plan, BufferAllocation::Slice input_buffer,
                    const Shape& input_shape,
                    BufferAllocation::Slice output_buffer,
                    const Shape& output_shape)
@@ -48,6 +61,7 @@ FftThunk::FftThunk(Info thunk_info, bool is_multi_thread_eigen,
                            input_shape.element_type() == C128),
       fft_type_(fft_type),
       fft_length_(fft_length.begin(), fft_length.end()),
+      plan_(std::move(plan)),
       input_buffer_(input_buffer),
       output_buffer_(output_buffer),
       input_shape_(input_shape),
@@ -58,16 +72,134 @@ absl::StatusOr<std::unique_ptr<FftThunk>> FftThunk::Create(
     absl::Span<const int64_t> fft_length, BufferAllocation::Slice input_buffer,
     const Shape& input_shape, BufferAllocation::Slice output_buffer,
     const Shape& output_shape) {
-  return absl::WrapUnique(
-      new FftThunk(thunk_info, is_multi_thread_eigen, fft_type, fft_length,
-                   input_buffer, input_shape, output_buffer, output_shape));
+  TF_RET_CHECK(LayoutUtil::IsMonotonicWithDim0Major(input_shape.layout()));
+  TF_RET_CHECK(LayoutUtil::IsMonotonicWithDim0Major(output_shape.layout()));
+
+  const int64_t fft_rank = fft_length.size();
+  const int64_t batch_rank = input_shape.rank() - fft_rank;
+  TF_RET_CHECK(fft_rank > 0 && batch_rank >= 0);
+
+  bool forward = (fft_type == FFT || fft_type == RFFT);
+  bool real = (fft_type == RFFT || fft_type == IRFFT);
+
+  // Flatten operand batches into dimension 0 and compute the DUCC shapes and
+  // strides of the row-major input and output arrays.
+  Plan plan;
+  plan.in_shape.resize(fft_rank + 1);
+  plan.in_stride.resize(fft_rank + 1);
+  plan.out_shape.resize(fft_rank + 1);
+  plan.out_stride.resize(fft_rank + 1);
+  plan.axes.resize(fft_rank);
+
+  int64_t batch_size = 1;
+  for (int64_t i = 0; i < batch_rank; ++i) {
+    batch_size *= input_shape.dimensions(i);
+  }
+
+  plan.in_shape[fft_rank] = input_shape.dimensions(batch_rank + fft_rank - 1);
+  plan.in_stride[fft_rank] = 1;
+  plan.out_shape[fft_rank] = (real && forward)
+                                 ? fft_length[fft_rank - 1] / 2 + 1
+                                 : fft_length[fft_rank - 1];
+  plan.out_stride[fft_rank] = 1;
+  for (int64_t i = fft_rank; i-- > 1;) {
+    plan.in_shape[i] = input_shape.dimensions(batch_rank + i - 1);
+    plan.in_stride[i] = plan.in_stride[i + 1] * plan.in_shape[i + 1];
+    plan.out_shape[i] = fft_length[i - 1];
+    plan.out_stride[i] = plan.out_stride[i + 1] * plan.out_shape[i + 1];
+    plan.axes[i] = i + 1;
+  }
+  plan.in_shape[0] = batch_size;
+  plan.in_stride[0] = plan.in_stride[1] * plan.in_shape[1];
+  plan.out_shape[0] = batch_size;
+  plan.out_stride[0] = plan.out_stride[1] * plan.out_shape[1];
+  plan.axes[0] = 1;
+
+  // DUCC doesn't handle the case where fft_size[i] < input_size[i], so clamp
+  // the input shape (but not strides) if required. If doing irfft, the limit
+  // of the last axis is actually fft_size[i]/2 + 1.
+  const bool is_irfft = real && !forward;
+  for (int64_t i = 0; i < fft_rank; ++i) {
+    int64_t limit = (is_irfft && (i == (fft_rank - 1)))
+                        ? fft_length[i] / 2 + 1
+                        : fft_length[i];
+    if (static_cast<int64_t>(plan.in_shape[plan.axes[i]]) > limit) {
+      plan.in_shape[plan.axes[i]] = limit;
+    }
+  }
+
+  double inv_scale = 1.0;
+  for (int64_t i = 0; i < fft_rank; ++i) {
+    inv_scale *= plan.out_shape[plan.axes[i]];
+  }
+  plan.scale = forward ? 1.0 : 1.0 / inv_scale;
+
+  plan.in_batch_stride_bytes =
+      plan.in_stride[0] *
+      ShapeUtil::ByteSizeOfPrimitiveType(input_shape.element_type());
+  plan.out_batch_stride_bytes =
+      plan.out_stride[0] *
+      ShapeUtil::ByteSizeOfPrimitiveType(output_shape.element_type());
+
+  return absl::WrapUnique(new FftThunk(
+      thunk_info, is_multi_thread_eigen, fft_type, fft_length, std::move(plan),
+      input_buffer, input_shape, output_buffer, output_shape));
+}
+
+template <typename T>
+static void DuccFft(int32_t fft_type, const void* in,
+                    const ducc0::google::Shape& in_shape,
+                    const ducc0::google::Stride& in_stride, void* out,
+                    const ducc0::google::Shape& out_shape,
+                    const ducc0::google::Stride& out_stride,
+                    const ducc0::google::Shape& axes, T scale) {
+  using Complex = std::complex<T>;
+
+  // DUCC runs in the caller thread, FftThunk parallelizes across the batch.
+  switch (fft_type) {
+    case FFT:
+    case IFFT:
+      ducc0::google::c2c(static_cast<const Complex*>(in), in_shape, in_stride,
+                         static_cast<Complex*>(out), out_shape, out_stride,
+                         axes, fft_type == FFT, scale,
+                         /*thread_pool=*/nullptr);
+      break;
+    case RFFT:
+      ducc0::google::r2c(static_cast<const T*>(in), in_shape, in_stride,
+                         static_cast<Complex*>(out), out_shape, out_stride,
+                         axes, /*forward=*/true, scale,
+                         /*thread_pool=*/nullptr);
+      break;
+    case IRFFT:
+      ducc0::google::c2r(static_cast<const Complex*>(in), in_shape, in_stride,
+                         static_cast<T*>(out), out_shape, out_stride, axes,
+                         /*forward=*/false, scale, /*thread_pool=*/nullptr);
+      break;
+  }
+}
+
+void FftThunk::Transform(int64_t begin, int64_t end, const std::byte* input,
+                         std::byte* output) const {
+  ducc0::google::Shape in_shape = plan_.in_shape;
+  ducc0::google::Shape out_shape = plan_.out_shape;
+  in_shape[0] = out_shape[0] = end - begin;
+
+  const std::byte* in = input + begin * plan_.in_batch_stride_bytes;
+  std::byte* out = output + begin * plan_.out_batch_stride_bytes;
+
+  if (is_double_precision_) {
+    DuccFft<double>(fft_type_, in, in_shape, plan_.in_stride, out, out_shape,
+                    plan_.out_stride, plan_.axes, plan_.scale);
+  } else {
+    DuccFft<float>(fft_type_, in, in_shape, plan_.in_stride, out, out_shape,
+                   plan_.out_stride, plan_.axes,
+                   static_cast<float>(plan_.scale));
+  }
 }
 
 tsl::AsyncValueRef<Thunk::ExecuteEvent> FftThunk::Execute(
     const ExecuteParams& params) {
   tsl::profiler::TraceMe trace([&] { return TraceMeEncode(); });
-  TF_RET_CHECK(LayoutUtil::IsMonotonicWithDim0Major(input_shape_.layout()));
-  TF_RET_CHECK(LayoutUtil::IsMonotonicWithDim0Major(output_shape_.layout()));
 
   TF_ASSIGN_OR_RETURN(
       se::DeviceMemoryBase input_data,
@@ -76,35 +208,48 @@ tsl::AsyncValueRef<Thunk::ExecuteEvent> FftThunk::Execute(
       se::DeviceMemoryBase output_data,
       params.buffer_allocations->GetDeviceAddress(output_buffer_));
 
-  const int fft_rank = fft_length_.size();
+  const std::byte* input = static_cast<const std::byte*>(input_data.opaque());
+  std::byte* output = static_cast<std::byte*>(output_data.opaque());
 
-  // Flatten operand batches.
-  absl::InlinedVector<int64_t, 4> operand_shape_flat(fft_rank + 1);
-  int64_t input_batch = 1;
-  int64_t input_batch_length = output_shape_.dimensions_size() - fft_rank;
-  for (int i = 0; i < input_batch_length; i++) {
-    input_batch *= input_shape_.dimensions(i);
+  // Skip FFTs with an empty batch.
+  if (ABSL_PREDICT_FALSE(batch_size() == 0)) {
+    return OkExecuteEvent();
   }
-  operand_shape_flat[0] = input_batch;
-  for (int i = 0; i < fft_rank; ++i) {
-    operand_shape_flat[i + 1] = input_shape_.dimensions(i + input_batch_length);
+
+  // Transforms in the batch are independent, so we split the batch into
+  // chunks of at least `kMinParallelFftTaskSize` output elements and process
+  // them in parallel on the intra-op thread pool.
+  int64_t num_tasks = 1;
+  if (is_multi_thread_eigen_ && params.intra_op_threadpool != nullptr) {
+    num_tasks = std::min<int64_t>(
+        {params.intra_op_threadpool->numThreadsInPool(), batch_size(),
+         batch_size() * plan_.out_stride[0] / kMinParallelFftTaskSize});
   }
 
-  // Args have been computed, make the call.
-  if (is_multi_thread_eigen_) {
-    __xla_cpu_runtime_DuccFft(nullptr,
-                              reinterpret_cast<float*>(output_data.opaque()),
-                              reinterpret_cast<float*>(input_data.opaque()),
-                              fft_type_, is_double_precision_, fft_rank,
-                              operand_shape_flat.data(), fft_length_.data());
-  } else {
-    __xla_cpu_runtime_DuccSingleThreadedFft(
-        nullptr, reinterpret_cast<float*>(output_data.opaque()),
-        reinterpret_cast<float*>(input_data.opaque()), fft_type_,
-        is_double_precision_, fft_rank, operand_shape_flat.data(),
-        fft_length_.data());
+  if (ABSL_PREDICT_TRUE(num_tasks <= 1)) {
+    Transform(0, batch_size(), input, output);
+    return OkExecuteEvent();
   }
-  return OkExecuteEvent();
+
+  int64_t batch_per_task = CeilOfRatio(batch_size(), num_tasks);
+  num_tasks = CeilOfRatio(batch_size(), batch_per_task);
+
+  auto event = tsl::MakeConstructedAsyncValueRef<ExecuteEvent>();
+  auto counter = std::make_shared<std::atomic<int64_t>>(num_tasks);
+
+  ScheduleAll(params.intra_op_threadpool, num_tasks,
+              [this, event, counter, batch_per_task, input,
+               output](int64_t task) {
+                int64_t begin = task * batch_per_task;
+                int64_t end = std::min(begin + batch_per_task, batch_size());
+                Transform(begin, end, input, output);
+
+                if (counter->load() == 1 || counter->fetch_sub(1) == 1) {
+                  event.SetStateConcrete();
+                }
+              });
+
+  return event;
 }
 
 Thunk::BufferUses FftThunk::buffer_uses() const {
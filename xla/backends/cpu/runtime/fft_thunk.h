@@ -16,6 +16,7 @@ limitations under the License.
 #ifndef XLA_BACKENDS_CPU_RUNTIME_FFT_THUNK_H_
 #define XLA_BACKENDS_CPU_RUNTIME_FFT_THUNK_H_
 
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <vector>
@@ -33,6 +34,12 @@ namespace xla::cpu {
 // This class stores everything that is needed to launch an FFT.
 // It is generated by IrEmitter.
 //
+// The FFT type, length and operand layouts are fixed at construction time, so
+// the thunk prepares the DUCC call parameters once and reuses them for every
+// execution. Leading (batch) dimensions hold independent transforms, and with
+// multi-threaded Eigen enabled large batches are split into chunks that are
+// transformed in parallel on the intra-op thread pool.
+//
 // This is thread-compatible.
 class FftThunk final : public Thunk {
  public:
@@ -48,16 +55,39 @@ class FftThunk final : public Thunk {
   BufferUses buffer_uses() const final;
 
  private:
+  // DUCC call parameters for transforming the whole batch. Shapes and strides
+  // are in elements, dimension 0 is the flattened batch.
+  struct Plan {
+    std::vector<size_t> in_shape;
+    std::vector<ptrdiff_t> in_stride;
+    std::vector<size_t> out_shape;
+    std::vector<ptrdiff_t> out_stride;
+    std::vector<size_t> axes;
+
+    double scale;
+
+    // Distance in bytes between consecutive transforms in the batch.
+    int64_t in_batch_stride_bytes;
+    int64_t out_batch_stride_bytes;
+  };
+
   // Constructs a thunk for launching an FFT on a host.
   FftThunk(Info thunk_info, bool is_multi_thread_eigen, int32_t fft_type,
-           absl::Span<const int64_t> fft_length,
+           absl::Span<const int64_t> fft_length, Plan plan,
            BufferAllocation::Slice input_buffer, const Shape& input_shape,
            BufferAllocation::Slice output_buffer, const Shape& output_shape);
 
+  // Transforms batch elements in the [begin, end) range.
+  void Transform(int64_t begin, int64_t end, const std::byte* input,
+                 std::byte* output) const;
+
+  int64_t batch_size() const { return plan_.in_shape[0]; }
+
   const bool is_multi_thread_eigen_;
   const bool is_double_precision_;
   const int32_t fft_type_;
   const std::vector<int64_t> fft_length_;
+  const Plan plan_;
 
   const BufferAllocation::Slice input_buffer_;
   const BufferAllocation::Slice output_buffer_;
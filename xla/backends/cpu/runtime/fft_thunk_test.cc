@@ -0,0 +1,213 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/backends/cpu/runtime/fft_thunk.h"
+
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "xla/backends/cpu/runtime/buffer_allocations.h"
+#include "xla/backends/cpu/runtime/thunk.h"
+#include "xla/service/buffer_assignment.h"
+#include "xla/service/maybe_owning_device_memory.h"
+#include "xla/shape.h"
+#include "xla/shape_util.h"
+#include "xla/stream_executor/device_memory.h"
+#include "xla/tsl/concurrency/async_value_ref.h"
+#include "xla/xla_data.pb.h"
+#include "tsl/platform/env.h"
+#include "tsl/platform/statusor.h"
+#include "tsl/platform/test.h"
+#include "tsl/platform/threadpool.h"
+
+#define EIGEN_USE_THREADS
+
+#include "unsupported/Eigen/CXX11/Tensor"
+
+namespace xla::cpu {
+namespace {
+
+using Complex = std::complex<float>;
+
+// Computes a DFT of length `length` of every row of the row-major
+// [batch, row_length] input, ignoring elements past `length` in each row.
+// Inverse transforms are scaled by 1/length.
+static std::vector<Complex> ReferenceDft(const std::vector<Complex>& input,
+                                         int64_t batch, int64_t row_length,
+                                         int64_t length, int64_t output_length,
+                                         bool inverse = false) {
+  double sign = inverse ? 1.0 : -1.0;
+  double scale = inverse ? 1.0 / length : 1.0;
+  std::vector<Complex> output(batch * output_length);
+  for (int64_t b = 0; b < batch; ++b) {
+    for (int64_t k = 0; k < output_length; ++k) {
+      std::complex<double> sum = 0;
+      for (int64_t n = 0; n < length; ++n) {
+        double angle = sign * 2.0 * M_PI * k * n / length;
+        sum += std::complex<double>(input[b * row_length + n]) *
+               std::polar(1.0, angle);
+      }
+      output[b * output_length + k] = Complex(sum * scale);
+    }
+  }
+  return output;
+}
+
+static std::vector<Complex> CreateInput(int64_t size, bool real) {
+  std::vector<Complex> input(size);
+  for (int64_t i = 0; i < size; ++i) {
+    input[i] = Complex(std::sin(0.1f * i), real ? 0.0f : std::cos(0.3f * i));
+  }
+  return input;
+}
+
+class FftThunkTest : public testing::TestWithParam<bool> {
+ protected:
+  FftThunkTest()
+      : thread_pool_(tsl::Env::Default(), "fft-test", 8),
+        device_(thread_pool_.AsEigenThreadPool(), thread_pool_.NumThreads()) {}
+
+  // Runs an FFT from `input` to `output`, on the intra-op thread pool if the
+  // test is parametrized to use it.
+  void RunFft(FftType fft_type, int64_t fft_length, void* input,
+              const Shape& input_shape, void* output,
+              const Shape& output_shape) {
+    size_t input_size = ShapeUtil::ByteSizeOf(input_shape);
+    size_t output_size = ShapeUtil::ByteSizeOf(output_shape);
+
+    std::vector<MaybeOwningDeviceMemory> buffers;
+    buffers.emplace_back(se::DeviceMemoryBase(input, input_size));
+    buffers.emplace_back(se::DeviceMemoryBase(output, output_size));
+    BufferAllocations allocations(buffers);
+
+    BufferAllocation input_alloc(0, input_size, 0);
+    BufferAllocation output_alloc(1, output_size, 0);
+    BufferAllocation::Slice input_slice(&input_alloc, 0, input_size);
+    BufferAllocation::Slice output_slice(&output_alloc, 0, output_size);
+
+    TF_ASSERT_OK_AND_ASSIGN(
+        auto thunk, FftThunk::Create({"fft"}, /*is_multi_thread_eigen=*/true,
+                                     fft_type, {fft_length}, input_slice,
+                                     input_shape, output_slice, output_shape));
+
+    Thunk::ExecuteParams params;
+    params.buffer_allocations = &allocations;
+    if (GetParam()) params.intra_op_threadpool = &device_;
+
+    auto execute_event = thunk->Execute(params);
+    tsl::BlockUntilReady(execute_event);
+    ASSERT_FALSE(execute_event.IsError());
+  }
+
+  tsl::thread::ThreadPool thread_pool_;
+  Eigen::ThreadPoolDevice device_;
+};
+
+TEST_P(FftThunkTest, BatchedFft) {
+  // Large enough batch to be split into multiple parallel tasks.
+  const int64_t batch = 256, length = 128;
+
+  std::vector<Complex> input = CreateInput(batch * length, /*real=*/false);
+  std::vector<Complex> output(batch * length);
+  Shape shape = ShapeUtil::MakeShape(C64, {4, batch / 4, length});
+
+  RunFft(FFT, length, input.data(), shape, output.data(), shape);
+
+  std::vector<Complex> expected =
+      ReferenceDft(input, batch, length, length, length);
+  for (size_t i = 0; i < expected.size(); ++i) {
+    ASSERT_NEAR(output[i].real(), expected[i].real(), 1e-3) << i;
+    ASSERT_NEAR(output[i].imag(), expected[i].imag(), 1e-3) << i;
+  }
+}
+
+TEST_P(FftThunkTest, BatchedRfft) {
+  // Large enough batch to be split into multiple parallel tasks.
+  const int64_t batch = 2048, length = 64, output_length = length / 2 + 1;
+
+  std::vector<Complex> complex_input =
+      CreateInput(batch * length, /*real=*/true);
+  std::vector<float> input(batch * length);
+  for (size_t i = 0; i < input.size(); ++i) input[i] = complex_input[i].real();
+  std::vector<Complex> output(batch * output_length);
+
+  RunFft(RFFT, length, input.data(), ShapeUtil::MakeShape(F32, {batch, length}),
+         output.data(), ShapeUtil::MakeShape(C64, {batch, output_length}));
+
+  std::vector<Complex> expected =
+      ReferenceDft(complex_input, batch, length, length, output_length);
+  for (size_t i = 0; i < expected.size(); ++i) {
+    ASSERT_NEAR(output[i].real(), expected[i].real(), 1e-3) << i;
+    ASSERT_NEAR(output[i].imag(), expected[i].imag(), 1e-3) << i;
+  }
+}
+
+TEST_P(FftThunkTest, BatchedIfftWithWideInput) {
+  // Large enough batch to be split into multiple parallel tasks. Input rows are
+  // wider than the FFT length, and the extra elements must be ignored.
+  const int64_t batch = 256, length = 128, input_length = 160;
+
+  std::vector<Complex> input =
+      CreateInput(batch * input_length, /*real=*/false);
+  std::vector<Complex> output(batch * length);
+
+  RunFft(IFFT, length, input.data(),
+         ShapeUtil::MakeShape(C64, {batch, input_length}), output.data(),
+         ShapeUtil::MakeShape(C64, {batch, length}));
+
+  std::vector<Complex> expected = ReferenceDft(
+      input, batch, input_length, length, length, /*inverse=*/true);
+  for (size_t i = 0; i < expected.size(); ++i) {
+    ASSERT_NEAR(output[i].real(), expected[i].real(), 1e-4) << i;
+    ASSERT_NEAR(output[i].imag(), expected[i].imag(), 1e-4) << i;
+  }
+}
+
+TEST_P(FftThunkTest, BatchedIrfftWithWideInput) {
+  // Large enough batch to be split into multiple parallel tasks. IRFFT reads
+  // only the first `length / 2 + 1` elements of every input row.
+  const int64_t batch = 1024, length = 64, input_length = 40;
+  const int64_t spectrum_length = length / 2 + 1;
+
+  // The input is the spectrum of a real signal, padded with garbage, so the
+  // inverse transform must reproduce the signal.
+  std::vector<Complex> signal = CreateInput(batch * length, /*real=*/true);
+  std::vector<Complex> spectrum =
+      ReferenceDft(signal, batch, length, length, spectrum_length);
+  std::vector<Complex> input(batch * input_length, Complex(100.0f, -100.0f));
+  for (int64_t b = 0; b < batch; ++b) {
+    for (int64_t k = 0; k < spectrum_length; ++k) {
+      input[b * input_length + k] = spectrum[b * spectrum_length + k];
+    }
+  }
+  std::vector<float> output(batch * length);
+
+  RunFft(IRFFT, length, input.data(),
+         ShapeUtil::MakeShape(C64, {batch, input_length}), output.data(),
+         ShapeUtil::MakeShape(F32, {batch, length}));
+
+  for (size_t i = 0; i < output.size(); ++i) {
+    ASSERT_NEAR(output[i], signal[i].real(), 1e-4) << i;
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(FftThunk, FftThunkTest, testing::Bool(),
+                         testing::PrintToStringParamName());
+
+}  // namespace
+}  // namespace xla::cpu
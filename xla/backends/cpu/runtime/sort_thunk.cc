@@ -17,12 +17,14 @@ limitations under the License.
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
 #include <functional>
 #include <iterator>
+#include <limits>
 #include <memory>
 #include <optional>
 #include <string>
@@ -36,11 +38,13 @@ limitations under the License.
 #include "absl/base/optimization.h"
 #include "absl/container/inlined_vector.h"
 #include "absl/memory/memory.h"
+#include "absl/numeric/bits.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
 #include "absl/types/span.h"
+#include "xla/backends/cpu/runtime/concurrency.h"
 #include "xla/backends/cpu/runtime/function_library.h"
 #include "xla/backends/cpu/runtime/thunk.h"
 #include "xla/layout_util.h"
@@ -453,6 +457,16 @@ struct SortDims {
   int64_t num_iterations;
 };
 
+// A range of a 1-dimensional slice processed by a single sort task. Large
+// slices are sorted in parallel: first we sort disjoint chunks of the slice,
+// and then we merge adjacent sorted chunks until the whole slice is sorted.
+struct SortRange {
+  int64_t begin;
+  int64_t end;
+  // If set, [begin, mid) and [mid, end) are sorted and have to be merged.
+  std::optional<int64_t> mid;
+};
+
 }  // namespace
 
 // Conceptually we have a 3-dimensional shape:
@@ -491,29 +505,157 @@ static SortDims GetSortDims(const Shape& shape, int64_t dimension) {
                   num_iterations};
 }
 
+// Returns the offset of the 1-dimensional slice with the given index.
+static int64_t GetSliceOffset(const SortDims& sort_dims, int64_t index) {
+  int64_t inner_idx = index % sort_dims.inner_dim_size;
+  return inner_idx + (index - inner_idx) * sort_dims.sort_dim_size;
+}
+
+// Sorts or merges the `range` of the slice starting at `slice` iterator.
+template <class Iterator, class Compare>
+static void SortRangeInplace(Iterator slice, const SortRange& range,
+                             bool is_stable, Compare compare) {
+  Iterator begin = slice + range.begin;
+  Iterator end = slice + range.end;
+
+  if (range.mid.has_value()) {
+    std::inplace_merge(begin, slice + *range.mid, end, compare);
+  } else if (is_stable) {
+    std::stable_sort(begin, end, compare);
+  } else {
+    std::sort(begin, end, compare);
+  }
+}
+
 template <class Iterator, class NativeT>
-static void Sort1DArrInplace(int64_t sort_dims_size, int64_t offset,
-                             Iterator begin, bool is_stable,
+static void Sort1DArrInplace(const SortRange& range, Iterator begin,
+                             bool is_stable,
                              SortThunk::SortDirection direction) {
   if (direction == SortThunk::SortDirection::kAscending) {
-    if (is_stable) {
-      std::stable_sort(begin, begin + sort_dims_size, std::less<NativeT>());
-    } else {
-      std::sort(begin, begin + sort_dims_size, std::less<NativeT>());
-    }
+    SortRangeInplace(begin, range, is_stable, std::less<NativeT>());
   } else {
-    if (is_stable) {
-      std::stable_sort(begin, begin + sort_dims_size, std::greater<NativeT>());
-    } else {
-      std::sort(begin, begin + sort_dims_size, std::greater<NativeT>());
+    SortRangeInplace(begin, range, is_stable, std::greater<NativeT>());
+  }
+}
+
+// Radix sort is faster than comparison based sorting for all but the smallest
+// arrays of primitive types.
+//
+// Single-input sorts of radix sortable types with a known direction order all
+// ranges by radix keys (see `ToRadixKey`), also the ones below this threshold,
+// so that the result does not depend on the range size. For floating point
+// types the ascending order is -NaN < -inf < ... < -0.0 == +0.0 < ... < +inf <
+// +NaN, and the descending order reverses it. Negative and positive zeros
+// compare equal, so a stable sort keeps their relative order. Unlike
+// `std::less` and `std::greater`, this is a strict weak order even if the input
+// contains NaNs.
+static constexpr int64_t kRadixSortThreshold = 1024;
+
+// Returns true if the values of the given type can be sorted with radix sort.
+// We don't radix sort 8-bit floating point types, as some of them don't have a
+// sign bit or have multiple encodings of zero.
+static constexpr bool IsRadixSortable(PrimitiveType type) {
+  return primitive_util::IsIntegralType(type) || type == F16 || type == BF16 ||
+         type == F32 || type == F64;
+}
+
+template <typename NativeT>
+using RadixKey = UnsignedIntegerTypeForSizeType<sizeof(NativeT)>;
+
+// Maps a value to an unsigned integer key, such that sorting keys in ascending
+// order sorts values in the given direction. Negative and positive zeros are
+// mapped to the same key, and NaNs are ordered according to their sign bit.
+template <typename NativeT>
+static RadixKey<NativeT> ToRadixKey(NativeT value,
+                                    SortThunk::SortDirection direction) {
+  using Key = RadixKey<NativeT>;
+  static constexpr Key kSignBit = static_cast<Key>(Key{1}
+                                                   << (8 * sizeof(Key) - 1));
+
+  Key key;
+  std::memcpy(&key, &value, sizeof(Key));
+
+  if constexpr (std::numeric_limits<NativeT>::is_integer) {
+    if constexpr (std::numeric_limits<NativeT>::is_signed) key ^= kSignBit;
+  } else {
+    if (value == static_cast<NativeT>(0)) key = 0;
+    key = (key & kSignBit) ? static_cast<Key>(~key)
+                           : static_cast<Key>(key | kSignBit);
+  }
+
+  return direction == SortThunk::SortDirection::kAscending
+             ? key
+             : static_cast<Key>(~key);
+}
+
+// Stable least-significant-digit radix sort with 8-bit digits.
+template <typename NativeT>
+static void RadixSort(NativeT* data, int64_t size,
+                      SortThunk::SortDirection direction) {
+  using Key = RadixKey<NativeT>;
+  static constexpr size_t kNumDigits = sizeof(Key);
+  static constexpr size_t kNumBuckets = 256;
+
+  // Build histograms for all digits with a single pass over the data.
+  std::vector<std::array<int64_t, kNumBuckets>> histograms(kNumDigits);
+  for (int64_t i = 0; i < size; ++i) {
+    Key key = ToRadixKey(data[i], direction);
+    for (size_t d = 0; d < kNumDigits; ++d) {
+      ++histograms[d][(key >> (8 * d)) & 0xFF];
+    }
+  }
+
+  std::unique_ptr<NativeT[]> scratch(new NativeT[size]);
+  NativeT* src = data;
+  NativeT* dst = scratch.get();
+
+  for (size_t d = 0; d < kNumDigits; ++d) {
+    std::array<int64_t, kNumBuckets>& histogram = histograms[d];
+
+    // Skip digits that are the same for all values.
+    if (absl::c_linear_search(histogram, size)) continue;
+
+    // Convert bucket sizes into bucket offsets.
+    int64_t offset = 0;
+    for (int64_t& bucket : histogram) {
+      offset += std::exchange(bucket, offset);
+    }
+
+    for (int64_t i = 0; i < size; ++i) {
+      Key key = ToRadixKey(src[i], direction);
+      dst[histogram[(key >> (8 * d)) & 0xFF]++] = src[i];
     }
+    std::swap(src, dst);
+  }
+
+  if (src != data) std::copy(src, src + size, data);
+}
+
+// Sorts or merges the `range` of a contiguous slice using radix keys order.
+template <typename NativeT>
+static void RadixSortRangeInplace(NativeT* slice, const SortRange& range,
+                                  bool is_stable,
+                                  SortThunk::SortDirection direction) {
+  // Radix sort is stable, so we can use it for both stable and unstable sorts.
+  if (!range.mid.has_value() &&
+      range.end - range.begin >= kRadixSortThreshold) {
+    RadixSort(slice + range.begin, range.end - range.begin, direction);
+    return;
+  }
+
+  // For small ranges and for merging sorted chunks compare radix keys, so that
+  // the order is consistent with the radix sort order.
+  auto compare = [direction](NativeT a, NativeT b) {
+    return ToRadixKey(a, direction) < ToRadixKey(b, direction);
   };
+  SortRangeInplace(slice, range, is_stable, compare);
 }
 
 // The most efficient way to sort a single buffer is to use the builtin
 // comparator functions.
 template <PrimitiveType Type>
 static void Sort1DArrInplace(const SortDims& sort_dims, int64_t offset,
+                             const SortRange& range,
                              absl::Span<se::DeviceMemoryBase> data,
                              bool is_stable,
                              SortThunk::SortDirection direction) {
@@ -522,19 +664,23 @@ static void Sort1DArrInplace(const SortDims& sort_dims, int64_t offset,
   NativeT* begin = reinterpret_cast<NativeT*>(data[0].opaque()) + offset;
 
   if (sort_dims.inner_dim_size == 1) {
-    Sort1DArrInplace<NativeT*, NativeT>(sort_dims.sort_dim_size, offset, begin,
-                                        is_stable, direction);
+    if constexpr (IsRadixSortable(Type)) {
+      RadixSortRangeInplace<NativeT>(begin, range, is_stable, direction);
+    } else {
+      Sort1DArrInplace<NativeT*, NativeT>(range, begin, is_stable, direction);
+    }
   } else {
     using Iterator = SortIterator<NativeT, NativeT&, NativeT*>;
     Iterator begin_iter(begin, /*stride=*/sort_dims.inner_dim_size);
-    Sort1DArrInplace<Iterator, NativeT>(sort_dims.sort_dim_size, offset,
-                                        begin_iter, is_stable, direction);
+    Sort1DArrInplace<Iterator, NativeT>(range, begin_iter, is_stable,
+                                        direction);
   }
 }
 
 // Sorts `n` buffers in place.
 template <size_t n>
 static void SortInplace(const SortDims& sort_dims, int64_t offset,
+                        const SortRange& range,
                         absl::Span<se::DeviceMemoryBase> data,
                         absl::Span<const Shape> shapes, bool is_stable,
                         SortThunk::LessThan* less_than) {
@@ -559,14 +705,11 @@ static void SortInplace(const SortDims& sort_dims, int64_t offset,
   SortIterator<Value<n>, Ref<n>, Ptr<n>> begin(
       Ptr<n>(ptr, ptr_sizes),
       /*stride=*/sort_dims.inner_dim_size);
-  if (is_stable) {
-    std::stable_sort(begin, begin + sort_dims.sort_dim_size, compare);
-  } else {
-    std::sort(begin, begin + sort_dims.sort_dim_size, compare);
-  }
+  SortRangeInplace(begin, range, is_stable, compare);
 }
 
 static void DSortInplace(const SortDims& sort_dims, int64_t offset,
+                         const SortRange& range,
                          absl::Span<se::DeviceMemoryBase> data,
                          absl::Span<const Shape> shapes, bool is_stable,
                          SortThunk::LessThan* less_than, size_t n) {
@@ -590,10 +733,130 @@ static void DSortInplace(const SortDims& sort_dims, int64_t offset,
 
   SortIterator<DValue, DRef, DPtr> begin(DPtr(ptr, ptr_sizes),
                                          /*stride=*/sort_dims.inner_dim_size);
-  if (is_stable) {
-    std::stable_sort(begin, begin + sort_dims.sort_dim_size, compare);
-  } else {
-    std::sort(begin, begin + sort_dims.sort_dim_size, compare);
+  SortRangeInplace(begin, range, is_stable, compare);
+}
+
+// Sorts (or merges) the `range` of the 1-dimensional slice at `offset` inplace.
+static void SortSliceInplace(
+    const SortDims& sort_dims, int64_t offset, const SortRange& range,
+    absl::Span<se::DeviceMemoryBase> data, absl::Span<const Shape> shapes,
+    bool is_stable, SortThunk::LessThan* less_than,
+    std::optional<SortThunk::SortDirection> direction) {
+  auto sort = [&](auto num_inputs) {
+    SortInplace<decltype(num_inputs)::value>(sort_dims, offset, range, data,
+                                             shapes, is_stable, less_than);
+  };
+
+  auto dsort = [&](size_t num_inputs) {
+    DSortInplace(sort_dims, offset, range, data, shapes, is_stable,
+                 less_than, num_inputs);
+  };
+
+  // Sorts array using builtin comparator functor
+  auto builtin_sort = [&](PrimitiveType type,
+                          SortThunk::SortDirection direction) {
+    primitive_util::ArrayTypeSwitch<void>(
+        [&](auto cst_type) {
+          if constexpr ((primitive_util::IsFloatingPointType(cst_type) ||
+                         primitive_util::IsIntegralType(cst_type)) &&
+                        primitive_util::BitWidth(cst_type) >= 8) {
+            Sort1DArrInplace<cst_type>(sort_dims, offset, range, data,
+                                       is_stable, direction);
+          } else {
+            sort(std::integral_constant<size_t, 1>{});
+          }
+        },
+        type);
+  };
+
+  // use "sort" for statically known number of sorted inputs (expected to be
+  // faster) and "dsort" for dynamically known number of sorted inputs.
+  // for 100 elements stable sort is 1.5 times faster than stable dsort.
+  // for 100 elements unstable sort is 2.47 times faster than unstable dsort.
+  switch (data.size()) {
+    case 1:
+      DCHECK_EQ(shapes.size(), 1);
+      if (direction.has_value()) {
+        builtin_sort(shapes[0].element_type(), *direction);
+      } else {
+        sort(std::integral_constant<size_t, 1>{});
+      }
+      break;
+    case 2:
+      sort(std::integral_constant<size_t, 2>{});
+      break;
+    case 3:
+      sort(std::integral_constant<size_t, 3>{});
+      break;
+    case 4:
+      sort(std::integral_constant<size_t, 4>{});
+      break;
+    case 5:
+      sort(std::integral_constant<size_t, 5>{});
+      break;
+    case 6:
+      sort(std::integral_constant<size_t, 6>{});
+      break;
+    case 7:
+      sort(std::integral_constant<size_t, 7>{});
+      break;
+    case 8:
+      sort(std::integral_constant<size_t, 8>{});
+      break;
+    case 9:
+      sort(std::integral_constant<size_t, 9>{});
+      break;
+    case 10:
+      sort(std::integral_constant<size_t, 10>{});
+      break;
+    case 11:
+      sort(std::integral_constant<size_t, 11>{});
+      break;
+    case 12:
+      sort(std::integral_constant<size_t, 12>{});
+      break;
+    case 13:
+      sort(std::integral_constant<size_t, 13>{});
+      break;
+    case 14:
+      sort(std::integral_constant<size_t, 14>{});
+      break;
+    case 15:
+      sort(std::integral_constant<size_t, 15>{});
+      break;
+    case 16:
+      sort(std::integral_constant<size_t, 16>{});
+      break;
+    case 17:
+      sort(std::integral_constant<size_t, 17>{});
+      break;
+    case 18:
+      sort(std::integral_constant<size_t, 18>{});
+      break;
+    case 19:
+      sort(std::integral_constant<size_t, 19>{});
+      break;
+    case 20:
+      sort(std::integral_constant<size_t, 20>{});
+      break;
+    case 21:
+      sort(std::integral_constant<size_t, 21>{});
+      break;
+    case 22:
+      sort(std::integral_constant<size_t, 22>{});
+      break;
+    case 23:
+      sort(std::integral_constant<size_t, 23>{});
+      break;
+    case 24:
+      sort(std::integral_constant<size_t, 24>{});
+      break;
+    case 25:
+      sort(std::integral_constant<size_t, 25>{});
+      break;
+    default:
+      dsort(data.size());
+      break;
   }
 }
 
@@ -605,131 +868,146 @@ static absl::Status SortInplace(
   // All inputs have the same dimensions and layout, so we can use the first
   // shape to get the sort dimensions.
   SortDims sort_dims = GetSortDims(shapes[0], dimension);
+  SortRange range = {0, sort_dims.sort_dim_size, std::nullopt};
 
   // Iterate over all the 1-dimensional slices of the buffers and sort them.
   for (int64_t i = 0; i < sort_dims.num_iterations; ++i) {
-    int64_t inner_idx = i % sort_dims.inner_dim_size;
-    int64_t offset = inner_idx + (i - inner_idx) * sort_dims.sort_dim_size;
+    SortSliceInplace(sort_dims, GetSliceOffset(sort_dims, i), range, data,
+                     shapes, is_stable, less_than, direction);
+  }
 
-    auto sort = [&](auto num_inputs) {
-      SortInplace<decltype(num_inputs)::value>(sort_dims, offset, data, shapes,
-                                               is_stable, less_than);
-    };
+  return absl::OkStatus();
+}
 
-    auto dsort = [&](size_t num_inputs) {
-      DSortInplace(sort_dims, offset, data, shapes, is_stable, less_than,
-                   num_inputs);
-    };
+// Sorting small inputs in parallel is not worth the task scheduling overheads.
+static constexpr int64_t kMinParallelSortSize = 64 * 1024;
+
+// Minimum number of elements sorted by a single parallel sort task.
+static constexpr int64_t kMinParallelSortTaskSize = 16 * 1024;
+
+namespace {
+
+// State of a parallel sort shared by all sort tasks. We sort in rounds: in the
+// first round every task sorts a chunk of a slice (or a group of slices), and
+// in the following rounds tasks merge pairs of adjacent sorted chunks, until
+// all slices are sorted. All chunks of a slice are sorted and merged with a
+// stable algorithm if the original sort is stable.
+struct ParallelSortState {
+  const Eigen::ThreadPoolDevice* intra_op_threadpool;
+
+  absl::InlinedVector<se::DeviceMemoryBase, 8> data;
+  absl::InlinedVector<Shape, 8> shapes;
+
+  SortDims sort_dims;
+  bool is_stable;
+  SortThunk::LessThan* less_than;
+  std::optional<SortThunk::SortDirection> direction;
+
+  int64_t num_chunks;       // number of chunks in a slice (a power of two)
+  int64_t slices_per_task;  // number of slices processed by a single task
+
+  tsl::AsyncValueRef<SortThunk::ExecuteEvent> event;
+};
+
+}  // namespace
+
+// Returns the max number of tasks we can use to sort `sort_dims` in parallel.
+static int64_t GetMaxParallelSortTasks(
+    const SortDims& sort_dims,
+    const Eigen::ThreadPoolDevice* intra_op_threadpool) {
+  if (intra_op_threadpool == nullptr) return 1;
 
-    // Sorts array using builtin comparator functor
-    auto builtin_sort = [&](PrimitiveType type,
-                            SortThunk::SortDirection direction) {
-      primitive_util::ArrayTypeSwitch<void>(
-          [&](auto cst_type) {
-            if constexpr ((primitive_util::IsFloatingPointType(cst_type) ||
-                           primitive_util::IsIntegralType(cst_type)) &&
-                          primitive_util::BitWidth(cst_type) >= 8) {
-              Sort1DArrInplace<cst_type>(sort_dims, offset, data, is_stable,
-                                         direction);
-            } else {
-              sort(std::integral_constant<size_t, 1>{});
-            }
-          },
-          type);
+  int64_t num_elements = sort_dims.num_iterations * sort_dims.sort_dim_size;
+  if (num_elements < kMinParallelSortSize) return 1;
+
+  return std::min<int64_t>(intra_op_threadpool->numThreadsInPool(),
+                           num_elements / kMinParallelSortTaskSize);
+}
+
+// Runs a parallel sort round, in which every task sorts (if `width` is one) or
+// merges `width` adjacent chunks of a slice. Starts the next round when all
+// tasks are completed.
+static void RunParallelSortRound(std::shared_ptr<ParallelSortState> state,
+                                 int64_t width) {
+  if (width > state->num_chunks) {
+    state->event.SetStateConcrete();
+    return;
+  }
+
+  int64_t num_slice_groups =
+      CeilOfRatio(state->sort_dims.num_iterations, state->slices_per_task);
+  int64_t tasks_per_slice = state->num_chunks / width;
+  int64_t num_tasks = num_slice_groups * tasks_per_slice;
+
+  auto counter = std::make_shared<std::atomic<int64_t>>(num_tasks);
+
+  auto execute = [state, width, tasks_per_slice, counter](int64_t task) {
+    const SortDims& sort_dims = state->sort_dims;
+
+    auto chunk_offset = [&](int64_t chunk) {
+      return chunk * sort_dims.sort_dim_size / state->num_chunks;
     };
 
-    // use "sort" for statically known number of sorted inputs (expected to be
-    // faster) and "dsort" for dynamically known number of sorted inputs.
-    // for 100 elements stable sort is 1.5 times faster than stable dsort.
-    // for 100 elements unstable sort is 2.47 times faster than unstable dsort.
-    switch (data.size()) {
-      case 1:
-        DCHECK_EQ(shapes.size(), 1);
-        if (direction.has_value()) {
-          builtin_sort(shapes[0].element_type(), *direction);
-        } else {
-          sort(std::integral_constant<size_t, 1>{});
-        }
-        break;
-      case 2:
-        sort(std::integral_constant<size_t, 2>{});
-        break;
-      case 3:
-        sort(std::integral_constant<size_t, 3>{});
-        break;
-      case 4:
-        sort(std::integral_constant<size_t, 4>{});
-        break;
-      case 5:
-        sort(std::integral_constant<size_t, 5>{});
-        break;
-      case 6:
-        sort(std::integral_constant<size_t, 6>{});
-        break;
-      case 7:
-        sort(std::integral_constant<size_t, 7>{});
-        break;
-      case 8:
-        sort(std::integral_constant<size_t, 8>{});
-        break;
-      case 9:
-        sort(std::integral_constant<size_t, 9>{});
-        break;
-      case 10:
-        sort(std::integral_constant<size_t, 10>{});
-        break;
-      case 11:
-        sort(std::integral_constant<size_t, 11>{});
-        break;
-      case 12:
-        sort(std::integral_constant<size_t, 12>{});
-        break;
-      case 13:
-        sort(std::integral_constant<size_t, 13>{});
-        break;
-      case 14:
-        sort(std::integral_constant<size_t, 14>{});
-        break;
-      case 15:
-        sort(std::integral_constant<size_t, 15>{});
-        break;
-      case 16:
-        sort(std::integral_constant<size_t, 16>{});
-        break;
-      case 17:
-        sort(std::integral_constant<size_t, 17>{});
-        break;
-      case 18:
-        sort(std::integral_constant<size_t, 18>{});
-        break;
-      case 19:
-        sort(std::integral_constant<size_t, 19>{});
-        break;
-      case 20:
-        sort(std::integral_constant<size_t, 20>{});
-        break;
-      case 21:
-        sort(std::integral_constant<size_t, 21>{});
-        break;
-      case 22:
-        sort(std::integral_constant<size_t, 22>{});
-        break;
-      case 23:
-        sort(std::integral_constant<size_t, 23>{});
-        break;
-      case 24:
-        sort(std::integral_constant<size_t, 24>{});
-        break;
-      case 25:
-        sort(std::integral_constant<size_t, 25>{});
-        break;
-      default:
-        dsort(data.size());
-        break;
+    int64_t first_chunk = (task % tasks_per_slice) * width;
+    SortRange range = {chunk_offset(first_chunk),
+                       chunk_offset(first_chunk + width), std::nullopt};
+    if (width > 1) range.mid = chunk_offset(first_chunk + width / 2);
+
+    int64_t begin = (task / tasks_per_slice) * state->slices_per_task;
+    int64_t end = std::min(begin + state->slices_per_task,
+                           sort_dims.num_iterations);
+
+    for (int64_t i = begin; i < end; ++i) {
+      SortSliceInplace(sort_dims, GetSliceOffset(sort_dims, i), range,
+                       absl::MakeSpan(state->data), state->shapes,
+                       state->is_stable, state->less_than, state->direction);
+    }
+
+    if (counter->load() == 1 || counter->fetch_sub(1) == 1) {
+      RunParallelSortRound(state, width * 2);
     }
+  };
+
+  ScheduleAll(state->intra_op_threadpool, num_tasks, std::move(execute));
+}
+
+// Sorts `data` of the given `shape` along the `dimension` inplace using up to
+// `max_tasks` tasks running in the intra-op thread pool.
+static tsl::AsyncValueRef<SortThunk::ExecuteEvent> ParallelSortInplace(
+    const Eigen::ThreadPoolDevice* intra_op_threadpool, int64_t max_tasks,
+    absl::Span<const se::DeviceMemoryBase> data,
+    absl::Span<const Shape> shapes, const SortDims& sort_dims, bool is_stable,
+    SortThunk::LessThan* less_than,
+    std::optional<SortThunk::SortDirection> direction) {
+  auto state = std::make_shared<ParallelSortState>();
+  state->intra_op_threadpool = intra_op_threadpool;
+  state->data.assign(data.begin(), data.end());
+  state->shapes.assign(shapes.begin(), shapes.end());
+  state->sort_dims = sort_dims;
+  state->is_stable = is_stable;
+  state->less_than = less_than;
+  state->direction = direction;
+  state->event = tsl::MakeConstructedAsyncValueRef<SortThunk::ExecuteEvent>();
+
+  // Prefer parallelizing over independent slices, and split slices into
+  // chunks that are sorted in parallel and then merged only if we don't have
+  // enough slices to keep all threads busy.
+  if (sort_dims.num_iterations >= max_tasks) {
+    state->num_chunks = 1;
+    state->slices_per_task = CeilOfRatio(sort_dims.num_iterations, max_tasks);
+  } else {
+    state->num_chunks = absl::bit_floor(
+        static_cast<uint64_t>(max_tasks / sort_dims.num_iterations));
+    state->slices_per_task = 1;
   }
 
-  return absl::OkStatus();
+  VLOG(3) << absl::StreamFormat(
+      "  parallel sort: num_chunks=%d, slices_per_task=%d", state->num_chunks,
+      state->slices_per_task);
+
+  auto event = state->event;
+  RunParallelSortRound(std::move(state), /*width=*/1);
+  return event;
 }
 
 tsl::AsyncValueRef<SortThunk::ExecuteEvent> SortThunk::Execute(
@@ -789,6 +1067,17 @@ tsl::AsyncValueRef<SortThunk::ExecuteEvent> SortThunk::Execute(
   TF_RETURN_IF_ERROR(less_than_.status());
   LessThan* less_than = &less_than_.value();
 
+  // Use intra-op thread pool to sort large inputs in parallel.
+  SortDims sort_dims = GetSortDims(shapes[0], dimension_);
+  int64_t max_tasks =
+      GetMaxParallelSortTasks(sort_dims, params.intra_op_threadpool);
+
+  if (max_tasks > 1) {
+    return ParallelSortInplace(params.intra_op_threadpool, max_tasks, data,
+                               shapes, sort_dims, is_stable_, less_than,
+                               direction_);
+  }
+
   TF_RETURN_IF_ERROR(SortInplace(absl::MakeSpan(data), shapes, dimension_,
                                  is_stable_, less_than, direction_));
 
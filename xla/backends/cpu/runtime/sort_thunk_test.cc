@@ -17,15 +17,19 @@ limitations under the License.
 
 #include <algorithm>
 #include <array>
+#include <cmath>
 #include <cstddef>
 #include <cstdint>
 #include <functional>
+#include <limits>
 #include <numeric>
+#include <optional>
 #include <random>
 #include <string_view>
 #include <vector>
 
 #include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
 #include "xla/backends/cpu/runtime/buffer_allocations.h"
 #include "xla/backends/cpu/runtime/function_library.h"
 #include "xla/backends/cpu/runtime/thunk.h"
@@ -37,10 +41,17 @@ limitations under the License.
 #include "xla/shape_util.h"
 #include "xla/stream_executor/device_memory.h"
 #include "xla/tsl/concurrency/async_value_ref.h"
+#include "tsl/platform/env.h"
 #include "tsl/platform/logging.h"
 #include "tsl/platform/statusor.h"
 #include "tsl/platform/test.h"
 #include "tsl/platform/test_benchmark.h"
+#include "tsl/platform/threadpool.h"
+
+#define EIGEN_USE_THREADS
+
+#include "Eigen/ThreadPool"
+#include "unsupported/Eigen/CXX11/Tensor"
 
 namespace xla::cpu {
 namespace {
@@ -110,6 +121,79 @@ TEST_P(SortThunkTest, DescendingSortPlainArray) {
       std::is_sorted(data.cbegin(), data.cend(), std::greater<float>()));
 }
 
+// Returns the position of `value` in the order of the radix sort used for
+// plain float arrays with ascending direction: -NaN < -inf < ... < -0 == +0 <
+// ... < +inf < +NaN.
+static int RadixSortRank(float value) {
+  if (std::isnan(value)) return std::signbit(value) ? 0 : 6;
+  if (std::isinf(value)) return value < 0 ? 1 : 5;
+  if (value == 0.0f) return 3;
+  return value < 0 ? 2 : 4;
+}
+
+TEST_P(SortThunkTest, SortPlainArrayOrdersNaNsAndZeros) {
+  bool is_stable = GetParam();
+
+  const float nan = std::numeric_limits<float>::quiet_NaN();
+  const float inf = std::numeric_limits<float>::infinity();
+  const std::vector<float> pattern = {nan,  -1.0f, 0.0f, -inf, -nan,
+                                      1.0f, -0.0f, inf,  0.0f, -0.0f};
+
+  // Check ranges below and above the radix sort threshold.
+  for (int64_t repeats : {1, 200}) {
+    for (auto direction : {SortThunk::SortDirection::kAscending,
+                           SortThunk::SortDirection::kDescending}) {
+      std::vector<float> data;
+      for (int64_t i = 0; i < repeats; ++i) {
+        data.insert(data.end(), pattern.begin(), pattern.end());
+      }
+
+      // Negative and positive zeros compare equal and keep their relative
+      // order if the sort is stable.
+      bool ascending = direction == SortThunk::SortDirection::kAscending;
+      std::vector<float> expected = data;
+      std::stable_sort(expected.begin(), expected.end(), [&](float a, float b) {
+        return ascending ? RadixSortRank(a) < RadixSortRank(b)
+                         : RadixSortRank(a) > RadixSortRank(b);
+      });
+
+      const size_t size_in_bytes = data.size() * sizeof(float);
+      std::vector<MaybeOwningDeviceMemory> buffers;
+      buffers.emplace_back(se::DeviceMemoryBase(data.data(), size_in_bytes));
+
+      const BufferAllocations allocations(buffers);
+      const BufferAllocation alloc(0, size_in_bytes, 0);
+      const BufferAllocation::Slice slice0(&alloc, 0, size_in_bytes);
+      const Shape data_shape =
+          ShapeUtil::MakeShape(F32, {static_cast<int64_t>(data.size())});
+
+      auto fake_less_than = [](const void** data) { return false; };
+
+      TF_ASSERT_OK_AND_ASSIGN(
+          auto thunk,
+          SortThunk::Create({"sort"}, {{slice0, data_shape}},
+                            /*dimension=*/0, is_stable, fake_less_than,
+                            direction));
+
+      Thunk::ExecuteParams params;
+      params.buffer_allocations = &allocations;
+
+      auto execute_event = thunk->Execute(params);
+      tsl::BlockUntilReady(execute_event);
+      ASSERT_FALSE(execute_event.IsError());
+
+      for (size_t i = 0; i < data.size(); ++i) {
+        SCOPED_TRACE(absl::StrCat("repeats=", repeats,
+                                  " ascending=", ascending, " i=", i));
+        EXPECT_EQ(RadixSortRank(data[i]), RadixSortRank(expected[i]));
+        if (is_stable) {
+          EXPECT_EQ(std::signbit(data[i]), std::signbit(expected[i]));
+        }
+      }
+    }
+  }
+}
+
 TEST_P(SortThunkTest, Sort1D) {
   bool is_stable = GetParam();
 
@@ -371,6 +455,165 @@ TEST_P(SortThunkTest, Sort2DWithLayout) {
   EXPECT_EQ(indices, expected_indices);
 }
 
+// A fixture for tests that sort large inputs in parallel using the intra-op
+// thread pool.
+class ParallelSortThunkTest : public testing::TestWithParam<bool> {
+ protected:
+  ParallelSortThunkTest()
+      : thread_pool_(tsl::Env::Default(), "sort-test", 8),
+        device_(thread_pool_.AsEigenThreadPool(), thread_pool_.NumThreads()) {}
+
+  tsl::thread::ThreadPool thread_pool_;
+  Eigen::ThreadPoolDevice device_;
+};
+
+TEST_P(ParallelSortThunkTest, SortPlainArray) {
+  bool is_stable = GetParam();
+  const int data_size = 1000000;
+
+  // Use a small range of values to get a lot of duplicates.
+  std::vector<float> data(data_size);
+  std::default_random_engine gen;
+  std::uniform_int_distribution<int32_t> distribution(-1000, 1000);
+  for (float& value : data) value = distribution(gen) / 10.0f;
+
+  std::vector<float> expected = data;
+  std::stable_sort(expected.begin(), expected.end(), std::greater<float>());
+
+  const size_t size_in_bytes = data_size * sizeof(float);
+  std::vector<MaybeOwningDeviceMemory> buffers;
+  buffers.emplace_back(se::DeviceMemoryBase(data.data(), size_in_bytes));
+
+  const BufferAllocations allocations(buffers);
+  const BufferAllocation alloc(0, size_in_bytes, 0);
+  const BufferAllocation::Slice slice0(&alloc, 0, size_in_bytes);
+  const Shape data_shape = ShapeUtil::MakeShape(F32, {data_size});
+
+  auto fake_less_than = [](const void** data) { return false; };
+
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto thunk, SortThunk::Create({"sort"}, {{slice0, data_shape}},
+                                    /*dimension=*/0, is_stable, fake_less_than,
+                                    SortThunk::SortDirection::kDescending));
+
+  Thunk::ExecuteParams params;
+  params.buffer_allocations = &allocations;
+  params.intra_op_threadpool = &device_;
+
+  auto execute_event = thunk->Execute(params);
+  tsl::BlockUntilReady(execute_event);
+  ASSERT_FALSE(execute_event.IsError());
+
+  EXPECT_EQ(data, expected);
+}
+
+TEST_P(ParallelSortThunkTest, SortKeysAndIndices) {
+  bool is_stable = GetParam();
+
+  // Sort a few large rows, so that each row is sorted by multiple tasks.
+  const int num_rows = 3;
+  const int row_size = 200000;
+  const int data_size = num_rows * row_size;
+
+  std::vector<float> data(data_size);
+  std::default_random_engine gen;
+  std::uniform_int_distribution<int32_t> distribution(0, 100);
+  for (float& value : data) value = distribution(gen);
+
+  std::vector<int32_t> indices(data_size);
+  for (int i = 0; i < data_size; ++i) indices[i] = i % row_size;
+
+  std::vector<float> original = data;
+
+  std::vector<MaybeOwningDeviceMemory> buffers;
+  buffers.emplace_back(
+      se::DeviceMemoryBase(data.data(), data_size * sizeof(float)));
+  buffers.emplace_back(
+      se::DeviceMemoryBase(indices.data(), data_size * sizeof(int32_t)));
+
+  BufferAllocations allocations(buffers);
+
+  BufferAllocation alloc0(0, data_size * sizeof(float), 0);
+  BufferAllocation alloc1(1, data_size * sizeof(int32_t), 0);
+
+  BufferAllocation::Slice slice0(&alloc0, 0, alloc0.size());
+  BufferAllocation::Slice slice1(&alloc1, 0, alloc1.size());
+
+  Shape data_shape = ShapeUtil::MakeShape(F32, {num_rows, row_size});
+  Shape indices_shape = ShapeUtil::MakeShape(S32, {num_rows, row_size});
+
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto thunk, SortThunk::Create(
+                      {"sort"}, {{slice0, data_shape}, {slice1, indices_shape}},
+                      /*dimension=*/1, is_stable, LessThan,
+                      /*direction=*/std::nullopt));
+
+  Thunk::ExecuteParams params;
+  params.buffer_allocations = &allocations;
+  params.intra_op_threadpool = &device_;
+
+  auto execute_event = thunk->Execute(params);
+  tsl::BlockUntilReady(execute_event);
+  ASSERT_FALSE(execute_event.IsError());
+
+  for (int row = 0; row < num_rows; ++row) {
+    const float* keys = data.data() + row * row_size;
+    const int32_t* idxs = indices.data() + row * row_size;
+
+    ASSERT_TRUE(std::is_sorted(keys, keys + row_size));
+    for (int i = 0; i < row_size; ++i) {
+      ASSERT_EQ(keys[i], original[row * row_size + idxs[i]]);
+      // Stable sort must preserve the original order of equal keys.
+      if (is_stable && i > 0 && keys[i - 1] == keys[i]) {
+        ASSERT_LT(idxs[i - 1], idxs[i]);
+      }
+    }
+  }
+}
+
+TEST_P(ParallelSortThunkTest, SortManySlices) {
+  bool is_stable = GetParam();
+
+  // Sort a lot of small rows, so that each task sorts a group of rows.
+  const int num_rows = 1000;
+  const int row_size = 128;
+  const int data_size = num_rows * row_size;
+
+  std::vector<int32_t> data(data_size);
+  std::default_random_engine gen;
+  std::uniform_int_distribution<int32_t> distribution(-100, 100);
+  for (int32_t& value : data) value = distribution(gen);
+
+  const size_t size_in_bytes = data_size * sizeof(int32_t);
+  std::vector<MaybeOwningDeviceMemory> buffers;
+  buffers.emplace_back(se::DeviceMemoryBase(data.data(), size_in_bytes));
+
+  const BufferAllocations allocations(buffers);
+  const BufferAllocation alloc(0, size_in_bytes, 0);
+  const BufferAllocation::Slice slice0(&alloc, 0, size_in_bytes);
+  const Shape data_shape = ShapeUtil::MakeShape(S32, {num_rows, row_size});
+
+  auto fake_less_than = [](const void** data) { return false; };
+
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto thunk, SortThunk::Create({"sort"}, {{slice0, data_shape}},
+                                    /*dimension=*/1, is_stable, fake_less_than,
+                                    SortThunk::SortDirection::kAscending));
+
+  Thunk::ExecuteParams params;
+  params.buffer_allocations = &allocations;
+  params.intra_op_threadpool = &device_;
+
+  auto execute_event = thunk->Execute(params);
+  tsl::BlockUntilReady(execute_event);
+  ASSERT_FALSE(execute_event.IsError());
+
+  for (int row = 0; row < num_rows; ++row) {
+    ASSERT_TRUE(std::is_sorted(data.begin() + row * row_size,
+                               data.begin() + (row + 1) * row_size));
+  }
+}
+
 void BM_DynamicSort1D(::testing::benchmark::State& state, bool is_stable) {
   const int total_num_of_slices = state.range(0);
   const int num_of_empty_slices = total_num_of_slices - 2;
@@ -491,6 +734,54 @@ void BM_SortPlainArray(::testing::benchmark::State& state, bool is_stable) {
   }
 }
 
+void BM_ParallelSortPlainArray(::testing::benchmark::State& state,
+                               bool is_stable) {
+  const int data_size = state.range(0);
+
+  std::vector<float> data(data_size);
+
+  std::default_random_engine gen;
+  std::uniform_real_distribution<float> distribution(0.0, 1000.0);
+
+  for (int i = 0; i < data_size; i++) {
+    data[i] = distribution(gen);
+  }
+
+  const size_t size_in_bytes = data_size * sizeof(float);
+  const BufferAllocation alloc(0, size_in_bytes, 0);
+  const BufferAllocation::Slice slice0(&alloc, 0, size_in_bytes);
+  const Shape data_shape = ShapeUtil::MakeShape(F32, {data_size});
+
+  tsl::thread::ThreadPool thread_pool(tsl::Env::Default(), "sort-bench", 8);
+  Eigen::ThreadPoolDevice device(thread_pool.AsEigenThreadPool(),
+                                 thread_pool.NumThreads());
+
+  auto fake_less_than = [](const void** data) { return false; };
+
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto thunk, SortThunk::Create({"sort"}, {{slice0, data_shape}},
+                                    /*dimension=*/0, is_stable, fake_less_than,
+                                    SortThunk::SortDirection::kAscending));
+
+  for (auto s : state) {
+    state.PauseTiming();
+    auto data_clone(data);
+    std::vector<MaybeOwningDeviceMemory> buffer;
+    buffer.emplace_back(se::DeviceMemoryBase(data_clone.data(), size_in_bytes));
+
+    const BufferAllocations allocations(buffer);
+
+    Thunk::ExecuteParams params;
+    params.buffer_allocations = &allocations;
+    params.intra_op_threadpool = &device;
+
+    state.ResumeTiming();
+    auto execute_event = thunk->Execute(params);
+    tsl::BlockUntilReady(execute_event);
+    ASSERT_FALSE(execute_event.IsError());
+  }
+}
+
 void BM_StableDynamicSort1D(::testing::benchmark::State& state) {
   BM_DynamicSort1D(state, /*is_stable=*/true);
 }
@@ -529,8 +820,31 @@ BENCHMARK(BM_UnstableSortPlainArray)
     ->Arg(10000)
     ->Arg(100000);
 
+void BM_StableParallelSortPlainArray(::testing::benchmark::State& state) {
+  BM_ParallelSortPlainArray(state, /*is_stable=*/true);
+}
+
+void BM_UnstableParallelSortPlainArray(::testing::benchmark::State& state) {
+  BM_ParallelSortPlainArray(state, /*is_stable=*/false);
+}
+
+BENCHMARK(BM_StableParallelSortPlainArray)
+    ->UseRealTime()
+    ->Arg(100000)
+    ->Arg(1000000)
+    ->Arg(10000000);
+
+BENCHMARK(BM_UnstableParallelSortPlainArray)
+    ->UseRealTime()
+    ->Arg(100000)
+    ->Arg(1000000)
+    ->Arg(10000000);
+
 INSTANTIATE_TEST_SUITE_P(SortThunk, SortThunkTest, testing::Bool(),
                          testing::PrintToStringParamName());
 
+INSTANTIATE_TEST_SUITE_P(ParallelSortThunk, ParallelSortThunkTest,
+                         testing::Bool(), testing::PrintToStringParamName());
+
 }  // namespace
 }  // namespace xla::cpu
@@ -95,6 +95,11 @@ class Thunk {
     std::string op_name;
     std::string module_name;
     int64_t module_id;
+
+    // Estimated thunk execution time in nanoseconds (i.e., derived from the
+    // HLO cost analysis at compile time), or zero if unknown. Thunk executor
+    // uses it to prioritize thunks on the critical path.
+    int64_t estimated_cost_ns = 0;
   };
 
   using Task = std::function<void()>;
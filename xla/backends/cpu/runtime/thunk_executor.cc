@@ -15,10 +15,13 @@ limitations under the License.
 
 #include "xla/backends/cpu/runtime/thunk_executor.h"
 
+#include <algorithm>
 #include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <limits>
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -26,6 +29,7 @@ limitations under the License.
 #include "absl/algorithm/container.h"
 #include "absl/base/attributes.h"
 #include "absl/base/optimization.h"
+#include "absl/container/inlined_vector.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_format.h"
@@ -49,6 +53,11 @@ ThunkExecutor::ThunkExecutor(ThunkSequence thunk_sequence,
       num_thunks_(thunk_sequence_.size()),
       nodes_defs_(std::move(nodes_defs)),
       is_sequential_(true) {
+  // A lookahead beyond the last thunk doesn't defer anything. Clamping it keeps
+  // `first_pending + max_lookahead` from overflowing for huge flag values.
+  options_.max_lookahead =
+      std::min(options_.max_lookahead, static_cast<size_t>(num_thunks_));
+
   for (NodeId i = 0; i < nodes_defs_.size(); ++i) {
     // Mark nodes with empty in-edges as source nodes.
     if (nodes_defs_[i].in_edges.empty()) {
@@ -64,6 +73,16 @@ ThunkExecutor::ThunkExecutor(ThunkSequence thunk_sequence,
   // Erase redundant edges between nodes.
   int64_t num_erased_edges = RunTransitiveReductionAndUpdatePriorities();
 
+  // Override priorities with the critical path estimates from thunk costs.
+  if (options_.priority_type == Options::PriorityType::kCriticalPath) {
+    std::vector<int64_t> nodes_costs(num_thunks_);
+    for (NodeId i = 0; i < num_thunks_; ++i) {
+      nodes_costs[i] = thunk_sequence_[i]->info().estimated_cost_ns;
+    }
+    absl::Status updated = UpdateCriticalPathPriorities(nodes_costs);
+    DCHECK(updated.ok()) << updated;
+  }
+
   // Check if constructed execution DAG is sequential: every node depends on the
   // completion of the previous node.
   for (NodeId i = 1; i < nodes_defs_.size() && is_sequential_; ++i) {
@@ -138,17 +157,27 @@ ThunkExecutor::ExecuteState::Node::Node(const NodeDef& node_def)
     : counter(node_def.in_edges.size()), out_edges(&node_def.out_edges) {}
 
 ThunkExecutor::ExecuteState::ExecuteState(ThunkExecutor* executor,
-                                          Thunk::TaskRunner* runner)
+                                          Thunk::TaskRunner* runner,
+                                          size_t num_work_queues)
     : executor(executor),
       runner(runner),
       nodes(executor->nodes_defs().size()),
       execute_event(tsl::MakeConstructedAsyncValueRef<ExecuteEvent>()),
+      work_queues(num_work_queues),
       pending_sink_nodes(executor->sink().size()),
-      abort(false) {
+      abort(false),
+      lookahead_end(executor->options_.max_lookahead
+                        ? static_cast<NodeId>(executor->options_.max_lookahead)
+                        : std::numeric_limits<NodeId>::max()) {
   NodeStorage* node = nodes.data();
   for (const NodeDef& node_def : executor->nodes_defs()) {
     new (node++) Node(node_def);
   }
+
+  if (executor->options_.max_lookahead) {
+    absl::MutexLock lock(&lookahead_mutex);
+    completed_nodes.resize(executor->nodes_defs().size());
+  }
 }
 
 tsl::AsyncValueRef<ThunkExecutor::ExecuteEvent> ThunkExecutor::Execute(
@@ -169,20 +198,60 @@ tsl::AsyncValueRef<ThunkExecutor::ExecuteEvent> ThunkExecutor::Execute(
     return ExecuteSequential(params);
   }
 
-  // Create async execution state on heap and kick-off execution.
-  auto state = std::make_unique<ExecuteState>(this, params.task_runner);
+  // In work stealing mode we have a work queue for every session worker and
+  // one extra queue for the caller thread.
+  bool work_stealing =
+      options_.ready_queue_type == Options::ReadyQueueType::kWorkStealing;
+  size_t num_work_queues =
+      work_stealing ? params.session.max_workers() + 1 : 0;
+
+  // Create async execution state on heap and kick-off execution. Work queues
+  // are part of the state, so work stealing workers share its ownership.
+  auto state = std::make_shared<ExecuteState>(this, params.task_runner,
+                                              num_work_queues);
+
+  // In the bounded lookahead mode we defer source nodes outside of the initial
+  // execution window. Source nodes are sorted, and the first node is always a
+  // source node inside the window, so the ready queue is never empty.
+  absl::Span<const NodeId> source = source_;
+  if (ABSL_PREDICT_FALSE(options_.max_lookahead)) {
+    auto window_end = absl::c_lower_bound(
+        source_, static_cast<NodeId>(options_.max_lookahead));
+    source = source.first(window_end - source_.begin());
+
+    absl::MutexLock lock(&state->lookahead_mutex);
+    for (auto it = window_end; it != source_.end(); ++it) {
+      state->deferred_nodes.push(*it);
+    }
+  }
 
   // When we kick-off execution we don't have to grab the session lock, as the
   // main thread is not counted towards the number of concurrent workers limit.
   // This also works for thunks with nested thunk executors (i.e., WhileThunk),
   // as launching nested thunk sequence must not reduce the available
   // concurrency for the other thunks executing in parallel.
-  if (options_.use_priority_ready_queue) {
-    Execute(state.get(), params, PriorityReadyQueue(nodes_defs_, source_),
-            /*lock=*/nullptr);
-  } else {
-    Execute(state.get(), params, FifoReadyQueue(source_),
-            /*lock=*/nullptr);
+  switch (options_.ready_queue_type) {
+    case Options::ReadyQueueType::kFifo:
+      Execute(state.get(), params, FifoReadyQueue(source),
+              /*lock=*/nullptr);
+      break;
+    case Options::ReadyQueueType::kPriority:
+      Execute(state.get(), params, PriorityReadyQueue(nodes_defs_, source),
+              /*lock=*/nullptr);
+      break;
+    case Options::ReadyQueueType::kWorkStealing: {
+      // Push source nodes in reverse order, so that the caller thread starts
+      // execution from the first source node, and other workers steal nodes
+      // from the end of the sequence.
+      size_t worker = WorkStealingWorker(params.task_runner, num_work_queues);
+      WorkStealingQueue& queue = state->work_queues[worker];
+      for (auto it = source.rbegin(); it != source.rend(); ++it) {
+        queue.Push(*it);
+      }
+      ExecuteWorkStealing(state, params, params.task_runner, worker,
+                          /*lock=*/nullptr);
+      break;
+    }
   }
 
   // If execution already completed (all kernels executed in the caller thread),
@@ -416,6 +485,125 @@ inline ABSL_ATTRIBUTE_ALWAYS_INLINE void ThunkExecutor::SplitReadyQueue(
   }
 }
 
+void ThunkExecutor::ExecuteWorkStealing(std::shared_ptr<ExecuteState> state,
+                                        const Thunk::ExecuteParams& params,
+                                        Thunk::TaskRunner* runner,
+                                        size_t worker,
+                                        Thunk::ExecuteSession::Lock lock) {
+  tsl::profiler::TraceMe trace("ThunkExecutor::ExecuteWorkStealing");
+  WorkStealingReadyQueue ready_queue(absl::MakeSpan(state->work_queues),
+                                     worker);
+
+  // We can't touch `params` and the executor until we get a ready node, as
+  // execution might be already completed by other workers.
+  for (NodeId id = ready_queue.Pop(); id != kInvalidNodeId;
+       id = ready_queue.Pop()) {
+    ExecuteState::Node& node = state->node(id);
+
+    int64_t cnt = node.counter.load(std::memory_order_acquire);
+    DCHECK_EQ(cnt, 0) << "Node counter must be 0";
+
+    // If we have more ready nodes than the split threshold, wake up one more
+    // worker to steal them. Unlike ready queue splitting we don't hand off
+    // nodes to the new worker, and if the current worker gets to them first,
+    // they will be executed in the current thread.
+    if (ABSL_PREDICT_FALSE(runner && ready_queue.Size() >
+                                         params.session.split_threshold())) {
+      WakeUpWorkStealingWorker(state, params, runner);
+    }
+
+    // Execute thunk for the given node id. If execution is aborted, we keep
+    // processing the nodes DAG without executing thunks.
+    Thunk& thunk = *state->executor->thunk_sequence_[id];
+    tsl::AsyncValueRef<ExecuteEvent> execute_event =
+        ABSL_PREDICT_FALSE(state->abort.load(std::memory_order_relaxed))
+            ? Thunk::OkExecuteEventSingleton()
+            : thunk.Execute(params);
+
+    if (ABSL_PREDICT_TRUE(execute_event.IsAvailable())) {
+      // If thunk execution is completed, push ready nodes to the worker queue
+      // and keep working on them in the current thread.
+      state->executor->ProcessOutEdges(state.get(), execute_event.AsPtr(),
+                                       node, ready_queue);
+
+    } else {
+      // If thunk execution is not completed yet, attach a continuation to the
+      // event and push ready nodes to the queue of a worker that will resume
+      // execution (the thread that marked event completed, or a task runner
+      // thread if event was completed by an external thread).
+      execute_event.AndThen([&params, &node, state, runner,
+                             execute_event = execute_event.AsPtr(),
+                             lock = params.session.Join()]() mutable {
+        FifoReadyQueue ready_nodes({});
+        state->executor->ProcessOutEdges(state.get(), execute_event, node,
+                                         ready_nodes);
+
+        // If there are no ready nodes, it might mean that we have completed an
+        // execution and `params` might be already destroyed, so we make sure
+        // we don't touch them if we don't have to.
+        if (ABSL_PREDICT_FALSE(ready_nodes.Empty())) {
+          return;
+        }
+
+        auto resume = [state = std::move(state), &params, runner,
+                       ready_nodes = std::move(ready_nodes),
+                       lock = std::move(lock)]() mutable {
+          size_t worker = WorkStealingWorker(runner, state->work_queues.size());
+          WorkStealingQueue& queue = state->work_queues[worker];
+          while (!ready_nodes.Empty()) queue.Push(ready_nodes.Pop());
+          ExecuteWorkStealing(std::move(state), params, runner, worker,
+                              std::move(lock));
+        };
+
+        if (!runner || runner->current_worker_id()) {
+          // Resume execution in the current thread if we are already running
+          // on a thread managed by the task runner.
+          resume();
+        } else {
+          // Resume execution in the task runner to avoid thread "leaks".
+          (*runner)(std::move(resume));
+        }
+      });
+    }
+  }
+}
+
+void ThunkExecutor::WakeUpWorkStealingWorker(
+    const std::shared_ptr<ExecuteState>& state,
+    const Thunk::ExecuteParams& params, Thunk::TaskRunner* runner) {
+  DCHECK(runner) << "TaskRunner must be set";
+
+  // Try to acquire a lock to launch a new worker. If we can't get a lock, it
+  // means that we have enough concurrent workers processing the same execute
+  // session, and they will steal ready nodes once they run out of work.
+  Thunk::ExecuteSession::Lock task_runner_lock = params.session.TryJoin();
+  if (!task_runner_lock) {
+    return;
+  }
+
+  (*runner)([state, &params, runner,
+             lock = std::move(task_runner_lock)]() mutable {
+    size_t worker = WorkStealingWorker(runner, state->work_queues.size());
+    ExecuteWorkStealing(state, params, runner, worker, std::move(lock));
+  });
+}
+
+size_t ThunkExecutor::WorkStealingWorker(Thunk::TaskRunner* runner,
+                                         size_t num_work_queues) {
+  DCHECK_GT(num_work_queues, 0) << "Work queues must not be empty";
+
+  // Threads not managed by the task runner (i.e., the caller thread) share the
+  // first work queue, and task runner threads are mapped to the rest of the
+  // queues. If multiple threads share the same queue it's still correct, as
+  // all queue operations are thread safe, we only lose some cache locality.
+  std::optional<int64_t> worker_id =
+      runner ? runner->current_worker_id() : std::nullopt;
+  if (!worker_id.has_value() || num_work_queues == 1) {
+    return 0;
+  }
+  return 1 + *worker_id % (num_work_queues - 1);
+}
+
 template <typename ReadyQueue>
 void ThunkExecutor::ProcessOutEdges(
     ExecuteState* state, tsl::AsyncValuePtr<Thunk::ExecuteEvent> node_event,
@@ -433,13 +621,28 @@ void ThunkExecutor::ProcessOutEdges(
   // race with NodeDef destructor.
   bool is_sink = node.out_edges->empty();
 
+  bool has_lookahead = options_.max_lookahead;
+
   // Append ready nodes to the back of the ready queue.
   for (NodeId out_edge : *node.out_edges) {
     ExecuteState::Node& out_node = state->node(out_edge);
 
     int64_t cnt = out_node.counter.fetch_sub(1, std::memory_order_release);
     DCHECK_GE(cnt, 1) << "Node counter can't drop below 0";
-    if (cnt == 1) ready_queue.Push(out_edge);
+    if (cnt == 1) {
+      if (ABSL_PREDICT_FALSE(has_lookahead)) {
+        PushReadyNode(state, out_edge, ready_queue);
+      } else {
+        ready_queue.Push(out_edge);
+      }
+    }
+  }
+
+  // Move the execution window forward in the bounded lookahead mode. We must
+  // do it before dropping the pending sink nodes counter, as after that the
+  // `state` might be destroyed.
+  if (ABSL_PREDICT_FALSE(has_lookahead)) {
+    CompleteNodeInWindow(state, state->node_id(node), ready_queue);
   }
 
   // Drop the pending sink nodes counter if the node is a sink.
@@ -467,6 +670,57 @@ void ThunkExecutor::ProcessOutEdges(
   }
 }
 
+template <typename ReadyQueue>
+void ThunkExecutor::PushReadyNode(ExecuteState* state, NodeId id,
+                                  ReadyQueue& ready_queue) {
+  if (ABSL_PREDICT_TRUE(
+          id < state->lookahead_end.load(std::memory_order_acquire))) {
+    ready_queue.Push(id);
+    return;
+  }
+
+  // Check the window again under the lock, as it might have moved forward
+  // concurrently, and we must not defer a node after the window passed it.
+  {
+    absl::MutexLock lock(&state->lookahead_mutex);
+    if (id >= state->lookahead_end.load(std::memory_order_relaxed)) {
+      state->deferred_nodes.push(id);
+      return;
+    }
+  }
+  ready_queue.Push(id);
+}
+
+template <typename ReadyQueue>
+void ThunkExecutor::CompleteNodeInWindow(ExecuteState* state, NodeId id,
+                                         ReadyQueue& ready_queue) {
+  absl::InlinedVector<NodeId, 8> ready_nodes;
+  {
+    absl::MutexLock lock(&state->lookahead_mutex);
+    state->completed_nodes[id] = true;
+
+    NodeId& first_pending = state->first_pending_node;
+    if (id != first_pending) return;
+
+    while (first_pending < num_thunks_ &&
+           state->completed_nodes[first_pending]) {
+      ++first_pending;
+    }
+
+    NodeId lookahead_end =
+        first_pending + static_cast<NodeId>(options_.max_lookahead);
+    state->lookahead_end.store(lookahead_end, std::memory_order_release);
+
+    auto& deferred_nodes = state->deferred_nodes;
+    while (!deferred_nodes.empty() && deferred_nodes.top() < lookahead_end) {
+      ready_nodes.push_back(deferred_nodes.top());
+      deferred_nodes.pop();
+    }
+  }
+
+  for (NodeId ready_node : ready_nodes) ready_queue.Push(ready_node);
+}
+
 // Erases edge from `from` node to `to` node if it exists. We rely on the fact
 // that out and in-edges are sorted and use binary search on a critical path.
 static int64_t EraseEdge(ThunkExecutor::NodeDef& from,
@@ -564,6 +818,35 @@ int64_t ThunkExecutor::RunTransitiveReductionAndUpdatePriorities() {
   return num_erased_edges;
 }
 
+absl::Status ThunkExecutor::UpdateCriticalPathPriorities(
+    absl::Span<const int64_t> nodes_costs) {
+  if (nodes_costs.size() != nodes_defs_.size()) {
+    return absl::InvalidArgumentError(absl::StrFormat(
+        "Number of nodes costs %d does not match the number of nodes %d",
+        nodes_costs.size(), nodes_defs_.size()));
+  }
+
+  // Nodes are topologically sorted (all edges point from smaller to larger
+  // node ids), so we compute critical paths in reverse order, when critical
+  // paths of all out nodes are already known. Transitive reduction does not
+  // change the critical path, as a removed edge always has a longer path
+  // going through the remaining edges.
+  for (int64_t i = nodes_defs_.size() - 1; i >= 0; --i) {
+    NodeDef& node = nodes_defs_[i];
+
+    int64_t out_critical_path = 0;
+    for (NodeId out_id : node.out_edges) {
+      DCHECK_GT(out_id, i) << "Out edges must point to larger node ids";
+      out_critical_path =
+          std::max(out_critical_path, nodes_defs_[out_id].priority);
+    }
+
+    node.priority = std::max<int64_t>(nodes_costs[i], 1) + out_critical_path;
+  }
+
+  return absl::OkStatus();
+}
+
 std::string ThunkExecutor::ToString() const {
   std::string str = absl::StrFormat(
       "ThunkExecutor: #thunks=%d #source_nodes=%d #sink_nodes=%d", num_thunks_,
@@ -666,4 +949,70 @@ ThunkExecutor::PriorityReadyQueue::CreateEmptyReadyQueue() const {
   return PriorityReadyQueue(nodes_defs_, {});
 }
 
+void ThunkExecutor::WorkStealingQueue::Push(NodeId id) {
+  absl::MutexLock lock(&mu_);
+  queue_.push_back(id);
+  size_.store(queue_.size(), std::memory_order_relaxed);
+}
+
+ThunkExecutor::NodeId ThunkExecutor::WorkStealingQueue::Pop() {
+  if (Empty()) return kInvalidNodeId;
+
+  absl::MutexLock lock(&mu_);
+  if (queue_.empty()) return kInvalidNodeId;
+
+  NodeId id = queue_.back();
+  queue_.pop_back();
+  size_.store(queue_.size(), std::memory_order_relaxed);
+  return id;
+}
+
+ThunkExecutor::NodeId ThunkExecutor::WorkStealingQueue::Steal() {
+  if (Empty()) return kInvalidNodeId;
+
+  absl::MutexLock lock(&mu_);
+  if (queue_.empty()) return kInvalidNodeId;
+
+  NodeId id = queue_.front();
+  queue_.pop_front();
+  size_.store(queue_.size(), std::memory_order_relaxed);
+  return id;
+}
+
+size_t ThunkExecutor::WorkStealingQueue::Size() const {
+  return size_.load(std::memory_order_relaxed);
+}
+
+bool ThunkExecutor::WorkStealingQueue::Empty() const { return Size() == 0; }
+
+ThunkExecutor::WorkStealingReadyQueue::WorkStealingReadyQueue(
+    absl::Span<WorkStealingQueue> queues, size_t worker)
+    : queues_(queues), worker_(worker) {
+  DCHECK_LT(worker_, queues_.size()) << "Worker index out of bounds";
+}
+
+void ThunkExecutor::WorkStealingReadyQueue::Push(NodeId id) {
+  queues_[worker_].Push(id);
+}
+
+ThunkExecutor::NodeId ThunkExecutor::WorkStealingReadyQueue::Pop() {
+  NodeId id = queues_[worker_].Pop();
+  if (ABSL_PREDICT_TRUE(id != kInvalidNodeId)) return id;
+
+  // Worker queue is empty, try to steal a node from other workers. We start
+  // from the next worker to spread thieves across different victims.
+  for (size_t i = 1; i < queues_.size(); ++i) {
+    WorkStealingQueue& victim = queues_[(worker_ + i) % queues_.size()];
+    if (NodeId stolen = victim.Steal(); stolen != kInvalidNodeId) {
+      return stolen;
+    }
+  }
+
+  return kInvalidNodeId;
+}
+
+size_t ThunkExecutor::WorkStealingReadyQueue::Size() const {
+  return queues_[worker_].Size();
+}
+
 }  // namespace xla::cpu
@@ -19,7 +19,10 @@ limitations under the License.
 #include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <deque>
+#include <functional>
 #include <limits>
+#include <memory>
 #include <new>
 #include <queue>
 #include <string>
@@ -52,9 +55,47 @@ struct ThunkExecutorOptions {
   // the overall execution time.
   size_t execute_sequential_num_thunks_threshold = 8;
 
-  // Use priority ready queue to execute nodes according to their priority. By
-  // default we use FIFO ready queue.
-  bool use_priority_ready_queue = false;
+  // Ready queue type that defines the order of executing ready nodes and the
+  // way ready nodes are distributed between task runner workers.
+  enum class ReadyQueueType {
+    // Execute ready nodes in FIFO order and offload half of the ready queue to
+    // the task runner when it grows above the split threshold.
+    kFifo,
+    // Execute ready nodes according to their priority and offload nodes with
+    // lower priorities to the task runner.
+    kPriority,
+    // Every worker owns a ready queue and executes nodes that became ready
+    // after completing its own thunks, idle workers steal ready nodes from
+    // other workers (see `WorkStealingQueue` for details).
+    kWorkStealing,
+  };
+
+  ReadyQueueType ready_queue_type = ReadyQueueType::kFifo;
+
+  // Defines how node priorities are computed for the priority ready queue.
+  enum class PriorityType {
+    // Node priority is the number of nodes reachable from it.
+    kReachableNodes,
+    // Node priority is the estimated execution time of the longest (critical)
+    // path from the node to a sink node, computed from thunk cost estimates
+    // (see `Thunk::Info::estimated_cost_ns`). Starting long chains of
+    // expensive thunks earlier shortens the overall execution time.
+    kCriticalPath,
+  };
+
+  PriorityType priority_type = PriorityType::kReachableNodes;
+
+  // If positive, bounds how far concurrent execution can run ahead of the
+  // thunk sequence order, which is the sequential HLO schedule that buffer
+  // assignment was computed for: a thunk with index `i` starts only if
+  // `i < first_pending + max_lookahead`, where `first_pending` is the index of
+  // the first thunk that has not completed yet. Buffer uses already prevent
+  // thunks from racing on reused buffers, but without a bound the executor
+  // can run far ahead of the schedule, and keep many more thunks (and the
+  // memory they allocate at run time) in flight than the sequential plan.
+  // A value of one gives sequential execution, zero means unbounded. Values
+  // larger than the number of thunks are clamped to it.
+  size_t max_lookahead = 0;
 };
 }  // namespace internal
 
@@ -62,6 +103,15 @@ struct ThunkExecutorOptions {
 // on buffer uses to build a DAG defining execution order. At run time executes
 // thunks concurrently in a given thread pool.
 class ThunkExecutor {
+  // Align all atomic counters to a cache line boundary to avoid false
+  // sharing between multiple worker threads.
+  static constexpr size_t kAtomicAlignment =
+#if defined(__cpp_lib_hardware_interference_size)
+      std::hardware_destructive_interference_size;
+#else
+      64;
+#endif
+
  public:
   using BufferUses = Thunk::BufferUses;
   using ResourceUses = Thunk::ResourceUses;
@@ -108,6 +158,14 @@ class ThunkExecutor {
 
   bool is_sequential() const { return is_sequential_; }
 
+  // Updates node priorities to the estimated execution time of the critical
+  // path from the node to a sink node, using given node costs (i.e., thunk
+  // execution times measured in a profiling run). Nodes with zero cost are
+  // assumed to have a unit cost. Must not be called concurrently with
+  // `Execute`.
+  absl::Status UpdateCriticalPathPriorities(
+      absl::Span<const int64_t> nodes_costs);
+
   // A ready queue that executes nodes in FIFO order.
   class FifoReadyQueue {
    public:
@@ -159,16 +217,63 @@ class ThunkExecutor {
     InlinedPriorityQueue queue_;
   };
 
- private:
-  // Align all atomic counters to a cache line boundary to avoid false
-  // sharing between multiple worker threads.
-  static constexpr size_t kAtomicAlignment =
-#if defined(__cpp_lib_hardware_interference_size)
-      std::hardware_destructive_interference_size;
-#else
-      64;
-#endif
+  // A ready queue owned by one of the workers in the work stealing mode. Owner
+  // pushes and pops nodes at the back of the queue (LIFO order), so that nodes
+  // that became ready after completing a thunk are executed by the same thread
+  // while their inputs are still hot in cache. Idle workers steal nodes from
+  // the front of the queue, as those are the oldest ready nodes that most
+  // likely lost their cache locality anyway.
+  //
+  // All operations are thread safe, as the owner and thieves can access the
+  // queue concurrently.
+  class alignas(kAtomicAlignment) WorkStealingQueue {
+   public:
+    void Push(NodeId id);
+
+    // Pops a node from the back of the queue. Returns `kInvalidNodeId` if
+    // the queue is empty.
+    NodeId Pop();
+
+    // Steals a node from the front of the queue. Returns `kInvalidNodeId` if
+    // the queue is empty.
+    NodeId Steal();
 
+    // Returns the number of nodes in the queue. The result is a snapshot that
+    // might be outdated when the caller gets it.
+    size_t Size() const;
+    bool Empty() const;
+
+   private:
+    absl::Mutex mu_;
+    std::deque<NodeId> queue_ ABSL_GUARDED_BY(mu_);
+    std::atomic<size_t> size_{0};
+  };
+
+  using WorkStealingQueues = absl::FixedArray<WorkStealingQueue>;
+
+  // A ready queue adaptor for the worker executing nodes in the work stealing
+  // mode: pushes ready nodes to the worker's own queue, and pops nodes from the
+  // worker's own queue, or steals from other workers when it is empty.
+  class WorkStealingReadyQueue {
+   public:
+    WorkStealingReadyQueue(absl::Span<WorkStealingQueue> queues,
+                           size_t worker);
+
+    void Push(NodeId id);
+
+    // Pops a node from the worker queue or steals from other workers. Returns
+    // `kInvalidNodeId` if all queues are empty.
+    NodeId Pop();
+
+    // Returns the number of nodes in the worker queue.
+    size_t Size() const;
+
+   private:
+    absl::Span<WorkStealingQueue> queues_;
+    size_t worker_;
+  };
+
+ private:
   // A struct to keep the state of a running ThunkExecutor.
   struct ExecuteState {
     // At run time NodeDef instantiated as a Node with an atomic counter that
@@ -187,16 +292,27 @@ class ThunkExecutor {
     // memory and do not pay the cost of default initializing all nodes.
     using NodeStorage = std::aligned_storage_t<sizeof(Node), alignof(Node)>;
 
-    ExecuteState(ThunkExecutor* executor, Thunk::TaskRunner* runner);
+    ExecuteState(ThunkExecutor* executor, Thunk::TaskRunner* runner,
+                 size_t num_work_queues);
 
     Node& node(NodeId id) { return *reinterpret_cast<Node*>(&nodes[id]); }
 
+    NodeId node_id(const Node& node) const {
+      return reinterpret_cast<const NodeStorage*>(&node) - nodes.data();
+    }
+
     ThunkExecutor* executor;
     Thunk::TaskRunner* runner;
 
     absl::FixedArray<NodeStorage> nodes;
     tsl::AsyncValueRef<ExecuteEvent> execute_event;
 
+    // Per-worker ready queues for the work stealing execution mode (empty for
+    // all other modes). Idle workers look for ready nodes concurrently with
+    // the thread that completes the last sink node, so in this mode workers
+    // share the ownership of the execute state to keep the queues alive.
+    WorkStealingQueues work_queues;
+
     // Once the number of pending sink nodes drops to zero, the execution is
     // completed and we set `execute_event` as concrete or error.
     alignas(kAtomicAlignment) std::atomic<int64_t> pending_sink_nodes;
@@ -206,6 +322,17 @@ class ThunkExecutor {
     alignas(kAtomicAlignment) std::atomic<bool> abort;
     absl::Mutex abort_mutex;
     absl::Status abort_status ABSL_GUARDED_BY(abort_mutex);
+
+    // Nodes with ids at or above `lookahead_end` are outside of the execution
+    // window in the bounded lookahead mode, and we defer them until the window
+    // moves forward. In the unbounded mode `lookahead_end` is the max node id.
+    // We update `lookahead_end` only when holding `lookahead_mutex`.
+    alignas(kAtomicAlignment) std::atomic<NodeId> lookahead_end;
+    absl::Mutex lookahead_mutex;
+    NodeId first_pending_node ABSL_GUARDED_BY(lookahead_mutex) = 0;
+    std::vector<bool> completed_nodes ABSL_GUARDED_BY(lookahead_mutex);
+    std::priority_queue<NodeId, std::vector<NodeId>, std::greater<NodeId>>
+        deferred_nodes ABSL_GUARDED_BY(lookahead_mutex);
   };
 
   ThunkExecutor(ThunkSequence thunk_sequence, std::vector<NodeDef> nodes_defs,
@@ -232,6 +359,28 @@ class ThunkExecutor {
   void SplitReadyQueue(ExecuteState* state, const Thunk::ExecuteParams& params,
                        ReadyQueue& ready_queue, int64_t split_threshold);
 
+  // Executes ready nodes from the `worker` queue, and steals ready nodes from
+  // other workers when it is empty. Returns when all work queues are empty.
+  //
+  // Work stealing workers can be launched after the execution is completed,
+  // and they must not touch `params` or the executor until they get a ready
+  // node, because of that these functions are static and keep `state` alive
+  // with a shared pointer.
+  static void ExecuteWorkStealing(std::shared_ptr<ExecuteState> state,
+                                  const Thunk::ExecuteParams& params,
+                                  Thunk::TaskRunner* runner, size_t worker,
+                                  Thunk::ExecuteSession::Lock lock);
+
+  // Launches a work stealing worker in the task runner if the execute session
+  // has capacity for one more worker.
+  static void WakeUpWorkStealingWorker(
+      const std::shared_ptr<ExecuteState>& state,
+      const Thunk::ExecuteParams& params, Thunk::TaskRunner* runner);
+
+  // Returns the index of the work queue owned by the current thread.
+  static size_t WorkStealingWorker(Thunk::TaskRunner* runner,
+                                   size_t num_work_queues);
+
   // Processes out edges of a completed `node` and updates `ready_queue` with
   // nodes that are ready to execute. If `node_event` is in error state, aborts
   // the execution and records the error status to forward it to the caller.
@@ -240,8 +389,21 @@ class ThunkExecutor {
                        tsl::AsyncValuePtr<Thunk::ExecuteEvent> node_event,
                        ExecuteState::Node& node, ReadyQueue& ready_queue);
 
+  // Pushes a ready node to the ready queue, or defers it if it is outside of
+  // the execution window in the bounded lookahead mode.
+  template <typename ReadyQueue>
+  void PushReadyNode(ExecuteState* state, NodeId id, ReadyQueue& ready_queue);
+
+  // Marks the node completed in the bounded lookahead mode. If it was the first
+  // pending node, moves the execution window forward and pushes deferred nodes
+  // that got into the window to the ready queue.
+  template <typename ReadyQueue>
+  void CompleteNodeInWindow(ExecuteState* state, NodeId id,
+                            ReadyQueue& ready_queue);
+
   // Runs a transitive reduction on the NodeDef graph to remove redundant edges,
-  // and updates nodes priorities. Returns the number of removed edges.
+  // and updates nodes priorities to the number of reachable nodes. Returns the
+  // number of removed edges.
   //
   // See: https://en.wikipedia.org/wiki/Transitive_reduction
   int64_t RunTransitiveReductionAndUpdatePriorities();
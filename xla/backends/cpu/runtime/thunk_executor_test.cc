@@ -20,6 +20,7 @@ limitations under the License.
 #include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <limits>
 #include <memory>
 #include <optional>
 #include <random>
@@ -29,8 +30,10 @@ limitations under the License.
 #include <vector>
 
 #include "absl/algorithm/container.h"
+#include "absl/base/thread_annotations.h"
 #include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/types/span.h"
 #include "xla/backends/cpu/runtime/buffer_allocations.h"
 #include "xla/backends/cpu/runtime/resource_use.h"
@@ -41,6 +44,7 @@ limitations under the License.
 #include "xla/service/maybe_owning_device_memory.h"
 #include "xla/stream_executor/device_memory.h"
 #include "xla/tsl/concurrency/async_value_ref.h"
+#include "xla/tsl/lib/core/status_test_util.h"
 #include "tsl/platform/env.h"
 #include "tsl/platform/errors.h"
 #include "tsl/platform/logging.h"
@@ -105,6 +109,41 @@ std::vector<MaybeOwningDeviceMemory> AsDeviceMemory(
   return buffers;
 }
 
+// Tracks thunks of a sequence that are in flight, to check how far ahead of
+// the sequence order the executor runs. Thunks report completion right before
+// they return their execute event, so the first pending thunk seen here is
+// never behind the one seen by the executor.
+class InFlightThunks {
+ public:
+  explicit InFlightThunks(size_t num_thunks) : completed_(num_thunks) {}
+
+  void Start(size_t index) {
+    absl::MutexLock lock(&mu_);
+    max_spread_ = std::max(max_spread_, index - first_pending_);
+  }
+
+  void Complete(size_t index) {
+    absl::MutexLock lock(&mu_);
+    completed_[index] = true;
+    while (first_pending_ < completed_.size() && completed_[first_pending_]) {
+      ++first_pending_;
+    }
+  }
+
+  // Returns the largest distance between a starting thunk and the first thunk
+  // that has not completed yet.
+  size_t max_spread() {
+    absl::MutexLock lock(&mu_);
+    return max_spread_;
+  }
+
+ private:
+  absl::Mutex mu_;
+  std::vector<bool> completed_ ABSL_GUARDED_BY(mu_);
+  size_t first_pending_ ABSL_GUARDED_BY(mu_) = 0;
+  size_t max_spread_ ABSL_GUARDED_BY(mu_) = 0;
+};
+
 // A test-only thunk for verifying thunk executor implementation:
 //
 //   dst += src (for all srcs and dsts slices)
@@ -117,13 +156,14 @@ class AddI32Thunk final : public Thunk {
   AddI32Thunk(std::string name, std::vector<BufferAllocation::Slice> srcs,
               std::vector<BufferAllocation::Slice> dsts,
               std::vector<std::string>* trace, bool use_shared_resource,
-              bool inject_error);
+              bool inject_error, InFlightThunks* in_flight, size_t index);
 
   static std::unique_ptr<Thunk> Create(
       std::string name, std::vector<BufferAllocation::Slice> srcs,
       std::vector<BufferAllocation::Slice> dsts,
       std::vector<std::string>* trace = nullptr,
-      bool use_shared_resource = false, bool inject_error = false);
+      bool use_shared_resource = false, bool inject_error = false,
+      InFlightThunks* in_flight = nullptr, size_t index = 0);
 
   // Executes `dst += src` for a single src/dst pair.
   static absl::Status Execute(const BufferAllocations* allocations,
@@ -141,28 +181,34 @@ class AddI32Thunk final : public Thunk {
   std::vector<std::string>* trace_;
   bool use_shared_resource_;
   bool inject_error_;
+  InFlightThunks* in_flight_;
+  size_t index_;
 };
 
 std::unique_ptr<Thunk> AddI32Thunk::Create(
     std::string name, std::vector<BufferAllocation::Slice> srcs,
     std::vector<BufferAllocation::Slice> dsts, std::vector<std::string>* trace,
-    bool use_shared_resource, bool inject_error) {
-  return std::make_unique<AddI32Thunk>(std::move(name), std::move(srcs),
-                                       std::move(dsts), trace,
-                                       use_shared_resource, inject_error);
+    bool use_shared_resource, bool inject_error, InFlightThunks* in_flight,
+    size_t index) {
+  return std::make_unique<AddI32Thunk>(
+      std::move(name), std::move(srcs), std::move(dsts), trace,
+      use_shared_resource, inject_error, in_flight, index);
 }
 
 AddI32Thunk::AddI32Thunk(std::string name,
                          std::vector<BufferAllocation::Slice> srcs,
                          std::vector<BufferAllocation::Slice> dsts,
                          std::vector<std::string>* trace,
-                         bool use_shared_resource, bool inject_error)
+                         bool use_shared_resource, bool inject_error,
+                         InFlightThunks* in_flight, size_t index)
     : Thunk(Kind::kKernel, Info{name}),
       srcs_(std::move(srcs)),
       dsts_(std::move(dsts)),
       trace_(trace),
       use_shared_resource_(use_shared_resource),
-      inject_error_(inject_error) {}
+      inject_error_(inject_error),
+      in_flight_(in_flight),
+      index_(index) {}
 
 absl::Status AddI32Thunk::Execute(const BufferAllocations* allocations,
                                   BufferAllocation::Slice src_slice,
@@ -188,6 +234,7 @@ absl::Status AddI32Thunk::Execute(const BufferAllocations* allocations,
 tsl::AsyncValueRef<Thunk::ExecuteEvent> AddI32Thunk::Execute(
     const ExecuteParams& params) {
   if (trace_) trace_->push_back(info().op_name);
+  if (in_flight_) in_flight_->Start(index_);
 
   auto execute = [&]() -> absl::Status {
     CHECK_EQ(srcs_.size(), dsts_.size());
@@ -210,6 +257,7 @@ tsl::AsyncValueRef<Thunk::ExecuteEvent> AddI32Thunk::Execute(
         event.SetError(absl::InternalError("Injected error"));
       } else {
         CHECK_OK(execute());
+        if (in_flight_) in_flight_->Complete(index_);
         event.SetStateConcrete();
       }
     });
@@ -225,6 +273,7 @@ tsl::AsyncValueRef<Thunk::ExecuteEvent> AddI32Thunk::Execute(
   }
 
   TF_RETURN_IF_ERROR(execute());
+  if (in_flight_) in_flight_->Complete(index_);
   return Thunk::OkExecuteEvent();
 }
 
@@ -306,6 +355,40 @@ TEST(ThunkExecutorTest, FifoReadyQueueTest) {
   EXPECT_EQ(half2.Pop(), 5);
 }
 
+TEST(ThunkExecutorTest, WorkStealingQueueTest) {
+  ThunkExecutor::WorkStealingQueues queues(2);
+  ThunkExecutor::WorkStealingReadyQueue queue0(absl::MakeSpan(queues), 0);
+  ThunkExecutor::WorkStealingReadyQueue queue1(absl::MakeSpan(queues), 1);
+
+  // Check basic queue properties.
+  EXPECT_EQ(queue0.Size(), 0);
+  EXPECT_EQ(queue0.Pop(), ThunkExecutor::kInvalidNodeId);
+
+  queue0.Push(1);
+  queue0.Push(2);
+  queue0.Push(3);
+
+  EXPECT_EQ(queue0.Size(), 3);
+  EXPECT_EQ(queue1.Size(), 0);
+
+  // Owner pops nodes in LIFO order.
+  EXPECT_EQ(queue0.Pop(), 3);
+
+  // Thief steals nodes from the front of the owner queue.
+  EXPECT_EQ(queue1.Pop(), 1);
+  EXPECT_EQ(queue0.Size(), 1);
+
+  // Nodes pushed by the thief go to its own queue.
+  queue1.Push(4);
+  EXPECT_EQ(queue1.Size(), 1);
+
+  EXPECT_EQ(queue0.Pop(), 2);
+  EXPECT_EQ(queue0.Pop(), 4);
+
+  EXPECT_EQ(queue0.Pop(), ThunkExecutor::kInvalidNodeId);
+  EXPECT_EQ(queue1.Pop(), ThunkExecutor::kInvalidNodeId);
+}
+
 TEST(ThunkExecutorTest, PriorityReadyQueueTest) {
   std::vector<ThunkExecutor::NodeDef> nodes_defs(16);
   for (size_t i = 0; i < nodes_defs.size(); ++i) {
@@ -391,6 +474,38 @@ TEST(ThunkExecutorTest, DependencyOrdering) {
   EXPECT_EQ(executor.node_def(2).priority, 0);
 }
 
+TEST(ThunkExecutorTest, CriticalPathPriorities) {
+  BufferAllocation alloc(/*index=*/0, /*size=*/80, /*color=*/0);
+
+  BufferAllocation::Slice slice0(&alloc, /*offset=*/0, /*size=*/40);
+  BufferAllocation::Slice slice1(&alloc, /*offset=*/40, /*size=*/40);
+  BufferAllocation::Slice slice2(&alloc, /*offset=*/20, /*size=*/40);
+
+  ThunkSequence sequence;
+  sequence.push_back(AddI32Thunk::Create("a", {slice0}, {slice0}));
+  sequence.push_back(AddI32Thunk::Create("b", {slice1}, {slice1}));
+  sequence.push_back(AddI32Thunk::Create("c", {slice2}, {slice2}));
+
+  ThunkExecutor::Options options = OptionsForTest();
+  options.priority_type = ThunkExecutor::Options::PriorityType::kCriticalPath;
+
+  TF_ASSERT_OK_AND_ASSIGN(ThunkExecutor executor,
+                          ThunkExecutor::Create(std::move(sequence), options));
+
+  // Thunks do not have cost estimates and all nodes have a unit cost.
+  EXPECT_EQ(executor.node_def(0).priority, 2);
+  EXPECT_EQ(executor.node_def(1).priority, 2);
+  EXPECT_EQ(executor.node_def(2).priority, 1);
+
+  // Update priorities with measured costs: `b` is on the critical path.
+  TF_ASSERT_OK(executor.UpdateCriticalPathPriorities({10, 100, 5}));
+  EXPECT_EQ(executor.node_def(0).priority, 15);
+  EXPECT_EQ(executor.node_def(1).priority, 105);
+  EXPECT_EQ(executor.node_def(2).priority, 5);
+
+  EXPECT_FALSE(executor.UpdateCriticalPathPriorities({1, 2}).ok());
+}
+
 TEST(ThunkExecutorTest, SequentialOrdering) {
   BufferAllocation alloc(/*index=*/0, /*size=*/80, /*color=*/0);
   BufferAllocation::Slice slice(&alloc, /*offset=*/0, /*size=*/40);
@@ -512,6 +627,60 @@ TEST(ThunkExecutorTest, Execute) {
                                 2, 2, 2, 2, 2));               // slice1
 }
 
+TEST(ThunkExecutorTest, ExecuteWithBoundedLookahead) {
+  BufferAllocation alloc(/*index=*/0, /*size=*/80, /*color=*/0);
+
+  BufferAllocation::Slice slice0(&alloc, /*offset=*/0, /*size=*/20);
+  BufferAllocation::Slice slice1(&alloc, /*offset=*/20, /*size=*/20);
+  BufferAllocation::Slice slice2(&alloc, /*offset=*/40, /*size=*/20);
+  BufferAllocation::Slice slice3(&alloc, /*offset=*/60, /*size=*/20);
+
+  std::vector<std::string> trace;
+
+  // All thunks are independent and can run in any order.
+  ThunkSequence sequence;
+  sequence.push_back(AddI32Thunk::Create("a", {slice0}, {slice0}, &trace));
+  sequence.push_back(AddI32Thunk::Create("b", {slice1}, {slice1}, &trace));
+  sequence.push_back(AddI32Thunk::Create("c", {slice2}, {slice2}, &trace));
+  sequence.push_back(AddI32Thunk::Create("d", {slice3}, {slice3}, &trace));
+
+  ThunkExecutor::Options options = OptionsForTest();
+  options.max_lookahead = 1;
+
+  TF_ASSERT_OK_AND_ASSIGN(ThunkExecutor executor,
+                          ThunkExecutor::Create(std::move(sequence), options));
+  EXPECT_FALSE(executor.is_sequential());
+
+  std::vector<int32_t> data(20, 1);  // shared src and dst allocation
+
+  auto buffers = AsDeviceMemory<int32_t>({&data});
+  BufferAllocations allocations(buffers);
+
+  auto task_runner = MakeTaskRunnerFrom(
+      [&](Thunk::Task task) {
+        trace.push_back("<TaskRunner>");
+        task();
+      },
+      // Always return current worker id as 0.
+      [] { return 0; });
+
+  Thunk::ExecuteParams params = {nullptr, &allocations};
+  params.task_runner = &task_runner;
+  params.session =
+      Thunk::ExecuteSession(/*max_workers=*/8, /*split_threshold=*/0);
+
+  auto execute_event = executor.Execute(params);
+
+  tsl::BlockUntilReady(execute_event);
+  ASSERT_TRUE(execute_event.IsConcrete());
+
+  // With a single thunk lookahead thunks run in the sequence order, and the
+  // ready queue never grows large enough to be offloaded to the task runner.
+  EXPECT_THAT(trace, ElementsAre("a", "b", "c", "d"));
+  EXPECT_THAT(data, ElementsAre(2, 2, 2, 2, 2, 2, 2, 2, 2, 2,  //
+                                2, 2, 2, 2, 2, 2, 2, 2, 2, 2));
+}
+
 //===----------------------------------------------------------------------===//
 // ThunkExecutor resource isolation testing
 //===----------------------------------------------------------------------===//
@@ -626,8 +795,8 @@ struct GeneratedThunkSequence {
 
 static absl::StatusOr<std::unique_ptr<GeneratedThunkSequence>>
 GenerateThunkSequence(size_t num_elements, size_t num_thunks,
-                      SharedResourceUse shared_resource_use,
-                      bool inject_errors) {
+                      SharedResourceUse shared_resource_use, bool inject_errors,
+                      InFlightThunks* in_flight = nullptr) {
   auto g = std::make_unique<GeneratedThunkSequence>(GeneratedThunkSequence{
       BufferAllocation(/*index=*/0, num_elements * sizeof(int32_t), 0),
       BufferAllocation(/*index=*/1, num_elements * sizeof(int32_t), 0),
@@ -679,7 +848,7 @@ GenerateThunkSequence(size_t num_elements, size_t num_thunks,
     bool inject_error = inject_errors && inject_error_dist(engine) == 0;
     g->sequence.push_back(AddI32Thunk::Create(absl::StrCat(i), {src}, {dst},
                                               /*trace=*/nullptr, use_resource,
-                                              inject_error));
+                                              inject_error, in_flight, i));
   }
 
   return g;
@@ -689,11 +858,12 @@ GenerateThunkSequence(size_t num_elements, size_t num_thunks,
 // and optionally uses a thread pool to execute thunk executor tasks.
 class ThunkExecutorStressTest
     : public testing::TestWithParam<
-          std::tuple<int32_t, bool, bool, SharedResourceUse, bool, bool>> {
+          std::tuple<int32_t, bool, bool, SharedResourceUse, bool,
+                     ThunkExecutor::Options::ReadyQueueType>> {
  public:
   void SetUp() override {
     auto& [num_thunks, use_task_runner, use_device, shared_resource_use,
-           inject_errors, use_priority_ready_queue] = GetParam();
+           inject_errors, ready_queue_type] = GetParam();
 
     use_task_runner_ = use_task_runner;
     use_device_ = use_device;
@@ -731,7 +901,7 @@ class ThunkExecutorStressTest
 
 TEST_P(ThunkExecutorStressTest, Execute) {
   auto [num_thunks, use_task_runner, use_device, shared_resource_use,
-        inject_errors, use_priority_ready_queue] = GetParam();
+        inject_errors, ready_queue_type] = GetParam();
 
   TF_ASSERT_OK_AND_ASSIGN(
       std::unique_ptr<GeneratedThunkSequence> g,
@@ -740,7 +910,8 @@ TEST_P(ThunkExecutorStressTest, Execute) {
 
   ThunkExecutor::Options executor_options = {
       /*execute_sequential_buffer_threshold=*/0,
-      /*use_priority_ready_queue=*/use_priority_ready_queue,
+      /*execute_sequential_num_thunks_threshold=*/0,
+      /*ready_queue_type=*/ready_queue_type,
   };
 
   TF_ASSERT_OK_AND_ASSIGN(
@@ -776,7 +947,58 @@ INSTANTIATE_TEST_SUITE_P(
                                      SharedResourceUse::kAll,
                                      SharedResourceUse::kRandom),
                      /*inject_errors=*/testing::Bool(),
-                     /*use_priority_ready_queue=*/testing::Bool()));
+                     /*ready_queue_type=*/
+                     testing::Values(
+                         ThunkExecutor::Options::ReadyQueueType::kFifo,
+                         ThunkExecutor::Options::ReadyQueueType::kPriority,
+                         ThunkExecutor::Options::ReadyQueueType::
+                             kWorkStealing)));
+
+TEST(ThunkExecutorTest, ExecuteWithBoundedLookaheadConcurrently) {
+  tsl::thread::ThreadPool thread_pool(tsl::Env::Default(), "thunk-executor", 8);
+  ThreadPoolTaskRunner task_runner(thread_pool.AsEigenThreadPool());
+
+  for (auto ready_queue_type :
+       {ThunkExecutor::Options::ReadyQueueType::kFifo,
+        ThunkExecutor::Options::ReadyQueueType::kPriority,
+        ThunkExecutor::Options::ReadyQueueType::kWorkStealing}) {
+    // The largest value must not overflow the end of the lookahead window.
+    for (size_t max_lookahead :
+         {size_t{1}, size_t{4}, size_t{32},
+          std::numeric_limits<size_t>::max()}) {
+      InFlightThunks in_flight(/*num_thunks=*/1000);
+      TF_ASSERT_OK_AND_ASSIGN(
+          std::unique_ptr<GeneratedThunkSequence> g,
+          GenerateThunkSequence(/*num_elements=*/1024, /*num_thunks=*/1000,
+                                SharedResourceUse::kRandom,
+                                /*inject_errors=*/false, &in_flight));
+
+      ThunkExecutor::Options options = OptionsForTest();
+      options.ready_queue_type = ready_queue_type;
+      options.max_lookahead = max_lookahead;
+
+      TF_ASSERT_OK_AND_ASSIGN(
+          ThunkExecutor executor,
+          ThunkExecutor::Create(std::move(g->sequence), options));
+
+      BufferAllocations allocations(g->buffers);
+      Thunk::ExecuteParams params = {nullptr, &allocations, nullptr, nullptr,
+                                     &task_runner};
+
+      shared_resource = 0;
+
+      auto execute_event = executor.Execute(params);
+      tsl::BlockUntilReady(execute_event);
+
+      ASSERT_TRUE(execute_event.IsConcrete());
+      EXPECT_EQ(shared_resource, g->expected_shared_resource_value);
+      EXPECT_EQ(g->dst, g->expected);
+
+      // No thunk started at or beyond `first_pending + max_lookahead`.
+      EXPECT_LT(in_flight.max_spread(), max_lookahead);
+    }
+  }
+}
 
 //===----------------------------------------------------------------------===//
 // Performance benchmarks below
@@ -15,26 +15,40 @@ limitations under the License.
 
 #include "xla/backends/cpu/runtime/topk_thunk.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cstdint>
 #include <memory>
 #include <utility>
 
+#include "absl/base/optimization.h"
 #include "absl/memory/memory.h"
 #include "absl/status/statusor.h"
+#include "xla/backends/cpu/runtime/concurrency.h"
 #include "xla/backends/cpu/runtime/thunk.h"
+#include "xla/primitive_util.h"
 #include "xla/service/buffer_assignment.h"
 #include "xla/service/cpu/runtime_topk.h"
 #include "xla/stream_executor/device_memory.h"
 #include "xla/tsl/concurrency/async_value_ref.h"
+#include "xla/util.h"
+#include "xla/xla_data.pb.h"
+#include "tsl/platform/logging.h"
 #include "tsl/platform/statusor.h"
 
 namespace xla::cpu {
 
-TopKThunk::TopKThunk(Info info, BufferAllocation::Slice values,
+// Minimum number of input elements processed by a single parallel task. Top-k
+// of smaller inputs is too cheap to amortize the cost of scheduling a task.
+static constexpr int64_t kMinParallelTopKTaskSize = 64 * 1024;
+
+TopKThunk::TopKThunk(Info info, PrimitiveType element_type,
+                     BufferAllocation::Slice values,
                      BufferAllocation::Slice output,
                      BufferAllocation::Slice indices, int64_t batch_size,
                      int64_t input_size, int64_t k)
     : Thunk(Thunk::Kind::kTopK, std::move(info)),
+      element_type_(element_type),
       values_buffer_(values),
       output_buffer_(output),
       indices_buffer_(indices),
@@ -43,11 +57,51 @@ TopKThunk::TopKThunk(Info info, BufferAllocation::Slice values,
       k_(k) {}
 
 absl::StatusOr<std::unique_ptr<TopKThunk>> TopKThunk::Create(
-    Info info, BufferAllocation::Slice values, BufferAllocation::Slice output,
-    BufferAllocation::Slice indices, int64_t batch_size, int64_t input_size,
-    int64_t k) {
-  return absl::WrapUnique(new TopKThunk(std::move(info), values, output,
-                                        indices, batch_size, input_size, k));
+    Info info, PrimitiveType element_type, BufferAllocation::Slice values,
+    BufferAllocation::Slice output, BufferAllocation::Slice indices,
+    int64_t batch_size, int64_t input_size, int64_t k) {
+  if (element_type != F32 && element_type != F16 && element_type != BF16) {
+    return InvalidArgument("Unsupported TopK element type: %s",
+                           primitive_util::LowercasePrimitiveTypeName(
+                               element_type));
+  }
+  return absl::WrapUnique(new TopKThunk(std::move(info), element_type, values,
+                                        output, indices, batch_size,
+                                        input_size, k));
+}
+
+void TopKThunk::TopK(int64_t begin, int64_t end, const void* values,
+                     void* output, int32_t* indices) const {
+  int64_t batch_size = end - begin;
+  int64_t values_offset = begin * input_size_;
+  int64_t output_offset = begin * k_;
+
+  switch (element_type_) {
+    case F32:
+      __xla_cpu_runtime_TopKF32(
+          batch_size, input_size_, k_,
+          static_cast<const float*>(values) + values_offset,
+          static_cast<float*>(output) + output_offset,
+          indices + output_offset);
+      break;
+    case F16:
+      __xla_cpu_runtime_TopKF16(
+          batch_size, input_size_, k_,
+          static_cast<const uint16_t*>(values) + values_offset,
+          static_cast<uint16_t*>(output) + output_offset,
+          indices + output_offset);
+      break;
+    case BF16:
+      __xla_cpu_runtime_TopKBF16(
+          batch_size, input_size_, k_,
+          static_cast<const uint16_t*>(values) + values_offset,
+          static_cast<uint16_t*>(output) + output_offset,
+          indices + output_offset);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported TopK element type: "
+                 << primitive_util::LowercasePrimitiveTypeName(element_type_);
+  }
 }
 
 tsl::AsyncValueRef<Thunk::ExecuteEvent> TopKThunk::Execute(
@@ -62,11 +116,44 @@ tsl::AsyncValueRef<Thunk::ExecuteEvent> TopKThunk::Execute(
       se::DeviceMemoryBase indices,
       params.buffer_allocations->GetDeviceAddress(indices_buffer_));
 
-  __xla_cpu_runtime_TopKF32(batch_size_, input_size_, k_,
-                            reinterpret_cast<const float*>(values.opaque()),
-                            reinterpret_cast<float*>(output.opaque()),
-                            reinterpret_cast<int32_t*>(indices.opaque()));
-  return OkExecuteEvent();
+  const void* values_data = values.opaque();
+  void* output_data = output.opaque();
+  int32_t* indices_data = reinterpret_cast<int32_t*>(indices.opaque());
+
+  // Rows are independent, so we split the batch into chunks of rows with at
+  // least `kMinParallelTopKTaskSize` input elements and process them in
+  // parallel on the intra-op thread pool.
+  int64_t num_tasks = 1;
+  if (params.intra_op_threadpool != nullptr) {
+    num_tasks = std::min<int64_t>(
+        {params.intra_op_threadpool->numThreadsInPool(), batch_size_,
+         batch_size_ * input_size_ / kMinParallelTopKTaskSize});
+  }
+
+  if (ABSL_PREDICT_TRUE(num_tasks <= 1)) {
+    TopK(0, batch_size_, values_data, output_data, indices_data);
+    return OkExecuteEvent();
+  }
+
+  int64_t rows_per_task = CeilOfRatio(batch_size_, num_tasks);
+  num_tasks = CeilOfRatio(batch_size_, rows_per_task);
+
+  auto event = tsl::MakeConstructedAsyncValueRef<ExecuteEvent>();
+  auto counter = std::make_shared<std::atomic<int64_t>>(num_tasks);
+
+  ScheduleAll(params.intra_op_threadpool, num_tasks,
+              [this, event, counter, rows_per_task, values_data, output_data,
+               indices_data](int64_t task) {
+                int64_t begin = task * rows_per_task;
+                int64_t end = std::min(begin + rows_per_task, batch_size_);
+                TopK(begin, end, values_data, output_data, indices_data);
+
+                if (counter->load() == 1 || counter->fetch_sub(1) == 1) {
+                  event.SetStateConcrete();
+                }
+              });
+
+  return event;
 }
 
 }  // namespace xla::cpu
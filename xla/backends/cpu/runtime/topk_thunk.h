@@ -24,15 +24,19 @@ limitations under the License.
 #include "xla/runtime/buffer_use.h"
 #include "xla/service/buffer_assignment.h"
 #include "xla/tsl/concurrency/async_value_ref.h"
+#include "xla/xla_data.pb.h"
 
 namespace xla::cpu {
 
+// Computes top-k elements of each row of a [batch_size, input_size] array of
+// F32, F16 or BF16 values. Large batches are split into chunks of rows that
+// are processed in parallel on the intra-op thread pool.
 class TopKThunk final : public Thunk {
  public:
   static absl::StatusOr<std::unique_ptr<TopKThunk>> Create(
-      Info info, BufferAllocation::Slice values, BufferAllocation::Slice output,
-      BufferAllocation::Slice indices, int64_t batch_size, int64_t input_size,
-      int64_t k);
+      Info info, PrimitiveType element_type, BufferAllocation::Slice values,
+      BufferAllocation::Slice output, BufferAllocation::Slice indices,
+      int64_t batch_size, int64_t input_size, int64_t k);
 
   tsl::AsyncValueRef<ExecuteEvent> Execute(const ExecuteParams& params) final;
 
@@ -42,10 +46,16 @@ class TopKThunk final : public Thunk {
   }
 
  private:
-  TopKThunk(Info info, BufferAllocation::Slice values,
-            BufferAllocation::Slice output, BufferAllocation::Slice indices,
-            int64_t batch_size, int64_t input_size, int64_t k);
+  TopKThunk(Info info, PrimitiveType element_type,
+            BufferAllocation::Slice values, BufferAllocation::Slice output,
+            BufferAllocation::Slice indices, int64_t batch_size,
+            int64_t input_size, int64_t k);
 
+  // Computes top-k elements for rows in the [begin, end) range.
+  void TopK(int64_t begin, int64_t end, const void* values, void* output,
+            int32_t* indices) const;
+
+  PrimitiveType element_type_;
   BufferAllocation::Slice values_buffer_;
   BufferAllocation::Slice output_buffer_;
   BufferAllocation::Slice indices_buffer_;
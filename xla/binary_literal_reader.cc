@@ -0,0 +1,142 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/binary_literal_reader.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/base/internal/endian.h"
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/match.h"
+#include "absl/strings/string_view.h"
+#include "xla/binary_literal_writer.h"
+#include "xla/layout_util.h"
+#include "xla/literal.h"
+#include "xla/primitive_util.h"
+#include "xla/shape.h"
+#include "xla/shape_tree.h"
+#include "xla/shape_util.h"
+#include "xla/util.h"
+#include "xla/xla_data.pb.h"
+#include "tsl/platform/env.h"
+#include "tsl/platform/errors.h"
+#include "tsl/platform/file_system.h"
+
+namespace xla {
+
+/* static */ absl::StatusOr<std::unique_ptr<BinaryLiteralReader>>
+BinaryLiteralReader::Open(absl::string_view path, tsl::Env* env) {
+  std::unique_ptr<tsl::ReadOnlyMemoryRegion> region;
+  TF_RETURN_IF_ERROR(
+      env->NewReadOnlyMemoryRegionFromFile(std::string(path), &region));
+  absl::string_view data(static_cast<const char*>(region->data()),
+                         region->length());
+  auto reader = absl::WrapUnique(new BinaryLiteralReader(std::move(region)));
+  TF_RETURN_IF_ERROR(reader->Parse(data));
+  return reader;
+}
+
+/* static */ absl::StatusOr<std::unique_ptr<BinaryLiteralReader>>
+BinaryLiteralReader::FromBuffer(absl::string_view data) {
+  auto reader = absl::WrapUnique(new BinaryLiteralReader());
+  TF_RETURN_IF_ERROR(reader->Parse(data));
+  return reader;
+}
+
+/* static */ absl::StatusOr<Literal> BinaryLiteralReader::ReadPath(
+    absl::string_view path, tsl::Env* env) {
+  TF_ASSIGN_OR_RETURN(std::unique_ptr<BinaryLiteralReader> reader,
+                      Open(path, env));
+  return reader->literal().Clone();
+}
+
+/* static */ bool BinaryLiteralReader::HasBinaryLiteralMagic(
+    absl::string_view data) {
+  return absl::StartsWith(data, BinaryLiteralWriter::kMagic);
+}
+
+absl::Status BinaryLiteralReader::Parse(absl::string_view data) {
+  constexpr int64_t kHeaderSize =
+      BinaryLiteralWriter::kMagic.size() + sizeof(uint64_t);
+  if (data.size() < kHeaderSize || !HasBinaryLiteralMagic(data)) {
+    return InvalidArgument("Not a binary literal");
+  }
+  uint64_t shape_size = absl::little_endian::Load64(
+      data.data() + BinaryLiteralWriter::kMagic.size());
+  if (shape_size > data.size() - kHeaderSize) {
+    return InvalidArgument("Binary literal is truncated: shape of %d bytes",
+                           shape_size);
+  }
+
+  ShapeProto shape_proto;
+  if (!shape_proto.ParseFromArray(data.data() + kHeaderSize, shape_size)) {
+    return InvalidArgument("Failed to parse shape of binary literal");
+  }
+  Shape shape(shape_proto);
+  TF_RETURN_IF_ERROR(ShapeUtil::ValidateShapeWithOptionalLayout(shape));
+  if (!shape.is_static() || !LayoutUtil::HasLayout(shape)) {
+    return InvalidArgument(
+        "Binary literal must have a static shape with layout, got %s",
+        ShapeUtil::HumanStringWithLayout(shape));
+  }
+
+  // Buffers are placed exactly as BinaryLiteralWriter does it.
+  ShapeTree<const char*> buffers(shape, nullptr);
+  int64_t offset = kHeaderSize + shape_size;
+  TF_RETURN_IF_ERROR(ShapeUtil::ForEachSubshapeWithStatus(
+      shape,
+      [&](const Shape& subshape, const ShapeIndex& index) -> absl::Status {
+        if (subshape.IsTuple()) return absl::OkStatus();
+        if (!subshape.IsArray()) {
+          return InvalidArgument("Unsupported shape in binary literal: %s",
+                                 ShapeUtil::HumanString(subshape));
+        }
+        // Sparse arrays have no fixed byte size.
+        if (!LayoutUtil::IsDenseArray(subshape)) {
+          return InvalidArgument(
+              "Binary literal must have dense arrays, got %s",
+              ShapeUtil::HumanStringWithLayout(subshape));
+        }
+        offset = RoundUpTo(offset, BinaryLiteralWriter::kAlignment);
+        int64_t size = ShapeUtil::ByteSizeOf(subshape);
+        if (offset > data.size() || size > data.size() - offset) {
+          return InvalidArgument(
+              "Binary literal is truncated: buffer %s of %d bytes at offset %d "
+              "exceeds %d bytes",
+              index.ToString(), size, offset, data.size());
+        }
+        const char* buffer = data.data() + offset;
+        int64_t alignment =
+            primitive_util::ByteWidth(subshape.element_type());
+        if (reinterpret_cast<uintptr_t>(buffer) % alignment != 0) {
+          return InvalidArgument(
+              "Buffer %s of binary literal is not aligned to %d bytes",
+              index.ToString(), alignment);
+        }
+        *buffers.mutable_element(index) = buffer;
+        offset += size;
+        return absl::OkStatus();
+      }));
+
+  literal_ = BorrowingLiteral(std::move(buffers));
+  return absl::OkStatus();
+}
+
+}  // namespace xla
@@ -0,0 +1,70 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef XLA_BINARY_LITERAL_READER_H_
+#define XLA_BINARY_LITERAL_READER_H_
+
+#include <memory>
+
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "xla/literal.h"
+#include "tsl/platform/env.h"
+#include "tsl/platform/file_system.h"
+
+namespace xla {
+
+// Reads literals written by BinaryLiteralWriter. The file is memory-mapped and
+// literal() borrows the array buffers from the mapping, so opening a literal
+// doesn't copy its data and only touches the pages that are accessed.
+class BinaryLiteralReader {
+ public:
+  // Maps the file at `path` into memory.
+  static absl::StatusOr<std::unique_ptr<BinaryLiteralReader>> Open(
+      absl::string_view path, tsl::Env* env = tsl::Env::Default());
+
+  // Views `data`, which must outlive the reader. Array buffers must be aligned
+  // for their element type, which holds if `data` is 64-byte aligned.
+  static absl::StatusOr<std::unique_ptr<BinaryLiteralReader>> FromBuffer(
+      absl::string_view data);
+
+  // Reads the file at `path` into a literal that owns its data.
+  static absl::StatusOr<Literal> ReadPath(absl::string_view path,
+                                          tsl::Env* env = tsl::Env::Default());
+
+  // Returns whether `data` starts like a binary literal.
+  static bool HasBinaryLiteralMagic(absl::string_view data);
+
+  // Valid for the lifetime of the reader.
+  const BorrowingLiteral& literal() const { return literal_; }
+
+ private:
+  explicit BinaryLiteralReader(
+      std::unique_ptr<tsl::ReadOnlyMemoryRegion> region = nullptr)
+      : region_(std::move(region)) {}
+
+  // Parses the header in `data` and points literal_ at the buffers.
+  absl::Status Parse(absl::string_view data);
+
+  std::unique_ptr<tsl::ReadOnlyMemoryRegion> region_;
+  BorrowingLiteral literal_;
+
+  BinaryLiteralReader(const BinaryLiteralReader&) = delete;
+  BinaryLiteralReader& operator=(const BinaryLiteralReader&) = delete;
+};
+
+}  // namespace xla
+
+#endif  // XLA_BINARY_LITERAL_READER_H_
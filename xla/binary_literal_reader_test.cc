@@ -0,0 +1,119 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/binary_literal_reader.h"
+
+#include <complex>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/base/internal/endian.h"
+#include "absl/status/status.h"
+#include "xla/binary_literal_writer.h"
+#include "xla/layout_util.h"
+#include "xla/literal.h"
+#include "xla/literal_util.h"
+#include "xla/shape_util.h"
+#include "xla/test.h"
+#include "xla/tsl/lib/core/status_test_util.h"
+#include "xla/types.h"
+#include "xla/util.h"
+#include "xla/xla_data.pb.h"
+#include "tsl/platform/env.h"
+#include "tsl/platform/statusor.h"
+
+namespace xla {
+namespace {
+
+TEST(BinaryLiteralReaderTest, RoundTripsArray) {
+  Literal literal = LiteralUtil::CreateR2WithLayout<float>(
+      {{1.5, 2.5, 3.5}, {4.5, 5.5, 6.5}}, LayoutUtil::MakeLayout({0, 1}));
+  TF_ASSERT_OK_AND_ASSIGN(std::string data,
+                          BinaryLiteralWriter::WriteToString(literal));
+
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<BinaryLiteralReader> reader,
+                          BinaryLiteralReader::FromBuffer(data));
+  EXPECT_EQ(reader->literal(), literal);
+  EXPECT_TRUE(ShapeUtil::Equal(reader->literal().shape(), literal.shape()));
+
+  // The literal borrows the buffer instead of copying it.
+  const char* buffer =
+      static_cast<const char*>(reader->literal().untyped_data());
+  EXPECT_GE(buffer, data.data());
+  EXPECT_LT(buffer, data.data() + data.size());
+}
+
+TEST(BinaryLiteralReaderTest, RoundTripsNestedTupleFile) {
+  Literal literal = LiteralUtil::MakeTupleOwned(
+      LiteralUtil::CreateR1<int32_t>({1, 2, 3}),
+      LiteralUtil::MakeTupleOwned(
+          LiteralUtil::CreateR0<bool>(true),
+          LiteralUtil::CreateR1<std::complex<double>>({{1, 2}, {3, 4}})),
+      LiteralUtil::CreateR1<s4>({s4(-1), s4(7)}));
+
+  std::string path = tsl::testing::TmpDir() + "/RoundTripsNestedTupleFile.lit";
+  TF_ASSERT_OK(BinaryLiteralWriter::WriteToPath(literal, path));
+
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<BinaryLiteralReader> reader,
+                          BinaryLiteralReader::Open(path));
+  EXPECT_EQ(reader->literal(), literal);
+
+  TF_ASSERT_OK_AND_ASSIGN(Literal owned, BinaryLiteralReader::ReadPath(path));
+  EXPECT_EQ(owned, literal);
+}
+
+TEST(BinaryLiteralReaderTest, RejectsTruncatedData) {
+  Literal literal = LiteralUtil::CreateR1<float>({1, 2, 3, 4});
+  TF_ASSERT_OK_AND_ASSIGN(std::string data,
+                          BinaryLiteralWriter::WriteToString(literal));
+  EXPECT_TRUE(BinaryLiteralReader::HasBinaryLiteralMagic(data));
+
+  data.resize(data.size() - 1);
+  EXPECT_FALSE(BinaryLiteralReader::FromBuffer(data).ok());
+  EXPECT_FALSE(BinaryLiteralReader::FromBuffer("f32[4] {1, 2, 3, 4}").ok());
+}
+
+TEST(BinaryLiteralReaderTest, RejectsSparseArrays) {
+  // Encode a file the writer would never produce: the header claims that the
+  // array is compressed.
+  ShapeProto shape =
+      ShapeUtil::MakeShapeWithDenseLayout(F32, {4}, {0}).ToProto();
+  shape.mutable_layout()->clear_dim_level_types();
+  shape.mutable_layout()->add_dim_level_types(DIM_COMPRESSED);
+  std::string shape_data = shape.SerializeAsString();
+
+  std::string data(BinaryLiteralWriter::kMagic);
+  char shape_size[sizeof(uint64_t)];
+  absl::little_endian::Store64(shape_size, shape_data.size());
+  data.append(shape_size, sizeof(shape_size));
+  data.append(shape_data);
+  data.resize(RoundUpTo<size_t>(data.size(), BinaryLiteralWriter::kAlignment),
+              '\0');
+  data.append(4 * sizeof(float), '\0');
+
+  EXPECT_EQ(BinaryLiteralReader::FromBuffer(data).status().code(),
+            absl::StatusCode::kInvalidArgument);
+}
+
+TEST(BinaryLiteralReaderTest, RejectsDynamicShapes) {
+  Literal literal = LiteralUtil::CreateR1<float>({1, 2, 3, 4});
+  literal.SetDynamicSize(0, 2);
+  EXPECT_FALSE(BinaryLiteralWriter::WriteToString(literal).ok());
+}
+
+}  // namespace
+}  // namespace xla
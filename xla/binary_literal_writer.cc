@@ -0,0 +1,116 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/binary_literal_writer.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "absl/base/internal/endian.h"
+#include "absl/functional/function_ref.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "xla/literal.h"
+#include "xla/shape.h"
+#include "xla/shape_util.h"
+#include "xla/util.h"
+#include "xla/xla_data.pb.h"
+#include "tsl/platform/env.h"
+#include "tsl/platform/errors.h"
+#include "tsl/platform/file_system.h"
+
+namespace xla {
+
+namespace {
+
+// Writes `literal` in the binary literal format to `append`, which is called
+// with consecutive pieces of the output. Array buffers are passed without
+// copying them.
+absl::Status WriteBinaryLiteral(
+    const LiteralSlice& literal,
+    absl::FunctionRef<absl::Status(absl::string_view)> append) {
+  const Shape& shape = literal.shape();
+  if (!shape.is_static()) {
+    return InvalidArgument(
+        "Binary literal format does not support dynamic shapes: %s",
+        ShapeUtil::HumanStringWithLayout(shape));
+  }
+
+  std::string shape_proto;
+  if (!shape.ToProto().SerializeToString(&shape_proto)) {
+    return Internal("Failed to serialize shape %s",
+                    ShapeUtil::HumanStringWithLayout(shape));
+  }
+
+  char shape_size[sizeof(uint64_t)];
+  absl::little_endian::Store64(shape_size, shape_proto.size());
+
+  static constexpr char kZeros[BinaryLiteralWriter::kAlignment] = {};
+  int64_t offset = 0;
+  auto write = [&](absl::string_view data) -> absl::Status {
+    offset += data.size();
+    return append(data);
+  };
+  auto pad = [&]() -> absl::Status {
+    int64_t padding = RoundUpTo(offset, BinaryLiteralWriter::kAlignment) -
+                      offset;
+    return write(absl::string_view(kZeros, padding));
+  };
+
+  TF_RETURN_IF_ERROR(write(BinaryLiteralWriter::kMagic));
+  TF_RETURN_IF_ERROR(write(absl::string_view(shape_size, sizeof(shape_size))));
+  TF_RETURN_IF_ERROR(write(shape_proto));
+
+  return ShapeUtil::ForEachSubshapeWithStatus(
+      shape,
+      [&](const Shape& subshape, const ShapeIndex& index) -> absl::Status {
+        if (subshape.IsTuple()) return absl::OkStatus();
+        if (!subshape.IsArray()) {
+          return InvalidArgument(
+              "Binary literal format does not support shape %s",
+              ShapeUtil::HumanString(subshape));
+        }
+        TF_RETURN_IF_ERROR(pad());
+        return write(absl::string_view(
+            static_cast<const char*>(literal.untyped_data(index)),
+            literal.size_bytes(index)));
+      });
+}
+
+}  // namespace
+
+/* static */ absl::Status BinaryLiteralWriter::WriteToPath(
+    const LiteralSlice& literal, absl::string_view path, tsl::Env* env) {
+  std::unique_ptr<tsl::WritableFile> file;
+  TF_RETURN_IF_ERROR(env->NewWritableFile(std::string(path), &file));
+  TF_RETURN_IF_ERROR(WriteBinaryLiteral(
+      literal, [&](absl::string_view data) { return file->Append(data); }));
+  return file->Close();
+}
+
+/* static */ absl::StatusOr<std::string> BinaryLiteralWriter::WriteToString(
+    const LiteralSlice& literal) {
+  std::string result;
+  TF_RETURN_IF_ERROR(
+      WriteBinaryLiteral(literal, [&](absl::string_view data) {
+        result.append(data.data(), data.size());
+        return absl::OkStatus();
+      }));
+  return result;
+}
+
+}  // namespace xla
@@ -0,0 +1,66 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef XLA_BINARY_LITERAL_WRITER_H_
+#define XLA_BINARY_LITERAL_WRITER_H_
+
+#include <cstdint>
+#include <string>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "xla/literal.h"
+#include "tsl/platform/env.h"
+
+namespace xla {
+
+// Writes a literal in a flat binary format that can be memory-mapped and
+// viewed as a literal without copying (see BinaryLiteralReader). Unlike
+// LiteralProto the format has no size limit and doesn't convert elements.
+//
+// The format is:
+//
+//    magic         8 bytes, kMagic
+//    shape_size    uint64_t, little endian
+//    shape         serialized ShapeProto (with layout) of shape_size bytes
+//    buffers       the buffer of every array in the literal, in the order of
+//                  ShapeUtil::ForEachSubshape
+//
+// The first buffer and every following one start at an offset that is a
+// multiple of kAlignment, the gaps are filled with zeros. Buffers hold the
+// in-memory representation of the literal on the writing host, so files are
+// not portable between hosts with different endianness. Only static shapes are
+// supported.
+class BinaryLiteralWriter {
+ public:
+  // Identifies the format and its version.
+  static constexpr absl::string_view kMagic{"XLALIT\0\1", 8};
+  static constexpr int64_t kAlignment = 64;
+
+  static absl::Status WriteToPath(const LiteralSlice& literal,
+                                  absl::string_view path,
+                                  tsl::Env* env = tsl::Env::Default());
+
+  static absl::StatusOr<std::string> WriteToString(const LiteralSlice& literal);
+
+ private:
+  BinaryLiteralWriter(const BinaryLiteralWriter&) = delete;
+  BinaryLiteralWriter& operator=(const BinaryLiteralWriter&) = delete;
+};
+
+}  // namespace xla
+
+#endif  // XLA_BINARY_LITERAL_WRITER_H_
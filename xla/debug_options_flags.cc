@@ -54,6 +54,7 @@ DebugOptions DefaultDebugOptionsIgnoringFlags() {
   opts.set_xla_llvm_enable_invariant_load_metadata(true);
   opts.set_xla_llvm_disable_expensive_passes(false);
   opts.set_xla_backend_optimization_level(3);
+  opts.set_xla_hlo_pass_computation_parallelism(0);
   opts.set_xla_gpu_autotune_level(4);
   opts.set_xla_gpu_autotune_max_solutions(0);
   opts.set_xla_cpu_multi_thread_eigen(true);
@@ -86,6 +87,12 @@ DebugOptions DefaultDebugOptionsIgnoringFlags() {
   opts.set_xla_cpu_use_acl(true);
 #endif
   opts.set_xla_cpu_use_thunk_runtime(true);
+  opts.set_xla_cpu_thunk_executor_ready_queue(
+      DebugOptions::CPU_THUNK_EXECUTOR_READY_QUEUE_FIFO);
+  opts.set_xla_cpu_thunk_executor_critical_path_priorities(false);
+  opts.set_xla_cpu_parameter_alignment(0);
+  opts.set_xla_cpu_thunk_executor_max_lookahead(0);
+  opts.set_xla_cpu_parallel_cost_profile("");
   opts.set_xla_cpu_parallel_codegen_split_count(32);
   opts.set_xla_cpu_copy_insertion_use_region_analysis(false);
   opts.set_xla_cpu_enable_concurrency_optimized_scheduler(false);
@@ -713,6 +720,18 @@ void MakeDebugOptionsFlags(std::vector<tsl::Flag>* flag_list,
         return true;
       };
 
+  // Custom "sub-parser" lambda for xla_cpu_thunk_executor_ready_queue.
+  auto setter_for_xla_cpu_thunk_executor_ready_queue =
+      [debug_options](const std::string& value) {
+        DebugOptions::CpuThunkExecutorReadyQueue ready_queue;
+        if (!DebugOptions::CpuThunkExecutorReadyQueue_Parse(value,
+                                                            &ready_queue)) {
+          return false;
+        }
+        debug_options->set_xla_cpu_thunk_executor_ready_queue(ready_queue);
+        return true;
+      };
+
   // Don't use an initializer list for initializing the vector; this would
   // create a temporary copy, and exceeds the stack space when compiling with
   // certain configurations.
@@ -810,6 +829,22 @@ void MakeDebugOptionsFlags(std::vector<tsl::Flag>* flag_list,
       "over time. The only 'guarantee', such as it is, is that if you compile "
       "XLA and dump the optimized HLO for some graph, you should be able to "
       "run it again on the same device with the same build of XLA."));
+  flag_list->push_back(tsl::Flag(
+      "xla_hlo_pass_computation_parallelism",
+      int32_setter_for(
+          &DebugOptions::set_xla_hlo_pass_computation_parallelism),
+      debug_options->xla_hlo_pass_computation_parallelism(),
+      "Number of threads used to run computation-local HLO passes on "
+      "independent computations concurrently. Values below two run all "
+      "passes sequentially."));
+  flag_list->push_back(tsl::Flag(
+      "xla_hlo_evaluator_inter_op_parallelism",
+      int32_setter_for(
+          &DebugOptions::set_xla_hlo_evaluator_inter_op_parallelism),
+      debug_options->xla_hlo_evaluator_inter_op_parallelism(),
+      "Number of threads the HLO evaluator of the interpreter backend uses to "
+      "evaluate independent instructions concurrently. Values below two "
+      "evaluate instructions sequentially."));
   flag_list->push_back(
       tsl::Flag("xla_embed_ir_in_executable",
                 bool_setter_for(&DebugOptions::set_xla_embed_ir_in_executable),
@@ -887,6 +922,43 @@ void MakeDebugOptionsFlags(std::vector<tsl::Flag>* flag_list,
                 bool_setter_for(&DebugOptions::set_xla_cpu_use_thunk_runtime),
                 debug_options->xla_cpu_use_thunk_runtime(),
                 "Use Thunk-based runtime for the CPU backend."));
+  flag_list->push_back(tsl::Flag(
+      "xla_cpu_thunk_executor_ready_queue",
+      setter_for_xla_cpu_thunk_executor_ready_queue,
+      DebugOptions::CpuThunkExecutorReadyQueue_Name(
+          debug_options->xla_cpu_thunk_executor_ready_queue()),
+      "Ready queue used by the XLA:CPU thunk executor. Available values: "
+      "CPU_THUNK_EXECUTOR_READY_QUEUE_FIFO, "
+      "CPU_THUNK_EXECUTOR_READY_QUEUE_PRIORITY and "
+      "CPU_THUNK_EXECUTOR_READY_QUEUE_WORK_STEALING."));
+  flag_list->push_back(tsl::Flag(
+      "xla_cpu_thunk_executor_critical_path_priorities",
+      bool_setter_for(
+          &DebugOptions::set_xla_cpu_thunk_executor_critical_path_priorities),
+      debug_options->xla_cpu_thunk_executor_critical_path_priorities(),
+      "Estimate thunk execution times with the HLO cost analysis and "
+      "prioritize thunks on the critical path in the XLA:CPU thunk executor "
+      "priority ready queue."));
+  flag_list->push_back(tsl::Flag(
+      "xla_cpu_parameter_alignment",
+      int64_setter_for(&DebugOptions::set_xla_cpu_parameter_alignment),
+      debug_options->xla_cpu_parameter_alignment(),
+      "Alignment in bytes that XLA:CPU kernels assume for entry computation "
+      "parameters. Zero means the default alignment."));
+  flag_list->push_back(tsl::Flag(
+      "xla_cpu_thunk_executor_max_lookahead",
+      int64_setter_for(&DebugOptions::set_xla_cpu_thunk_executor_max_lookahead),
+      debug_options->xla_cpu_thunk_executor_max_lookahead(),
+      "If positive, the XLA:CPU thunk executor runs thunks at most this many "
+      "thunks ahead of the first not yet completed thunk in the schedule. "
+      "Zero means unbounded."));
+  flag_list->push_back(tsl::Flag(
+      "xla_cpu_parallel_cost_profile",
+      string_setter_for(&DebugOptions::set_xla_cpu_parallel_cost_profile),
+      debug_options->xla_cpu_parallel_cost_profile(),
+      "Path to a ParallelCostProfile with the measured throughput of the "
+      "host. If set, XLA:CPU chooses parallel task counts with a cost model "
+      "calibrated by the profile."));
   flag_list->push_back(tsl::Flag(
       "xla_cpu_parallel_codegen_split_count",
       int32_setter_for(&DebugOptions::set_xla_cpu_parallel_codegen_split_count),
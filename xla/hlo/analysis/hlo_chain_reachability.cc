@@ -0,0 +1,105 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/hlo/analysis/hlo_chain_reachability.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "absl/algorithm/container.h"
+#include "absl/types/span.h"
+#include "xla/hlo/ir/hlo_computation.h"
+#include "xla/hlo/ir/hlo_instruction.h"
+
+namespace xla {
+
+bool HloChainReachabilityMap::IsReachable(const HloInstruction* a,
+                                          const HloInstruction* b) const {
+  const Node& node = nodes_[indices_.at(a)];
+  absl::Span<const int32_t> row = Row(indices_.at(b));
+  return node.chain < row.size() && node.position <= row[node.chain];
+}
+
+std::unique_ptr<HloChainReachabilityMap> HloChainReachabilityMap::Build(
+    const HloComputation* computation) {
+  HloComputation::ChannelDependencies channel_dependencies =
+      computation->ComputeChannelDependencies();
+  std::vector<HloInstruction*> instructions =
+      computation->MakeInstructionPostOrder(channel_dependencies);
+
+  auto result = std::make_unique<HloChainReachabilityMap>();
+  result->indices_.reserve(instructions.size());
+  result->nodes_.reserve(instructions.size());
+  result->row_offsets_.reserve(instructions.size() + 1);
+  result->row_offsets_.push_back(0);
+
+  // Position of the last instruction in each chain.
+  std::vector<int32_t> tails;
+  std::vector<int32_t> row;
+
+  for (const HloInstruction* instruction : instructions) {
+    // Instructions are visited in post order, so chains started later can't
+    // reach the current instruction and the row only covers existing chains.
+    row.assign(tails.size(), -1);
+
+    auto add_predecessor = [&](const HloInstruction* predecessor) {
+      absl::Span<const int32_t> predecessor_row =
+          result->Row(result->indices_.at(predecessor));
+      for (size_t c = 0; c < predecessor_row.size(); ++c) {
+        row[c] = std::max(row[c], predecessor_row[c]);
+      }
+    };
+    auto add_dependencies = [&](const HloInstruction* dependent) {
+      absl::c_for_each(dependent->operands(), add_predecessor);
+      absl::c_for_each(dependent->control_predecessors(), add_predecessor);
+    };
+
+    add_dependencies(instruction);
+
+    // If an instruction has channel dependencies, they are also reachable.
+    auto it = channel_dependencies.find(instruction);
+    if (it != channel_dependencies.end()) {
+      absl::c_for_each(it->second, add_dependencies);
+    }
+
+    // Append the instruction to the first chain whose last instruction it is
+    // reachable from, or start a new chain.
+    size_t chain = 0;
+    while (chain < tails.size() && row[chain] != tails[chain]) ++chain;
+    if (chain == tails.size()) {
+      tails.push_back(-1);
+      row.push_back(-1);
+    }
+    row[chain] = ++tails[chain];
+
+    // Trailing entries for chains that don't reach the instruction are
+    // implicit.
+    while (!row.empty() && row.back() < 0) row.pop_back();
+
+    result->indices_[instruction] = result->nodes_.size();
+    result->nodes_.push_back(
+        {static_cast<uint32_t>(chain), static_cast<int32_t>(tails[chain])});
+    result->table_.insert(result->table_.end(), row.begin(), row.end());
+    result->row_offsets_.push_back(result->table_.size());
+  }
+
+  result->num_chains_ = tails.size();
+  return result;
+}
+
+}  // namespace xla
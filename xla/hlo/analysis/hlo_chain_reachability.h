@@ -0,0 +1,103 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef XLA_HLO_ANALYSIS_HLO_CHAIN_REACHABILITY_H_
+#define XLA_HLO_ANALYSIS_HLO_CHAIN_REACHABILITY_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/types/span.h"
+#include "xla/hlo/ir/hlo_computation.h"
+#include "xla/hlo/ir/hlo_instruction.h"
+
+namespace xla {
+
+// A compact reachability map for very large computations based on a chain
+// decomposition of the graph.
+//
+// Instructions are greedily partitioned into chains, i.e. sequences of
+// instructions where each one is reachable from the previous one. An
+// instruction is identified by its chain and its position in that chain, and
+// for every chain it stores the last position from which the instruction is
+// reachable. As reachability is a total order along a chain, 'b' is reachable
+// from 'a' iff the position of 'a' is not after the one that 'b' stores for
+// the chain of 'a'.
+//
+// This takes O(N * C) memory for N instructions decomposed into C chains,
+// compared to the O(N^2) bits of HloReachabilityMap, and answers queries with
+// a single lookup. C is bounded from below by the width of the graph, so the
+// representation pays off for the long and narrow graphs of large models; use
+// num_chains() to check how well a computation compresses. The map can't be
+// updated, use HloReachabilityMap if the graph changes.
+class HloChainReachabilityMap {
+ public:
+  // Computes the reachability between HLO instructions in the computation,
+  // with the same semantics as HloReachabilityMap::Build.
+  static std::unique_ptr<HloChainReachabilityMap> Build(
+      const HloComputation* computation);
+
+  // Returns true iff the instruction was present in the computation passed to
+  // Build().
+  bool IsPresent(const HloInstruction* instruction) const {
+    return indices_.contains(instruction);
+  }
+
+  // Returns true if "b" is reachable from "a".
+  bool IsReachable(const HloInstruction* a, const HloInstruction* b) const;
+
+  // Returns true if "b" is reachable from "a" or "a" is reachable from "b".
+  bool IsConnected(const HloInstruction* a, const HloInstruction* b) const {
+    return IsReachable(a, b) || IsReachable(b, a);
+  }
+
+  // Returns the number of chains the computation was decomposed into.
+  size_t num_chains() const { return num_chains_; }
+
+  // Returns the size of the reachability table in bytes.
+  size_t table_size_in_bytes() const {
+    return table_.size() * sizeof(int32_t);
+  }
+
+ private:
+  struct Node {
+    uint32_t chain;
+    int32_t position;
+  };
+
+  // Returns the last reachable positions in each chain for the node. Entries
+  // for chains past the end of the row are implicitly -1 (not reachable).
+  absl::Span<const int32_t> Row(size_t index) const {
+    return absl::MakeConstSpan(table_).subspan(
+        row_offsets_[index], row_offsets_[index + 1] - row_offsets_[index]);
+  }
+
+  absl::flat_hash_map<const HloInstruction*, size_t> indices_;
+  std::vector<Node> nodes_;
+
+  // Rows of the reachability table of all nodes stored back to back; the row
+  // of node i is table_[row_offsets_[i], row_offsets_[i + 1]).
+  std::vector<size_t> row_offsets_;
+  std::vector<int32_t> table_;
+
+  size_t num_chains_ = 0;
+};
+
+}  // namespace xla
+
+#endif  // XLA_HLO_ANALYSIS_HLO_CHAIN_REACHABILITY_H_
@@ -0,0 +1,260 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/hlo/analysis/hlo_chain_reachability.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "absl/types/span.h"
+#include "xla/hlo/analysis/hlo_reachability.h"
+#include "xla/hlo/ir/hlo_computation.h"
+#include "xla/hlo/ir/hlo_instruction.h"
+#include "xla/hlo/ir/hlo_opcode.h"
+#include "xla/hlo/testlib/hlo_hardware_independent_test_base.h"
+#include "xla/literal_util.h"
+#include "xla/service/computation_placer.h"
+#include "xla/service/hlo_module_config.h"
+#include "xla/shape.h"
+#include "xla/shape_util.h"
+#include "xla/test.h"
+#include "tsl/platform/status.h"
+#include "tsl/platform/test_benchmark.h"
+
+namespace xla {
+
+namespace {
+
+class HloChainReachabilityMapTest : public HloHardwareIndependentTestBase {};
+
+TEST_F(HloChainReachabilityMapTest, NonTrivialReachability) {
+  // Test reachability of a non-trivial computation:
+  //
+  // const1    const2
+  //    |         |
+  //    | +-------+
+  //    | |       |
+  //    add ..   negate
+  //     |   .     |
+  //     |   .... exp
+  //     |         |
+  //     +---+   +-+---+
+  //         |   |     |
+  //       multiply   copy
+  //
+  // There is a control dependency from 'add' to 'exp'.
+  Shape r0f32 = ShapeUtil::MakeShape(F32, {});
+  auto builder = HloComputation::Builder(TestName());
+  auto constant1 = builder.AddInstruction(
+      HloInstruction::CreateConstant(LiteralUtil::CreateR0<float>(1.0f)));
+  auto constant2 = builder.AddInstruction(
+      HloInstruction::CreateConstant(LiteralUtil::CreateR0<float>(2.0f)));
+  auto add = builder.AddInstruction(HloInstruction::CreateBinary(
+      r0f32, HloOpcode::kAdd, constant1, constant2));
+  auto negate = builder.AddInstruction(
+      HloInstruction::CreateUnary(r0f32, HloOpcode::kNegate, constant2));
+  auto exp = builder.AddInstruction(
+      HloInstruction::CreateUnary(r0f32, HloOpcode::kExp, negate));
+  auto mul = builder.AddInstruction(
+      HloInstruction::CreateBinary(r0f32, HloOpcode::kMultiply, add, exp));
+  auto copy = builder.AddInstruction(
+      HloInstruction::CreateUnary(r0f32, HloOpcode::kCopy, exp));
+
+  auto module = CreateNewVerifiedModule();
+  auto computation =
+      module->AddEntryComputation(builder.Build(/*root_instruction=*/mul));
+
+  TF_CHECK_OK(add->AddControlDependencyTo(exp));
+  auto reachability = HloChainReachabilityMap::Build(computation);
+
+  EXPECT_TRUE(reachability->IsReachable(constant1, constant1));
+  EXPECT_FALSE(reachability->IsReachable(constant1, constant2));
+  EXPECT_TRUE(reachability->IsReachable(constant1, add));
+  EXPECT_FALSE(reachability->IsReachable(constant1, negate));
+  EXPECT_TRUE(reachability->IsReachable(constant1, exp));
+  EXPECT_TRUE(reachability->IsReachable(constant1, mul));
+  EXPECT_TRUE(reachability->IsReachable(constant1, copy));
+
+  EXPECT_FALSE(reachability->IsReachable(constant2, constant1));
+  EXPECT_TRUE(reachability->IsReachable(constant2, constant2));
+  EXPECT_TRUE(reachability->IsReachable(constant2, add));
+  EXPECT_TRUE(reachability->IsReachable(constant2, negate));
+  EXPECT_TRUE(reachability->IsReachable(constant2, exp));
+  EXPECT_TRUE(reachability->IsReachable(constant2, mul));
+  EXPECT_TRUE(reachability->IsReachable(constant2, copy));
+
+  EXPECT_FALSE(reachability->IsReachable(exp, constant1));
+  EXPECT_FALSE(reachability->IsReachable(exp, constant2));
+  EXPECT_FALSE(reachability->IsReachable(exp, add));
+  EXPECT_FALSE(reachability->IsReachable(exp, negate));
+  EXPECT_TRUE(reachability->IsReachable(exp, exp));
+  EXPECT_TRUE(reachability->IsReachable(exp, mul));
+  EXPECT_TRUE(reachability->IsReachable(exp, copy));
+
+  EXPECT_FALSE(reachability->IsReachable(mul, constant1));
+  EXPECT_FALSE(reachability->IsReachable(mul, constant2));
+  EXPECT_FALSE(reachability->IsReachable(mul, add));
+  EXPECT_FALSE(reachability->IsReachable(mul, negate));
+  EXPECT_FALSE(reachability->IsReachable(mul, exp));
+  EXPECT_TRUE(reachability->IsReachable(mul, mul));
+  EXPECT_FALSE(reachability->IsReachable(mul, copy));
+
+  EXPECT_TRUE(reachability->IsConnected(constant1, copy));
+  EXPECT_TRUE(reachability->IsConnected(copy, constant1));
+  EXPECT_FALSE(reachability->IsConnected(negate, add));
+  EXPECT_FALSE(reachability->IsConnected(add, negate));
+}
+
+TEST_F(HloChainReachabilityMapTest, ChannelReachability) {
+  const Shape shape = ShapeUtil::MakeShape(F32, {5, 7});
+  HloComputation::Builder builder("ChannelReachability");
+  auto param = builder.AddInstruction(
+      HloInstruction::CreateParameter(0, shape, "param"));
+  auto token0 = builder.AddInstruction(HloInstruction::CreateToken());
+  auto send = builder.AddInstruction(HloInstruction::CreateSend(
+      param, token0, /*channel_id=*/1, /*is_host_transfer=*/false));
+  auto send_done = builder.AddInstruction(HloInstruction::CreateSendDone(
+      send, send->channel_id(), /*is_host_transfer=*/false));
+  auto token1 = builder.AddInstruction(HloInstruction::CreateToken());
+  auto recv = builder.AddInstruction(HloInstruction::CreateRecv(
+      shape, token1, /*channel_id=*/1, /*is_host_transfer=*/false));
+  auto recv_done = builder.AddInstruction(HloInstruction::CreateRecvDone(
+      recv, recv->channel_id(), /*is_host_transfer=*/false));
+
+  auto module = CreateNewVerifiedModule();
+  module->mutable_config().set_use_spmd_partitioning(false);
+  module->mutable_config().set_static_device_assignment(DeviceAssignment(1, 2));
+  auto computation = module->AddEntryComputation(builder.Build(recv_done));
+  auto reachability = HloChainReachabilityMap::Build(computation);
+  EXPECT_FALSE(reachability->IsReachable(param, recv_done));
+  EXPECT_FALSE(reachability->IsReachable(send, recv));
+  EXPECT_FALSE(reachability->IsReachable(send_done, recv));
+}
+
+TEST_F(HloChainReachabilityMapTest, MatchesHloReachabilityMap) {
+  // Build a random DAG where each instruction uses one or two of the previous
+  // instructions.
+  Shape r0f32 = ShapeUtil::MakeShape(F32, {});
+  auto builder = HloComputation::Builder(TestName());
+  std::minstd_rand rng(42);
+
+  std::vector<HloInstruction*> instructions;
+  for (int i = 0; i < 8; ++i) {
+    instructions.push_back(builder.AddInstruction(
+        HloInstruction::CreateParameter(i, r0f32, absl::StrCat("p", i))));
+  }
+  for (int i = 0; i < 200; ++i) {
+    // Prefer recent instructions to get long, narrow graphs.
+    auto pick = [&] {
+      size_t window = std::min<size_t>(instructions.size(), 16);
+      return instructions[instructions.size() - 1 - rng() % window];
+    };
+    instructions.push_back(builder.AddInstruction(
+        rng() % 2 ? HloInstruction::CreateUnary(r0f32, HloOpcode::kExp, pick())
+                  : HloInstruction::CreateBinary(r0f32, HloOpcode::kAdd,
+                                                 pick(), pick())));
+  }
+  HloInstruction* root = builder.AddInstruction(HloInstruction::CreateTuple(
+      absl::MakeSpan(instructions).subspan(instructions.size() - 16)));
+
+  auto module = CreateNewUnverifiedModule();
+  auto computation = module->AddEntryComputation(builder.Build(root));
+
+  auto expected = HloReachabilityMap::Build(computation);
+  auto reachability = HloChainReachabilityMap::Build(computation);
+  EXPECT_LT(reachability->num_chains(), computation->instruction_count());
+
+  for (const HloInstruction* a : computation->instructions()) {
+    for (const HloInstruction* b : computation->instructions()) {
+      EXPECT_EQ(reachability->IsReachable(a, b), expected->IsReachable(a, b))
+          << a->name() << " -> " << b->name();
+    }
+  }
+}
+
+class HloChainReachabilityBenchmark {
+ public:
+  HloChainReachabilityBenchmark(int size, std::string_view name)
+      : name_(name) {
+    Shape r0f32 = ShapeUtil::MakeShape(F32, {});
+    auto builder = HloComputation::Builder(name);
+
+    // Build a graph of chained Exponentials, i.e. Exp(...(Exp(Input))...).
+    HloInstruction* constant = builder.AddInstruction(
+        HloInstruction::CreateConstant(LiteralUtil::CreateR0<float>(2.0f)));
+    HloInstruction* prev = constant;
+    for (int i = 1; i < size; ++i) {
+      prev = builder.AddInstruction(
+          HloInstruction::CreateUnary(r0f32, HloOpcode::kExp, prev));
+    }
+
+    HloModuleConfig hlo_config;
+    module_ = std::make_unique<HloModule>(name_, hlo_config);
+    computation_ =
+        module_->AddEntryComputation(builder.Build(/*root_instruction=*/prev));
+  }
+
+  std::unique_ptr<HloChainReachabilityMap> Build() {
+    return HloChainReachabilityMap::Build(computation_);
+  }
+
+  const HloComputation* computation() { return computation_; }
+
+ private:
+  std::unique_ptr<HloModule> module_;
+  HloComputation* computation_;
+  const std::string name_;
+};
+
+void BM_HloChainReachabilityBuild(benchmark::State& state) {
+  int num_nodes = state.range(0);
+  HloChainReachabilityBenchmark bm(num_nodes, state.name());
+  while (state.KeepRunningBatch(num_nodes)) {
+    benchmark::DoNotOptimize(bm.Build());
+  }
+}
+
+void BM_HloChainReachabilityCheck(benchmark::State& state) {
+  size_t size = state.range(0);
+
+  HloChainReachabilityBenchmark bm(size, state.name());
+  auto reachability = bm.Build();
+  auto instrs = bm.computation()->MakeInstructionPostOrder();
+
+  size_t i = 0;
+  for (auto s : state) {
+    size_t from = i % size;
+    size_t to = (++i + size / 2) % size;
+    benchmark::DoNotOptimize(
+        reachability->IsReachable(instrs[from], instrs[to]));
+  }
+}
+
+// Goes beyond the sizes used for HloReachabilityMap, whose quadratic memory
+// usage makes it impractical for millions of instructions.
+#define BM_ARGS \
+  Arg(1)->Arg(64)->Arg(128)->Arg(256)->Range(512, 4 * 1024 * 1024)
+BENCHMARK(BM_HloChainReachabilityBuild)->BM_ARGS;
+BENCHMARK(BM_HloChainReachabilityCheck)->BM_ARGS;
+
+}  // namespace
+
+}  // namespace xla
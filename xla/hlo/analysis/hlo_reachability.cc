@@ -15,11 +15,17 @@ limitations under the License.
 
 #include "xla/hlo/analysis/hlo_reachability.h"
 
+#include <algorithm>
+#include <cstddef>
 #include <memory>
 #include <queue>
+#include <utility>
 #include <vector>
 
 #include "absl/algorithm/container.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/container/inlined_vector.h"
+#include "absl/types/span.h"
 #include "xla/hlo/ir/hlo_instruction.h"
 
 namespace xla {
@@ -138,6 +144,7 @@ std::unique_ptr<HloReachabilityMap> HloReachabilityMap::Build(
       absl::c_for_each(it->second, add_dependencies);
     }
   }
+  result->channel_dependencies_ = std::move(channel_dependencies);
   return result;
 }
 
@@ -168,4 +175,122 @@ void HloReachabilityMap::UpdateReachabilityThroughInstruction(
   }
 }
 
+void HloReachabilityMap::AddEdge(Index a, Index b) {
+  if (IsReachable(a, b)) return;
+  // 'a' can't be reachable from 'b' as the graph is acyclic, so its bit-set
+  // is not modified by the loop below.
+  DCHECK(!IsReachable(b, a));
+  const BitSet& a_bit_set = bit_sets_[a];
+  for (BitSet& bit_set : bit_sets_) {
+    if (bit_set.Get(b)) bit_set |= a_bit_set;
+  }
+}
+
+void HloReachabilityMap::RemoveEdge(const HloInstruction* a,
+                                    const HloInstruction* b) {
+  DCHECK(IsReachable(a, b));
+
+  // Instructions with channel dependencies are reachable from everything the
+  // other instructions of their channel group are reachable from (see Build).
+  auto channel_dependencies = [&](const HloInstruction* instruction)
+      -> absl::Span<HloInstruction* const> {
+    auto it = channel_dependencies_.find(instruction);
+    if (it == channel_dependencies_.end()) return {};
+    return it->second;
+  };
+
+  // Only 'b', instructions reachable from it and the channel groups of those
+  // can be affected.
+  std::vector<const HloInstruction*> affected;
+  absl::flat_hash_set<const HloInstruction*> visited;
+  auto visit = [&](const HloInstruction* successor) {
+    if (IsPresent(successor) && visited.insert(successor).second) {
+      affected.push_back(successor);
+    }
+  };
+  auto visit_with_channel_group = [&](const HloInstruction* successor) {
+    visit(successor);
+    absl::c_for_each(channel_dependencies(successor), visit);
+  };
+  visit_with_channel_group(b);
+  for (size_t i = 0; i < affected.size(); ++i) {
+    const HloInstruction* item = affected[i];
+    absl::c_for_each(item->users(), visit_with_channel_group);
+    absl::c_for_each(item->control_successors(), visit_with_channel_group);
+  }
+
+  // The reachability set of an instruction is a strict superset of the
+  // reachability sets of its predecessors, so sorting by the size of the
+  // (not yet updated) sets gives a topological order.
+  std::vector<std::pair<size_t, const HloInstruction*>> order;
+  order.reserve(affected.size());
+  for (const HloInstruction* instruction : affected) {
+    order.push_back({bit_sets_[GetIndex(instruction)].Count(), instruction});
+  }
+  absl::c_stable_sort(order, [](const auto& x, const auto& y) {
+    return x.first < y.first;
+  });
+
+  // Recompute the reachability of every affected instruction once, skipping
+  // instructions none of whose predecessors changed. The predecessors of 'b'
+  // changed, so 'b' and the rest of its channel group are always recomputed.
+  absl::flat_hash_set<const HloInstruction*> changed;
+  auto is_changed = [&](const HloInstruction* predecessor) {
+    return changed.contains(predecessor);
+  };
+  auto add_inputs = [](const HloInstruction* instruction,
+                       std::vector<HloInstruction*>& inputs) {
+    inputs.insert(inputs.end(), instruction->operands().begin(),
+                  instruction->operands().end());
+    inputs.insert(inputs.end(), instruction->control_predecessors().begin(),
+                  instruction->control_predecessors().end());
+  };
+
+  std::vector<HloInstruction*> inputs;
+  for (const auto& [count, item] : order) {
+    inputs.clear();
+    add_inputs(item, inputs);
+    for (const HloInstruction* dependency : channel_dependencies(item)) {
+      add_inputs(dependency, inputs);
+    }
+    if (item != b && !absl::c_linear_search(channel_dependencies(b), item) &&
+        !absl::c_any_of(inputs, is_changed)) {
+      continue;
+    }
+    if (SetReachabilityToUnion(inputs, item)) changed.insert(item);
+  }
+}
+
+void HloReachabilityMap::FuseInstructions(
+    absl::Span<const HloInstruction* const> instructions,
+    const HloInstruction* fusion) {
+  CHECK(!instructions.empty());
+
+  absl::InlinedVector<Index, 4> fused;
+  fused.reserve(instructions.size());
+  for (const HloInstruction* instruction : instructions) {
+    fused.push_back(GetIndex(instruction));
+  }
+
+  // The fused node is reachable from everything any of the fused instructions
+  // is reachable from.
+  tmp_bit_set_ = bit_sets_[fused.front()];
+  for (Index index : absl::MakeSpan(fused).subspan(1)) {
+    tmp_bit_set_ |= bit_sets_[index];
+  }
+
+  // Everything reachable from one of the fused instructions (including the
+  // fused instructions themselves) becomes reachable from the fused node.
+  auto reaches = [&](const BitSet& bit_set) {
+    return absl::c_any_of(fused, [&](Index index) {
+      return bit_set.Get(index);
+    });
+  };
+  for (BitSet& bit_set : bit_sets_) {
+    if (reaches(bit_set)) bit_set |= tmp_bit_set_;
+  }
+
+  if (!IsPresent(fusion)) Replace(instructions.back(), fusion);
+}
+
 }  // namespace xla
@@ -16,12 +16,15 @@ limitations under the License.
 #ifndef XLA_HLO_ANALYSIS_HLO_REACHABILITY_H_
 #define XLA_HLO_ANALYSIS_HLO_REACHABILITY_H_
 
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <utility>
 #include <vector>
 
 #include "absl/algorithm/container.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/numeric/bits.h"
 #include "absl/types/span.h"
 #include "xla/hlo/ir/hlo_computation.h"
 #include "xla/hlo/ir/hlo_instruction.h"
@@ -108,6 +111,37 @@ class HloReachabilityMap {
   // (operands and control predecessors) of 'instruction' has changed.
   void UpdateReachabilityThroughInstruction(const HloInstruction* instruction);
 
+  // Incremental updates. Unlike SetReachable and SetReachabilityToUnion the
+  // methods below keep the map transitive, so passes can keep a single map
+  // up to date while they rewrite the graph instead of rebuilding it.
+
+  // Updates the map after an edge (operand or control dependency) from 'a' to
+  // 'b' has been added to the graph: every instruction reachable from 'b'
+  // becomes reachable from everything 'a' is reachable from. Does not look at
+  // the HLO graph, so it can also be used to record artificial edges.
+  void AddEdge(const HloInstruction* a, const HloInstruction* b) {
+    AddEdge(GetIndex(a), GetIndex(b));
+  }
+  void AddEdge(Index a, Index b);
+
+  // Updates the map after an edge from 'a' to 'b' has been removed from the
+  // graph. Recomputes the reachability of 'b' and of its transitive users from
+  // their current operands and control predecessors, visiting each of them at
+  // most once in topological order. Maps created by Build also keep the
+  // channel dependencies of the computation, which are taken into account in
+  // the same way as Build does.
+  void RemoveEdge(const HloInstruction* a, const HloInstruction* b);
+
+  // Updates the map after 'instructions' have been fused into 'fusion'. All
+  // of 'instructions' are merged into a single node, which is reachable from
+  // everything any of them was reachable from and reaches everything any of
+  // them reached. If 'fusion' is not yet present in the map it takes the
+  // place of the last of 'instructions' (see Replace). The caller must make
+  // sure that fusion does not introduce a cycle, i.e. that there is no path
+  // between two of 'instructions' that leaves the fused set.
+  void FuseInstructions(absl::Span<const HloInstruction* const> instructions,
+                        const HloInstruction* fusion);
+
   // Returns true if "b" is reachable from "a"
   //
   // Note that this function only correctly answers queries about reachability
@@ -177,6 +211,13 @@ class HloReachabilityMap {
     // Sets the bitvector to all zeros.
     void SetToZero() { absl::c_fill(vector_, 0); }
 
+    // Returns the number of set bits.
+    size_t Count() const {
+      size_t count = 0;
+      for (Word word : vector_) count += absl::popcount(word);
+      return count;
+    }
+
     bool operator==(const BitSet& other) const {
       return vector_ == other.vector_;
     }
@@ -214,6 +255,10 @@ class HloReachabilityMap {
   // A temporary used by SetReachabilityToUnion to avoid an allocation with each
   // call to the method.
   BitSet tmp_bit_set_;
+
+  // Channel dependencies between collectives that Build added to the map,
+  // kept so that RemoveEdge can recompute reachability the same way.
+  HloComputation::ChannelDependencies channel_dependencies_;
 };
 
 }  // namespace xla
@@ -15,10 +15,13 @@ limitations under the License.
 
 #include "xla/hlo/analysis/hlo_reachability.h"
 
+#include <algorithm>
+#include <cstddef>
 #include <memory>
 #include <set>
 #include <string>
 #include <string_view>
+#include <vector>
 
 #include "absl/random/random.h"
 #include "xla/hlo/ir/hlo_instruction.h"
@@ -31,6 +34,7 @@ limitations under the License.
 #include "xla/shape_util.h"
 #include "xla/test.h"
 #include "xla/test_helpers.h"
+#include "xla/tsl/lib/core/status_test_util.h"
 #include "tsl/platform/status.h"
 #include "tsl/platform/test_benchmark.h"
 
@@ -253,6 +257,142 @@ TEST_F(HloReachabilityTest, ReplaceInstructions) {
   EXPECT_TRUE(reachability->IsReachable(p0, fusion));
 }
 
+TEST_F(HloReachabilityTest, AddAndRemoveEdge) {
+  auto module = ParseAndReturnVerifiedModule(R"(
+    HloModule test
+
+    ENTRY entry {
+      p0 = f32[] parameter(0)
+      p1 = f32[] parameter(1)
+      a = f32[] negate(p0)
+      b = f32[] exponential(a)
+      c = f32[] negate(p1)
+      d = f32[] exponential(c)
+      ROOT tuple = (f32[], f32[]) tuple(b, d)
+    })")
+                    .value();
+  auto computation = module->entry_computation();
+  auto reachability = HloReachabilityMap::Build(computation);
+  HloInstruction* a = FindInstruction(module.get(), "a");
+  HloInstruction* b = FindInstruction(module.get(), "b");
+  HloInstruction* c = FindInstruction(module.get(), "c");
+  HloInstruction* d = FindInstruction(module.get(), "d");
+  EXPECT_FALSE(reachability->IsConnected(a, d));
+
+  TF_ASSERT_OK(b->AddControlDependencyTo(c));
+  reachability->AddEdge(b, c);
+  EXPECT_TRUE(reachability->IsReachable(a, c));
+  EXPECT_TRUE(reachability->IsReachable(a, d));
+  EXPECT_FALSE(reachability->IsReachable(d, a));
+
+  // The map must match a map built from scratch.
+  auto expected = HloReachabilityMap::Build(computation);
+  for (const HloInstruction* x : computation->instructions()) {
+    for (const HloInstruction* y : computation->instructions()) {
+      EXPECT_EQ(reachability->IsReachable(x, y), expected->IsReachable(x, y));
+    }
+  }
+
+  TF_ASSERT_OK(b->RemoveControlDependencyTo(c));
+  reachability->RemoveEdge(b, c);
+  EXPECT_FALSE(reachability->IsConnected(a, c));
+  EXPECT_FALSE(reachability->IsConnected(a, d));
+  EXPECT_TRUE(reachability->IsReachable(c, d));
+}
+
+TEST_F(HloReachabilityTest, RemoveEdgeKeepsChannelReachability) {
+  // Collectives in the same channel group depend on each other's operands,
+  // so 'c' is reachable from 'a' although no data or control path exists.
+  auto module = ParseAndReturnVerifiedModule(R"(
+    HloModule test
+
+    sum {
+      x = f32[] parameter(0)
+      y = f32[] parameter(1)
+      ROOT add = f32[] add(x, y)
+    }
+
+    ENTRY entry {
+      p0 = f32[] parameter(0)
+      p1 = f32[] parameter(1)
+      a = f32[] negate(p0)
+      ar0 = f32[] all-reduce(a), channel_id=1, to_apply=sum
+      b = f32[] negate(p1)
+      ar1 = f32[] all-reduce(b), channel_id=1, to_apply=sum
+      c = f32[] exponential(ar1)
+      ROOT tuple = (f32[], f32[]) tuple(ar0, c)
+    })")
+                    .value();
+  auto computation = module->entry_computation();
+  auto reachability = HloReachabilityMap::Build(computation);
+  HloInstruction* p0 = FindInstruction(module.get(), "p0");
+  HloInstruction* a = FindInstruction(module.get(), "a");
+  HloInstruction* b = FindInstruction(module.get(), "b");
+  HloInstruction* c = FindInstruction(module.get(), "c");
+  ASSERT_TRUE(reachability->IsReachable(a, c));
+
+  // Add and remove an edge that is unrelated to the channel dependencies.
+  TF_ASSERT_OK(p0->AddControlDependencyTo(b));
+  reachability->AddEdge(p0, b);
+  TF_ASSERT_OK(p0->RemoveControlDependencyTo(b));
+  reachability->RemoveEdge(p0, b);
+
+  // The map must match a map built from scratch.
+  auto expected = HloReachabilityMap::Build(computation);
+  for (const HloInstruction* x : computation->instructions()) {
+    for (const HloInstruction* y : computation->instructions()) {
+      EXPECT_EQ(reachability->IsReachable(x, y), expected->IsReachable(x, y))
+          << x->name() << " -> " << y->name();
+    }
+  }
+  EXPECT_TRUE(reachability->IsReachable(a, c));
+}
+
+TEST_F(HloReachabilityTest, FuseInstructions) {
+  auto module = ParseAndReturnVerifiedModule(R"(
+    HloModule test
+
+    ENTRY entry {
+      p0 = f32[] parameter(0)
+      p1 = f32[] parameter(1)
+      a = f32[] negate(p0)
+      b = f32[] negate(p1)
+      c = f32[] exponential(a)
+      d = f32[] exponential(b)
+      ROOT tuple = (f32[], f32[]) tuple(c, d)
+    })")
+                    .value();
+  auto computation = module->entry_computation();
+  auto reachability = HloReachabilityMap::Build(computation);
+  HloInstruction* p0 = FindInstruction(module.get(), "p0");
+  HloInstruction* p1 = FindInstruction(module.get(), "p1");
+  HloInstruction* a = FindInstruction(module.get(), "a");
+  HloInstruction* b = FindInstruction(module.get(), "b");
+  HloInstruction* c = FindInstruction(module.get(), "c");
+  HloInstruction* d = FindInstruction(module.get(), "d");
+  EXPECT_FALSE(reachability->IsReachable(p1, c));
+
+  // Sibling fusion of `a` and `b` into `a`: both users now depend on both
+  // parameters.
+  reachability->FuseInstructions({a, b}, a);
+  EXPECT_TRUE(reachability->IsReachable(p0, a));
+  EXPECT_TRUE(reachability->IsReachable(p1, a));
+  EXPECT_TRUE(reachability->IsReachable(p1, c));
+  EXPECT_TRUE(reachability->IsReachable(p0, d));
+  EXPECT_TRUE(reachability->IsReachable(a, d));
+  EXPECT_FALSE(reachability->IsConnected(c, d));
+
+  // Producer-consumer fusion of `d` into a new fusion instruction.
+  auto* fusion = computation->AddInstruction(HloInstruction::CreateFusion(
+      d->shape(), HloInstruction::FusionKind::kLoop, d));
+  reachability->FuseInstructions({a, d}, fusion);
+  EXPECT_TRUE(reachability->IsPresent(fusion));
+  EXPECT_FALSE(reachability->IsPresent(d));
+  EXPECT_TRUE(reachability->IsReachable(p0, fusion));
+  EXPECT_TRUE(reachability->IsReachable(p1, fusion));
+  EXPECT_TRUE(reachability->IsReachable(fusion, c));
+}
+
 }  // namespace
 
 class HloReachabilityMapBitSetBenchmark {
@@ -268,6 +408,7 @@ class HloReachabilityMapBitSetBenchmark {
     }
   }
   void Union() { a_ |= b_; }
+  size_t Count() const { return a_.Count(); }
 
  private:
   HloReachabilityMap::BitSet a_;
@@ -282,8 +423,19 @@ void BM_HloReachabilityBitSetUnion(benchmark::State& state) {
     bm.Union();
   }
 }
+
+void BM_HloReachabilityBitSetCount(benchmark::State& state) {
+  HloReachabilityMapBitSetBenchmark bm(state.range(0));
+  for (auto s : state) {
+    benchmark::DoNotOptimize(bm.Count());
+  }
+}
 #define BM_ARGS Arg(1)->Arg(64)->Arg(128)->Arg(256)->Range(512, 256 * 1024)
-BENCHMARK(BM_HloReachabilityBitSetUnion)->BM_ARGS;
+// Incremental updates scan all bit-sets, so bit-set operations are also
+// measured for the sizes of very large computations.
+#define BM_BIT_SET_ARGS BM_ARGS->Arg(1024 * 1024)->Arg(4 * 1024 * 1024)
+BENCHMARK(BM_HloReachabilityBitSetUnion)->BM_BIT_SET_ARGS;
+BENCHMARK(BM_HloReachabilityBitSetCount)->BM_BIT_SET_ARGS;
 
 class HloReachabilityBenchmark {
  public:
@@ -323,6 +475,44 @@ void BM_HloReachabilityBuild(benchmark::State& state) {
 }
 BENCHMARK(BM_HloReachabilityBuild)->BM_ARGS;
 
+// Adds and removes a control dependency between two independent chains of
+// `size / 2` instructions, which is what passes do instead of rebuilding the
+// map from scratch.
+void BM_HloReachabilityAddRemoveEdge(benchmark::State& state) {
+  int size = state.range(0);
+  Shape r0f32 = ShapeUtil::MakeShape(F32, {});
+  auto builder = HloComputation::Builder(state.name());
+
+  auto make_chain = [&](float value) {
+    std::vector<HloInstruction*> chain = {builder.AddInstruction(
+        HloInstruction::CreateConstant(LiteralUtil::CreateR0<float>(value)))};
+    for (int i = 1; i < std::max(size / 2, 1); ++i) {
+      chain.push_back(builder.AddInstruction(
+          HloInstruction::CreateUnary(r0f32, HloOpcode::kExp, chain.back())));
+    }
+    return chain;
+  };
+  std::vector<HloInstruction*> lhs = make_chain(1.0f);
+  std::vector<HloInstruction*> rhs = make_chain(2.0f);
+  HloInstruction* root = builder.AddInstruction(
+      HloInstruction::CreateTuple({lhs.back(), rhs.back()}));
+
+  HloModule module(state.name(), HloModuleConfig());
+  HloComputation* computation =
+      module.AddEntryComputation(builder.Build(/*root_instruction=*/root));
+  auto reachability = HloReachabilityMap::Build(computation);
+
+  HloInstruction* from = lhs[lhs.size() / 2];
+  HloInstruction* to = rhs.front();
+  for (auto s : state) {
+    TF_CHECK_OK(from->AddControlDependencyTo(to));
+    reachability->AddEdge(from, to);
+    TF_CHECK_OK(from->RemoveControlDependencyTo(to));
+    reachability->RemoveEdge(from, to);
+  }
+}
+BENCHMARK(BM_HloReachabilityAddRemoveEdge)->BM_ARGS;
+
 }  // namespace
 
 }  // namespace xla
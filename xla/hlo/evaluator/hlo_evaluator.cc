@@ -22,6 +22,7 @@ limitations under the License.
 #include <cstdint>
 #include <cstdlib>
 #include <cstring>
+#include <deque>
 #include <functional>
 #include <iterator>
 #include <limits>
@@ -48,6 +49,7 @@ limitations under the License.
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/types/span.h"
 #include "Eigen/Core"
 #include "xla/array2d.h"
@@ -157,15 +159,15 @@ std::optional<bool> GetInstructionStaticValueAsBool(
 }
 
 template <PrimitiveType kType>
-struct PopulateParallelImpl {
+struct PopulateParallelTiledImpl {
   using NativeT = NativeTypeOf<kType>;
   static absl::Status Run(
       Literal& literal,
       absl::FunctionRef<Literal(absl::Span<const int64_t>, int)>
           literal_generator) {
-    return literal.PopulateParallel<NativeT>(
-        [&literal_generator](absl::Span<const int64_t> output_index,
-                             int thread_id) {
+    return HloEvaluator::PopulateParallelTiled<NativeT>(
+        literal, [&literal_generator](absl::Span<const int64_t> output_index,
+                                      int thread_id) {
           return literal_generator(output_index, thread_id)
               .template Get<NativeT>({});
         });
@@ -929,7 +931,11 @@ absl::StatusOr<Literal> HloEvaluator::Evaluate(
   }
   engine_.seed(seed_);
 
-  TF_RETURN_IF_ERROR(computation.Accept(this));
+  if (inter_op_thread_pool_ != nullptr) {
+    TF_RETURN_IF_ERROR(EvaluateConcurrently(computation));
+  } else {
+    TF_RETURN_IF_ERROR(computation.Accept(this));
+  }
   const Literal& result =
       GetEvaluatedLiteralFor(computation.root_instruction());
   if (VLOG_IS_ON(100)) {
@@ -943,6 +949,187 @@ absl::StatusOr<Literal> HloEvaluator::Evaluate(
   return result.Clone();
 }
 
+void HloEvaluator::set_inter_op_parallelism(int num_threads) {
+  inter_op_thread_pool_.reset();
+  if (num_threads > 1) {
+    inter_op_thread_pool_ = std::make_unique<tsl::thread::ThreadPool>(
+        tsl::Env::Default(), "hlo_evaluator", num_threads);
+  }
+}
+
+// Returns true if evaluating `instruction` only reads the literals of its
+// operands and writes its own literal, so it can run concurrently with other
+// such instructions.
+static bool CanEvaluateConcurrently(const HloInstruction* instruction) {
+  if (instruction->HasSideEffect()) {
+    return false;
+  }
+  if (instruction->IsElementwise()) {
+    return true;
+  }
+  switch (instruction->opcode()) {
+    case HloOpcode::kBroadcast:
+    case HloOpcode::kConcatenate:
+    case HloOpcode::kConstant:
+    case HloOpcode::kConvolution:
+    case HloOpcode::kDot:
+    case HloOpcode::kDynamicSlice:
+    case HloOpcode::kGather:
+    case HloOpcode::kGetTupleElement:
+    case HloOpcode::kIota:
+    case HloOpcode::kPad:
+    case HloOpcode::kParameter:
+    case HloOpcode::kReduce:
+    case HloOpcode::kReduceWindow:
+    case HloOpcode::kReshape:
+    case HloOpcode::kReverse:
+    case HloOpcode::kSlice:
+    case HloOpcode::kTranspose:
+    case HloOpcode::kTuple:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Returns true if `instruction` is expensive enough to be worth a thread hop.
+// Cheaper instructions are evaluated inline by the scheduling thread.
+static bool IsWorthDispatching(const HloInstruction* instruction) {
+  static constexpr int64_t kMinDispatchElements = 16 * 1024;
+  switch (instruction->opcode()) {
+    case HloOpcode::kConvolution:
+    case HloOpcode::kDot:
+    case HloOpcode::kMap:
+    case HloOpcode::kReduce:
+    case HloOpcode::kReduceWindow:
+      return true;
+    case HloOpcode::kConstant:
+    case HloOpcode::kGetTupleElement:
+    case HloOpcode::kParameter:
+    case HloOpcode::kTuple:
+      return false;
+    default:
+      return instruction->shape().IsArray() &&
+             ShapeUtil::ElementsIn(instruction->shape()) >=
+                 kMinDispatchElements;
+  }
+}
+
+absl::Status HloEvaluator::EvaluateConcurrently(
+    const HloComputation& computation) {
+  std::vector<HloInstruction*> post_order =
+      computation.MakeInstructionPostOrder();
+
+  // Instructions in flight insert their results into `evaluated_` while other
+  // threads look up operands.
+  evaluated_.set_synchronized(true);
+  absl::Cleanup unsynchronize = [this] { evaluated_.set_synchronized(false); };
+
+  // Number of operands and control predecessors that are not evaluated yet.
+  absl::flat_hash_map<const HloInstruction*, int64_t> num_pending;
+  std::deque<const HloInstruction*> ready;
+  std::vector<const HloInstruction*> serial;
+  for (const HloInstruction* instruction : post_order) {
+    int64_t pending = instruction->unique_operands().size() +
+                      instruction->control_predecessors().size();
+    num_pending[instruction] = pending;
+    if (CanEvaluateConcurrently(instruction)) {
+      if (pending == 0) ready.push_back(instruction);
+    } else {
+      serial.push_back(instruction);
+    }
+  }
+
+  auto evaluate = [this](const HloInstruction* instruction) -> absl::Status {
+    TF_RETURN_IF_ERROR(Preprocess(instruction));
+    TF_RETURN_IF_ERROR(instruction->Visit(this));
+    return Postprocess(instruction);
+  };
+
+  // Marks `instruction` as evaluated and collects users that became ready.
+  // Serial instructions are tracked by `num_pending` only.
+  auto finish = [&](const HloInstruction* instruction) {
+    auto release = [&](const HloInstruction* successor) {
+      if (--num_pending[successor] == 0 &&
+          CanEvaluateConcurrently(successor)) {
+        ready.push_back(successor);
+      }
+    };
+    for (const HloInstruction* user : instruction->users()) release(user);
+    for (const HloInstruction* successor :
+         instruction->control_successors()) {
+      release(successor);
+    }
+  };
+
+  absl::Mutex mu;
+  std::vector<std::pair<const HloInstruction*, absl::Status>> completed;
+  int64_t num_in_flight = 0;
+  int64_t next_serial = 0;
+  absl::Status status;
+
+  while (true) {
+    // Serial instructions run in post order, on this thread and only when no
+    // other instruction is in flight. Once the next one is ready we stop
+    // dispatching new work until it has been evaluated.
+    bool serial_ready = next_serial < serial.size() &&
+                        num_pending[serial[next_serial]] == 0;
+    if (status.ok() && serial_ready && num_in_flight == 0) {
+      const HloInstruction* instruction = serial[next_serial++];
+      status = evaluate(instruction);
+      finish(instruction);
+      continue;
+    }
+
+    while (status.ok() && !serial_ready && !ready.empty()) {
+      const HloInstruction* instruction = ready.front();
+      ready.pop_front();
+      if (!IsWorthDispatching(instruction)) {
+        status = evaluate(instruction);
+        finish(instruction);
+        serial_ready = next_serial < serial.size() &&
+                       num_pending[serial[next_serial]] == 0;
+        continue;
+      }
+      ++num_in_flight;
+      inter_op_thread_pool_->Schedule([&, instruction] {
+        absl::Status instruction_status = evaluate(instruction);
+        absl::MutexLock lock(&mu);
+        completed.push_back({instruction, std::move(instruction_status)});
+      });
+    }
+
+    if (num_in_flight == 0) {
+      if (!status.ok()) return status;
+      if (ready.empty()) {
+        if (next_serial == serial.size()) break;
+        TF_RET_CHECK(num_pending[serial[next_serial]] == 0)
+            << "No instruction is ready for evaluation in "
+            << computation.name();
+      }
+      continue;
+    }
+
+    // Wait for at least one in flight instruction to finish.
+    std::vector<std::pair<const HloInstruction*, absl::Status>> finished;
+    {
+      absl::MutexLock lock(&mu);
+      mu.Await(absl::Condition(
+          +[](std::vector<std::pair<const HloInstruction*, absl::Status>>*
+                  completed) { return !completed->empty(); },
+          &completed));
+      finished.swap(completed);
+    }
+    for (auto& [instruction, instruction_status] : finished) {
+      --num_in_flight;
+      status.Update(instruction_status);
+      finish(instruction);
+    }
+  }
+
+  return FinishVisit(computation.root_instruction());
+}
+
 absl::StatusOr<Literal> HloEvaluator::Evaluate(
     const HloInstruction* instruction, PrecomputedAnalyses precomputed_analyses,
     bool recursively_evaluate_nonconstant_operands) {
@@ -4416,6 +4603,310 @@ static absl::StatusOr<bool> GenerateReduceOutputElement(
   return true;
 }
 
+// Returns the opcode of a reducer that applies a single elementwise binary op
+// to its two scalar parameters, or std::nullopt for any other computation.
+// Sets `accumulator_is_lhs` if the accumulator (parameter 0) is the left hand
+// side of the op.
+static std::optional<HloOpcode> MatchScalarBinaryReducer(
+    const HloComputation* function, bool* accumulator_is_lhs) {
+  const HloInstruction* root = function->root_instruction();
+  if (function->num_parameters() != 2 || root->operand_count() != 2 ||
+      !ShapeUtil::IsScalar(root->shape())) {
+    return std::nullopt;
+  }
+  const HloInstruction* lhs = root->operand(0);
+  const HloInstruction* rhs = root->operand(1);
+  if (lhs->opcode() != HloOpcode::kParameter ||
+      rhs->opcode() != HloOpcode::kParameter || lhs == rhs ||
+      !ShapeUtil::SameElementType(lhs->shape(), root->shape()) ||
+      !ShapeUtil::SameElementType(rhs->shape(), root->shape())) {
+    return std::nullopt;
+  }
+  switch (root->opcode()) {
+    case HloOpcode::kAdd:
+    case HloOpcode::kMultiply:
+    case HloOpcode::kMaximum:
+    case HloOpcode::kMinimum:
+    case HloOpcode::kAnd:
+    case HloOpcode::kOr:
+      *accumulator_is_lhs = lhs->parameter_number() == 0;
+      return root->opcode();
+    default:
+      return std::nullopt;
+  }
+}
+
+namespace {
+
+// Describes how a bulk reduction walks a dense input buffer: the elements
+// reduced into an output element are found at fixed offsets from a base that
+// depends only on the output index.
+struct BulkReduceIndexing {
+  // Returns the input linear index of the first reduced element of the output
+  // element at `output_linear_index`.
+  int64_t InputBase(int64_t output_linear_index) const {
+    DimensionVector output_index =
+        IndexUtil::LinearIndexToMultidimensionalIndex(*output_shape,
+                                                      output_linear_index);
+    int64_t base = 0;
+    for (int64_t i = 0; i < output_index.size(); ++i) {
+      base += output_index[i] * output_strides[i];
+    }
+    return base;
+  }
+
+  const Shape* output_shape;
+  // Input strides of the non-reduced dimensions, in output dimension order.
+  DimensionVector output_strides;
+  int64_t num_reduced;
+  // Offsets of the reduced elements in iteration order. Empty if the reduced
+  // dimensions are the most minor ones and the offsets are 0..num_reduced-1.
+  std::vector<int64_t> offsets;
+};
+
+// Bulk reductions with more reduced elements than this that don't reduce the
+// most minor dimensions fall back to the generic path instead of building a
+// large offsets table.
+constexpr int64_t kMaxBulkReduceOffsets = 1 << 20;
+
+// Output chunks smaller than this many input elements run on a single thread.
+constexpr int64_t kMinBulkReduceChunkSize = 64 * 1024;
+
+// Reduces `input` into `result` with `combine`, visiting the reduced elements
+// in the same order as the generic path.
+template <typename NativeT, typename Combine>
+void BulkReduceLoop(const Literal& input, NativeT init,
+                    const BulkReduceIndexing& indexing, Literal& result,
+                    Combine combine) {
+  absl::Span<const NativeT> in = input.data<NativeT>();
+  absl::Span<NativeT> out = result.data<NativeT>();
+  HloEvaluator::ForEachLinearChunk(
+      out.size(),
+      CeilOfRatio(kMinBulkReduceChunkSize,
+                  std::max<int64_t>(indexing.num_reduced, 1)),
+      [&](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; ++i) {
+          const NativeT* base = in.data() + indexing.InputBase(i);
+          NativeT acc = init;
+          if (indexing.offsets.empty()) {
+            for (int64_t j = 0; j < indexing.num_reduced; ++j) {
+              acc = combine(acc, base[j]);
+            }
+          } else {
+            for (int64_t offset : indexing.offsets) {
+              acc = combine(acc, base[offset]);
+            }
+          }
+          out[i] = acc;
+        }
+      });
+}
+
+// Floating point additions accumulate in double, in chunks of the same size as
+// the per-element fast path, so both paths produce bit-identical results.
+template <typename NativeT>
+void BulkReduceAddAsDouble(const Literal& input, double init,
+                           const BulkReduceIndexing& indexing,
+                           Literal& result) {
+  static constexpr int64_t kChunkSize = 512;
+  absl::Span<const NativeT> in = input.data<NativeT>();
+  absl::Span<NativeT> out = result.data<NativeT>();
+  auto element = [&](const NativeT* base, int64_t j) {
+    return static_cast<double>(
+        indexing.offsets.empty() ? base[j] : base[indexing.offsets[j]]);
+  };
+  HloEvaluator::ForEachLinearChunk(
+      out.size(),
+      CeilOfRatio(kMinBulkReduceChunkSize,
+                  std::max<int64_t>(indexing.num_reduced, 1)),
+      [&](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; ++i) {
+          const NativeT* base = in.data() + indexing.InputBase(i);
+          double acc = init;
+          for (int64_t j = 0; j < indexing.num_reduced; j += kChunkSize) {
+            double partial = 0.0;
+            int64_t chunk_end =
+                std::min(j + kChunkSize, indexing.num_reduced);
+            for (int64_t k = j; k < chunk_end; ++k) {
+              partial += element(base, k);
+            }
+            acc += partial;
+          }
+          out[i] = static_cast<NativeT>(acc);
+        }
+      });
+}
+
+template <typename NativeT>
+bool BulkReduceTyped(HloOpcode opcode, bool accumulator_is_lhs,
+                     const Literal& input, const Literal& init_value,
+                     const BulkReduceIndexing& indexing, Literal& result) {
+  constexpr PrimitiveType kType =
+      primitive_util::NativeToPrimitiveType<NativeT>();
+  NativeT init = init_value.GetFirstElement<NativeT>();
+
+  if constexpr (primitive_util::IsFloatingPointType(kType)) {
+    if (opcode == HloOpcode::kAdd) {
+      BulkReduceAddAsDouble<NativeT>(input, static_cast<double>(init),
+                                     indexing, result);
+      return true;
+    }
+  }
+
+  // Maximum and minimum propagate the first NaN and keep the left hand side
+  // on ties, so the order of operands matters.
+  if constexpr (std::is_same_v<NativeT, float> ||
+                std::is_same_v<NativeT, double>) {
+    if (opcode != HloOpcode::kMaximum && opcode != HloOpcode::kMinimum) {
+      return false;
+    }
+    bool is_max = opcode == HloOpcode::kMaximum;
+    auto min_max = [is_max](NativeT lhs, NativeT rhs) {
+      if (std::isnan(lhs)) return lhs;
+      if (std::isnan(rhs)) return rhs;
+      return is_max ? std::max(lhs, rhs) : std::min(lhs, rhs);
+    };
+    if (accumulator_is_lhs) {
+      BulkReduceLoop<NativeT>(input, init, indexing, result, min_max);
+    } else {
+      BulkReduceLoop<NativeT>(
+          input, init, indexing, result,
+          [&](NativeT acc, NativeT x) { return min_max(x, acc); });
+    }
+    return true;
+  }
+
+  // Integer reductions are associative and commutative, additions and
+  // multiplications wrap around like in the typed visitor.
+  if constexpr (std::is_integral_v<NativeT>) {
+    switch (opcode) {
+      case HloOpcode::kAnd:
+        BulkReduceLoop<NativeT>(
+            input, init, indexing, result,
+            [](NativeT acc, NativeT x) -> NativeT { return acc & x; });
+        return true;
+      case HloOpcode::kOr:
+        BulkReduceLoop<NativeT>(
+            input, init, indexing, result,
+            [](NativeT acc, NativeT x) -> NativeT { return acc | x; });
+        return true;
+      case HloOpcode::kMaximum:
+        BulkReduceLoop<NativeT>(
+            input, init, indexing, result,
+            [](NativeT acc, NativeT x) { return std::max(acc, x); });
+        return true;
+      case HloOpcode::kMinimum:
+        BulkReduceLoop<NativeT>(
+            input, init, indexing, result,
+            [](NativeT acc, NativeT x) { return std::min(acc, x); });
+        return true;
+      default:
+        break;
+    }
+    if constexpr (!std::is_same_v<NativeT, bool>) {
+      if (opcode == HloOpcode::kAdd) {
+        BulkReduceLoop<NativeT>(
+            input, init, indexing, result, [](NativeT acc, NativeT x) {
+              return static_cast<NativeT>(static_cast<uint64_t>(acc) +
+                                          static_cast<uint64_t>(x));
+            });
+        return true;
+      }
+      if (opcode == HloOpcode::kMultiply) {
+        BulkReduceLoop<NativeT>(
+            input, init, indexing, result, [](NativeT acc, NativeT x) {
+              return static_cast<NativeT>(static_cast<uint64_t>(acc) *
+                                          static_cast<uint64_t>(x));
+            });
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
+// Reduces `input` with a scalar binary reducer by walking its buffer directly
+// instead of evaluating `function` with an embedded evaluator for every
+// element. Returns false and leaves `result` untouched if the reducer or the
+// literals are not supported.
+static bool BulkReduce(const Literal& input, const Literal& init_value,
+                       const HloComputation* function,
+                       absl::Span<const int64_t> dimensions_to_reduce,
+                       Literal& result) {
+  bool accumulator_is_lhs = true;
+  std::optional<HloOpcode> opcode =
+      MatchScalarBinaryReducer(function, &accumulator_is_lhs);
+  if (!opcode.has_value()) return false;
+
+  const Shape& input_shape = input.shape();
+  const Shape& result_shape = result.shape();
+  if (!LayoutUtil::IsDenseArray(input_shape) || !input_shape.is_static() ||
+      !LayoutUtil::IsDenseArray(result_shape) || !result_shape.is_static() ||
+      input_shape.element_type() != result_shape.element_type() ||
+      init_value.shape().element_type() != result_shape.element_type() ||
+      function->root_instruction()->shape().element_type() !=
+          result_shape.element_type()) {
+    return false;
+  }
+
+  BulkReduceIndexing indexing;
+  indexing.output_shape = &result_shape;
+  indexing.num_reduced = 1;
+  std::vector<bool> is_reduced(input_shape.rank(), false);
+  for (int64_t dim : dimensions_to_reduce) {
+    is_reduced[dim] = true;
+    indexing.num_reduced *= input_shape.dimensions(dim);
+  }
+  for (int64_t dim = 0; dim < input_shape.rank(); ++dim) {
+    if (!is_reduced[dim]) {
+      indexing.output_strides.push_back(
+          IndexUtil::GetDimensionStride(input_shape, dim));
+    }
+  }
+
+  // If the reduced dimensions are the most minor ones, every output element
+  // reduces a contiguous span of the input.
+  absl::Span<const int64_t> minor_to_major =
+      LayoutUtil::MinorToMajor(input_shape);
+  bool is_contiguous = absl::c_all_of(
+      minor_to_major.first(dimensions_to_reduce.size()),
+      [&](int64_t dim) { return is_reduced[dim]; });
+
+  if (!is_contiguous) {
+    if (indexing.num_reduced > kMaxBulkReduceOffsets) return false;
+    // Visit the reduced elements in the same order as the generic path.
+    std::vector<int64_t> base(input_shape.rank(), 0);
+    std::vector<int64_t> counts(input_shape.rank(), 0);
+    std::vector<int64_t> steps(input_shape.rank(), 0);
+    for (int64_t dim : dimensions_to_reduce) {
+      counts[dim] = input_shape.dimensions(dim);
+      steps[dim] = 1;
+    }
+    indexing.offsets.reserve(indexing.num_reduced);
+    ShapeUtil::ForEachIndexNoStatus(
+        input_shape, base, counts, steps,
+        [&](absl::Span<const int64_t> index) {
+          indexing.offsets.push_back(
+              IndexUtil::MultidimensionalIndexToLinearIndex(input_shape,
+                                                            index));
+          return true;
+        });
+  }
+
+  return primitive_util::PrimitiveTypeSwitch<bool>(
+      [&](auto primitive_type_constant) -> bool {
+        if constexpr (primitive_util::IsArrayType(primitive_type_constant)) {
+          using NativeT = primitive_util::NativeTypeOf<primitive_type_constant>;
+          return BulkReduceTyped<NativeT>(*opcode, accumulator_is_lhs, input,
+                                          init_value, indexing, result);
+        }
+        return false;
+      },
+      result_shape.element_type());
+}
+
 absl::Status HloEvaluator::HandleReduce(const HloInstruction* hlo) {
   const HloReduceInstruction* reduce = Cast<HloReduceInstruction>(hlo);
   int64_t num_args = reduce->inputs().size();
@@ -4479,26 +4970,34 @@ absl::Status HloEvaluator::HandleReduce(const HloInstruction* hlo) {
     }
   }
 
-  const int num_threads = ShapeUtil::GetForEachIndexParallelThreadCount() + 1;
-  std::vector<std::unique_ptr<HloEvaluator>> embedded_evaluators;
-  embedded_evaluators.reserve(num_threads);
-  for (int i = 0; i < num_threads; ++i) {
-    embedded_evaluators.push_back(CreateEmbedded(max_loop_iterations_));
-  }
-
   absl::InlinedVector<Literal, 1> results(num_args);
   for (int64_t i = 0; i < num_args; ++i) {
     results[i] = Literal(is_tuple ? out_shape.tuple_shapes(i) : out_shape);
   }
 
-  TF_RETURN_IF_ERROR(ShapeUtil::ForEachIndexParallelWithStatus(
-      output_shape, [&](absl::Span<const int64_t> output_index, int thread_id) {
-        return GenerateReduceOutputElement(
-            is_tuple, use_fast_path_reduce_, output_index, init_values,
-            input_args, absl::Span<Literal>(results), function,
-            embedded_evaluators[thread_id + 1].get(), arg_dim_steps,
-            arg_dim_counts, result_to_arg_index);
-      }));
+  bool bulk_reduced = use_fast_path_reduce_ && !is_tuple &&
+                      BulkReduce(*input_args[0], *init_values[0], function,
+                                 dimensions_to_reduce, results[0]);
+
+  if (!bulk_reduced) {
+    const int num_threads =
+        ShapeUtil::GetForEachIndexParallelThreadCount() + 1;
+    std::vector<std::unique_ptr<HloEvaluator>> embedded_evaluators;
+    embedded_evaluators.reserve(num_threads);
+    for (int i = 0; i < num_threads; ++i) {
+      embedded_evaluators.push_back(CreateEmbedded(max_loop_iterations_));
+    }
+
+    TF_RETURN_IF_ERROR(ShapeUtil::ForEachIndexParallelWithStatus(
+        output_shape,
+        [&](absl::Span<const int64_t> output_index, int thread_id) {
+          return GenerateReduceOutputElement(
+              is_tuple, use_fast_path_reduce_, output_index, init_values,
+              input_args, absl::Span<Literal>(results), function,
+              embedded_evaluators[thread_id + 1].get(), arg_dim_steps,
+              arg_dim_counts, result_to_arg_index);
+        }));
+  }
 
   if (is_tuple) {
     Literal tuple_result(inferred_return_shape);
@@ -4647,7 +5146,7 @@ absl::Status HloEvaluator::HandleReduceWindow(const HloInstruction* hlo) {
     result = Literal::MoveIntoTuple(absl::MakeSpan(results));
     VLOG(2) << "Final result is:" << result.ToString() << "\n";
   } else {
-    TF_RETURN_IF_ERROR(Apply<PopulateParallelImpl>(
+    TF_RETURN_IF_ERROR(Apply<PopulateParallelTiledImpl>(
         result, [&evaluate_impl](absl::Span<const int64_t> output_index,
                                  int thread_id) {
           return std::move(evaluate_impl(output_index, thread_id)[0]);
@@ -4745,6 +5244,27 @@ absl::Status HloEvaluator::Postprocess(const HloInstruction* hlo) {
   return absl::OkStatus();
 }
 
+void HloEvaluator::ForEachLinearChunk(
+    int64_t n, int64_t min_chunk_size,
+    absl::FunctionRef<void(int64_t begin, int64_t end)> fn) {
+  // A few chunks per thread balance the load without a long task queue.
+  int64_t max_chunks = 4 * ShapeUtil::GetForEachIndexParallelThreadCount();
+  int64_t num_chunks = std::min(
+      CeilOfRatio(n, std::max<int64_t>(min_chunk_size, 1)), max_chunks);
+  if (num_chunks <= 1) {
+    fn(0, n);
+    return;
+  }
+  int64_t chunk_size = CeilOfRatio(n, num_chunks);
+  ShapeUtil::ForEachIndexParallel(
+      ShapeUtil::MakeShape(S64, {CeilOfRatio(n, chunk_size)}),
+      [&](absl::Span<const int64_t> chunk_index, int) -> absl::StatusOr<bool> {
+        int64_t begin = chunk_index[0] * chunk_size;
+        fn(begin, std::min(begin + chunk_size, n));
+        return true;
+      });
+}
+
 namespace {
 template <typename T>
 std::unique_ptr<Array2D<T>> MatmulArray2DImpl(
@@ -36,7 +36,9 @@ limitations under the License.
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/node_hash_map.h"
+#include "absl/functional/function_ref.h"
 #include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/types/span.h"
 #include "xla/array2d.h"
 #include "xla/hlo/analysis/tuple_points_to_analysis.h"
@@ -44,8 +46,11 @@ limitations under the License.
 #include "xla/hlo/ir/hlo_computation.h"
 #include "xla/hlo/ir/hlo_instruction.h"
 #include "xla/hlo/ir/hlo_module.h"
+#include "xla/index_util.h"
+#include "xla/layout_util.h"
 #include "xla/literal.h"
 #include "xla/literal_util.h"
+#include "xla/primitive_util.h"
 #include "xla/service/call_graph.h"
 #include "xla/service/dynamic_dimension_inference.h"
 #include "xla/service/shape_inference.h"
@@ -53,12 +58,14 @@ limitations under the License.
 #include "xla/util.h"
 #include "xla/xla_data.pb.h"
 #include "tsl/platform/ml_dtypes.h"
+#include "tsl/platform/threadpool.h"
 
 namespace xla {
 
 // Responsible for evaluating HLO and obtain literal as the evaluation results.
 //
-// This class is not thread-safe.
+// This class is not thread-safe. It can, however, evaluate independent
+// instructions of a computation concurrently, see set_inter_op_parallelism().
 class HloEvaluator : public ConstDfsHloVisitorWithDefault {
  public:
   // Precomputed analyses that can be passed to Evaluate functions to avoid
@@ -249,6 +256,70 @@ class HloEvaluator : public ConstDfsHloVisitorWithDefault {
   static std::unique_ptr<Array2D<uint8_t>> MatmulArray2D(
       const Array2D<uint8_t>& lhs, const Array2D<uint8_t>& rhs);
 
+  // Calls `fn(begin, end)` on consecutive chunks of the linear index range
+  // [0, n). Chunks hold at least `min_chunk_size` elements and run in parallel
+  // on the ShapeUtil::ForEachIndexParallel thread pool, so small ranges are
+  // processed inline on the calling thread.
+  static void ForEachLinearChunk(
+      int64_t n, int64_t min_chunk_size,
+      absl::FunctionRef<void(int64_t begin, int64_t end)> fn);
+
+  // Like Literal::PopulateParallel, but splits the output into tiles of
+  // consecutive elements instead of rows along the most minor dimension. Used
+  // for ops with expensive elements (dot, convolution, reduce-window), so that
+  // outputs with a few long rows still keep all threads busy.
+  template <typename NativeT>
+  static absl::Status PopulateParallelTiled(
+      Literal& literal,
+      absl::FunctionRef<NativeT(absl::Span<const int64_t>, int)> generator) {
+    const Shape& shape = literal.shape();
+    TF_RET_CHECK(LayoutUtil::IsDenseArray(shape));
+    if (!shape.is_static()) {
+      return literal.PopulateParallel<NativeT>(generator);
+    }
+    absl::Span<NativeT> data = literal.data<NativeT>();
+    const int64_t n = data.size();
+    if (n == 0) {
+      return absl::OkStatus();
+    }
+
+    static constexpr int64_t kTilesPerThread = 4;
+    const int64_t max_tiles =
+        kTilesPerThread * ShapeUtil::GetForEachIndexParallelThreadCount();
+    const int64_t tile_size = CeilOfRatio(n, std::min(n, max_tiles));
+    absl::Span<const int64_t> minor_to_major = LayoutUtil::MinorToMajor(shape);
+
+    ShapeUtil::ForEachIndexParallel(
+        ShapeUtil::MakeShape(S64, {CeilOfRatio(n, tile_size)}),
+        [&](absl::Span<const int64_t> tile_index,
+            int thread_id) -> absl::StatusOr<bool> {
+          int64_t begin = tile_index[0] * tile_size;
+          int64_t end = std::min(begin + tile_size, n);
+          DimensionVector index =
+              IndexUtil::LinearIndexToMultidimensionalIndex(shape, begin);
+          for (int64_t i = begin; i < end; ++i) {
+            data[i] = generator(index, thread_id);
+            // Advance to the next element in physical order.
+            for (int64_t dim : minor_to_major) {
+              if (++index[dim] < shape.dimensions(dim)) break;
+              index[dim] = 0;
+            }
+          }
+          return true;
+        });
+    return absl::OkStatus();
+  }
+
+  // Evaluates independent instructions of a computation concurrently on up
+  // to `num_threads` threads. Instructions that only read their operands
+  // (elementwise ops, dot, convolution, reductions, data movement) are
+  // dispatched as soon as their operands are available; all other
+  // instructions (control flow, RNG, custom calls, ...) run one at a time in
+  // post order, so results are identical to sequential evaluation. A value of
+  // 1 or less restores sequential evaluation. The interpreter backend sets it
+  // from DebugOptions::xla_hlo_evaluator_inter_op_parallelism.
+  void set_inter_op_parallelism(int num_threads);
+
  protected:
   // Evaluates the given instruction, and stores the evaluation result in the
   // evaluated_ map.
@@ -403,10 +474,10 @@ class HloEvaluator : public ConstDfsHloVisitorWithDefault {
       return *arg_literals_.at(hlo->parameter_number());
     }
 
-    auto it = evaluated_.find(hlo);
-    CHECK(it != evaluated_.end())
+    const Literal* literal = evaluated_.Find(hlo);
+    CHECK(literal != nullptr)
         << "could not find evaluated value for: " << hlo->ToString();
-    return it->second;
+    return *literal;
   }
 
   // Returns true if the given hlo has been evaluated and cached.
@@ -418,8 +489,8 @@ class HloEvaluator : public ConstDfsHloVisitorWithDefault {
     if (hlo->opcode() == HloOpcode::kParameter && !arg_literals_.empty()) {
       return true;
     }
-    auto it = evaluated_.find(hlo);
-    if (it == evaluated_.end()) {
+    const Literal* literal = evaluated_.Find(hlo);
+    if (literal == nullptr) {
       return false;
     }
     // We may evaluate some elements of a tuple-shaped instruction and mark
@@ -428,9 +499,46 @@ class HloEvaluator : public ConstDfsHloVisitorWithDefault {
     // are needed. By marking the other elements undetermined, we allow the
     // evaluator to update the cached tuple literal when more elements are
     // evaluated.
-    return it->second.IsDetermined(shape_index);
+    return literal->IsDetermined(shape_index);
   }
 
+  // Map from instructions to their evaluated literals. While instructions are
+  // evaluated concurrently, lookups and insertions are synchronized. Literals
+  // have stable addresses, so returned references stay valid while other
+  // threads insert.
+  class EvaluatedLiterals {
+   public:
+    Literal& operator[](const HloInstruction* hlo) {
+      absl::MutexLockMaybe lock(synchronized_ ? &mu_ : nullptr);
+      return literals_[hlo];
+    }
+
+    // Returns null if there is no literal for `hlo`.
+    Literal* Find(const HloInstruction* hlo) {
+      absl::MutexLockMaybe lock(synchronized_ ? &mu_ : nullptr);
+      auto it = literals_.find(hlo);
+      return it == literals_.end() ? nullptr : &it->second;
+    }
+
+    Literal& at(const HloInstruction* hlo) {
+      Literal* literal = Find(hlo);
+      CHECK(literal != nullptr) << "no literal for " << hlo->name();
+      return *literal;
+    }
+
+    bool contains(const HloInstruction* hlo) { return Find(hlo) != nullptr; }
+
+    void clear() { literals_.clear(); }
+
+    // Must not be called while other threads access the map.
+    void set_synchronized(bool synchronized) { synchronized_ = synchronized; }
+
+   private:
+    bool synchronized_ = false;
+    absl::Mutex mu_;
+    absl::node_hash_map<const HloInstruction*, Literal> literals_;
+  };
+
   // Tracks the HLO instruction and its evaluated literal result.
   //
   // Parameters and constants aren't stored here, see implementation of
@@ -444,7 +552,7 @@ class HloEvaluator : public ConstDfsHloVisitorWithDefault {
   //
   // Storing Literal in place requires the container to have pointer stability
   // so we cannot use flat_hash_map any more.
-  absl::node_hash_map<const HloInstruction*, Literal> evaluated_;
+  EvaluatedLiterals evaluated_;
   // Set by EvaluateInternal and opportunitiscally used by the HandleXXX
   // functions. When non-empty, the HandleXXX function may evaluate the
   // instruction at only the given shape index.
@@ -460,6 +568,10 @@ class HloEvaluator : public ConstDfsHloVisitorWithDefault {
   // Use fast path that doesn't use embedded evaluators in reduce.
   bool use_fast_path_reduce_ = true;
 
+  // Thread pool for evaluating independent instructions concurrently. Null if
+  // instructions are evaluated sequentially.
+  std::unique_ptr<tsl::thread::ThreadPool> inter_op_thread_pool_;
+
  private:
   template <typename ReturnT, typename NativeT>
   static absl::StatusOr<Literal> ElementWiseUnaryOpImpl(
@@ -471,6 +583,17 @@ class HloEvaluator : public ConstDfsHloVisitorWithDefault {
     TF_RET_CHECK(ShapeUtil::SameDimensions(shape, operand->shape()));
 
     Literal result(shape);
+    if (IsLinearElementwiseOperand<NativeT>(result, operand_literal)) {
+      absl::Span<ReturnT> out = result.data<ReturnT>();
+      absl::Span<const NativeT> in = operand_literal.data<NativeT>();
+      ForEachLinearChunk(out.size(), kMinElementwiseChunkSize,
+                         [&](int64_t begin, int64_t end) {
+                           for (int64_t i = begin; i < end; ++i) {
+                             out[i] = unary_op(in[i]);
+                           }
+                         });
+      return std::move(result);
+    }
     TF_RETURN_IF_ERROR(result.PopulateParallel<ReturnT>(
         [&](absl::Span<const int64_t> multi_index, int) {
           return unary_op(operand_literal.Get<NativeT>(multi_index));
@@ -478,6 +601,32 @@ class HloEvaluator : public ConstDfsHloVisitorWithDefault {
     return std::move(result);
   }
 
+  // Elementwise ops on literals with identical dense layouts walk the
+  // underlying buffers linearly instead of computing a multi-dimensional index
+  // for every element. Chunks smaller than this are not worth a thread hop.
+  static constexpr int64_t kMinElementwiseChunkSize = 16 * 1024;
+
+  // Returns true if `operand` holds NativeT elements in the same physical
+  // order as `result`, so both can be indexed with one linear index.
+  template <typename NativeT>
+  static bool IsLinearElementwiseOperand(const Literal& result,
+                                         const Literal& operand) {
+    const Shape& result_shape = result.shape();
+    const Shape& operand_shape = operand.shape();
+    return LayoutUtil::IsDenseArray(result_shape) &&
+           LayoutUtil::IsDenseArray(operand_shape) &&
+           result_shape.is_static() && operand_shape.is_static() &&
+           operand_shape.element_type() ==
+               primitive_util::NativeToPrimitiveType<NativeT>() &&
+           ShapeUtil::SameDimensions(result_shape, operand_shape) &&
+           LayoutUtil::MinorToMajor(result_shape) ==
+               LayoutUtil::MinorToMajor(operand_shape);
+  }
+
+  // Evaluates all instructions of `computation` by dispatching independent
+  // instructions to `inter_op_thread_pool_`.
+  absl::Status EvaluateConcurrently(const HloComputation& computation);
+
   // Map from a primitive type to its associated (templated) DfsHloVisitor.
   std::unique_ptr<ConstDfsHloVisitor> typed_visitors_[PrimitiveType_ARRAYSIZE];
 
@@ -33,6 +33,7 @@ limitations under the License.
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_format.h"
+#include "absl/strings/str_join.h"
 #include "absl/strings/string_view.h"
 #include "absl/types/span.h"
 #include "xla/array2d.h"
@@ -2639,6 +2640,217 @@ TEST_F(HloEvaluatorPreciseReduceTest, AddReductionPrecisionTest) {
   LiteralTestUtil::ExpectR0Equal<float>(kNumElements, result);
 }
 
+// Bulk reductions must produce exactly the same results as evaluating the
+// reducer element by element, including for non-default layouts, reducers
+// with swapped operands and non-contiguous reduced dimensions.
+TEST_F(HloEvaluatorTest, BulkReduceMatchesGenericReduce) {
+  constexpr absl::string_view hlo_text = R"(
+  HloModule BulkReduce
+
+  max_f32 {
+    a = f32[] parameter(0)
+    b = f32[] parameter(1)
+    ROOT max = f32[] maximum(b, a)
+  }
+
+  add_f32 {
+    a = f32[] parameter(0)
+    b = f32[] parameter(1)
+    ROOT add = f32[] add(a, b)
+  }
+
+  add_s32 {
+    a = s32[] parameter(0)
+    b = s32[] parameter(1)
+    ROOT add = s32[] add(a, b)
+  }
+
+  mul_u8 {
+    a = u8[] parameter(0)
+    b = u8[] parameter(1)
+    ROOT mul = u8[] multiply(a, b)
+  }
+
+  ENTRY main {
+    p0 = f32[7,33,5]{0,2,1} parameter(0)
+    p1 = s32[7,33,5]{2,1,0} parameter(1)
+    p2 = u8[7,33,5]{2,1,0} parameter(2)
+    f32_init = f32[] constant(-inf)
+    f32_zero = f32[] constant(0)
+    s32_init = s32[] constant(0)
+    u8_init = u8[] constant(1)
+    max = f32[33] reduce(p0, f32_init), dimensions={0,2}, to_apply=max_f32
+    add = f32[7,5] reduce(p0, f32_zero), dimensions={1}, to_apply=add_f32
+    sum_minor = s32[7] reduce(p1, s32_init), dimensions={1,2},
+      to_apply=add_s32
+    sum_major = s32[5] reduce(p1, s32_init), dimensions={0,1},
+      to_apply=add_s32
+    mul = u8[7,5] reduce(p2, u8_init), dimensions={1}, to_apply=mul_u8
+    ROOT tuple = (f32[33], f32[7,5], s32[7], s32[5], u8[7,5])
+      tuple(max, add, sum_minor, sum_major, mul)
+  }
+  )";
+  TF_ASSERT_OK_AND_ASSIGN(m_, ParseAndReturnVerifiedModule(hlo_text));
+  const HloComputation* entry = m_->entry_computation();
+
+  std::vector<Literal> args;
+  for (const HloInstruction* param : entry->parameter_instructions()) {
+    TF_ASSERT_OK_AND_ASSIGN(Literal arg, MakeFakeLiteral(param->shape()));
+    args.push_back(std::move(arg));
+  }
+  // NaNs must propagate the same way through both paths.
+  args[0].Set<float>({3, 10, 2}, std::numeric_limits<float>::quiet_NaN());
+
+  HloEvaluator bulk_evaluator;
+  TF_ASSERT_OK_AND_ASSIGN(Literal bulk,
+                          bulk_evaluator.Evaluate(*entry, args));
+
+  HloEvaluator generic_evaluator;
+  generic_evaluator.set_reduce_use_fast_path(false);
+  TF_ASSERT_OK_AND_ASSIGN(Literal generic,
+                          generic_evaluator.Evaluate(*entry, args));
+
+  EXPECT_TRUE(LiteralTestUtil::Equal(generic, bulk));
+}
+
+TEST_F(HloEvaluatorTest, InterOpParallelismMatchesSequentialEvaluation) {
+  constexpr absl::string_view hlo_text = R"(
+  HloModule InterOpParallelism
+
+  add {
+    a = f32[] parameter(0)
+    b = f32[] parameter(1)
+    ROOT add = f32[] add(a, b)
+  }
+
+  cond {
+    state = (s32[], f32[64,64]) parameter(0)
+    i = s32[] get-tuple-element(state), index=0
+    n = s32[] constant(3)
+    ROOT lt = pred[] compare(i, n), direction=LT
+  }
+
+  body {
+    state = (s32[], f32[64,64]) parameter(0)
+    i = s32[] get-tuple-element(state), index=0
+    x = f32[64,64] get-tuple-element(state), index=1
+    one = s32[] constant(1)
+    next_i = s32[] add(i, one)
+    next_x = f32[64,64] dot(x, x), lhs_contracting_dims={1},
+      rhs_contracting_dims={0}
+    ROOT next = (s32[], f32[64,64]) tuple(next_i, next_x)
+  }
+
+  ENTRY main {
+    p0 = f32[64,64] parameter(0)
+    p1 = f32[64,64] parameter(1)
+    zero = f32[] constant(0)
+    dot0 = f32[64,64] dot(p0, p1), lhs_contracting_dims={1},
+      rhs_contracting_dims={0}
+    dot1 = f32[64,64] dot(p1, p0), lhs_contracting_dims={1},
+      rhs_contracting_dims={0}
+    window = f32[64,64] reduce-window(p0, zero),
+      window={size=3x3 pad=1_1x1_1}, to_apply=add
+    reduce = f32[64] reduce(p1, zero), dimensions={1}, to_apply=add
+    sum = f32[64,64] add(dot0, dot1)
+    i0 = s32[] constant(0)
+    init = (s32[], f32[64,64]) tuple(i0, window)
+    loop = (s32[], f32[64,64]) while(init), condition=cond, body=body
+    loop_x = f32[64,64] get-tuple-element(loop), index=1
+    ROOT result = (f32[64,64], f32[64,64], f32[64]) tuple(sum, loop_x, reduce)
+  }
+  )";
+  TF_ASSERT_OK_AND_ASSIGN(m_, ParseAndReturnVerifiedModule(hlo_text));
+  const HloComputation* entry = m_->entry_computation();
+
+  Array2D<float> values(64, 64);
+  values.FillRandom(0.1f);
+  Literal p0 = LiteralUtil::CreateR2FromArray2D(values);
+  Literal p1 = LiteralUtil::CreateR2FromArray2D(values);
+
+  HloEvaluator sequential_evaluator;
+  TF_ASSERT_OK_AND_ASSIGN(Literal expected,
+                          sequential_evaluator.Evaluate(*entry, {&p0, &p1}));
+
+  HloEvaluator parallel_evaluator;
+  parallel_evaluator.set_inter_op_parallelism(4);
+  for (int i = 0; i < 3; ++i) {
+    TF_ASSERT_OK_AND_ASSIGN(Literal result,
+                            parallel_evaluator.Evaluate(*entry, {&p0, &p1}));
+    EXPECT_TRUE(LiteralTestUtil::Equal(expected, result));
+  }
+}
+
+TEST_F(HloEvaluatorTest, InterOpParallelismMatchesSequentialOnWideGraph) {
+  // Eight independent branches, each with elementwise ops, a dot and a
+  // reduction that are large enough to be dispatched to the thread pool,
+  // joined by a concatenate, a reduction and tuples.
+  constexpr int kNumBranches = 8;
+  std::string hlo_text = R"(
+  HloModule InterOpParallelismWideGraph
+
+  add {
+    a = f32[] parameter(0)
+    b = f32[] parameter(1)
+    ROOT add = f32[] add(a, b)
+  }
+
+  ENTRY main {
+    p0 = f32[128,128] parameter(0)
+    p1 = f32[128,128] parameter(1)
+    zero = f32[] constant(0)
+)";
+  std::string branches;
+  std::string reductions;
+  for (int b = 0; b < kNumBranches; ++b) {
+    absl::StrAppendFormat(
+        &hlo_text,
+        "    s%d = f32[] constant(%d)\n"
+        "    bs%d = f32[128,128] broadcast(s%d), dimensions={}\n"
+        "    x%d = f32[128,128] multiply(p0, bs%d)\n"
+        "    d%d = f32[128,128] dot(x%d, p1), lhs_contracting_dims={1}, "
+        "rhs_contracting_dims={0}\n"
+        "    t%d = f32[128,128] tanh(d%d)\n"
+        "    r%d = f32[128] reduce(t%d, zero), dimensions={1}, "
+        "to_apply=add\n",
+        b, b + 1, b, b, b, b, b, b, b, b, b, b);
+    absl::StrAppendFormat(&branches, "%st%d", b == 0 ? "" : ", ", b);
+    absl::StrAppendFormat(&reductions, "%sr%d", b == 0 ? "" : ", ", b);
+  }
+  std::string reduction_shapes =
+      absl::StrJoin(std::vector<std::string>(kNumBranches, "f32[128]"), ", ");
+  absl::StrAppendFormat(
+      &hlo_text,
+      "    cat = f32[%d,128] concatenate(%s), dimensions={0}\n"
+      "    total = f32[128] reduce(cat, zero), dimensions={0}, "
+      "to_apply=add\n"
+      "    rs = (%s) tuple(%s)\n"
+      "    ROOT result = (f32[128], (%s)) tuple(total, rs)\n"
+      "  }\n",
+      128 * kNumBranches, branches, reduction_shapes, reductions,
+      reduction_shapes);
+  TF_ASSERT_OK_AND_ASSIGN(m_, ParseAndReturnVerifiedModule(hlo_text));
+  const HloComputation* entry = m_->entry_computation();
+
+  Array2D<float> values(128, 128);
+  values.FillRandom(0.1f);
+  Literal p0 = LiteralUtil::CreateR2FromArray2D(values);
+  values.FillRandom(0.2f);
+  Literal p1 = LiteralUtil::CreateR2FromArray2D(values);
+
+  HloEvaluator sequential_evaluator;
+  TF_ASSERT_OK_AND_ASSIGN(Literal expected,
+                          sequential_evaluator.Evaluate(*entry, {&p0, &p1}));
+
+  HloEvaluator parallel_evaluator;
+  parallel_evaluator.set_inter_op_parallelism(4);
+  for (int i = 0; i < 3; ++i) {
+    TF_ASSERT_OK_AND_ASSIGN(Literal result,
+                            parallel_evaluator.Evaluate(*entry, {&p0, &p1}));
+    EXPECT_TRUE(LiteralTestUtil::Equal(expected, result));
+  }
+}
+
 // Reducing many numbers should be fast because it doesn't create
 // intermediate Literals; the microbenchmark should finish in < 1 msec.
 void BM_ReducePrecisely(::testing::benchmark::State& state) {
@@ -70,7 +70,13 @@ namespace detail {
 template <typename T>
 using unsigned_promoted_type_t =
     std::make_unsigned_t<decltype(std::declval<T>() + std::declval<T>())>;
-}
+
+// Element types for which the dot fast path multiplies matrices with Eigen.
+template <typename T>
+inline constexpr bool has_fast_dot_v =
+    std::is_same_v<T, float> || std::is_same_v<T, double> ||
+    std::is_same_v<T, complex64> || std::is_same_v<T, complex128>;
+}  // namespace detail
 
 // ToArithmeticSafeType(T t):
 //  - converts `t` to an unsigned integer at least as wide as `int` if T is an
@@ -964,7 +970,8 @@ class HloEvaluatorTypedVisitor : public ConstDfsHloVisitorWithDefault {
     };
 
     Literal result(result_shape);
-    TF_RETURN_IF_ERROR(result.PopulateParallel<ReturnT>(func));
+    TF_RETURN_IF_ERROR(
+        HloEvaluator::PopulateParallelTiled<ReturnT>(result, func));
 
     parent_->evaluated_[conv] = std::move(result);
     return absl::OkStatus();
@@ -1040,7 +1047,7 @@ class HloEvaluatorTypedVisitor : public ConstDfsHloVisitorWithDefault {
   }
 
   template <typename NativeT, typename std::enable_if_t<
-                                  std::is_same_v<NativeT, float>>* = nullptr>
+                                  detail::has_fast_dot_v<NativeT>>* = nullptr>
   absl::Status HandleDot(const HloInstruction* dot) {
     const HloInstruction* lhs = dot->operand(0);
     const HloInstruction* rhs = dot->operand(1);
@@ -1105,7 +1112,7 @@ class HloEvaluatorTypedVisitor : public ConstDfsHloVisitorWithDefault {
   }
 
   template <typename NativeT, typename std::enable_if_t<
-                                  !std::is_same_v<NativeT, float>>* = nullptr>
+                                  !detail::has_fast_dot_v<NativeT>>* = nullptr>
   absl::Status HandleDot(const HloInstruction* dot) {
     return HandleDotSlowPath(dot);
   }
@@ -1150,7 +1157,8 @@ class HloEvaluatorTypedVisitor : public ConstDfsHloVisitorWithDefault {
     }
     const int64_t total_contraction_size = Product(contracting_dim_sizes);
     Literal result(dot->shape());
-    TF_RETURN_IF_ERROR(result.PopulateParallel<ReturnT>(
+    TF_RETURN_IF_ERROR(HloEvaluator::PopulateParallelTiled<ReturnT>(
+        result,
         [&](absl::Span<const int64_t> result_index, int /*thread_id*/) {
           // Locations in LHS and RHS that we read from.
           DimensionVector lhs_index(lhs_rank);
@@ -1663,6 +1671,24 @@ class HloEvaluatorTypedVisitor : public ConstDfsHloVisitorWithDefault {
 
     Literal result(shape);
 
+    if (HloEvaluator::IsLinearElementwiseOperand<ReturnT>(result,
+                                                          lhs_literal) &&
+        HloEvaluator::IsLinearElementwiseOperand<ReturnT>(result,
+                                                          rhs_literal)) {
+      auto op = ConvertBinaryFunction(binary_op);
+      absl::Span<ReturnT> out = result.data<ReturnT>();
+      absl::Span<const ReturnT> lhs_data = lhs_literal.data<ReturnT>();
+      absl::Span<const ReturnT> rhs_data = rhs_literal.data<ReturnT>();
+      HloEvaluator::ForEachLinearChunk(
+          out.size(), HloEvaluator::kMinElementwiseChunkSize,
+          [&](int64_t begin, int64_t end) {
+            for (int64_t i = begin; i < end; ++i) {
+              out[i] = op(lhs_data[i], rhs_data[i]);
+            }
+          });
+      return std::move(result);
+    }
+
     TF_RETURN_IF_ERROR(result.PopulateParallel<ReturnT>(
         [&](absl::Span<const int64_t> multi_index, int) {
           return ConvertBinaryFunction(binary_op)(
@@ -1690,6 +1716,26 @@ class HloEvaluatorTypedVisitor : public ConstDfsHloVisitorWithDefault {
 
     Literal result(shape);
 
+    if (HloEvaluator::IsLinearElementwiseOperand<LhsType>(result,
+                                                          lhs_literal) &&
+        HloEvaluator::IsLinearElementwiseOperand<RhsType>(result,
+                                                          rhs_literal) &&
+        HloEvaluator::IsLinearElementwiseOperand<EhsType>(result,
+                                                          ehs_literal)) {
+      absl::Span<ReturnT> out = result.data<ReturnT>();
+      absl::Span<const LhsType> lhs_data = lhs_literal.data<LhsType>();
+      absl::Span<const RhsType> rhs_data = rhs_literal.data<RhsType>();
+      absl::Span<const EhsType> ehs_data = ehs_literal.data<EhsType>();
+      HloEvaluator::ForEachLinearChunk(
+          out.size(), HloEvaluator::kMinElementwiseChunkSize,
+          [&](int64_t begin, int64_t end) {
+            for (int64_t i = begin; i < end; ++i) {
+              out[i] = ternary_op(lhs_data[i], rhs_data[i], ehs_data[i]);
+            }
+          });
+      return std::move(result);
+    }
+
     TF_RETURN_IF_ERROR(result.PopulateParallel<ReturnT>(
         [&](absl::Span<const int64_t> multi_index, int) {
           return ternary_op(lhs_literal.Get<LhsType>(multi_index),
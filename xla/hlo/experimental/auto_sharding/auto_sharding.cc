@@ -1787,6 +1787,8 @@ CreateAutoShardingSolverRequestAndCallSolver(
   request.set_deterministic_mode(deterministic_mode);
   request.set_request_name(std::string(request_name));
   request.set_enable_memory_edge_costs(option.model_resharding_memory_costs);
+  request.set_enable_warm_start(option.enable_solver_warm_start);
+  request.set_enable_decomposition(option.enable_solver_decomposition);
   // If we're removing user shardings, we are probably doing internal testing /
   // debugging where additional output from the solver might be helpful.
   request.set_enable_output(
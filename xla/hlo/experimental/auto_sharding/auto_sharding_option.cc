@@ -116,6 +116,12 @@ std::string AutoShardingOption::ToString() const {
   lines.push_back(
       absl::StrCat("solver_timeout_in_seconds: ", solver_timeout_in_seconds));
 
+  lines.push_back(
+      absl::StrCat("enable_solver_warm_start: ", enable_solver_warm_start));
+
+  lines.push_back(absl::StrCat("enable_solver_decomposition: ",
+                               enable_solver_decomposition));
+
   lines.push_back(absl::StrCat("loop_iteration_count_estimate: ",
                                loop_iteration_count_estimate));
 
@@ -163,6 +163,16 @@ struct AutoShardingOption {
   // sharding_propagation.cc.
   int64_t solver_timeout_in_seconds = 3600;
 
+  // Hint the solver with the solution found for a previously compiled module
+  // whose solver request has the same structure, which speeds up recompiling
+  // a model after small changes.
+  bool enable_solver_warm_start = false;
+
+  // Split the solver request into independent subproblems and solve them
+  // concurrently. Only applies if there is no memory budget, since the memory
+  // constraints couple all instructions.
+  bool enable_solver_decomposition = false;
+
   // Static estimate for iteration count of a while loop, used in the cost
   // model. This estimate is used when we cannot infer an upper bound on the
   // number of iterations in the loop (as implemented in
@@ -19,9 +19,12 @@ limitations under the License.
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
+#include <deque>
 #include <functional>
+#include <iterator>
 #include <limits>
 #include <memory>
+#include <numeric>
 #include <optional>
 #include <string>
 #include <string_view>
@@ -34,20 +37,25 @@ limitations under the License.
 #ifdef PLATFORM_GOOGLE
 #include "file/base/options.h"
 #endif
+#include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/log/check.h"
 #include "absl/log/log.h"
 #include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
 #include "xla/hlo/experimental/auto_sharding/auto_sharding_memory.h"
 #include "xla/hlo/experimental/auto_sharding/auto_sharding_strategy.h"
 #include "xla/status_macros.h"
 #include "xla/util.h"
+#include "tsl/platform/env.h"
+#include "tsl/platform/errors.h"
 #include "tsl/platform/fingerprint.h"
 #include "tsl/platform/hash.h"
+#include "tsl/platform/threadpool.h"
 #include "tsl/platform/types.h"
 #include "ortools/linear_solver/linear_solver.h"
 #include "ortools/linear_solver/linear_solver.pb.h"
@@ -469,6 +477,35 @@ void AddMemoryTerms(
 
 }  // namespace
 
+// Evaluates `result` against the unscaled request and logs its total costs.
+static void LogTotalCosts(const AutoShardingSolverRequest& unscaled_request,
+                          const AutoShardingSolverOutput& result) {
+  const AutoShardingEvaluation evaluation = Evaluate(unscaled_request, result);
+  LOG(INFO) << "*** Total costs for the (unscaled) solver request ***";
+  LOG(INFO) << "Total Communication Cost: "
+            << evaluation.total.communication_cost
+            << " (lower bound: " << evaluation.lower_bound.communication_cost
+            << ")";
+  LOG(INFO) << "Total Computation Cost: " << evaluation.total.computation_cost
+            << " (lower bound: " << evaluation.lower_bound.computation_cost
+            << ")";
+  LOG(INFO) << "Total Resharding Cost: " << evaluation.total.resharding_cost
+            << " (lower bound: " << evaluation.lower_bound.resharding_cost
+            << ")";
+  LOG(INFO) << "Total Overbudget Cost: " << evaluation.total.overbudget_cost
+            << " (lower bound: " << evaluation.lower_bound.overbudget_cost
+            << ")";
+  LOG(INFO) << "Total Makespan Cost: " << evaluation.total.makespan_cost
+            << " (lower bound: " << evaluation.lower_bound.makespan_cost
+            << ")";
+  LOG(INFO) << "Total Cost: " << evaluation.total.cost()
+            << " (lower bound: " << evaluation.lower_bound.cost() << ")";
+  LOG(INFO) << "Total Departures: " << evaluation.total_departures;
+  LOG(INFO) << "Total Makespan: " << evaluation.total_makespan;
+  LOG(INFO) << "Total Violations: " << evaluation.violation_codes.size();
+  LOG(INFO) << "Maximum Total Memory: " << evaluation.max_total_memory;
+}
+
 // Taking an auto-sharding problem (`request`) as an input, calls the OR tools
 // CP-SAT solver and outputs a solution to the input problem.
 //
@@ -515,6 +552,7 @@ void AddMemoryTerms(
 //       Make sure s[i] and s[j] align with e[i, j]:
 //     f. For all (i, j) in A and all (p, q),
 //        s[i][p] + s[j][q] <= 1 if v[p, q] == 1.0
+
 // Serialize parameters of the ILP problem as numpy arrays and call the python
 // solver.
 
@@ -534,12 +572,15 @@ void AddMemoryTerms(
 //    can be a few (usually < 10) edges in the problem with negative costs. This
 //    is guaranteed to never produce a negative overall cost for the graph,
 //    however.
-absl::StatusOr<AutoShardingSolverOutput> FormulateAndSolveMIPFromSolverRequest(
-    const AutoShardingSolverRequest& unscaled_request) {
+// 6. If request.enable_decomposition is set, the request is first split into
+//    independent subproblems (see SolveDecomposed below), each of which is
+//    formulated as described above.
+static absl::StatusOr<AutoShardingSolverOutput> FormulateAndSolveMIP(
+    const AutoShardingSolverRequest& unscaled_request, int num_workers,
+    bool log_total_costs = true) {
   const absl::Time start_time = absl::Now();
   const AutoShardingSolverRequest& request = ScaleRequest(unscaled_request);
   const size_t num_edges = request.edges_size();
-  const int num_workers = 32;
   // SAT or SCIP
 #ifdef PLATFORM_GOOGLE
   std::unique_ptr<MPSolver> solver(MPSolver::CreateSolver("SAT"));
@@ -928,39 +969,356 @@ absl::StatusOr<AutoShardingSolverOutput> FormulateAndSolveMIPFromSolverRequest(
   }
   auto result = SolveAndExtractSolution(request, s, e, overbudget_var,
                                         makespan_var, *solver);
-  if (result.ok()) {
-    const AutoShardingEvaluation evaluation =
-        Evaluate(unscaled_request, *result);
-    LOG(INFO) << "*** Total costs for the (unscaled) solver request ***";
-    LOG(INFO) << "Total Communication Cost: "
-              << evaluation.total.communication_cost
-              << " (lower bound: " << evaluation.lower_bound.communication_cost
-              << ")";
-    LOG(INFO) << "Total Computation Cost: " << evaluation.total.computation_cost
-              << " (lower bound: " << evaluation.lower_bound.computation_cost
-              << ")";
-    LOG(INFO) << "Total Resharding Cost: " << evaluation.total.resharding_cost
-              << " (lower bound: " << evaluation.lower_bound.resharding_cost
-              << ")";
-    LOG(INFO) << "Total Overbudget Cost: " << evaluation.total.overbudget_cost
-              << " (lower bound: " << evaluation.lower_bound.overbudget_cost
-              << ")";
-    LOG(INFO) << "Total Makespan Cost: " << evaluation.total.makespan_cost
-              << " (lower bound: " << evaluation.lower_bound.makespan_cost
-              << ")";
-    LOG(INFO) << "Total Cost: " << evaluation.total.cost()
-              << " (lower bound: " << evaluation.lower_bound.cost() << ")";
-    LOG(INFO) << "Total Departures: " << evaluation.total_departures;
-    LOG(INFO) << "Total Makespan: " << evaluation.total_makespan;
-    LOG(INFO) << "Total Violations: " << evaluation.violation_codes.size();
-    LOG(INFO) << "Maximum Total Memory: " << evaluation.max_total_memory;
+  if (result.ok() && log_total_costs) {
+    LogTotalCosts(unscaled_request, *result);
   }
   const absl::Time end_time = absl::Now();
   const auto duration = end_time - start_time;
   LOG(INFO) << "Solver took " << absl::ToInt64Milliseconds(duration) << " ms";
+  if (result.ok()) result->solve_times = {duration};
   return result;
 }
 
+namespace {
+
+// Number of CP-SAT workers shared by all subproblems of a request.
+constexpr int kNumWorkers = 32;
+
+// Upper bound on the number of subproblems solved concurrently. Independent
+// components beyond that are packed together, as every solver invocation comes
+// with a fixed overhead.
+constexpr int64_t kMaxSubproblems = 8;
+
+// Upper bound on the number of solutions kept for warm starts.
+constexpr size_t kMaxWarmStartSolutions = 64;
+
+// Solutions of previous requests keyed by their structural fingerprint.
+struct WarmStartCache {
+  absl::Mutex mu;
+  absl::flat_hash_map<uint64_t, std::vector<NodeStrategyIdx>> solutions
+      ABSL_GUARDED_BY(mu);
+  std::deque<uint64_t> fingerprints ABSL_GUARDED_BY(mu);  // Insertion order
+};
+
+WarmStartCache& GetWarmStartCache() {
+  static auto* const cache = new WarmStartCache();
+  return *cache;
+}
+
+// Fingerprints the variables and hard constraints of the request but not its
+// costs, which typically shift slightly between recompilations of the same
+// model.
+uint64_t StructuralFingerprint(const AutoShardingSolverRequest& request) {
+  AutoShardingSolverRequest structure;
+  structure.set_num_nodes(request.num_nodes());
+  *structure.mutable_s_len() = request.s_len();
+  *structure.mutable_s_follow() = request.s_follow();
+  *structure.mutable_edges() = request.edges();
+  *structure.mutable_aliases() = request.aliases();
+  *structure.mutable_value_costs() = request.value_costs();
+  return tsl::Fingerprint64(structure.SerializeAsString());
+}
+
+// Returns true if no constraint or objective term of the request spans
+// arbitrary sets of nodes, i.e., if nodes only interact through edges, aliases
+// and followers.
+bool IsDecomposable(const AutoShardingSolverRequest& request) {
+  return request.memory_budget() <= 0 && !request.has_max_departures() &&
+         !request.has_makespan_coeff() &&
+         (!request.has_max_cost() ||
+          request.max_cost().coeff() >= kMaxCostValue);
+}
+
+// Assigns every node to one of at most `max_subproblems` subproblems such that
+// nodes connected by an edge, an alias or a follower share a subproblem.
+// Connected components are packed greedily, largest first, into the subproblem
+// with the fewest nodes so far.
+std::vector<int64_t> FindIndependentSubproblems(
+    const AutoShardingSolverRequest& request, int64_t max_subproblems) {
+  std::vector<NodeIdx> parent(request.num_nodes());
+  std::iota(parent.begin(), parent.end(), 0);
+  auto find = [&](NodeIdx node_idx) {
+    while (parent[node_idx] != node_idx) {
+      node_idx = parent[node_idx] = parent[parent[node_idx]];
+    }
+    return node_idx;
+  };
+  auto unite = [&](NodeIdx a, NodeIdx b) {
+    a = find(a);
+    b = find(b);
+    if (a != b) parent[std::max(a, b)] = std::min(a, b);
+  };
+  for (NodeIdx node_idx = 0; node_idx < request.num_nodes(); ++node_idx) {
+    if (request.s_follow(node_idx) >= 0) {
+      unite(node_idx, request.s_follow(node_idx));
+    }
+  }
+  for (const auto& edge : request.edges()) unite(edge.first(), edge.second());
+  for (const auto& alias : request.aliases()) {
+    unite(alias.first(), alias.second());
+  }
+
+  absl::flat_hash_map<NodeIdx, int64_t> component_sizes;
+  for (NodeIdx node_idx = 0; node_idx < request.num_nodes(); ++node_idx) {
+    ++component_sizes[find(node_idx)];
+  }
+  std::vector<std::pair<int64_t, NodeIdx>> components;
+  components.reserve(component_sizes.size());
+  for (const auto& [root, size] : component_sizes) {
+    components.push_back({-size, root});
+  }
+  std::sort(components.begin(), components.end());
+
+  const int64_t num_subproblems =
+      std::min<int64_t>(max_subproblems, components.size());
+  std::vector<int64_t> subproblem_sizes(num_subproblems, 0);
+  absl::flat_hash_map<NodeIdx, int64_t> subproblem_of_root;
+  for (const auto& [negated_size, root] : components) {
+    const int64_t subproblem = std::distance(
+        subproblem_sizes.begin(),
+        std::min_element(subproblem_sizes.begin(), subproblem_sizes.end()));
+    subproblem_sizes[subproblem] -= negated_size;
+    subproblem_of_root[root] = subproblem;
+  }
+
+  std::vector<int64_t> subproblem_of(request.num_nodes());
+  for (NodeIdx node_idx = 0; node_idx < request.num_nodes(); ++node_idx) {
+    subproblem_of[node_idx] = subproblem_of_root[find(node_idx)];
+  }
+  return subproblem_of;
+}
+
+// Splits the request into `num_subproblems` requests according to the node
+// assignment computed by FindIndependentSubproblems. Nodes keep their relative
+// order within every subproblem.
+std::vector<AutoShardingSolverRequest> SplitRequest(
+    const AutoShardingSolverRequest& request,
+    const std::vector<int64_t>& subproblem_of, int64_t num_subproblems) {
+  AutoShardingSolverRequest header = request;
+  header.clear_s_len();
+  header.clear_s_follow();
+  header.clear_s_hint();
+  header.clear_peak_times();
+  header.clear_edges();
+  header.clear_live();
+  header.clear_live_edges();
+  header.clear_node_intervals();
+  header.clear_edge_intervals();
+  header.clear_node_groups();
+  header.clear_edge_groups();
+  header.clear_computation_costs();
+  header.clear_communication_costs();
+  header.clear_memory_costs();
+  header.clear_memory_edge_costs();
+  header.clear_departure_costs();
+  header.clear_resharding_costs();
+  header.clear_duration_costs();
+  header.clear_aliases();
+  header.clear_value_costs();
+  header.clear_instruction_names();
+  header.clear_opcodes();
+  header.clear_metadata_source_files();
+  header.clear_strategy_names();
+  // Costs are scaled once for the whole request before splitting it, so that
+  // the objective values of all subproblems add up.
+  header.clear_coeff_limit();
+
+  std::vector<AutoShardingSolverRequest> subrequests(num_subproblems, header);
+  for (int64_t i = 0; i < num_subproblems; ++i) {
+    subrequests[i].set_num_nodes(0);
+    subrequests[i].set_request_name(
+        absl::StrCat(request.request_name(), "_subproblem_", i));
+  }
+
+  std::vector<NodeIdx> local_idx(request.num_nodes());
+  for (NodeIdx node_idx = 0; node_idx < request.num_nodes(); ++node_idx) {
+    AutoShardingSolverRequest& subrequest =
+        subrequests[subproblem_of[node_idx]];
+    local_idx[node_idx] = subrequest.num_nodes();
+    subrequest.set_num_nodes(subrequest.num_nodes() + 1);
+  }
+
+  const int64_t num_nodes = request.num_nodes();
+  for (NodeIdx node_idx = 0; node_idx < num_nodes; ++node_idx) {
+    AutoShardingSolverRequest& subrequest =
+        subrequests[subproblem_of[node_idx]];
+    const NodeIdx follow_idx = request.s_follow(node_idx);
+    subrequest.add_s_len(request.s_len(node_idx));
+    subrequest.add_s_follow(follow_idx >= 0 ? local_idx[follow_idx] : -1);
+    if (request.s_hint_size() == num_nodes) {
+      subrequest.add_s_hint(request.s_hint(node_idx));
+    }
+    *subrequest.add_computation_costs() = request.computation_costs(node_idx);
+    *subrequest.add_communication_costs() =
+        request.communication_costs(node_idx);
+    if (request.memory_costs_size() == num_nodes) {
+      *subrequest.add_memory_costs() = request.memory_costs(node_idx);
+    }
+    if (request.departure_costs_size() == num_nodes) {
+      *subrequest.add_departure_costs() = request.departure_costs(node_idx);
+    }
+    if (request.instruction_names_size() == num_nodes) {
+      subrequest.add_instruction_names(request.instruction_names(node_idx));
+    }
+    if (request.opcodes_size() == num_nodes) {
+      subrequest.add_opcodes(request.opcodes(node_idx));
+    }
+    if (request.metadata_source_files_size() == num_nodes) {
+      subrequest.add_metadata_source_files(
+          request.metadata_source_files(node_idx));
+    }
+    if (request.strategy_names_size() == num_nodes) {
+      *subrequest.add_strategy_names() = request.strategy_names(node_idx);
+    }
+  }
+
+  const int64_t num_edges = request.edges_size();
+  for (EdgeIdx edge_idx = 0; edge_idx < num_edges; ++edge_idx) {
+    const auto& edge = request.edges(edge_idx);
+    AutoShardingSolverRequest& subrequest =
+        subrequests[subproblem_of[edge.first()]];
+    AutoShardingSolverRequest_Pair* local_edge = subrequest.add_edges();
+    local_edge->set_first(local_idx[edge.first()]);
+    local_edge->set_second(local_idx[edge.second()]);
+    *subrequest.add_resharding_costs() = request.resharding_costs(edge_idx);
+    if (request.duration_costs_size() == num_edges) {
+      *subrequest.add_duration_costs() = request.duration_costs(edge_idx);
+    }
+    if (request.memory_edge_costs_size() == num_edges) {
+      *subrequest.add_memory_edge_costs() =
+          request.memory_edge_costs(edge_idx);
+    }
+  }
+
+  for (AliasIdx alias_idx = 0; alias_idx < request.aliases_size();
+       ++alias_idx) {
+    const auto& alias = request.aliases(alias_idx);
+    AutoShardingSolverRequest& subrequest =
+        subrequests[subproblem_of[alias.first()]];
+    AutoShardingSolverRequest_Pair* local_alias = subrequest.add_aliases();
+    local_alias->set_first(local_idx[alias.first()]);
+    local_alias->set_second(local_idx[alias.second()]);
+    *subrequest.add_value_costs() = request.value_costs(alias_idx);
+  }
+  return subrequests;
+}
+
+// Solves the independent subproblems of the request concurrently and merges
+// their solutions. Falls back to solving the request as a whole if it does not
+// decompose.
+absl::StatusOr<AutoShardingSolverOutput> SolveDecomposed(
+    const AutoShardingSolverRequest& unscaled_request) {
+  const absl::Time start_time = absl::Now();
+  const AutoShardingSolverRequest& request = ScaleRequest(unscaled_request);
+  const std::vector<int64_t> subproblem_of =
+      FindIndependentSubproblems(request, kMaxSubproblems);
+  const int64_t num_subproblems =
+      subproblem_of.empty()
+          ? 0
+          : *std::max_element(subproblem_of.begin(), subproblem_of.end()) + 1;
+  if (num_subproblems <= 1) {
+    return FormulateAndSolveMIP(unscaled_request, kNumWorkers);
+  }
+
+  const std::vector<AutoShardingSolverRequest> subrequests =
+      SplitRequest(request, subproblem_of, num_subproblems);
+  std::vector<absl::StatusOr<AutoShardingSolverOutput>> results(
+      num_subproblems);
+  {
+    const int num_workers =
+        std::max<int>(1, kNumWorkers / static_cast<int>(num_subproblems));
+    tsl::thread::ThreadPool pool(tsl::Env::Default(), "auto_sharding_solver",
+                                 num_subproblems);
+    for (int64_t i = 0; i < num_subproblems; ++i) {
+      pool.Schedule([&, i] {
+        // Subrequests are already scaled, so their costs are only meaningful
+        // once merged and evaluated against the original request below.
+        results[i] = FormulateAndSolveMIP(subrequests[i], num_workers,
+                                          /*log_total_costs=*/false);
+      });
+    }
+  }
+
+  AutoShardingSolverOutput output;
+  output.s_val.resize(request.num_nodes());
+  output.cost = 0.0;
+  output.is_optimal = true;
+  std::vector<NodeIdx> next_local_idx(num_subproblems, 0);
+  for (int64_t i = 0; i < num_subproblems; ++i) {
+    TF_RETURN_IF_ERROR(results[i].status());
+    output.cost += results[i]->cost;
+    output.is_optimal &= results[i]->is_optimal;
+    output.solve_times.push_back(results[i]->solve_times.front());
+    LOG(INFO) << "Subproblem " << i << ": "
+              << subrequests[i].num_nodes() << " nodes, "
+              << subrequests[i].edges_size() << " edges, solved in "
+              << absl::ToInt64Milliseconds(output.solve_times.back()) << " ms";
+  }
+  for (NodeIdx node_idx = 0; node_idx < request.num_nodes(); ++node_idx) {
+    const int64_t i = subproblem_of[node_idx];
+    output.s_val[node_idx] = results[i]->s_val[next_local_idx[i]++];
+  }
+  LogTotalCosts(unscaled_request, output);
+  LOG(INFO) << "Solved " << num_subproblems << " subproblems in "
+            << absl::ToInt64Milliseconds(absl::Now() - start_time) << " ms";
+  return output;
+}
+
+}  // namespace
+
+std::optional<std::vector<NodeStrategyIdx>> FindWarmStartSolution(
+    const AutoShardingSolverRequest& request) {
+  const uint64_t fingerprint = StructuralFingerprint(request);
+  WarmStartCache& cache = GetWarmStartCache();
+  absl::MutexLock lock(&cache.mu);
+  auto it = cache.solutions.find(fingerprint);
+  if (it == cache.solutions.end()) return std::nullopt;
+  return it->second;
+}
+
+void ClearWarmStartSolutions() {
+  WarmStartCache& cache = GetWarmStartCache();
+  absl::MutexLock lock(&cache.mu);
+  cache.solutions.clear();
+  cache.fingerprints.clear();
+}
+
+absl::StatusOr<AutoShardingSolverOutput> FormulateAndSolveMIPFromSolverRequest(
+    const AutoShardingSolverRequest& request) {
+  // Hints the solver with the solution of a previous request that had the same
+  // structure, unless the caller provided a hint of their own.
+  std::optional<AutoShardingSolverRequest> hinted_request;
+  if (request.enable_warm_start() && request.s_hint().empty()) {
+    if (auto s_hint = FindWarmStartSolution(request)) {
+      LOG(INFO) << "Warm-starting the solver with a previous solution";
+      hinted_request = request;
+      hinted_request->mutable_s_hint()->Add(s_hint->begin(), s_hint->end());
+    }
+  }
+  const AutoShardingSolverRequest& hinted =
+      hinted_request ? *hinted_request : request;
+
+  absl::StatusOr<AutoShardingSolverOutput> output =
+      request.enable_decomposition() && IsDecomposable(request)
+          ? SolveDecomposed(hinted)
+          : FormulateAndSolveMIP(hinted, kNumWorkers);
+
+  if (request.enable_warm_start() && output.ok()) {
+    const uint64_t fingerprint = StructuralFingerprint(request);
+    WarmStartCache& cache = GetWarmStartCache();
+    absl::MutexLock lock(&cache.mu);
+    if (!cache.solutions.contains(fingerprint)) {
+      cache.fingerprints.push_back(fingerprint);
+    }
+    cache.solutions[fingerprint] = output->s_val;
+    if (cache.fingerprints.size() > kMaxWarmStartSolutions) {
+      cache.solutions.erase(cache.fingerprints.front());
+      cache.fingerprints.pop_front();
+    }
+  }
+  return output;
+}
+
 bool CostComponents::operator==(const CostComponents& other) const {
   return communication_cost == other.communication_cost &&
          computation_cost == other.computation_cost &&
@@ -16,11 +16,13 @@ limitations under the License.
 #ifndef XLA_HLO_EXPERIMENTAL_AUTO_SHARDING_AUTO_SHARDING_SOLVER_H_
 #define XLA_HLO_EXPERIMENTAL_AUTO_SHARDING_AUTO_SHARDING_SOLVER_H_
 
+#include <optional>
 #include <vector>
 
 #include "absl/container/flat_hash_set.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/time/time.h"
 #include "xla/hlo/experimental/auto_sharding/auto_sharding.pb.h"
 #include "xla/hlo/experimental/auto_sharding/auto_sharding_strategy.h"
 #include "ortools/linear_solver/linear_solver.h"
@@ -33,6 +35,9 @@ struct AutoShardingSolverOutput {
   double cost = -1.0;
   bool is_optimal = true;
   absl::flat_hash_set<LivenessIdx> peak_times;
+  // Wall time spent on each independent subproblem, or a single entry if the
+  // request was solved as a whole. Not considered by operator==.
+  std::vector<absl::Duration> solve_times;
 
   bool operator==(const AutoShardingSolverOutput& other) const;
 };
@@ -41,9 +46,23 @@ struct AutoShardingSolverOutput {
 AutoShardingSolverRequest ScaleRequest(
     const AutoShardingSolverRequest& request);
 
+// Solves the request. If `request.enable_warm_start` is set, the solver is
+// hinted with the solution of the last request with the same structure (nodes,
+// strategies, edges and aliases, but not costs) and the new solution is
+// remembered for later requests. If `request.enable_decomposition` is set and
+// the request has no constraints coupling all nodes (such as a memory budget),
+// independent subproblems are solved concurrently.
 absl::StatusOr<AutoShardingSolverOutput> FormulateAndSolveMIPFromSolverRequest(
     const AutoShardingSolverRequest& request);
 
+// Returns the remembered solution of a request with the same structure as
+// `request`, if any.
+std::optional<std::vector<NodeStrategyIdx>> FindWarmStartSolution(
+    const AutoShardingSolverRequest& request);
+
+// Forgets all solutions remembered for warm starts.
+void ClearWarmStartSolutions();
+
 enum AutoShardingViolationCode {
   kAliasViolationCode,     // Some node's strategy does not match its alias
   kFollowerViolationCode,  // Some node's strategy does not match its follower
@@ -13,6 +13,7 @@ limitations under the License.
 #include "xla/hlo/experimental/auto_sharding/auto_sharding_solver.h"
 
 #include <cstdint>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -31,6 +32,8 @@ namespace xla {
 namespace spmd {
 namespace {
 
+using ::testing::Optional;
+
 using CostMatrix = std::vector<std::vector<double>>;
 using NodeMatrix = std::vector<std::vector<int64_t>>;
 using EdgeMatrix = std::vector<std::vector<int64_t>>;
@@ -578,6 +581,69 @@ TEST(FormulateAndSolveMIPFromSolverRequestTest, SolvesWithEquivalences) {
   EXPECT_EQ(result, expected_output);
 }
 
+TEST(FormulateAndSolveMIPFromSolverRequestTest, SolvesIndependentSubproblems) {
+  AutoShardingSolverRequest request = DefaultAutoShardingSolverRequest();
+  request.set_memory_budget(0);
+  // Without the edge 1 -> 2, nodes {0, 2, 3} and {1, 4} are independent.
+  request.mutable_edges()->RemoveLast();
+  request.mutable_resharding_costs()->RemoveLast();
+  request.mutable_duration_costs()->RemoveLast();
+  request.set_enable_decomposition(true);
+
+  TF_ASSERT_OK_AND_ASSIGN(const AutoShardingSolverOutput result,
+                          FormulateAndSolveMIPFromSolverRequest(request));
+
+  const std::vector<NodeStrategyIdx> s_val = {0, 0, 0, 0, 0};
+  const double objective_value = 2650.0;
+  const AutoShardingSolverOutput expected_output = {s_val, objective_value};
+  EXPECT_EQ(result, expected_output);
+  EXPECT_EQ(result.solve_times.size(), 2);
+}
+
+TEST(FormulateAndSolveMIPFromSolverRequestTest,
+     DoesNotDecomposeWithMemoryBudget) {
+  AutoShardingSolverRequest request = DefaultAutoShardingSolverRequest();
+  request.mutable_edges()->RemoveLast();
+  request.mutable_resharding_costs()->RemoveLast();
+  request.mutable_duration_costs()->RemoveLast();
+  request.set_enable_decomposition(true);
+
+  TF_ASSERT_OK_AND_ASSIGN(const AutoShardingSolverOutput result,
+                          FormulateAndSolveMIPFromSolverRequest(request));
+
+  const std::vector<NodeStrategyIdx> s_val = {0, 0, 0, 0, 0};
+  const double objective_value = 2650.0;
+  const AutoShardingSolverOutput expected_output = {s_val, objective_value};
+  EXPECT_EQ(result, expected_output);
+  EXPECT_EQ(result.solve_times.size(), 1);
+}
+
+TEST(FormulateAndSolveMIPFromSolverRequestTest, RemembersWarmStartSolutions) {
+  ClearWarmStartSolutions();
+  AutoShardingSolverRequest request = DefaultAutoShardingSolverRequest();
+  request.set_enable_warm_start(true);
+  EXPECT_EQ(FindWarmStartSolution(request), std::nullopt);
+
+  TF_ASSERT_OK_AND_ASSIGN(const AutoShardingSolverOutput result,
+                          FormulateAndSolveMIPFromSolverRequest(request));
+
+  // Changing costs keeps the structure of the request, and thus its solution.
+  request.mutable_computation_costs(0)->set_costs(0, 1000);
+  EXPECT_THAT(FindWarmStartSolution(request), Optional(result.s_val));
+
+  TF_ASSERT_OK_AND_ASSIGN(const AutoShardingSolverOutput warm_result,
+                          FormulateAndSolveMIPFromSolverRequest(request));
+
+  const std::vector<NodeStrategyIdx> s_val = {0, 0, 0, 0, 0};
+  const double objective_value = 8640.0;
+  const AutoShardingSolverOutput expected_output = {s_val, objective_value};
+  EXPECT_EQ(warm_result, expected_output);
+
+  // Changing the number of strategies of a node changes the structure.
+  request.set_s_len(0, 5);
+  EXPECT_EQ(FindWarmStartSolution(request), std::nullopt);
+}
+
 TEST(AutoShardingEvaluatorTest, NoViolations) {
   const AutoShardingSolverRequest request = DefaultAutoShardingSolverRequest();
   const std::vector<NodeStrategyIdx> s_val = {3, 1, 2, 2, 1};
@@ -128,9 +128,46 @@ HloModule::StackFrame HloModule::get_stack_frame(int id) const {
   return stack_frame;
 }
 
+void HloModule::UniquifyNewInstruction(HloInstruction* instruction) {
+  if (concurrent_instructions_first_id_.has_value()) {
+    absl::MutexLock lock(&concurrent_instructions_mutex_);
+    instruction->SetUniqueId(NewUniqueInstructionId());
+    return;
+  }
+  instruction->UniquifyName(&instruction_name_uniquer_);
+  instruction->SetUniqueId(NewUniqueInstructionId());
+}
+
+void HloModule::StartConcurrentInstructionCreation() {
+  CHECK(!concurrent_instructions_first_id_.has_value());
+  concurrent_instructions_first_id_ = next_unique_id_;
+}
+
+void HloModule::FinishConcurrentInstructionCreation() {
+  CHECK(concurrent_instructions_first_id_.has_value());
+  int first_id = *concurrent_instructions_first_id_;
+  concurrent_instructions_first_id_.reset();
+
+  // Instructions added concurrently got ids in [first_id, next_unique_id_), so
+  // reassigning them from first_id in a deterministic order can't collide with
+  // ids of other instructions.
+  next_unique_id_ = first_id;
+  for (HloComputation* computation : computations()) {
+    for (HloInstruction* instruction : computation->instructions()) {
+      if (instruction->unique_id() < first_id) continue;
+      instruction->ClearUniqueIdInternal();
+      instruction->UniquifyName(&instruction_name_uniquer_);
+      instruction->SetUniqueId(NewUniqueInstructionId());
+    }
+  }
+}
+
 HloComputation* HloModule::AddComputationInternal(
     std::unique_ptr<HloComputation> computation, bool is_entry,
     bool uniquify_identifiers, bool preserve_entry_layouts) {
+  CHECK(!concurrent_instructions_first_id_.has_value())
+      << "Computations can't be added while instructions are added "
+         "concurrently";
   if (is_entry) {
     CHECK_EQ(nullptr, entry_computation_);
     entry_computation_ = computation.get();
@@ -465,6 +465,21 @@ class HloModule {
     return result;
   }
 
+  // Uniquifies the name of an instruction that is added to one of the
+  // computations of this module and assigns it a new unique id.
+  void UniquifyNewInstruction(HloInstruction* instruction);
+
+  // Allows adding instructions to different computations of this module from
+  // multiple threads, e.g. to run a pass on independent computations
+  // concurrently. Until FinishConcurrentInstructionCreation is called, new
+  // instructions get unique ids under a lock and keep their names as given.
+  // FinishConcurrentInstructionCreation then uniquifies names and reassigns ids
+  // of all instructions added in the meantime in the order of computations and
+  // instructions in the module, so the result doesn't depend on thread
+  // scheduling. Computations can't be added in between.
+  void StartConcurrentInstructionCreation();
+  void FinishConcurrentInstructionCreation();
+
   // input_output_alias_config indicates the list of aliased buffers that are
   // expected from the module.
   HloInputOutputAliasConfig& input_output_alias_config() {
@@ -718,6 +733,12 @@ class HloModule {
   NameUniquer instruction_name_uniquer_{/*separator=*/"."};
   int next_unique_id_ = 0;
 
+  // If set, instructions are being added concurrently and all instructions with
+  // ids starting from this one were added since
+  // StartConcurrentInstructionCreation.
+  std::optional<int> concurrent_instructions_first_id_;
+  absl::Mutex concurrent_instructions_mutex_;
+
   // Used to keep track of the next unique module id that should be assigned.
   static std::atomic<int> next_unique_module_id_;
   // A unique id to label modules with.
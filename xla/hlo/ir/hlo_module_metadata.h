@@ -117,6 +117,26 @@ class HloModuleMetadata {
           pass_metadata->add_module_group_module_ids(module_id);
         });
   }
+  absl::Status set_current_pass_instruction_counts(int64_t before,
+                                                  int64_t after) {
+    return MutateCurrentHloPassMetadata(
+        [&before, &after](HloPassMetadata* pass_metadata) {
+          pass_metadata->set_instruction_count_before(before);
+          pass_metadata->set_instruction_count_after(after);
+        });
+  }
+  absl::Status set_current_pass_peak_rss_bytes(int64_t peak_rss_bytes) {
+    return MutateCurrentHloPassMetadata(
+        [&peak_rss_bytes](HloPassMetadata* pass_metadata) {
+          pass_metadata->set_peak_rss_bytes(peak_rss_bytes);
+        });
+  }
+  absl::Status set_current_pass_fixed_point_iterations(int64_t iterations) {
+    return MutateCurrentHloPassMetadata(
+        [&iterations](HloPassMetadata* pass_metadata) {
+          pass_metadata->set_fixed_point_iterations(iterations);
+        });
+  }
 
  private:
   // Gets mutable metadata for the currently running pass. If passes are nested,
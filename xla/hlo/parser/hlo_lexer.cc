@@ -361,7 +361,7 @@ TokKind HloLexer::LexIdentifier() {
     }
   }
 
-  token_state_.str_val = std::string(identifier);
+  token_state_.str_val.assign(identifier.data(), identifier.size());
   return TokKind::kIdent;
 }
 
@@ -393,14 +393,19 @@ TokKind HloLexer::LexPercent() {
 // int ::=  [-]?[0-9]+
 // negative inf ::= '-inf'
 TokKind HloLexer::LexNumberOrPattern() {
+  if (std::optional<TokKind> kind = LexNumberFastPath()) {
+    return *kind;
+  }
+
   absl::string_view consumable = StringViewFromPointers(
       token_state_.token_start, buf_.data() + buf_.size());
   static LazyRE2 float_pattern = {
       R"([-]?((\d+|\d+[.]\d*|\d*[.]\d+)([eE][+-]?\d+))|[-]?(\d+[.]\d*|\d*[.]\d+))"};
   if (RE2::Consume(&consumable, *float_pattern)) {
     current_ptr_ = consumable.data();
-    CHECK(absl::SimpleAtod(std::string(token_state_.token_start, current_ptr_),
-                           &token_state_.decimal_val));
+    CHECK(absl::SimpleAtod(
+        StringViewFromPointers(token_state_.token_start, current_ptr_),
+        &token_state_.decimal_val));
     return TokKind::kDecimal;
   }
 
@@ -469,6 +474,63 @@ TokKind HloLexer::LexNumberOrPattern() {
   return TokKind::kError;
 }
 
+// Large constants consist of millions of numbers, so we lex the common case of
+// a number followed by a separator by hand:
+//
+// number ::= [-]?[0-9]+([.][0-9]*)?([eE][+-]?[0-9]+)?
+//
+// A number directly followed by a character that can continue one of the
+// patterns of LexNumberOrPattern (e.g. 'x' in "2x3" or '_' in "0_1") is left to
+// the regular expressions.
+std::optional<TokKind> HloLexer::LexNumberFastPath() {
+  const char* const end = buf_.data() + buf_.size();
+  const char* ptr = token_state_.token_start;
+  auto is_digit = [&](const char* p) {
+    return p < end && absl::ascii_isdigit(static_cast<unsigned char>(*p));
+  };
+
+  if (ptr < end && *ptr == '-') ++ptr;
+  if (!is_digit(ptr)) return std::nullopt;
+  while (is_digit(ptr)) ++ptr;
+
+  bool is_decimal = false;
+  if (ptr < end && *ptr == '.') {
+    is_decimal = true;
+    ++ptr;
+    while (is_digit(ptr)) ++ptr;
+  }
+  if (ptr < end && (*ptr == 'e' || *ptr == 'E')) {
+    const char* exponent = ptr + 1;
+    if (exponent < end && (*exponent == '+' || *exponent == '-')) ++exponent;
+    if (is_digit(exponent)) {
+      is_decimal = true;
+      ptr = exponent;
+      while (is_digit(ptr)) ++ptr;
+    }
+  }
+
+  if (ptr < end && (IsIdentifierChar(*ptr) || *ptr == '?')) {
+    return std::nullopt;
+  }
+
+  absl::string_view slice =
+      StringViewFromPointers(token_state_.token_start, ptr);
+  if (is_decimal) {
+    if (!absl::SimpleAtod(slice, &token_state_.decimal_val)) {
+      return std::nullopt;
+    }
+    current_ptr_ = ptr;
+    return TokKind::kDecimal;
+  }
+  if (absl::SimpleAtoi(slice, &token_state_.int64_val)) {
+    current_ptr_ = ptr;
+    return TokKind::kInt;
+  }
+  // Integers that don't fit into int64_t (or uint64_t) take the general path,
+  // which reports them.
+  return std::nullopt;
+}
+
 std::pair<unsigned, unsigned> HloLexer::GetLineAndColumn(LocTy location) const {
   unsigned line_no = 1;
   const char* start = buf_.data();
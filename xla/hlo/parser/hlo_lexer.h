@@ -103,7 +103,7 @@ class HloLexer {
   TokKind Lex() { return token_state_.current_kind = LexToken(); }
 
   TokKind GetKind() const { return token_state_.current_kind; }
-  std::string GetStrVal() const {
+  const std::string& GetStrVal() const {
     switch (GetKind()) {
       case TokKind::kName:
       case TokKind::kAttributeName:
@@ -179,6 +179,11 @@ class HloLexer {
   TokKind LexShape();
   TokKind LexConstant();
   TokKind LexNumberOrPattern();
+  // Lexes plain integer and decimal numbers without running the regular
+  // expressions of LexNumberOrPattern. Returns std::nullopt, without consuming
+  // any input, if the token might be something else (e.g. a dim labels or pad
+  // pattern) and needs the general code path.
+  std::optional<TokKind> LexNumberFastPath();
   TokKind LexString();
 
   std::optional<int64_t> LexNanPayload(absl::string_view& consumable);
@@ -376,6 +376,19 @@ class HloParserImpl : public HloParser {
   bool ParseTupleLiteral(Literal* literal, const Shape& shape);
   bool ParseNonTupleLiteral(Literal* literal, const Shape& shape);
   bool ParseDenseLiteral(Literal* literal, const Shape& shape);
+  // Fast path of ParseDenseLiteral for a run of integer and decimal elements
+  // of a numeric literal: parses up to `max_elements` values straight into the
+  // literal buffer, starting at `*linear_index`, and dispatches on the element
+  // type once per run rather than once per element. Stops without an error at
+  // the first token that needs the general code path, e.g. 'nan' or '}'.
+  // Updates `*linear_index` and sets `*num_parsed` to the number of values
+  // parsed.
+  bool ParseDenseLiteralElements(Literal* literal, int64_t max_elements,
+                                 int64_t* linear_index, int64_t* num_parsed);
+  template <typename NativeT>
+  bool ParseDenseLiteralElementsHelper(Literal* literal, int64_t max_elements,
+                                       int64_t* linear_index,
+                                       int64_t* num_parsed);
 
   // Parses and creates instruction given name, shape, opcode etc. This is
   // refactored out from ParseInstructionRhs to allow recursion of wrapped
@@ -4401,6 +4414,64 @@ bool HloParserImpl::SetValueInLiteral(LocTy loc, std::complex<double> value,
       shape.element_type());
 }
 
+bool HloParserImpl::ParseDenseLiteralElements(Literal* literal,
+                                              int64_t max_elements,
+                                              int64_t* linear_index,
+                                              int64_t* num_parsed) {
+  *num_parsed = 0;
+  return primitive_util::PrimitiveTypeSwitch<bool>(
+      [&](auto primitive_type_constant) -> bool {
+        if constexpr (primitive_util::IsIntegralType(primitive_type_constant) ||
+                      primitive_util::IsFloatingPointType(
+                          primitive_type_constant)) {
+          using NativeT = primitive_util::NativeTypeOf<primitive_type_constant>;
+          return ParseDenseLiteralElementsHelper<NativeT>(
+              literal, max_elements, linear_index, num_parsed);
+        }
+        // PRED and complex literals always take the general code path.
+        return true;
+      },
+      literal->shape().element_type());
+}
+
+template <typename NativeT>
+bool HloParserImpl::ParseDenseLiteralElementsHelper(Literal* literal,
+                                                    int64_t max_elements,
+                                                    int64_t* linear_index,
+                                                    int64_t* num_parsed) {
+  constexpr bool kIsIntegral = primitive_util::IsIntegralType(
+      primitive_util::NativeToPrimitiveType<NativeT>());
+  absl::Span<NativeT> data = literal->data<NativeT>();
+  while (*num_parsed < max_elements && *linear_index < data.size()) {
+    LocTy loc = lexer_.GetLoc();
+    if constexpr (kIsIntegral) {
+      if (lexer_.GetKind() != TokKind::kInt) break;
+      int64_t value = lexer_.GetInt64Val();
+      if (!CheckParsedValueIsInRange<NativeT>(loc, value)) return false;
+      data[*linear_index] = static_cast<NativeT>(value);
+    } else {
+      double value;
+      if (lexer_.GetKind() == TokKind::kInt) {
+        value = static_cast<double>(lexer_.GetInt64Val());
+      } else if (lexer_.GetKind() == TokKind::kDecimal &&
+                 std::isfinite(lexer_.GetDecimalVal())) {
+        value = lexer_.GetDecimalVal();
+      } else {
+        // NaNs (which might carry a payload) and overflowing decimals are
+        // handled by SetValueInLiteral and ParseDouble.
+        break;
+      }
+      if (!CheckParsedValueIsInRange<NativeT>(loc, value)) return false;
+      data[*linear_index] = static_cast<NativeT>(value);
+    }
+    ++*linear_index;
+    ++*num_parsed;
+    if (lexer_.Lex() != TokKind::kComma) break;
+    lexer_.Lex();
+  }
+  return true;
+}
+
 // Similar to ParseLiteral(Literal* literal, const Shape& shape), but parse the
 // shape instead of accepting one as argument.
 bool HloParserImpl::ParseLiteral(Literal* literal) {
@@ -4618,10 +4689,25 @@ bool HloParserImpl::ParseDenseLiteral(Literal* literal, const Shape& shape) {
         // Skip.
         lexer_.Lex();
         break;
+      case TokKind::kInt:
+      case TokKind::kDecimal: {
+        if (rank > 0 && nest_level == rank) {
+          int64_t& elems_seen = elems_seen_per_dim[rank - 1];
+          int64_t num_parsed;
+          if (!ParseDenseLiteralElements(
+                  literal, shape.dimensions(rank - 1) - elems_seen,
+                  &linear_index, &num_parsed)) {
+            return false;
+          }
+          elems_seen += num_parsed;
+          if (num_parsed > 0) {
+            break;
+          }
+        }
+        [[fallthrough]];
+      }
       case TokKind::kw_true:
       case TokKind::kw_false:
-      case TokKind::kInt:
-      case TokKind::kDecimal:
       case TokKind::kw_inf:
       case TokKind::kNegInf: {
         add_one_elem_seen();
@@ -4664,7 +4750,10 @@ bool HloParserImpl::ParseDenseLiteral(Literal* literal, const Shape& shape) {
     }  // end of switch
   } while (nest_level > 0);
 
-  *literal = literal->Relayout(shape.layout());
+  // Avoid copying large constants that are already in the right layout.
+  if (literal->shape().layout() != shape.layout()) {
+    *literal = literal->Relayout(shape.layout());
+  }
   return true;
 }
 
@@ -15,7 +15,9 @@ limitations under the License.
 
 #include "xla/hlo/parser/hlo_parser.h"
 
+#include <cmath>
 #include <cstdint>
+#include <limits>
 #include <memory>
 #include <string>
 #include <string_view>
@@ -24,6 +26,7 @@ limitations under the License.
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
+#include "absl/log/check.h"
 #include "absl/log/log.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
@@ -57,6 +60,7 @@ limitations under the License.
 #include "tsl/platform/status_matchers.h"
 #include "tsl/platform/statusor.h"
 #include "tsl/platform/test.h"
+#include "tsl/platform/test_benchmark.h"
 
 namespace xla {
 namespace {
@@ -3230,6 +3234,45 @@ ENTRY %ConstantWithExp.v4 () -> f32[] {
   // printed as "300".
 }
 
+TEST_F(HloParserTest, DenseConstantElements) {
+  const std::string original = R"(
+  HloModule test_module
+  ENTRY test {
+    ROOT c = f32[2,3]{0,1} constant({{1, -2.5, 3e+2}, {nan, 4., -inf}})
+  })";
+  TF_ASSERT_OK_AND_ASSIGN(auto module, ParseAndReturnVerifiedModule(original));
+  const Literal& literal =
+      module->entry_computation()->root_instruction()->literal();
+  EXPECT_EQ(literal.Get<float>({0, 0}), 1.0f);
+  EXPECT_EQ(literal.Get<float>({0, 1}), -2.5f);
+  EXPECT_EQ(literal.Get<float>({0, 2}), 300.0f);
+  EXPECT_TRUE(std::isnan(literal.Get<float>({1, 0})));
+  EXPECT_EQ(literal.Get<float>({1, 1}), 4.0f);
+  EXPECT_EQ(literal.Get<float>({1, 2}),
+            -std::numeric_limits<float>::infinity());
+}
+
+TEST_F(HloParserTest, DenseConstantElementOutOfRange) {
+  const std::string original = R"(
+  HloModule test_module
+  ENTRY test {
+    ROOT c = s8[2,3] constant({{1, 2, 3}, {4, 300, 6}})
+  })";
+  ExpectHasSubstr(ParseAndReturnUnverifiedModule(original).status().message(),
+                  "value 300 is out of range for literal's primitive type S8");
+}
+
+TEST_F(HloParserTest, DenseConstantTooManyElements) {
+  const std::string original = R"(
+  HloModule test_module
+  ENTRY test {
+    ROOT c = s32[2,3] constant({{1, 2, 3}, {4, 5, 6, 7}})
+  })";
+  ExpectHasSubstr(ParseAndReturnUnverifiedModule(original).status().message(),
+                  "expects 3 elements on the minor-most dimension, but sees "
+                  "more");
+}
+
 TEST_F(HloParserTest, ShortConstant) {
   const std::string original =
       R"(HloModule ShortConstant_module, entry_computation_layout={()->f32[67,89]{1,0}}
@@ -5846,5 +5889,49 @@ ENTRY main {
                   "error: unexpected attribute \"result_accuracy\"");
 }
 
+// Synthetic modules resembling large dumps: one with a big dense constant and
+// one with a long chain of elementwise instructions.
+std::string LargeConstantModule(int64_t num_elements) {
+  std::string text = absl::StrCat(
+      "HloModule large_constant\n\nENTRY main {\n  ROOT c = f32[",
+      num_elements, "] constant({");
+  for (int64_t i = 0; i < num_elements; ++i) {
+    absl::StrAppend(&text, i > 0 ? ", " : "", i * 0.25);
+  }
+  absl::StrAppend(&text, "})\n}\n");
+  return text;
+}
+
+std::string ManyInstructionsModule(int64_t num_instructions) {
+  std::string text =
+      "HloModule many_instructions\n\nENTRY main {\n"
+      "  add.0 = f32[8,8]{1,0} parameter(0)\n";
+  for (int64_t i = 1; i <= num_instructions; ++i) {
+    absl::StrAppend(&text, "  add.", i, " = f32[8,8]{1,0} add(add.", i - 1,
+                    ", add.", i - 1, "), metadata={op_name=\"add\"}\n");
+  }
+  absl::StrAppend(&text, "}\n");
+  return text;
+}
+
+void BM_ParseLargeConstant(benchmark::State& state) {
+  std::string text = LargeConstantModule(state.range(0));
+  for (auto s : state) {
+    CHECK_OK(ParseAndReturnUnverifiedModule(text).status());
+  }
+  state.SetBytesProcessed(state.iterations() * text.size());
+}
+
+void BM_ParseManyInstructions(benchmark::State& state) {
+  std::string text = ManyInstructionsModule(state.range(0));
+  for (auto s : state) {
+    CHECK_OK(ParseAndReturnUnverifiedModule(text).status());
+  }
+  state.SetBytesProcessed(state.iterations() * text.size());
+}
+
+BENCHMARK(BM_ParseLargeConstant)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 22);
+BENCHMARK(BM_ParseManyInstructions)->Arg(1 << 8)->Arg(1 << 12)->Arg(1 << 16);
+
 }  // namespace
 }  // namespace xla
@@ -17,9 +17,14 @@ limitations under the License.
 #define XLA_HLO_PASS_HLO_PASS_FIX_H_
 
 #include <algorithm>
+#include <cstdint>
 #include <type_traits>
+#include <utility>
 
+#include "absl/base/thread_annotations.h"
 #include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "xla/hlo/ir/hlo_computation.h"
 #include "xla/hlo/ir/hlo_module.h"
 #include "xla/hlo/ir/hlo_module_group.h"
 #include "xla/hlo/pass/hlo_pass_interface.h"
@@ -29,7 +34,7 @@ limitations under the License.
 namespace xla {
 
 // Do an HLO pass to a fix point.
-template <typename Pass, int kIterationLimit = 25>
+template <typename Pass, int kIterationLimit = 25, typename Enable = void>
 class HloPassFix : public Pass {
  public:
   static_assert(std::is_base_of<HloPassInterface, Pass>::value,
@@ -56,6 +61,7 @@ class HloPassFix : public Pass {
                                execution_threads) override {
     RunState run_state(module);
     TF_RETURN_IF_ERROR(RunToFixPoint(module, &run_state, execution_threads));
+    RecordIterations(module, run_state.iteration);
     return !run_state.changed.empty();
   }
 
@@ -78,14 +84,28 @@ class HloPassFix : public Pass {
       if (iteration_count == kIterationLimit) {
         VLOG(1) << "Unexpectedly high number of iterations in HLO passes, "
                    "exiting fixed point loop.";
+        for (HloModule* module : module_group->modules()) {
+          RecordIterations(module, iteration_count);
+        }
         // Return false in case this is fixed point is nested.
         return false;
       }
     }
+    for (HloModule* module : module_group->modules()) {
+      RecordIterations(module, iteration_count);
+    }
     return changed;
   }
 
  private:
+  // Records the number of iterations in the metadata of the currently running
+  // pass. There is no such pass if we are not run by an HloPassPipeline.
+  static void RecordIterations(HloModule* module, int64_t iterations) {
+    module->metadata()
+        ->set_current_pass_fixed_point_iterations(iterations)
+        .IgnoreError();
+  }
+
   absl::Status RunToFixPoint(
       HloModule* module, RunState* run_state,
       const absl::flat_hash_set<absl::string_view>& execution_threads) {
@@ -131,6 +151,65 @@ class HloPassFix : public Pass {
   }
 };
 
+// Do a computation pass to a fix point. Computations are transformed
+// independently of each other, so every computation is run to its own fix point
+// and the pipeline can still run the pass on computations concurrently.
+template <typename Pass, int kIterationLimit>
+class HloPassFix<Pass, kIterationLimit,
+                 std::enable_if_t<std::is_base_of_v<HloComputationPass, Pass>>>
+    : public Pass {
+ public:
+  template <typename... Args>
+  explicit HloPassFix(Args&&... args) : Pass(args...) {}
+
+  absl::StatusOr<bool> RunOnComputation(HloComputation* computation) override {
+    bool changed = false;
+    bool fixed_point = false;
+    int64_t iterations = 0;
+    while (!fixed_point && iterations < kIterationLimit) {
+      TF_ASSIGN_OR_RETURN(bool changed_this_iteration,
+                          Pass::RunOnComputation(computation));
+      ++iterations;
+      fixed_point = !changed_this_iteration;
+      changed |= changed_this_iteration;
+    }
+    RecordIterations(computation->parent(), iterations);
+    if (fixed_point) return changed;
+
+    VLOG(1) << "Unexpectedly high number of iterations in HLO passes '"
+            << Pass::name() << "' for computation '" << computation->name()
+            << "'. Exiting fixed point loop.";
+    // Return false in case this is fixed point is nested.
+    return false;
+  }
+
+ private:
+  // Records the largest number of iterations any computation needed so far in
+  // the metadata of the currently running pass. There is no such pass if we
+  // are not run by an HloPassPipeline. Computations may run concurrently, so
+  // the metadata is only updated under `mu_`.
+  void RecordIterations(HloModule* module, int64_t iterations) {
+    absl::MutexLock lock(&mu_);
+    absl::StatusOr<int64_t> pass_id = module->metadata()->current_pass_id();
+    if (!pass_id.ok()) return;
+
+    // Start over for every run of the pass.
+    std::pair<int, int64_t> run = {module->unique_id(), *pass_id};
+    if (run != recorded_run_) {
+      recorded_run_ = run;
+      max_iterations_ = 0;
+    }
+    max_iterations_ = std::max(max_iterations_, iterations);
+    module->metadata()
+        ->set_current_pass_fixed_point_iterations(max_iterations_)
+        .IgnoreError();
+  }
+
+  absl::Mutex mu_;
+  std::pair<int, int64_t> recorded_run_ ABSL_GUARDED_BY(mu_) = {-1, -1};
+  int64_t max_iterations_ ABSL_GUARDED_BY(mu_) = 0;
+};
+
 }  // namespace xla
 
 #endif  // XLA_HLO_PASS_HLO_PASS_FIX_H_
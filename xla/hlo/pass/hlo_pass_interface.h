@@ -124,6 +124,9 @@ class HloPassInterface {
 
   virtual bool IsPassPipeline() const { return false; }
 
+  // Returns true if the pass derives from HloComputationPass.
+  virtual bool IsComputationPass() const { return false; }
+
   // If an HloPassMetadata has previously been created, it adds a (key, value)
   // pair metric if none was already set or updates the existing value.
   // If an HloPassMetadata doesn't exist, it simply returns.
@@ -167,6 +170,40 @@ class HloModulePass : public HloPassInterface {
   }
 };
 
+// Base class for module-scoped passes which transform every non-fusion
+// computation independently of all other computations. RunOnComputation may
+// only read and modify the given computation and the computations nested in
+// its fusions. It must not add or remove computations, depend on the names of
+// instructions it adds, or mutate state of the pass object. It may read the
+// computations called by the given computation, which are always processed
+// before it. HloPassPipeline runs such passes on multiple computations
+// concurrently if DebugOptions::xla_hlo_pass_computation_parallelism is set.
+//
+// Run is final because the pipeline calls RunOnComputation directly.
+class HloComputationPass : public HloModulePass {
+ public:
+  using HloPassInterface::Run;
+  absl::StatusOr<bool> Run(HloModule* module,
+                           const absl::flat_hash_set<absl::string_view>&
+                               execution_threads) final {
+    bool changed = false;
+    for (HloComputation* computation :
+         module->MakeNonfusionComputations(execution_threads)) {
+      TF_ASSIGN_OR_RETURN(bool computation_changed,
+                          RunOnComputation(computation));
+      changed |= computation_changed;
+    }
+    return changed;
+  }
+
+  // Runs the pass on a single computation. Returns whether it modified the
+  // computation. Must be thread-safe.
+  virtual absl::StatusOr<bool> RunOnComputation(
+      HloComputation* computation) = 0;
+
+  bool IsComputationPass() const override { return true; }
+};
+
 // Base class for passes which are module-group scoped. These passes cannot run
 // on an HLO module.
 class HloModuleGroupPass : public HloPassInterface {
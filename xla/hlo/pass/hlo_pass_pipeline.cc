@@ -15,15 +15,30 @@ limitations under the License.
 
 #include "xla/hlo/pass/hlo_pass_pipeline.h"
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <numeric>
 #include <string>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/blocking_counter.h"
+#include "xla/hlo/ir/hlo_computation.h"
+#include "xla/hlo/ir/hlo_instruction.h"
+#include "xla/hlo/ir/hlo_module.h"
+#include "xla/hlo/ir/hlo_module_group.h"
+#include "xla/hlo/pass/hlo_pass_interface.h"
+#include "xla/service/compilation_stats.h"
 #include "xla/service/dump.h"
 #include "xla/service/hlo_graph_dumper.h"
 #include "xla/service/hlo_proto_util.h"
@@ -31,9 +46,11 @@ limitations under the License.
 #include "xla/types.h"
 #include "xla/util.h"
 #include "xla/xla.pb.h"
+#include "tsl/platform/env.h"
 #include "tsl/platform/errors.h"
 #include "tsl/platform/logging.h"
 #include "tsl/platform/status.h"
+#include "tsl/platform/threadpool.h"
 #include "tsl/profiler/lib/scoped_annotation.h"
 #include "tsl/profiler/lib/traceme.h"
 
@@ -57,47 +74,85 @@ void RecordPassStartMetadata(HloModuleGroup& module_group,
   }
 }
 
+int64_t InstructionCount(const HloModule& module) {
+  int64_t count = 0;
+  for (const HloComputation* computation : module.computations()) {
+    count += computation->instruction_count();
+  }
+  return count;
+}
+
+int64_t InstructionCount(const HloModuleGroup& module_group) {
+  int64_t count = 0;
+  for (const HloModule* module : module_group.modules()) {
+    count += InstructionCount(*module);
+  }
+  return count;
+}
+
 absl::Status AttemptRecordPassEndMetadata(HloModule& module,
                                           const std::string& pass_name,
-                                          bool module_changed) {
+                                          bool module_changed,
+                                          int64_t instruction_count_before,
+                                          int64_t instruction_count_after,
+                                          int64_t peak_rss_bytes) {
   // Module id is set here instead of RecordPassStartMetadata because it may
   // change in the middle of the pass, and we want the final id.
   TF_RETURN_IF_ERROR(
       module.metadata()->set_current_pass_module_id(module.unique_id()));
   TF_RETURN_IF_ERROR(
       module.metadata()->set_current_pass_module_changed(module_changed));
+  if (instruction_count_before >= 0) {
+    TF_RETURN_IF_ERROR(module.metadata()->set_current_pass_instruction_counts(
+        instruction_count_before, instruction_count_after));
+  }
+  TF_RETURN_IF_ERROR(
+      module.metadata()->set_current_pass_peak_rss_bytes(peak_rss_bytes));
   TF_RETURN_IF_ERROR(module.metadata()->RecordPassEnd());
   return absl::OkStatus();
 }
 
+// `instruction_count_before` is -1 if the pipeline does not collect instruction
+// counts, in which case none are recorded.
 void RecordPassEndMetadata(HloModule& module, const std::string& pass_name,
-                           bool module_changed) {
-  absl::Status status =
-      AttemptRecordPassEndMetadata(module, pass_name, module_changed);
+                           bool module_changed,
+                           int64_t instruction_count_before) {
+  absl::Status status = AttemptRecordPassEndMetadata(
+      module, pass_name, module_changed, instruction_count_before,
+      instruction_count_before >= 0 ? InstructionCount(module) : -1,
+      CompilationStats::PeakRssBytes());
   if (!status.ok()) {
     LOG(FATAL) << status;
   }
 }
 
+// Instruction counts are recorded for the whole group, since passes may
+// replace modules in the group.
 absl::Status AttemptRecordPassEndMetadata(HloModuleGroup& module_group,
                                           const std::string& pass_name,
-                                          bool module_changed) {
+                                          bool module_changed,
+                                          int64_t instruction_count_before) {
+  int64_t instruction_count_after =
+      instruction_count_before >= 0 ? InstructionCount(module_group) : -1;
+  int64_t peak_rss_bytes = CompilationStats::PeakRssBytes();
   for (HloModule* module : module_group.modules()) {
     for (HloModule* other_module : module_group.modules()) {
       TF_RETURN_IF_ERROR(
           module->metadata()->add_current_pass_module_group_module_id(
               other_module->unique_id()));
     }
-    TF_RETURN_IF_ERROR(
-        AttemptRecordPassEndMetadata(*module, pass_name, module_changed));
+    TF_RETURN_IF_ERROR(AttemptRecordPassEndMetadata(
+        *module, pass_name, module_changed, instruction_count_before,
+        instruction_count_after, peak_rss_bytes));
   }
   return absl::OkStatus();
 }
 
 void RecordPassEndMetadata(HloModuleGroup& module_group,
-                           const std::string& pass_name, bool module_changed) {
-  absl::Status status =
-      AttemptRecordPassEndMetadata(module_group, pass_name, module_changed);
+                           const std::string& pass_name, bool module_changed,
+                           int64_t instruction_count_before) {
+  absl::Status status = AttemptRecordPassEndMetadata(
+      module_group, pass_name, module_changed, instruction_count_before);
   if (!status.ok()) {
     LOG(FATAL) << status;
   }
@@ -148,9 +203,18 @@ absl::StatusOr<bool> HloPassPipeline::RunPassesInternal(
   // Copy string by value since debug options could get clobbered in an hlo
   // module group pass.
   std::string dump_regex = debug_options.xla_dump_hlo_pass_re();
+  int computation_parallelism =
+      debug_options.xla_hlo_pass_computation_parallelism();
   static constexpr absl::string_view kPipelineStart = "pipeline-start";
   static constexpr absl::string_view kPipelineEnd = "pipeline-end";
   std::string pipeline_name = std::string(name());
+  // Counting instructions walks the whole module, so only do it when the
+  // counts end up in the stats or in the dumped module metadata.
+  const bool count_instructions = compilation_stats_->IsEnabled() ||
+                                  debug_options.xla_dump_module_metadata();
+  auto instruction_count = [&] {
+    return count_instructions ? InstructionCount(*hlo) : int64_t{-1};
+  };
   tsl::profiler::ScopedAnnotation annotation{[&] {
     return absl::StrFormat("XlaPassPipeline:#name=%s,module=%s,program_id=%s#",
                            pipeline_name, hlo->name(), UniqueId(*hlo));
@@ -166,7 +230,8 @@ absl::StatusOr<bool> HloPassPipeline::RunPassesInternal(
                                    ? kPipelineEnd
                                    : passes.front()->name());
   RecordPassEndMetadata(*hlo, std::string(kPipelineStart),
-                        /*module_changed=*/false);
+                        /*module_changed=*/false,
+                        /*instruction_count_before=*/instruction_count());
 
   bool changed = false;
   for (int i = 0; i < passes.size(); i++) {
@@ -182,9 +247,22 @@ absl::StatusOr<bool> HloPassPipeline::RunPassesInternal(
     tsl::profiler::TraceMe traceme(pass->name());
     if (!pass->IsPassPipeline()) {
       compilation_stats_->StartPass(pass_name);
+    } else {
+      // Nested pipelines without stats of their own record their passes in
+      // ours, so that the stats cover the whole pipeline.
+      auto* nested = static_cast<HloPassPipeline*>(pass);
+      if (nested->empty_compilation_stats_ != nullptr) {
+        nested->compilation_stats_ = compilation_stats_;
+      }
     }
     RecordPassStartMetadata(*hlo, pass_name, pipeline_name);
-    auto status_or_changed = RunHelper(pass, hlo, execution_threads);
+    int64_t instruction_count_before = instruction_count();
+    auto status_or_changed =
+        pass->IsComputationPass()
+            ? RunComputationPassHelper(static_cast<HloComputationPass*>(pass),
+                                       hlo, computation_parallelism,
+                                       execution_threads)
+            : RunHelper(pass, hlo, execution_threads);
     if (auto status = status_or_changed.status(); !status.ok()) {
       compilation_stats_->RecordPassError(
           pass_name, absl::StatusCodeToString(status.code()));
@@ -197,7 +275,8 @@ absl::StatusOr<bool> HloPassPipeline::RunPassesInternal(
                                        ? kPipelineEnd
                                        : passes[i + 1]->name());
     }
-    RecordPassEndMetadata(*hlo, pass_name, pass_changed);
+    RecordPassEndMetadata(*hlo, pass_name, pass_changed,
+                          instruction_count_before);
     changed |= pass_changed;
     if (pass_changed) {
       VLOG(3) << "  Pass caused changes " << pass_name;
@@ -209,12 +288,110 @@ absl::StatusOr<bool> HloPassPipeline::RunPassesInternal(
       TF_RETURN_IF_ERROR(status);
     }
     if (!pass->IsPassPipeline()) {
+      if (count_instructions) {
+        compilation_stats_->RecordPassInstructionCounts(
+            pass_name, instruction_count_before, InstructionCount(*hlo));
+      }
       compilation_stats_->EndPass(pass_name);
     }
   }
   return changed;
 }
 
+absl::StatusOr<bool> HloPassPipeline::RunComputationPassHelper(
+    HloComputationPass* pass, HloModule* module, int parallelism,
+    const absl::flat_hash_set<absl::string_view>& execution_threads) {
+  std::vector<HloComputation*> computations =
+      module->MakeNonfusionComputations(execution_threads);
+  // Passes might update the schedule, which refers to instructions by id, and
+  // ids are only final after all computations are processed.
+  if (parallelism < 2 || computations.size() < 2 || module->has_schedule()) {
+    return RunHelper(pass, module, execution_threads);
+  }
+
+  if (computation_thread_pool_ == nullptr ||
+      computation_thread_pool_->NumThreads() != parallelism) {
+    computation_thread_pool_ = std::make_unique<tsl::thread::ThreadPool>(
+        tsl::Env::Default(), "hlo_pass_pipeline", parallelism);
+  }
+
+  VLOG(2) << "  Running " << pass->name() << " on " << computations.size()
+          << " computations using " << parallelism << " threads";
+
+  // A computation may read the computations it calls, directly or from its
+  // fusions, so it is only processed once all of them are done. This is the
+  // post order in which HloComputationPass::Run processes them as well.
+  absl::flat_hash_map<const HloComputation*, size_t> computation_index;
+  for (size_t i = 0; i < computations.size(); ++i) {
+    computation_index[computations[i]] = i;
+  }
+  std::vector<std::vector<size_t>> callers(computations.size());
+  auto pending_callees =
+      std::make_unique<std::atomic<size_t>[]>(computations.size());
+  for (size_t i = 0; i < computations.size(); ++i) {
+    absl::flat_hash_set<size_t> callees;
+    std::vector<const HloComputation*> worklist = {computations[i]};
+    while (!worklist.empty()) {
+      const HloComputation* computation = worklist.back();
+      worklist.pop_back();
+      for (const HloInstruction* instruction : computation->instructions()) {
+        for (const HloComputation* called :
+             instruction->called_computations()) {
+          if (called->IsFusionComputation()) {
+            worklist.push_back(called);
+          } else if (auto it = computation_index.find(called);
+                     it != computation_index.end() && it->second != i) {
+            callees.insert(it->second);
+          }
+        }
+      }
+    }
+    pending_callees[i] = callees.size();
+    for (size_t callee : callees) callers[callee].push_back(i);
+  }
+
+  std::vector<absl::StatusOr<bool>> results(computations.size());
+  std::vector<uint64_t> durations_micros(computations.size());
+
+  module->StartConcurrentInstructionCreation();
+  absl::BlockingCounter counter(computations.size());
+  std::function<void(size_t)> run_on_computation = [&](size_t i) {
+    uint64_t start_micros = tsl::Env::Default()->NowMicros();
+    results[i] = pass->RunOnComputation(computations[i]);
+    durations_micros[i] = tsl::Env::Default()->NowMicros() - start_micros;
+    for (size_t caller : callers[i]) {
+      if (pending_callees[caller].fetch_sub(1) == 1) {
+        computation_thread_pool_->Schedule(
+            [&, caller] { run_on_computation(caller); });
+      }
+    }
+    counter.DecrementCount();
+  };
+  for (size_t i = 0; i < computations.size(); ++i) {
+    if (pending_callees[i] == 0) {
+      computation_thread_pool_->Schedule([&, i] { run_on_computation(i); });
+    }
+  }
+  counter.Wait();
+  module->FinishConcurrentInstructionCreation();
+
+  compilation_stats_->RecordPassParallelism(
+      pass->name(), computations.size(),
+      std::accumulate(durations_micros.begin(), durations_micros.end(),
+                      uint64_t{0}) /
+          1000.0);
+
+  // Return the error of the first failed computation, so that errors don't
+  // depend on thread scheduling either.
+  bool changed = false;
+  for (absl::StatusOr<bool>& result : results) {
+    TF_ASSIGN_OR_RETURN(bool computation_changed, std::move(result));
+    changed |= computation_changed;
+  }
+  module->Cleanup();
+  return changed;
+}
+
 std::vector<HloPassInterface*> HloPassPipeline::GetEnabledPasses(
     const DebugOptions& debug_options) {
   if (debug_options.xla_disable_all_hlo_passes()) {
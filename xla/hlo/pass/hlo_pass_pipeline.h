@@ -32,6 +32,7 @@ limitations under the License.
 #include "xla/service/compilation_stats.h"
 #include "xla/types.h"
 #include "xla/xla.pb.h"
+#include "tsl/platform/threadpool.h"
 
 namespace xla {
 
@@ -156,6 +157,18 @@ class HloPassPipeline : public HloPassInterface {
     return changed;
   }
 
+  // Runs a computation pass on the non-fusion computations of the module using
+  // up to `parallelism` threads. A computation is processed after the
+  // computations it calls. Module groups are processed sequentially.
+  absl::StatusOr<bool> RunComputationPassHelper(
+      HloComputationPass* pass, HloModule* module, int parallelism,
+      const absl::flat_hash_set<absl::string_view>& execution_threads);
+  absl::StatusOr<bool> RunComputationPassHelper(
+      HloComputationPass* pass, HloModuleGroup* module_group, int parallelism,
+      const absl::flat_hash_set<absl::string_view>& execution_threads) {
+    return RunHelper(pass, module_group, execution_threads);
+  }
+
   const std::string name_;
   std::vector<std::unique_ptr<HloPassInterface>> passes_;
   std::vector<std::unique_ptr<HloPassInterface>> invariant_checkers_;
@@ -166,6 +179,10 @@ class HloPassPipeline : public HloPassInterface {
   // Use via compilation_stats_, not directly.
   std::unique_ptr<CompilationStats> empty_compilation_stats_;
 
+  // Thread pool for running computation passes concurrently, created on first
+  // use.
+  std::unique_ptr<tsl::thread::ThreadPool> computation_thread_pool_;
+
   // Allow PhaseOrderPipeline to modify private passes_ member in order to
   // perform PhaseOrdering.
   friend class ::xla::PhaseOrderPipeline;
@@ -23,28 +23,38 @@ limitations under the License.
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
+#include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
 #include "absl/types/span.h"
 #include "xla/hlo/ir/hlo_computation.h"
 #include "xla/hlo/ir/hlo_instruction.h"
 #include "xla/hlo/ir/hlo_module.h"
 #include "xla/hlo/ir/hlo_module_group.h"
+#include "xla/hlo/ir/hlo_opcode.h"
 #include "xla/hlo/parser/hlo_parser.h"
+#include "xla/hlo/pass/hlo_pass_fix.h"
 #include "xla/hlo/pass/hlo_pass_interface.h"
 #include "xla/hlo/testlib/hlo_hardware_independent_test_base.h"
+#include "xla/service/compilation_stats.h"
 #include "xla/service/hlo.pb.h"
 #include "xla/test_helpers.h"
 #include "xla/tsl/lib/core/status_test_util.h"
 #include "xla/util.h"
+#include "tsl/platform/status_matchers.h"
 #include "tsl/platform/statusor.h"
 
 namespace xla {
 namespace {
 
 using ::testing::ElementsAre;
+using ::testing::HasSubstr;
+using ::tsl::testing::IsOkAndHolds;
 using ::testing::SizeIs;
 using ::testing::StrEq;
 
@@ -64,6 +74,7 @@ class HloPassPipelineTest : public HloHardwareIndependentTestBase {
 
 // A module pass which renames instructions named 'foo' to 'bar'.
 class FooToBarModulePass : public HloModulePass {
+ public:
   absl::string_view name() const override { return "foo2bar"; }
 
   using HloPassInterface::Run;
@@ -131,6 +142,63 @@ class BazToQuxModuleGroupPass : public HloModuleGroupPass {
   }
 };
 
+// A computation pass which negates array roots of computations twice.
+class NegateRootsComputationPass : public HloComputationPass {
+  absl::string_view name() const override { return "negate-roots"; }
+
+  absl::StatusOr<bool> RunOnComputation(HloComputation* computation) override {
+    HloInstruction* root = computation->root_instruction();
+    if (!root->shape().IsArray()) return false;
+    for (int i = 0; i < 2; ++i) {
+      root = computation->AddInstruction(
+          HloInstruction::CreateUnary(root->shape(), HloOpcode::kNegate, root));
+    }
+    computation->set_root_instruction(root);
+    return true;
+  }
+};
+
+// A computation pass which replaces a negate root by its operand.
+class PeelNegateRootComputationPass : public HloComputationPass {
+  absl::string_view name() const override { return "peel-negate-root"; }
+
+  absl::StatusOr<bool> RunOnComputation(HloComputation* computation) override {
+    HloInstruction* root = computation->root_instruction();
+    if (root->opcode() != HloOpcode::kNegate) return false;
+    computation->set_root_instruction(root->mutable_operand(0));
+    return true;
+  }
+};
+
+// A computation pass which returns an error if a computation is processed
+// before the computations it calls.
+class CalleesFirstComputationPass : public HloComputationPass {
+  absl::string_view name() const override { return "callees-first"; }
+
+  absl::StatusOr<bool> RunOnComputation(HloComputation* computation) override {
+    {
+      absl::MutexLock lock(&mu_);
+      for (const HloInstruction* instruction : computation->instructions()) {
+        for (const HloComputation* callee :
+             instruction->called_computations()) {
+          if (!done_.contains(callee)) {
+            return Internal("%s ran before %s", computation->name(),
+                            callee->name());
+          }
+        }
+      }
+    }
+    // Give callers a chance to run too early.
+    absl::SleepFor(absl::Milliseconds(10));
+    absl::MutexLock lock(&mu_);
+    done_.insert(computation);
+    return false;
+  }
+
+  absl::Mutex mu_;
+  absl::flat_hash_set<const HloComputation*> done_ ABSL_GUARDED_BY(mu_);
+};
+
 // An invariant checker pass which returns an error if there exists an
 // instruction named 'bar'.
 class BarBlowerUpper : public HloModulePass {
@@ -419,5 +487,232 @@ TEST_F(HloPassPipelineTest, SetHloModuleMetadata) {
   }
 }
 
+TEST_F(HloPassPipelineTest, ComputationPassRunsConcurrently) {
+  const std::string module_str = R"(
+HloModule ComputationPassRunsConcurrently
+
+square {
+  p = f32[] parameter(0)
+  ROOT mul = f32[] multiply(p, p)
+}
+
+double {
+  p = f32[] parameter(0)
+  ROOT add = f32[] add(p, p)
+}
+
+negate {
+  p = f32[] parameter(0)
+  ROOT neg = f32[] negate(p)
+}
+
+ENTRY main {
+  a = f32[] parameter(0)
+  x = f32[] call(a), to_apply=square
+  y = f32[] call(a), to_apply=double
+  z = f32[] call(a), to_apply=negate
+  ROOT tuple = (f32[], f32[], f32[]) tuple(x, y, z)
+}
+)";
+
+  auto run = [&](int parallelism)
+      -> absl::StatusOr<std::unique_ptr<VerifiedHloModule>> {
+    TF_ASSIGN_OR_RETURN(std::unique_ptr<VerifiedHloModule> module,
+                        ParseAndReturnVerifiedModule(module_str));
+    module->mutable_config()
+        .mutable_debug_options()
+        .set_xla_hlo_pass_computation_parallelism(parallelism);
+    HloPassPipeline pipeline(TestName());
+    pipeline.AddPass<NegateRootsComputationPass>();
+    TF_ASSIGN_OR_RETURN(bool changed, pipeline.Run(module.get()));
+    EXPECT_TRUE(changed);
+    TF_RETURN_IF_ERROR(
+        module->CheckUniqueNamesAndIdsForComputationsAndInstructions());
+    for (HloComputation* computation : module->computations()) {
+      if (computation == module->entry_computation()) continue;
+      EXPECT_EQ(computation->root_instruction()->opcode(), HloOpcode::kNegate);
+      EXPECT_EQ(computation->instruction_count(), 4);
+    }
+    return module;
+  };
+
+  // New instructions are named in a different order than in a sequential run,
+  // but the resulting computations are the same.
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<VerifiedHloModule> sequential,
+                          run(/*parallelism=*/1));
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<VerifiedHloModule> first,
+                          run(/*parallelism=*/4));
+  EXPECT_EQ(first->ToString(HloPrintOptions::Canonical()),
+            sequential->ToString(HloPrintOptions::Canonical()));
+  for (int i = 0; i < 10; ++i) {
+    // Names and ids of new instructions don't depend on thread scheduling.
+    TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<VerifiedHloModule> module,
+                            run(/*parallelism=*/4));
+    EXPECT_EQ(module->ToString(), first->ToString());
+  }
+}
+
+TEST_F(HloPassPipelineTest, ComputationPassRunsCalleesFirst) {
+  const std::string module_str = R"(
+HloModule ComputationPassRunsCalleesFirst
+
+leaf {
+  p = f32[] parameter(0)
+  ROOT neg = f32[] negate(p)
+}
+
+middle {
+  p = f32[] parameter(0)
+  ROOT c = f32[] call(p), to_apply=leaf
+}
+
+other {
+  p = f32[] parameter(0)
+  ROOT c = f32[] call(p), to_apply=leaf
+}
+
+ENTRY main {
+  a = f32[] parameter(0)
+  x = f32[] call(a), to_apply=middle
+  y = f32[] call(a), to_apply=other
+  ROOT tuple = (f32[], f32[]) tuple(x, y)
+}
+)";
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<VerifiedHloModule> module,
+                          ParseAndReturnVerifiedModule(module_str));
+  module->mutable_config()
+      .mutable_debug_options()
+      .set_xla_hlo_pass_computation_parallelism(4);
+  HloPassPipeline pipeline(TestName());
+  pipeline.AddPass<CalleesFirstComputationPass>();
+  EXPECT_THAT(pipeline.Run(module.get()), IsOkAndHolds(false));
+}
+
+TEST_F(HloPassPipelineTest, RecordComputationPassFixedPointIterations) {
+  const std::string module_str = R"(
+HloModule RecordComputationPassFixedPointIterations
+
+other {
+  p = f32[] parameter(0)
+  ROOT n = f32[] negate(p)
+}
+
+ENTRY main {
+  a = f32[] parameter(0)
+  c = f32[] call(a), to_apply=other
+  n0 = f32[] negate(c)
+  n1 = f32[] negate(n0)
+  ROOT n2 = f32[] negate(n1)
+}
+)";
+  for (int parallelism : {1, 4}) {
+    TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<VerifiedHloModule> module,
+                            ParseAndReturnVerifiedModule(module_str));
+    module->mutable_config()
+        .mutable_debug_options()
+        .set_xla_hlo_pass_computation_parallelism(parallelism);
+    HloPassPipeline pipeline(TestName());
+    pipeline.AddPass<HloPassFix<PeelNegateRootComputationPass>>();
+    EXPECT_THAT(pipeline.Run(module.get()), IsOkAndHolds(true));
+
+    // 'main' needs three iterations that change it and one that doesn't,
+    // 'other' only needs two, the maximum is recorded.
+    const HloModuleMetadataProto& metadata = module->metadata().proto();
+    ASSERT_THAT(metadata.pass_metadata(), SizeIs(2));
+    const HloPassMetadata& peel = metadata.pass_metadata(1);
+    EXPECT_THAT(peel.pass_name(), StrEq("peel-negate-root"));
+    EXPECT_EQ(peel.fixed_point_iterations(), 4);
+  }
+}
+
+TEST_F(HloPassPipelineTest, RecordPassProfile) {
+  const std::string module_str = R"(
+HloModule RecordPassProfile
+
+ENTRY main {
+  a = f32[] parameter(0)
+  ROOT foo = f32[] negate(a)
+}
+)";
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<VerifiedHloModule> module,
+                          ParseAndReturnVerifiedModule(module_str));
+  std::unique_ptr<CompilationStats> stats = CompilationStats::MakeStats();
+  HloPassPipeline pipeline(TestName(), stats.get());
+  pipeline.AddPass<NegateRootsComputationPass>();
+  pipeline.AddPass<HloPassFix<FooToBarModulePass>>();
+  EXPECT_THAT(pipeline.Run(module.get()), IsOkAndHolds(true));
+
+  const HloModuleMetadataProto& metadata = module->metadata().proto();
+  ASSERT_THAT(metadata.pass_metadata(), SizeIs(3));
+  const HloPassMetadata& negate = metadata.pass_metadata(1);
+  EXPECT_THAT(negate.pass_name(), StrEq("negate-roots"));
+  EXPECT_EQ(negate.instruction_count_before(), 2);
+  EXPECT_EQ(negate.instruction_count_after(), 4);
+  EXPECT_EQ(negate.fixed_point_iterations(), 0);
+  // The first iteration renames 'foo', the second one finds nothing to do.
+  const HloPassMetadata& foo2bar = metadata.pass_metadata(2);
+  EXPECT_THAT(foo2bar.pass_name(), StrEq("foo2bar"));
+  EXPECT_EQ(foo2bar.instruction_count_before(), 4);
+  EXPECT_EQ(foo2bar.instruction_count_after(), 4);
+  EXPECT_EQ(foo2bar.fixed_point_iterations(), 2);
+
+  std::vector<CompilationStats::PassRecord> records = stats->GetPassRecords();
+  ASSERT_THAT(records, SizeIs(2));
+  EXPECT_THAT(records[0].pass_name, StrEq("negate-roots"));
+  EXPECT_EQ(records[0].instruction_count_before, 2);
+  EXPECT_EQ(records[0].instruction_count_after, 4);
+  EXPECT_GE(records[0].peak_rss_bytes, negate.peak_rss_bytes());
+  EXPECT_THAT(records[1].pass_name, StrEq("foo2bar"));
+  EXPECT_THAT(stats->CompilationReportJson(),
+              HasSubstr("\"pass_name\": \"negate-roots\""));
+}
+
+TEST_F(HloPassPipelineTest, SkipInstructionCountsWithoutStats) {
+  const std::string module_str = R"(
+HloModule SkipInstructionCountsWithoutStats
+
+ENTRY main {
+  a = f32[] parameter(0)
+  ROOT foo = f32[] negate(a)
+}
+)";
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<VerifiedHloModule> module,
+                          ParseAndReturnVerifiedModule(module_str));
+  HloPassPipeline pipeline(TestName());
+  pipeline.AddPass<NegateRootsComputationPass>();
+  EXPECT_THAT(pipeline.Run(module.get()), IsOkAndHolds(true));
+
+  const HloModuleMetadataProto& metadata = module->metadata().proto();
+  ASSERT_THAT(metadata.pass_metadata(), SizeIs(2));
+  const HloPassMetadata& negate = metadata.pass_metadata(1);
+  EXPECT_THAT(negate.pass_name(), StrEq("negate-roots"));
+  EXPECT_EQ(negate.instruction_count_before(), 0);
+  EXPECT_EQ(negate.instruction_count_after(), 0);
+}
+
+TEST_F(HloPassPipelineTest, NestedPipelineRecordsInParentStats) {
+  const std::string module_str = R"(
+HloModule NestedPipelineRecordsInParentStats
+
+ENTRY main {
+  a = f32[] parameter(0)
+  ROOT foo = f32[] negate(a)
+}
+)";
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<VerifiedHloModule> module,
+                          ParseAndReturnVerifiedModule(module_str));
+  std::unique_ptr<CompilationStats> stats = CompilationStats::MakeStats();
+  HloPassPipeline pipeline(TestName(), stats.get());
+  pipeline.AddPass<NegateRootsComputationPass>();
+  HloPassPipeline& nested = pipeline.AddPass<HloPassPipeline>("nested");
+  nested.AddPass<FooToBarModulePass>();
+  EXPECT_THAT(pipeline.Run(module.get()), IsOkAndHolds(true));
+
+  std::vector<CompilationStats::PassRecord> records = stats->GetPassRecords();
+  ASSERT_THAT(records, SizeIs(2));
+  EXPECT_THAT(records[0].pass_name, StrEq("negate-roots"));
+  EXPECT_THAT(records[1].pass_name, StrEq("foo2bar"));
+}
+
 }  // namespace
 }  // namespace xla
@@ -13,7 +13,9 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
-// Usage: show_text_literal <path-to-serialized-literal-text>
+// Usage: show_text_literal <path-to-serialized-literal>
+//
+// The literal can be in the format of TextLiteralWriter or BinaryLiteralWriter.
 
 #include <stdio.h>
 
@@ -22,22 +24,50 @@ limitations under the License.
 #include <string>
 
 #include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "xla/binary_literal_reader.h"
+#include "xla/binary_literal_writer.h"
 #include "xla/literal.h"
 #include "xla/text_literal_reader.h"
 #include "xla/types.h"
 #include "xla/xla_data.pb.h"
+#include "tsl/platform/env.h"
+#include "tsl/platform/file_system.h"
 #include "tsl/platform/init_main.h"
 #include "tsl/platform/logging.h"
 #include "tsl/platform/protobuf.h"
 
+// Returns whether the file at `path` starts with the binary literal magic.
+static bool IsBinaryLiteralFile(const char *path) {
+  std::unique_ptr<tsl::RandomAccessFile> file;
+  if (!tsl::Env::Default()->NewRandomAccessFile(path, &file).ok()) {
+    return false;
+  }
+  char scratch[xla::BinaryLiteralWriter::kMagic.size()];
+  absl::string_view prefix;
+  // Read returns OutOfRange for files shorter than the magic.
+  file->Read(0, sizeof(scratch), &prefix, scratch).IgnoreError();
+  return xla::BinaryLiteralReader::HasBinaryLiteralMagic(prefix);
+}
+
 int main(int argc, char **argv) {
   tsl::port::InitMain(argv[0], &argc, &argv);
 
   if (argc < 2) {
-    LOG(QFATAL) << "Usage: " << argv[0] << " <path-to-serialized-literal-text>";
+    LOG(QFATAL) << "Usage: " << argv[0] << " <path-to-serialized-literal>";
   }
 
-  xla::Literal literal = xla::TextLiteralReader::ReadPath(argv[1]).value();
+  // Binary literals are memory-mapped and shown without copying them.
+  std::unique_ptr<xla::BinaryLiteralReader> binary_reader;
+  xla::Literal text_literal;
+  xla::LiteralSlice literal;
+  if (IsBinaryLiteralFile(argv[1])) {
+    binary_reader = xla::BinaryLiteralReader::Open(argv[1]).value();
+    literal = binary_reader->literal();
+  } else {
+    text_literal = xla::TextLiteralReader::ReadPath(argv[1]).value();
+    literal = text_literal;
+  }
 
   LOG(INFO) << "literal: " << literal;
   fprintf(stderr, "%s\n", literal.ToString().c_str());
@@ -17,13 +17,17 @@ limitations under the License.
 
 #include <cstdint>
 #include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
+#include "absl/log/check.h"
 #include "absl/strings/string_view.h"
 #include "absl/types/span.h"
+#include "xla/array2d.h"
 #include "xla/hlo/ir/hlo_computation.h"
 #include "xla/hlo/ir/hlo_instruction.h"
+#include "xla/hlo/ir/hlo_module.h"
 #include "xla/hlo/parser/hlo_parser.h"
 #include "xla/hlo/testlib/hlo_hardware_independent_test_base.h"
 #include "xla/hlo/utils/hlo_matchers.h"
@@ -32,6 +36,7 @@ limitations under the License.
 #include "xla/literal_util.h"
 #include "xla/permutation_util.h"
 #include "xla/primitive_util.h"
+#include "xla/service/hlo_module_config.h"
 #include "xla/service/pattern_matcher.h"
 #include "xla/service/pattern_matcher_gmock.h"
 #include "xla/shape.h"
@@ -39,6 +44,7 @@ limitations under the License.
 #include "xla/test.h"
 #include "xla/xla_data.pb.h"
 #include "tsl/platform/statusor.h"
+#include "tsl/platform/test_benchmark.h"
 
 namespace xla {
 namespace {
@@ -491,5 +497,106 @@ TEST_F(HloConstantFoldingTest, TimingConsumingTest) {
   EXPECT_FALSE(result);
 }
 
+enum class FoldedOp { kElementwise, kReduce, kDot };
+
+// Builds a module that folds `op` over f32[n,n] constants.
+static std::unique_ptr<HloModule> MakeFoldingBenchmarkModule(FoldedOp op,
+                                                             int64_t n) {
+  Array2D<float> values(n, n);
+  values.FillRandom(1.0f);
+  Shape shape = ShapeUtil::MakeShape(F32, {n, n});
+  Shape scalar_shape = ShapeUtil::MakeShape(F32, {});
+
+  auto module = std::make_unique<HloModule>("BM_ConstantFolding",
+                                            HloModuleConfig());
+  HloComputation::Builder builder("entry");
+  HloInstruction* lhs = builder.AddInstruction(HloInstruction::CreateConstant(
+      LiteralUtil::CreateR2FromArray2D(values)));
+  HloInstruction* rhs = builder.AddInstruction(HloInstruction::CreateConstant(
+      LiteralUtil::CreateR2FromArray2D(values)));
+
+  switch (op) {
+    case FoldedOp::kElementwise: {
+      HloInstruction* add = builder.AddInstruction(
+          HloInstruction::CreateBinary(shape, HloOpcode::kAdd, lhs, rhs));
+      builder.AddInstruction(
+          HloInstruction::CreateUnary(shape, HloOpcode::kExp, add));
+      break;
+    }
+    case FoldedOp::kReduce: {
+      HloComputation::Builder max_builder("max");
+      HloInstruction* x = max_builder.AddInstruction(
+          HloInstruction::CreateParameter(0, scalar_shape, "x"));
+      HloInstruction* y = max_builder.AddInstruction(
+          HloInstruction::CreateParameter(1, scalar_shape, "y"));
+      max_builder.AddInstruction(HloInstruction::CreateBinary(
+          scalar_shape, HloOpcode::kMaximum, x, y));
+      HloComputation* max = module->AddEmbeddedComputation(max_builder.Build());
+      HloInstruction* init = builder.AddInstruction(
+          HloInstruction::CreateConstant(LiteralUtil::CreateR0<float>(0.f)));
+      builder.AddInstruction(HloInstruction::CreateReduce(
+          ShapeUtil::MakeShape(F32, {n}), lhs, init,
+          /*dimensions_to_reduce=*/{0}, max));
+      break;
+    }
+    case FoldedOp::kDot: {
+      DotDimensionNumbers dnums;
+      dnums.add_lhs_contracting_dimensions(1);
+      dnums.add_rhs_contracting_dimensions(0);
+      builder.AddInstruction(HloInstruction::CreateDot(
+          shape, lhs, rhs, dnums, PrecisionConfig()));
+      break;
+    }
+  }
+  module->AddEntryComputation(builder.Build());
+  return module;
+}
+
+// Measures constant folding time as a function of the constant size.
+static void BM_ConstantFolding(::testing::benchmark::State& state,
+                               FoldedOp op) {
+  int64_t n = state.range(0);
+  std::unique_ptr<HloModule> module = MakeFoldingBenchmarkModule(op, n);
+
+  for (auto s : state) {
+    state.PauseTiming();
+    std::unique_ptr<HloModule> clone = module->Clone();
+    state.ResumeTiming();
+    CHECK(HloConstantFolding().Run(clone.get()).value());
+  }
+  state.SetItemsProcessed(state.iterations() * n * n);
+}
+
+static void BM_ConstantFoldingElementwise(
+    ::testing::benchmark::State& state) {
+  BM_ConstantFolding(state, FoldedOp::kElementwise);
+}
+
+static void BM_ConstantFoldingReduce(::testing::benchmark::State& state) {
+  BM_ConstantFolding(state, FoldedOp::kReduce);
+}
+
+static void BM_ConstantFoldingDot(::testing::benchmark::State& state) {
+  BM_ConstantFolding(state, FoldedOp::kDot);
+}
+
+BENCHMARK(BM_ConstantFoldingElementwise)
+    ->MeasureProcessCPUTime()
+    ->Arg(64)
+    ->Arg(256)
+    ->Arg(1024)
+    ->Arg(4096);
+BENCHMARK(BM_ConstantFoldingReduce)
+    ->MeasureProcessCPUTime()
+    ->Arg(64)
+    ->Arg(256)
+    ->Arg(1024)
+    ->Arg(4096);
+BENCHMARK(BM_ConstantFoldingDot)
+    ->MeasureProcessCPUTime()
+    ->Arg(64)
+    ->Arg(256)
+    ->Arg(512);
+
 }  // namespace
 }  // namespace xla
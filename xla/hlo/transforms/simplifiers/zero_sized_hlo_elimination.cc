@@ -15,9 +15,7 @@ limitations under the License.
 
 #include "xla/hlo/transforms/simplifiers/zero_sized_hlo_elimination.h"
 
-#include "absl/container/flat_hash_set.h"
 #include "absl/status/statusor.h"
-#include "absl/strings/string_view.h"
 #include "xla/hlo/ir/hlo_computation.h"
 #include "xla/hlo/ir/hlo_instruction.h"
 #include "xla/hlo/ir/hlo_opcode.h"
@@ -30,31 +28,27 @@ limitations under the License.
 
 namespace xla {
 
-absl::StatusOr<bool> ZeroSizedHloElimination::Run(
-    HloModule* module,
-    const absl::flat_hash_set<absl::string_view>& execution_threads) {
+absl::StatusOr<bool> ZeroSizedHloElimination::RunOnComputation(
+    HloComputation* comp) {
   bool changed = false;
-  for (HloComputation* comp :
-       module->MakeNonfusionComputations(execution_threads)) {
-    for (HloInstruction* instruction : comp->MakeInstructionPostOrder()) {
-      if (instruction->HasSideEffect() || !instruction->shape().IsArray() ||
-          instruction->opcode() == HloOpcode::kConstant) {
-        continue;
-      }
-      if (comp->IsSafelyRemovable(instruction) &&
-          ShapeUtil::IsZeroElementArray(instruction->shape()) &&
-          instruction->shape().is_static()) {
-        // If the instruction doesn't have a layout, use a default layout for
-        // the literal.
-        Shape shape = instruction->shape();
-        if (!LayoutUtil::HasLayout(shape)) {
-          LayoutUtil::SetToDefaultLayout(&shape);
-        }
-        TF_RETURN_IF_ERROR(comp->ReplaceWithNewInstruction(
-            instruction,
-            HloInstruction::CreateConstant(Literal::CreateFromShape(shape))));
-        changed = true;
+  for (HloInstruction* instruction : comp->MakeInstructionPostOrder()) {
+    if (instruction->HasSideEffect() || !instruction->shape().IsArray() ||
+        instruction->opcode() == HloOpcode::kConstant) {
+      continue;
+    }
+    if (comp->IsSafelyRemovable(instruction) &&
+        ShapeUtil::IsZeroElementArray(instruction->shape()) &&
+        instruction->shape().is_static()) {
+      // If the instruction doesn't have a layout, use a default layout for
+      // the literal.
+      Shape shape = instruction->shape();
+      if (!LayoutUtil::HasLayout(shape)) {
+        LayoutUtil::SetToDefaultLayout(&shape);
       }
+      TF_RETURN_IF_ERROR(comp->ReplaceWithNewInstruction(
+          instruction,
+          HloInstruction::CreateConstant(Literal::CreateFromShape(shape))));
+      changed = true;
     }
   }
   return changed;
@@ -18,6 +18,7 @@ limitations under the License.
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
+#include <functional>
 #include <memory>
 #include <optional>
 #include <string>
@@ -69,6 +70,12 @@ namespace {
 
 constexpr size_t kSmallDataTransferByteSize = 102400;  // 100 KiB
 
+// Host buffer transposes smaller than this are always done by a single thread.
+constexpr size_t kMinParallelTransposeByteSize = 1 << 20;  // 1 MiB
+
+// Lower bound on the work assigned to each thread of a parallel transpose.
+constexpr int64_t kMinParallelTransposeBytesPerThread = 256 << 10;  // 256 KiB
+
 // Unpacks and copies the packed data at `input` into the literal at the given
 // ShapeIndex.
 void UnpackIntNToLiteral(PrimitiveType input_element_type,
@@ -715,7 +722,8 @@ AbstractTfrtCpuBuffer::BufferFromHostBufferHelper(
     PjRtClient::HostBufferSemantics host_buffer_semantics,
     absl::AnyInvocable<void() &&> on_done_with_host_buffer, const Shape& shape,
     AsyncWorkRunner* async_work_runner, absl::Mutex* transpose_mu,
-    TransposePlanCache* transpose_cache) {
+    TransposePlanCache* transpose_cache, int transpose_num_threads,
+    int64_t zero_copy_alignment) {
   bool has_default_layout =
       !byte_strides || HasMajorToMinorLayout(type, dims, *byte_strides);
   const int bit_width = primitive_util::BitWidth(type);
@@ -723,11 +731,16 @@ AbstractTfrtCpuBuffer::BufferFromHostBufferHelper(
   bool is_packed = primitive_util::IsSubByteNonPredType(type);
 
   // If the input buffer has a default layout and is sufficiently aligned, we
-  // can simply point to the input array's data without any further copies. At
-  // the time of writing we require a 16-byte alignment because XLA may generate
-  // code which requires it.
+  // can simply point to the input array's data without any further copies. By
+  // default we require the XLA:CPU alignment because XLA may generate code
+  // which requires it. Clients that compile executables with relaxed parameter
+  // alignment (see `xla_cpu_parameter_alignment`) can accept less aligned
+  // buffers.
+  if (zero_copy_alignment <= 0) {
+    zero_copy_alignment = cpu_function_runtime::MinAlign();
+  }
   bool is_aligned_data = ((absl::bit_cast<std::uintptr_t>(data) &
-                           (cpu_function_runtime::MinAlign() - 1)) == 0);
+                           (zero_copy_alignment - 1)) == 0);
 
   using HostBufferSemantics = PjRtClient::HostBufferSemantics;
   bool immutable_zero_copy_semantics =
@@ -774,9 +787,12 @@ AbstractTfrtCpuBuffer::BufferFromHostBufferHelper(
     if (!has_default_layout || is_packed) {
       // If the input array does not have a major-to-minor layout, transpose it
       // into major-to-minor layout. Currently we choose to always do this
-      // synchronously.
+      // synchronously, but large transposes are split across the threads of
+      // the async work runner. The calling thread runs every chunk that no
+      // worker has picked up, so this is safe on the runner's own threads.
       // TODO(phawkins): consider performing the transpose asynchronously.
-      // TODO(phawkins): parallelize the transpose.
+      bool parallel_transpose = transpose_num_threads > 1 &&
+                                byte_size >= kMinParallelTransposeByteSize;
       std::shared_ptr<TransposePlan> transpose;
       {
         absl::InlinedVector<int64_t, 4> permutation(dims.size());
@@ -786,18 +802,27 @@ AbstractTfrtCpuBuffer::BufferFromHostBufferHelper(
         options.dims = dims;
         options.permutation = permutation;
         options.input_layout = TransposePlan::Striding{*byte_strides};
+        if (parallel_transpose) {
+          // The plan decides how many threads to actually use based on its
+          // estimate of the work done by each loop of the transpose.
+          options.num_threads = transpose_num_threads;
+          options.min_bytes_per_thread = kMinParallelTransposeBytesPerThread;
+        }
         absl::MutexLock lock(transpose_mu);
         TF_ASSIGN_OR_RETURN(transpose, transpose_cache->GetOrCreate(options));
       }
+      auto schedule_work = [&](std::function<void()> work) {
+        async_work_runner->Schedule(std::move(work));
+      };
       if (!is_packed) {
-        transpose->Execute(data, dst_data_ptr);
+        transpose->Execute(data, dst_data_ptr, schedule_work);
       } else {
         // First transpose the unpacked data into a new temporary buffer, then
         // pack the data.
         // TODO(reedwm): Fuse the transpose and packing by having TransposePlan
         // support packing.
         auto data_transposed = std::make_unique<char[]>(byte_size);
-        transpose->Execute(data, data_transposed.get());
+        transpose->Execute(data, data_transposed.get(), schedule_work);
         absl::Span<const char> src_data_span(data_transposed.get(), byte_size);
         absl::Span<char> dst_data_span(static_cast<char*>(dst_data_ptr),
                                        dst_byte_size);
@@ -227,7 +227,10 @@ class AbstractTfrtCpuBuffer : public PjRtBuffer {
   // A helper function for PjRtClient::BufferFromHostBuffer. Creates a new cpu
   // device buffer from the host buffer (maybe zero-copy or async).
   // `transpose_mu` and `transpose_cache` are used to transpose the input
-  // layout.
+  // layout. Large transposes are split into up to `transpose_num_threads`
+  // parts that run in parallel on the `async_work_runner`. With zero-copy
+  // semantics, host buffers aligned to `zero_copy_alignment` bytes (the
+  // default XLA:CPU alignment if zero) are used without a copy.
   static absl::StatusOr<std::unique_ptr<TrackedTfrtCpuDeviceBuffer>>
   BufferFromHostBufferHelper(
       const void* data, PrimitiveType type, absl::Span<int64_t const> dims,
@@ -235,7 +238,8 @@ class AbstractTfrtCpuBuffer : public PjRtBuffer {
       PjRtClient::HostBufferSemantics host_buffer_semantics,
       absl::AnyInvocable<void() &&> on_done_with_host_buffer,
       const Shape& shape, AsyncWorkRunner* async_work_runner,
-      absl::Mutex* transpose_mu, TransposePlanCache* transpose_cache);
+      absl::Mutex* transpose_mu, TransposePlanCache* transpose_cache,
+      int transpose_num_threads = 1, int64_t zero_copy_alignment = 0);
 
  protected:
   virtual absl::string_view buffer_name() const = 0;
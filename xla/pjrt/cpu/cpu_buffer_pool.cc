@@ -0,0 +1,112 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/pjrt/cpu/cpu_buffer_pool.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "xla/cpu_function_runtime.h"
+#include "xla/pjrt/cpu/tracked_tfrt_cpu_device_buffer.h"
+#include "xla/tsl/concurrency/ref_count.h"
+#include "xla/util.h"
+#include "tsl/platform/mem.h"
+
+namespace xla::cpu {
+
+tsl::RCReference<CpuBufferPool> CpuBufferPool::Create(
+    std::vector<size_t> allocation_sizes, Options options) {
+  return tsl::TakeRef(
+      new CpuBufferPool(std::move(allocation_sizes), std::move(options)));
+}
+
+CpuBufferPool::CpuBufferPool(std::vector<size_t> allocation_sizes,
+                             Options options)
+    : allocation_sizes_(std::move(allocation_sizes)),
+      options_(std::move(options)),
+      free_lists_(allocation_sizes_.size()) {}
+
+CpuBufferPool::~CpuBufferPool() {
+  absl::MutexLock lock(&mu_);
+  for (std::vector<void*>& free_list : free_lists_) {
+    for (void* data : free_list) tsl::port::AlignedFree(data);
+  }
+}
+
+absl::StatusOr<MaybeOwningCpuMemory> CpuBufferPool::Allocate(int64_t index) {
+  size_t size = allocation_sizes_[index];
+
+  void* data = nullptr;
+  {
+    absl::MutexLock lock(&mu_);
+    std::vector<void*>& free_list = free_lists_[index];
+    if (free_list.empty()) {
+      ++stats_.misses;
+    } else {
+      data = free_list.back();
+      free_list.pop_back();
+      stats_.pooled_bytes -= size;
+      ++stats_.hits;
+    }
+  }
+
+  if (data == nullptr) {
+    data = tsl::port::AlignedMalloc(size, cpu_function_runtime::MinAlign());
+    if (data == nullptr) {
+      return ResourceExhausted("Out of memory allocating %d bytes.", size);
+    }
+  }
+
+  // Keep the pool alive until the buffer is released.
+  AddRef();
+  MaybeOwningCpuMemory::Deleter deleter(
+      +[](void* pool, int64_t index, void* data) {
+        static_cast<CpuBufferPool*>(pool)->Release(index, data);
+      },
+      this, index);
+  return MaybeOwningCpuMemory(
+      MaybeOwningCpuMemory::OwnedDataPtr(static_cast<uint8_t*>(data), deleter),
+      size);
+}
+
+void CpuBufferPool::Release(int64_t index, void* data) {
+  size_t size = allocation_sizes_[index];
+
+  bool pooled = false;
+  {
+    absl::MutexLock lock(&mu_);
+    if (stats_.pooled_bytes + size <= options_.max_pooled_bytes) {
+      free_lists_[index].push_back(data);
+      stats_.pooled_bytes += size;
+      pooled = true;
+    } else {
+      ++stats_.evictions;
+    }
+  }
+
+  if (!pooled) tsl::port::AlignedFree(data);
+  DropRef();
+}
+
+CpuBufferPool::Stats CpuBufferPool::stats() const {
+  absl::MutexLock lock(&mu_);
+  return stats_;
+}
+
+}  // namespace xla::cpu
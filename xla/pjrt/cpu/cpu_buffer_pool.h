@@ -0,0 +1,86 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef XLA_PJRT_CPU_CPU_BUFFER_POOL_H_
+#define XLA_PJRT_CPU_CPU_BUFFER_POOL_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "xla/pjrt/cpu/tracked_tfrt_cpu_device_buffer.h"
+#include "xla/tsl/concurrency/ref_count.h"
+
+namespace xla::cpu {
+
+// A pool that recycles the host memory of buffers that an executable allocates
+// on every execution, i.e. its temp and output buffers.
+//
+// The buffer assignment of an executable is fixed, so each allocation index
+// requests the same size on every execution, and the pool keeps one free list
+// per allocation index rather than per size class. Memory returns to the free
+// list of its index when the last reference to its MaybeOwningCpuMemory is
+// dropped, i.e. when an execution finishes for temps and when the user deletes
+// the buffer for outputs. Released memory that would grow the pool above
+// `max_pooled_bytes` is freed instead.
+//
+// Every outstanding buffer holds a reference to the pool, so buffers can safely
+// outlive the executable that allocated them. This class is thread-safe.
+class CpuBufferPool : public tsl::ReferenceCounted<CpuBufferPool> {
+ public:
+  struct Options {
+    // Upper bound on the total size of the idle memory kept by the pool.
+    int64_t max_pooled_bytes = 0;
+  };
+
+  struct Stats {
+    int64_t hits = 0;          // Allocations served from a free list.
+    int64_t misses = 0;        // Allocations that called the system allocator.
+    int64_t evictions = 0;     // Released buffers freed because of the cap.
+    int64_t pooled_bytes = 0;  // Idle memory currently kept by the pool.
+  };
+
+  // `allocation_sizes[i]` is the size of the memory allocated for index `i`.
+  static tsl::RCReference<CpuBufferPool> Create(
+      std::vector<size_t> allocation_sizes, Options options);
+
+  ~CpuBufferPool();
+
+  // Allocates memory for the allocation `index`, reusing memory released by a
+  // buffer of the same index if there is any.
+  absl::StatusOr<MaybeOwningCpuMemory> Allocate(int64_t index);
+
+  Stats stats() const;
+
+ private:
+  CpuBufferPool(std::vector<size_t> allocation_sizes, Options options);
+
+  // Called by the deleter of a buffer allocated for `index`.
+  void Release(int64_t index, void* data);
+
+  const std::vector<size_t> allocation_sizes_;
+  const Options options_;
+
+  mutable absl::Mutex mu_;
+  std::vector<std::vector<void*>> free_lists_ ABSL_GUARDED_BY(mu_);
+  Stats stats_ ABSL_GUARDED_BY(mu_);
+};
+
+}  // namespace xla::cpu
+
+#endif  // XLA_PJRT_CPU_CPU_BUFFER_POOL_H_
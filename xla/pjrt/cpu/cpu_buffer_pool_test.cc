@@ -0,0 +1,81 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/pjrt/cpu/cpu_buffer_pool.h"
+
+#include <optional>
+
+#include "xla/pjrt/cpu/tracked_tfrt_cpu_device_buffer.h"
+#include "xla/tsl/concurrency/ref_count.h"
+#include "tsl/platform/statusor.h"
+#include "tsl/platform/test.h"
+
+namespace xla::cpu {
+namespace {
+
+TEST(CpuBufferPoolTest, RecyclesMemoryByIndex) {
+  auto pool = CpuBufferPool::Create({64, 128}, {/*max_pooled_bytes=*/1024});
+
+  TF_ASSERT_OK_AND_ASSIGN(auto memory, pool->Allocate(0));
+  EXPECT_EQ(memory.size(), 64);
+  void* data = memory.data();
+
+  // Release the memory back to the pool.
+  memory = MaybeOwningCpuMemory();
+  EXPECT_EQ(pool->stats().pooled_bytes, 64);
+
+  // A different index does not reuse the released memory.
+  TF_ASSERT_OK_AND_ASSIGN(auto other, pool->Allocate(1));
+  EXPECT_EQ(other.size(), 128);
+  EXPECT_NE(other.data(), data);
+
+  TF_ASSERT_OK_AND_ASSIGN(auto reused, pool->Allocate(0));
+  EXPECT_EQ(reused.data(), data);
+
+  CpuBufferPool::Stats stats = pool->stats();
+  EXPECT_EQ(stats.hits, 1);
+  EXPECT_EQ(stats.misses, 2);
+  EXPECT_EQ(stats.evictions, 0);
+  EXPECT_EQ(stats.pooled_bytes, 0);
+}
+
+TEST(CpuBufferPoolTest, FreesMemoryAboveCap) {
+  auto pool = CpuBufferPool::Create({64}, {/*max_pooled_bytes=*/100});
+
+  {
+    TF_ASSERT_OK_AND_ASSIGN(auto a, pool->Allocate(0));
+    TF_ASSERT_OK_AND_ASSIGN(auto b, pool->Allocate(0));
+  }
+
+  // Only one of the two buffers fits into the pool.
+  CpuBufferPool::Stats stats = pool->stats();
+  EXPECT_EQ(stats.evictions, 1);
+  EXPECT_EQ(stats.pooled_bytes, 64);
+}
+
+TEST(CpuBufferPoolTest, BufferOutlivesPool) {
+  auto pool = CpuBufferPool::Create({64}, {/*max_pooled_bytes=*/1024});
+
+  std::optional<MaybeOwningCpuMemory> memory;
+  TF_ASSERT_OK_AND_ASSIGN(memory, pool->Allocate(0));
+  EXPECT_EQ(pool->NumRef(), 2);
+
+  // The buffer keeps the pool alive after its owner dropped it.
+  pool.reset();
+  memory.reset();
+}
+
+}  // namespace
+}  // namespace xla::cpu
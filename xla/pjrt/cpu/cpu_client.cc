@@ -67,6 +67,8 @@ limitations under the License.
 #include "xla/literal_util.h"
 #include "xla/pjrt/compile_options.pb.h"
 #include "xla/pjrt/cpu/abstract_tfrt_cpu_buffer.h"
+#include "xla/pjrt/cpu/cpu_buffer_pool.h"
+#include "xla/pjrt/cpu/cpu_executable_cache.h"
 #include "xla/pjrt/cpu/cpu_topology.h"
 #include "xla/pjrt/cpu/tracked_tfrt_cpu_device_buffer.h"
 #include "xla/pjrt/host_memory_spaces.h"
@@ -88,6 +90,7 @@ limitations under the License.
 #include "xla/service/cpu/cpu_event.h"
 #include "xla/service/cpu/cpu_executable.h"
 #include "xla/service/cpu/cpu_executable_run_options.h"
+#include "xla/service/cpu/cpu_options.h"
 #include "xla/service/cpu/cpu_runtime.h"
 #include "xla/service/cpu/cpu_xfeed.h"
 #include "xla/service/custom_call_status.h"
@@ -396,10 +399,20 @@ absl::StatusOr<std::unique_ptr<PjRtClient>> GetTfrtCpuClient(
     devices.push_back(std::move(device));
   }
 
+  std::unique_ptr<cpu::CpuExecutableCache> executable_cache;
+  if (!options.executable_cache_dir.empty()) {
+    TF_ASSIGN_OR_RETURN(executable_cache,
+                        cpu::CpuExecutableCache::Create(
+                            {std::move(options.executable_cache_dir),
+                             options.executable_cache_max_size_bytes}));
+  }
+
   return std::unique_ptr<PjRtClient>(std::make_unique<TfrtCpuClient>(
       options.process_id, std::move(devices), std::move(options.collectives),
       num_threads, options.asynchronous,
-      std::move(options.customize_hlo_module_config)));
+      std::move(options.customize_hlo_module_config),
+      std::move(executable_cache), options.parameter_alignment,
+      options.buffer_pool_max_bytes));
 }
 
 // An upper bound on the number of threads to use for intra-op parallelism. It
@@ -421,7 +434,9 @@ TfrtCpuClient::TfrtCpuClient(
     int process_index, std::vector<std::unique_ptr<TfrtCpuDevice>> devices,
     std::shared_ptr<cpu::CollectivesInterface> collectives, size_t num_threads,
     bool asynchronous,
-    std::function<void(HloModuleConfig&)> customize_hlo_module_config)
+    std::function<void(HloModuleConfig&)> customize_hlo_module_config,
+    std::unique_ptr<cpu::CpuExecutableCache> executable_cache,
+    int64_t parameter_alignment, int64_t buffer_pool_max_bytes)
     : process_index_(process_index),
       owned_devices_(std::move(devices)),
       computation_placer_(std::make_unique<ComputationPlacer>()),
@@ -444,7 +459,27 @@ TfrtCpuClient::TfrtCpuClient(
           platform_id(), platform_name(), platform_version(), owned_devices_,
           cpu::DetectMachineAttributes())),
       asynchronous_(asynchronous),
-      customize_hlo_module_config_(std::move(customize_hlo_module_config)) {
+      customize_hlo_module_config_(std::move(customize_hlo_module_config)),
+      executable_cache_(std::move(executable_cache)),
+      parameter_alignment_(parameter_alignment > 0
+                               ? cpu::options::ParameterAlignment(
+                                     parameter_alignment)
+                               : 0),
+      buffer_pool_max_bytes_(std::max<int64_t>(0, buffer_pool_max_bytes)) {
+  // Compile executables with the parameter alignment that we rely on when we
+  // adopt host buffers without copying them.
+  if (parameter_alignment_ > 0) {
+    customize_hlo_module_config_ =
+        [customize = std::move(customize_hlo_module_config_),
+         alignment = parameter_alignment_](HloModuleConfig& config) {
+          DebugOptions& debug_options = config.mutable_debug_options();
+          if (debug_options.xla_cpu_parameter_alignment() == 0) {
+            debug_options.set_xla_cpu_parameter_alignment(alignment);
+          }
+          if (customize) customize(config);
+        };
+  }
+
   for (const std::unique_ptr<TfrtCpuDevice>& device : owned_devices_) {
     devices_.push_back(device.get());
     CHECK(
@@ -713,13 +748,40 @@ TfrtCpuClient::LoadSerializedExecutable(absl::string_view serialized,
   return DeserializeExecutable(serialized, options);
 }
 
+// Loads an executable from the persistent executable cache. Returns nullptr if
+// the cache doesn't have an executable for the given key.
+static absl::StatusOr<std::unique_ptr<xla::Executable>> LoadCachedExecutable(
+    cpu::CpuExecutableCache& executable_cache, absl::string_view key,
+    cpu::CpuCompiler& compiler) {
+  tsl::profiler::TraceMe traceme("TfrtCpuClient::LoadCachedExecutable");
+  TF_ASSIGN_OR_RETURN(std::optional<std::string> serialized,
+                      executable_cache.Lookup(key));
+  if (!serialized.has_value()) return nullptr;
+
+  TF_ASSIGN_OR_RETURN(std::unique_ptr<AotCompilationResult> aot_result,
+                      compiler.LoadAotCompilationResult(*serialized));
+  return aot_result->LoadExecutable(&compiler, /*executor=*/nullptr);
+}
+
+// Serializes the executable and stores it in the persistent executable cache.
+static absl::Status StoreCachedExecutable(
+    cpu::CpuExecutableCache& executable_cache, absl::string_view key,
+    cpu::CpuCompiler& compiler, xla::Executable* executable) {
+  tsl::profiler::TraceMe traceme("TfrtCpuClient::StoreCachedExecutable");
+  TF_ASSIGN_OR_RETURN(std::unique_ptr<AotCompilationResult> aot_result,
+                      compiler.Export(executable));
+  TF_ASSIGN_OR_RETURN(std::string serialized, aot_result->SerializeAsString());
+  return executable_cache.Insert(key, serialized);
+}
+
 static absl::StatusOr<std::unique_ptr<xla::Executable>> JitCompile(
     const XlaComputation& computation,
     const absl::Span<const Shape* const> argument_layouts,
     const ExecutableBuildOptions& build_options,
     const ExecutionOptions& execution_options,
     const xla::Compiler::CompileOptions& compile_options, int num_threads,
-    std::function<void(HloModuleConfig&)> customize_hlo_module_config) {
+    std::function<void(HloModuleConfig&)> customize_hlo_module_config,
+    cpu::CpuExecutableCache* executable_cache) {
   TF_ASSIGN_OR_RETURN(ProgramShape program_shape,
                       computation.GetProgramShape());
   // Unoptimized HloModuleConfig.
@@ -743,15 +805,50 @@ static absl::StatusOr<std::unique_ptr<xla::Executable>> JitCompile(
   static constexpr char kBeforeOptimizationsDumpName[] = "before_optimizations";
   DumpHloModuleIfEnabled(*hlo_module, kBeforeOptimizationsDumpName);
 
-  // Run Hlo Passes
   cpu::CpuCompiler compiler;
+
+  // Skip compilation if we already have an executable for the same module and
+  // config compiled for the same target machine. Cache failures are not fatal,
+  // we fall back to compiling the module.
+  std::string cache_key;
+  if (executable_cache) {
+    cache_key = cpu::CpuExecutableCache::Key(
+        *hlo_module, cpu::DetectMachineAttributes(std::nullopt).features);
+    absl::StatusOr<std::unique_ptr<xla::Executable>> cached =
+        LoadCachedExecutable(*executable_cache, cache_key, compiler);
+    if (cached.ok() && *cached != nullptr) {
+      VLOG(1) << "Loaded executable " << hlo_module->name()
+              << " from executable cache with key " << cache_key;
+      return std::move(cached).value();
+    }
+    if (!cached.ok()) {
+      LOG(WARNING) << "Failed to load executable " << hlo_module->name()
+                   << " from executable cache: " << cached.status();
+    }
+  }
+
+  // Run Hlo Passes
   TF_ASSIGN_OR_RETURN(hlo_module, compiler.RunHloPasses(std::move(hlo_module),
                                                         /*stream_exec=*/nullptr,
                                                         compile_options));
 
   // Run backend.
-  return compiler.RunBackend(std::move(hlo_module), /*stream_exec=*/nullptr,
-                             compile_options);
+  TF_ASSIGN_OR_RETURN(
+      std::unique_ptr<xla::Executable> executable,
+      compiler.RunBackend(std::move(hlo_module), /*stream_exec=*/nullptr,
+                          compile_options));
+
+  if (executable_cache) {
+    if (absl::Status stored = StoreCachedExecutable(
+            *executable_cache, cache_key, compiler, executable.get());
+        !stored.ok()) {
+      LOG(WARNING) << "Failed to store executable "
+                   << executable->module().name()
+                   << " in executable cache: " << stored;
+    }
+  }
+
+  return executable;
 }
 
 absl::StatusOr<std::unique_ptr<PjRtLoadedExecutable>> TfrtCpuClient::Compile(
@@ -843,7 +940,7 @@ absl::StatusOr<std::unique_ptr<PjRtLoadedExecutable>> TfrtCpuClient::Compile(
       JitCompile(computation, argument_layout_pointers, build_options,
                  execution_options, compile_options,
                  eigen_intraop_device()->getPool()->NumThreads(),
-                 customize_hlo_module_config_));
+                 customize_hlo_module_config_, executable_cache_.get()));
   auto cpu_executable_ptr =
       tensorflow::down_cast<cpu::CpuExecutable*>(cpu_executable.get());
 
@@ -887,9 +984,12 @@ absl::StatusOr<std::unique_ptr<PjRtLoadedExecutable>> TfrtCpuClient::Compile(
   return Compile(xla_computation, options);
 }
 
+static bool IsAligned(const void* ptr, size_t alignment) {
+  return (absl::bit_cast<std::uintptr_t>(ptr) & (alignment - 1)) == 0;
+}
+
 static bool IsAlignedData(void* ptr) {
-  return (absl::bit_cast<std::uintptr_t>(ptr) &
-          (cpu_function_runtime::MinAlign() - 1)) == 0;
+  return IsAligned(ptr, cpu_function_runtime::MinAlign());
 }
 
 absl::StatusOr<std::unique_ptr<PjRtBuffer>>
@@ -993,7 +1093,8 @@ absl::StatusOr<std::unique_ptr<PjRtBuffer>> TfrtCpuClient::BufferFromHostBuffer(
       AbstractTfrtCpuBuffer::BufferFromHostBufferHelper(
           data, type, dims, byte_strides, host_buffer_semantics,
           std::move(on_done_with_host_buffer), shape, async_work_runner(),
-          &transpose_mu_, &transpose_cache_));
+          &transpose_mu_, &transpose_cache_,
+          pjrt_client_thread_pool()->NumThreads(), parameter_alignment_));
 
   return std::unique_ptr<PjRtBuffer>(std::make_unique<TfrtCpuBuffer>(
       shape, std::move(tracked_device_buffer), this,
@@ -1160,6 +1261,25 @@ TfrtCpuExecutable::TfrtCpuExecutable(
   // switch time (~5us).
   cheap_computation_ = hlo_cost_analysis->flop_count() < 1000;
 
+  // Only kernels emitted for the thunk runtime honor relaxed parameter
+  // alignment, legacy executables always assume the default alignment.
+  auto* executable =
+      tensorflow::down_cast<cpu::CpuExecutable*>(cpu_executable_.get());
+  parameter_alignment_ =
+      executable->has_thunks()
+          ? cpu::options::ParameterAlignment(executable->module().config())
+          : static_cast<int64_t>(cpu_function_runtime::MinAlign());
+
+  if (client_->buffer_pool_max_bytes_ > 0) {
+    const BufferAssignment& assignment = executable->buffer_assignment();
+    std::vector<size_t> allocation_sizes(assignment.Allocations().size());
+    for (BufferAllocation::Index i = 0; i < allocation_sizes.size(); ++i) {
+      allocation_sizes[i] = assignment.GetAllocation(i).size();
+    }
+    buffer_pool_ = cpu::CpuBufferPool::Create(
+        std::move(allocation_sizes), {client_->buffer_pool_max_bytes_});
+  }
+
   const auto& computation_layout =
       cpu_executable_->module().entry_computation_layout();
   if (computation_layout.parameter_count() == 0) {
@@ -1215,10 +1335,15 @@ struct BufferAlloc {
   // All data members should have the same size.
   absl::InlinedVector<tsl::AsyncValueRef<MaybeOwningCpuMemory>, 4> buffers;
   absl::InlinedVector<size_t, 4> allocation_sizes;
+  absl::InlinedVector<BufferAllocation::Index, 4> allocation_indices;
+
+  // If set, memory is allocated from the pool of the executable.
+  tsl::RCReference<cpu::CpuBufferPool> pool;
 
   void Allocate() {
     for (int i = 0; i < buffers.size(); ++i) {
-      auto memory = MaybeOwningCpuMemory::Allocate(allocation_sizes[i]);
+      auto memory = pool ? pool->Allocate(allocation_indices[i])
+                         : MaybeOwningCpuMemory::Allocate(allocation_sizes[i]);
       if (!memory.ok()) {
         buffers[i].SetError(memory.status());
         return;
@@ -1259,6 +1384,8 @@ static absl::StatusOr<BufferInfo> MemoryForAllocation(
     const BufferAllocation& allocation,
     absl::Span<const cpu::CpuExecutable::ConstantAllocation> constants,
     absl::Span<std::pair<bool, TrackedTfrtCpuDeviceBuffer*> const> arguments,
+    int64_t parameter_alignment,
+    tsl::AsyncValueRef<MaybeOwningCpuMemory> static_buffer,
     BufferAlloc& buffer_alloc, BufferAllocAndCopy& buffer_alloc_and_copy) {
   BufferInfo buffer_info;
   if (allocation.is_entry_computation_parameter()) {
@@ -1272,7 +1399,15 @@ static absl::StatusOr<BufferInfo> MemoryForAllocation(
     // If we don't own the buffer, we can't overwrite it or donate it. For
     // example we might be pointing to a buffer owned by the client whose
     // lifetime will not extend past the lifetime of the donated input buffer.
-    if ((!can_donate || !arg->owns_buffers()) && !allocation.is_readonly()) {
+    //
+    // Host buffers adopted without a copy might also be aligned to a smaller
+    // boundary than the compiled kernels assume, e.g. if the executable was
+    // compiled with a larger xla_cpu_parameter_alignment than the client's.
+    // Buffers allocated by XLA are always sufficiently aligned.
+    bool misaligned = out.IsConcrete() &&
+                      !IsAligned(out->data(), parameter_alignment);
+    if (((!can_donate || !arg->owns_buffers()) && !allocation.is_readonly()) ||
+        misaligned) {
       auto copy = tsl::MakeUnconstructedAsyncValueRef<MaybeOwningCpuMemory>();
 
       buffer_alloc_and_copy.src_buffers.push_back(std::move(out));
@@ -1294,15 +1429,18 @@ static absl::StatusOr<BufferInfo> MemoryForAllocation(
              allocation.index() < constants.size()) {
     se::DeviceMemoryBase constant =
         constants[allocation.index()].AsDeviceMemoryBase();
-    buffer_info.buffer = tsl::MakeAvailableAsyncValueRef<MaybeOwningCpuMemory>(
-        constant.opaque(), constant.size());
+    buffer_info.buffer =
+        static_buffer ? std::move(static_buffer)
+                      : tsl::MakeAvailableAsyncValueRef<MaybeOwningCpuMemory>(
+                            constant.opaque(), constant.size());
     buffer_info.owns_buffer = false;
     buffer_info.buffer_size = constant.size();
     return buffer_info;
 
   } else if (allocation.is_constant() || allocation.is_thread_local()) {
     buffer_info.buffer =
-        tsl::MakeAvailableAsyncValueRef<MaybeOwningCpuMemory>();
+        static_buffer ? std::move(static_buffer)
+                      : tsl::MakeAvailableAsyncValueRef<MaybeOwningCpuMemory>();
     buffer_info.owns_buffer = true;
     buffer_info.buffer_size = 0;
     return buffer_info;
@@ -1313,6 +1451,7 @@ static absl::StatusOr<BufferInfo> MemoryForAllocation(
 
   buffer_alloc.buffers.push_back(out);
   buffer_alloc.allocation_sizes.push_back(allocation.size());
+  buffer_alloc.allocation_indices.push_back(allocation.index());
 
   buffer_info.buffer = std::move(out);
   buffer_info.owns_buffer = true;
@@ -1320,22 +1459,54 @@ static absl::StatusOr<BufferInfo> MemoryForAllocation(
   return buffer_info;
 }
 
+// Buffers of constant and thread-local allocations do not depend on the
+// arguments, `static_buffers` (indexed by allocation index) may provide them
+// so that they are not created on every execution.
 static absl::StatusOr<std::vector<BufferInfo>> CreateBufferTable(
     const BufferAssignment& assignment,
     absl::Span<const cpu::CpuExecutable::ConstantAllocation> constants,
     absl::Span<std::pair<bool, TrackedTfrtCpuDeviceBuffer*> const> arguments,
+    int64_t parameter_alignment,
+    absl::Span<const tsl::AsyncValueRef<MaybeOwningCpuMemory>> static_buffers,
     BufferAlloc& buffer_alloc, BufferAllocAndCopy& buffer_alloc_and_copy) {
   std::vector<BufferInfo> buffer_table(assignment.Allocations().size());
   for (BufferAllocation::Index i = 0; i < buffer_table.size(); ++i) {
     const BufferAllocation& allocation = assignment.GetAllocation(i);
+    tsl::AsyncValueRef<MaybeOwningCpuMemory> static_buffer;
+    if (i < static_buffers.size()) static_buffer = static_buffers[i];
     TF_ASSIGN_OR_RETURN(
         buffer_table[i],
-        MemoryForAllocation(allocation, constants, arguments, buffer_alloc,
-                            buffer_alloc_and_copy));
+        MemoryForAllocation(allocation, constants, arguments,
+                            parameter_alignment, std::move(static_buffer),
+                            buffer_alloc, buffer_alloc_and_copy));
   }
   return std::move(buffer_table);
 }
 
+// Returns the buffers of constant and thread-local allocations for
+// `CreateBufferTable`.
+static std::vector<tsl::AsyncValueRef<MaybeOwningCpuMemory>>
+CreateStaticBuffers(
+    const BufferAssignment& assignment,
+    absl::Span<const cpu::CpuExecutable::ConstantAllocation> constants) {
+  std::vector<tsl::AsyncValueRef<MaybeOwningCpuMemory>> static_buffers(
+      assignment.Allocations().size());
+  for (BufferAllocation::Index i = 0; i < static_buffers.size(); ++i) {
+    const BufferAllocation& allocation = assignment.GetAllocation(i);
+    if (allocation.is_entry_computation_parameter()) continue;
+    if (allocation.is_constant() && allocation.index() < constants.size()) {
+      se::DeviceMemoryBase constant =
+          constants[allocation.index()].AsDeviceMemoryBase();
+      static_buffers[i] = tsl::MakeAvailableAsyncValueRef<MaybeOwningCpuMemory>(
+          constant.opaque(), constant.size());
+    } else if (allocation.is_constant() || allocation.is_thread_local()) {
+      static_buffers[i] =
+          tsl::MakeAvailableAsyncValueRef<MaybeOwningCpuMemory>();
+    }
+  }
+  return static_buffers;
+}
+
 static absl::InlinedVector<BufferInfo, 4> CreateResultBufferInfo(
     absl::Span<const BufferAllocation::Index> buffer_indices,
     absl::Span<const BufferInfo> buffer_table) {
@@ -1372,11 +1543,14 @@ absl::StatusOr<PjRtLoadedExecutable::Result> TfrtCpuExecutable::ExecuteHelper(
     absl::Span<PjRtBuffer* const> argument_handles, int replica, int partition,
     const RunId& run_id, const ExecuteOptions& options,
     tsl::AsyncValueRef<CpuEvent> last_collective_launch_event, bool fill_future,
-    TfrtCpuDevice* device) {
+    TfrtCpuDevice* device, const BoundCall* bound_call) {
   tsl::profiler::TraceMe traceme("TfrtCpuExecutable::ExecuteHelper");
 
   std::shared_ptr<DeviceAssignment> device_assignment;
-  if (device == nullptr) {
+  if (bound_call != nullptr) {
+    device = bound_call->device_;
+    device_assignment = bound_call->device_assignment_;
+  } else if (device == nullptr) {
     CHECK(device_assignment_ != nullptr);
     const int64_t device_id = (*device_assignment_)(replica, partition);
     PjRtGlobalDeviceId global_device_id(device_id);
@@ -1526,12 +1700,16 @@ absl::StatusOr<PjRtLoadedExecutable::Result> TfrtCpuExecutable::ExecuteHelper(
   // `buffer_alloc` and `buffer_alloc_and_copy` are used to do real memory
   // allocation and copy work.
   BufferAlloc buffer_alloc;
+  buffer_alloc.pool = buffer_pool_;
   BufferAllocAndCopy buffer_alloc_and_copy;
+  absl::Span<const tsl::AsyncValueRef<MaybeOwningCpuMemory>> static_buffers;
+  if (bound_call != nullptr) static_buffers = bound_call->static_buffers_;
   TF_ASSIGN_OR_RETURN(
       std::vector<BufferInfo> buffer_table,
       CreateBufferTable(cpu_executable->buffer_assignment(),
                         cpu_executable->constants(), tracked_buffers,
-                        buffer_alloc, buffer_alloc_and_copy));
+                        parameter_alignment_, static_buffers, buffer_alloc,
+                        buffer_alloc_and_copy));
   auto result_buffers_info =
       CreateResultBufferInfo(result_buffer_indices_, buffer_table);
 
@@ -1550,8 +1728,13 @@ absl::StatusOr<PjRtLoadedExecutable::Result> TfrtCpuExecutable::ExecuteHelper(
   run_options.set_device_assignment(device_assignment.get());
   run_options.set_intra_op_thread_pool(client_->eigen_intraop_device());
 
-  auto cpu_run_options = std::make_shared<cpu::CpuExecutableRunOptions>();
-  cpu_run_options->set_collectives(client_->collectives_.get());
+  std::shared_ptr<cpu::CpuExecutableRunOptions> cpu_run_options;
+  if (bound_call != nullptr) {
+    cpu_run_options = bound_call->cpu_run_options_;
+  } else {
+    cpu_run_options = std::make_shared<cpu::CpuExecutableRunOptions>();
+    cpu_run_options->set_collectives(client_->collectives_.get());
+  }
   run_options.set_cpu_executable_run_options(cpu_run_options.get());
 
   // Schedule only one collective at a time.
@@ -2094,4 +2277,132 @@ TfrtCpuExecutable::ExecutePortable(
   returned_future = std::move(result.future);
   return std::move(result.buffers);
 }
+
+absl::StatusOr<std::unique_ptr<TfrtCpuExecutable::BoundCall>>
+TfrtCpuExecutable::Bind(absl::Span<const Shape> argument_shapes,
+                        PjRtDevice* device, const ExecuteOptions& options) {
+  tsl::profiler::TraceMe traceme("TfrtCpuExecutable::Bind");
+  if (device == nullptr) {
+    return InvalidArgument("Bind expects a device to be specified");
+  }
+  if (options.arguments_are_tupled) {
+    return Unimplemented("Bound calls do not support tupled arguments");
+  }
+
+  // Check the argument signature once, so that every call only has to check
+  // the sizes of argument buffers.
+  const auto& computation_layout =
+      cpu_executable_->module().entry_computation_layout();
+  auto parameter_shape = [&](int i) -> const Shape& {
+    return parameter_is_tupled_arguments_
+               ? computation_layout.parameter_shape(0).tuple_shapes(i)
+               : computation_layout.parameter_shape(i);
+  };
+  int num_parameters =
+      parameter_is_tupled_arguments_
+          ? computation_layout.parameter_shape(0).tuple_shapes_size()
+          : computation_layout.parameter_count();
+
+  if (argument_shapes.size() != num_parameters) {
+    return InvalidArgument(
+        "Bound call has %d arguments but compiled program expects %d",
+        argument_shapes.size(), num_parameters);
+  }
+  for (int i = 0; i < argument_shapes.size(); ++i) {
+    if (!ShapeUtil::Compatible(argument_shapes[i], parameter_shape(i))) {
+      return InvalidArgument(
+          "Bound call argument %d has shape %s, but compiled program expects "
+          "%s",
+          i, ShapeUtil::HumanString(argument_shapes[i]),
+          ShapeUtil::HumanString(parameter_shape(i)));
+    }
+  }
+
+  auto bound_call = absl::WrapUnique(new BoundCall(this));
+  bound_call->device_ = tensorflow::down_cast<TfrtCpuDevice*>(device);
+  bound_call->options_ = options;
+
+  if (device_assignment_ != nullptr) {
+    auto it = absl::c_find(addressable_devices_, device);
+    if (it == addressable_devices_.end()) {
+      return InvalidArgument(
+          "Bind attempted to bind to device id %d which is not addressable by "
+          "the executable",
+          device->id());
+    }
+    const LogicalDeviceIds& logical_ids =
+        addressable_device_logical_ids_[it - addressable_devices_.begin()];
+    bound_call->replica_ = logical_ids.replica;
+    bound_call->partition_ = logical_ids.partition;
+    bound_call->device_assignment_ = device_assignment_;
+  } else {
+    if (num_replicas() != 1 || num_partitions() != 1) {
+      return InvalidArgument(
+          "Bind expects a single-core portable executable but gets one with "
+          "%d replica %d partition",
+          num_replicas(), num_partitions());
+    }
+    if (device->client() != client_ || !device->IsAddressable()) {
+      return InvalidArgument(
+          "Bind attempted to bind to device id %d which is not addressable by "
+          "this client",
+          device->id());
+    }
+    bound_call->device_assignment_ = std::make_shared<DeviceAssignment>(1, 1);
+    (*bound_call->device_assignment_)(0, 0) = device->id();
+  }
+
+  bound_call->cpu_run_options_ =
+      std::make_shared<cpu::CpuExecutableRunOptions>();
+  bound_call->cpu_run_options_->set_collectives(client_->collectives_.get());
+
+  auto* cpu_executable =
+      tensorflow::down_cast<cpu::CpuExecutable*>(cpu_executable_.get());
+  bound_call->static_buffers_ = CreateStaticBuffers(
+      cpu_executable->buffer_assignment(), cpu_executable->constants());
+
+  const HloModule& module = cpu_executable_->module();
+  bound_call->dump_hlo_snapshots_ =
+      DumpingEnabledForHloModule(module) &&
+      module.config().debug_options().xla_dump_hlo_snapshots();
+
+  return bound_call;
+}
+
+absl::StatusOr<std::vector<std::unique_ptr<PjRtBuffer>>>
+TfrtCpuExecutable::BoundCall::Execute(
+    absl::Span<PjRtBuffer* const> argument_handles,
+    std::optional<PjRtFuture<>>& returned_future, bool fill_future) {
+  tsl::profiler::TraceMe traceme("TfrtCpuExecutable::BoundCall::Execute");
+  RunId run_id;
+
+  const HloModule& module = executable_->cpu_executable_->module();
+  if (dump_hlo_snapshots_) {
+    MaybeDumpHloSnapshot(
+        module, run_id,
+        std::vector<PjRtBuffer*>(argument_handles.begin(),
+                                 argument_handles.end()),
+        {});
+  }
+
+  // Runs the regular execution path, which picks up the device, run options
+  // and static buffers resolved by Bind instead of creating them again.
+  TF_ASSIGN_OR_RETURN(
+      auto result,
+      executable_->ExecuteHelper(
+          argument_handles, replica_, partition_, run_id, options_,
+          /*last_collective_launch_event=*/tsl::AsyncValueRef<CpuEvent>(),
+          fill_future, /*device=*/nullptr, /*bound_call=*/this));
+
+  if (dump_hlo_snapshots_) {
+    MaybeDumpHloSnapshot(module, run_id,
+                         std::vector<PjRtBuffer*>(argument_handles.begin(),
+                                                  argument_handles.end()),
+                         result.buffers);
+  }
+
+  returned_future = std::move(result.future);
+  return std::move(result.buffers);
+}
+
 }  // namespace xla
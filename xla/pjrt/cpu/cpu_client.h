@@ -44,6 +44,8 @@ limitations under the License.
 #include "xla/layout.h"
 #include "xla/literal.h"
 #include "xla/pjrt/cpu/abstract_tfrt_cpu_buffer.h"
+#include "xla/pjrt/cpu/cpu_buffer_pool.h"
+#include "xla/pjrt/cpu/cpu_executable_cache.h"
 #include "xla/pjrt/cpu/cpu_topology.h"
 #include "xla/pjrt/cpu/tracked_tfrt_cpu_device_buffer.h"
 #include "xla/pjrt/pjrt_client.h"
@@ -59,12 +61,14 @@ limitations under the License.
 #include "xla/service/computation_placer.h"
 #include "xla/service/cpu/collectives_interface.h"
 #include "xla/service/cpu/cpu_event.h"
+#include "xla/service/cpu/cpu_executable_run_options.h"
 #include "xla/service/executable.h"
 #include "xla/service/hlo.pb.h"
 #include "xla/service/hlo_cost_analysis.h"
 #include "xla/service/hlo_module_config.h"
 #include "xla/shape.h"
 #include "xla/tsl/concurrency/async_value_ref.h"
+#include "xla/tsl/concurrency/ref_count.h"
 #include "xla/util.h"
 #include "xla/xla_data.pb.h"
 #include "tsl/platform/errors.h"
@@ -262,7 +266,9 @@ class TfrtCpuClient final : public PjRtClient {
       int process_index, std::vector<std::unique_ptr<TfrtCpuDevice>> devices,
       std::shared_ptr<cpu::CollectivesInterface> collectives,
       size_t num_threads, bool asynchronous,
-      std::function<void(HloModuleConfig&)> customize_hlo_module_config);
+      std::function<void(HloModuleConfig&)> customize_hlo_module_config,
+      std::unique_ptr<cpu::CpuExecutableCache> executable_cache = nullptr,
+      int64_t parameter_alignment = 0, int64_t buffer_pool_max_bytes = 0);
   ~TfrtCpuClient() override;
 
   int process_index() const override { return process_index_; }
@@ -408,6 +414,11 @@ class TfrtCpuClient final : public PjRtClient {
     return eigen_intraop_device_.get();
   }
 
+  // Returns the persistent executable cache or nullptr if it's not enabled.
+  cpu::CpuExecutableCache* executable_cache() const {
+    return executable_cache_.get();
+  }
+
   tsl::AsyncValueRef<CpuEvent> GetLastCollectiveLaunchEvent() {
     absl::MutexLock lock(&mu_);
     return last_collective_launch_event_.CopyRef();
@@ -489,6 +500,17 @@ class TfrtCpuClient final : public PjRtClient {
   // A callback to customize the HloModuleConfig for each compiled module.
   std::function<void(HloModuleConfig&)> customize_hlo_module_config_;
 
+  // A persistent cache of compiled executables. Optional.
+  std::unique_ptr<cpu::CpuExecutableCache> executable_cache_;
+
+  // Alignment in bytes that executables compiled by this client assume for
+  // their parameters, or zero for the default alignment.
+  int64_t parameter_alignment_;
+
+  // Size limit of the buffer pool of each executable, or zero if executables
+  // do not pool their buffers.
+  int64_t buffer_pool_max_bytes_;
+
   // Used to prevent too much parallelism: we will not enqueue next non-parallel
   // computation until last one is done within each user thread.
   // TODO(yueshengys): Consider moving the enqueuing/ordering logic to JAX via
@@ -630,6 +652,71 @@ class TfrtCpuExecutable final : public PjRtLoadedExecutable {
 
   std::shared_ptr<Executable> cpu_executable() const { return cpu_executable_; }
 
+  // Returns the statistics of the buffer pool or std::nullopt if the client
+  // was created without buffer pooling.
+  std::optional<cpu::CpuBufferPool::Stats> buffer_pool_stats() const {
+    if (!buffer_pool_) return std::nullopt;
+    return buffer_pool_->stats();
+  }
+
+  // A call of this executable bound to a fixed device, argument signature and
+  // execute options, see `Bind`. Some of the work that only depends on those is
+  // done once when binding: the signature is validated against the compiled
+  // program, the device and device assignment are looked up, and run options
+  // and buffers of constants and thread-local allocations are created.
+  //
+  // Everything else still happens on each `Execute`, exactly as for a regular
+  // `Execute` of the executable: argument buffers are acquired and checked,
+  // donations are tracked, the buffer table is built, temp and output buffers
+  // are allocated and the completion events are set up. Bound calls therefore
+  // save a constant amount of work per call, they do not make dispatch free.
+  //
+  // Bound calls may be executed concurrently, but must not outlive the
+  // executable that created them.
+  class BoundCall {
+   public:
+    absl::StatusOr<std::vector<std::unique_ptr<PjRtBuffer>>> Execute(
+        absl::Span<PjRtBuffer* const> argument_handles,
+        std::optional<PjRtFuture<>>& returned_future, bool fill_future);
+
+    absl::StatusOr<std::vector<std::unique_ptr<PjRtBuffer>>> Execute(
+        absl::Span<PjRtBuffer* const> argument_handles) {
+      std::optional<PjRtFuture<>> returned_future;
+      return Execute(argument_handles, returned_future, /*fill_future=*/false);
+    }
+
+    PjRtDevice* device() const { return device_; }
+
+   private:
+    friend class TfrtCpuExecutable;
+
+    explicit BoundCall(TfrtCpuExecutable* executable)
+        : executable_(executable) {}
+
+    TfrtCpuExecutable* executable_;
+    TfrtCpuDevice* device_ = nullptr;
+    int replica_ = 0;
+    int partition_ = 0;
+    ExecuteOptions options_;
+    bool dump_hlo_snapshots_ = false;
+
+    std::shared_ptr<DeviceAssignment> device_assignment_;
+    std::shared_ptr<cpu::CpuExecutableRunOptions> cpu_run_options_;
+
+    // Buffers of constant and thread-local allocations indexed by allocation
+    // index, null for all other allocations.
+    std::vector<tsl::AsyncValueRef<MaybeOwningCpuMemory>> static_buffers_;
+  };
+
+  // Binds the executable to run on `device` with arguments of
+  // `argument_shapes` (which must be compatible with the parameters of the
+  // compiled program) and `options`. Works for both portable executables and
+  // executables with a device assignment, in which case `device` must be one
+  // of the addressable devices.
+  absl::StatusOr<std::unique_ptr<BoundCall>> Bind(
+      absl::Span<const Shape> argument_shapes, PjRtDevice* device,
+      const ExecuteOptions& options = ExecuteOptions());
+
   absl::StatusOr<std::string> FingerprintExecutable() const override {
     return Unimplemented("Fingerprinting executable is not supported.");
   }
@@ -653,7 +740,8 @@ class TfrtCpuExecutable final : public PjRtLoadedExecutable {
       absl::Span<PjRtBuffer* const> argument_handles, int replica,
       int partition, const RunId& run_id, const ExecuteOptions& options,
       tsl::AsyncValueRef<CpuEvent> last_collective_launch_event,
-      bool fill_future, TfrtCpuDevice* device = nullptr);
+      bool fill_future, TfrtCpuDevice* device = nullptr,
+      const BoundCall* bound_call = nullptr);
 
   TfrtCpuClient* client_;
 
@@ -697,6 +785,14 @@ class TfrtCpuExecutable final : public PjRtLoadedExecutable {
   // Cached result of comparing HloCostAnalysis FLOP estimate for execute
   // critical path.
   bool cheap_computation_;
+
+  // Alignment in bytes that the compiled program assumes for its parameters.
+  // Arguments with a smaller alignment are copied before execution.
+  int64_t parameter_alignment_;
+
+  // Recycles the memory of temp and output buffers between executions.
+  // Optional.
+  tsl::RCReference<cpu::CpuBufferPool> buffer_pool_;
 };
 
 absl::StatusOr<std::unique_ptr<PjRtClient>> ABSL_DEPRECATED(
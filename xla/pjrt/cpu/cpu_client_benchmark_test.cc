@@ -0,0 +1,273 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/log/check.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "xla/hlo/builder/xla_computation.h"
+#include "xla/hlo/parser/hlo_parser.h"
+#include "xla/literal_util.h"
+#include "xla/pjrt/cpu/cpu_client.h"
+#include "xla/pjrt/pjrt_client.h"
+#include "xla/pjrt/pjrt_executable.h"
+#include "xla/pjrt/plugin/xla_cpu/cpu_client_options.h"
+#include "xla/shape.h"
+#include "xla/shape_util.h"
+#include "xla/xla_data.pb.h"
+#include "tsl/platform/casts.h"
+#include "tsl/platform/test_benchmark.h"
+
+namespace xla {
+namespace {
+
+// Benchmarks in this file measure the fixed per-call overhead of
+// TfrtCpuExecutable::Execute: argument validation, donation tracking, async
+// value and event plumbing. All programs are trivial, so that the time spent
+// in compiled kernels is negligible compared to the runtime overheads.
+//
+// Every iteration waits for the results to become ready, so asynchronous
+// dispatch measures the full round trip through the intra-op thread pool.
+
+using ExecutionMode = ExecuteOptions::ExecutionMode;
+
+static std::unique_ptr<PjRtClient> CreateClient() {
+  CpuClientOptions options;
+  options.cpu_device_count = 1;
+  auto client = GetTfrtCpuClient(std::move(options));
+  CHECK_OK(client);
+  return std::move(*client);
+}
+
+static std::unique_ptr<PjRtLoadedExecutable> Compile(PjRtClient* client,
+                                                     absl::string_view hlo) {
+  auto module = ParseAndReturnUnverifiedModule(hlo);
+  CHECK_OK(module);
+  auto executable =
+      client->Compile(XlaComputation((*module)->ToProto()), CompileOptions());
+  CHECK_OK(executable);
+  return std::move(*executable);
+}
+
+static std::vector<std::unique_ptr<PjRtBuffer>> CreateScalars(
+    PjRtClient* client, int64_t num_scalars) {
+  PjRtDevice* device = client->addressable_devices().front();
+  std::vector<std::unique_ptr<PjRtBuffer>> buffers;
+  for (int64_t i = 0; i < num_scalars; ++i) {
+    auto buffer = client->BufferFromHostLiteral(
+        LiteralUtil::CreateR0<float>(static_cast<float>(i)), device);
+    CHECK_OK(buffer);
+    CHECK_OK((*buffer)->GetReadyFuture().Await());
+    buffers.push_back(std::move(*buffer));
+  }
+  return buffers;
+}
+
+static std::vector<PjRtBuffer*> Pointers(
+    const std::vector<std::unique_ptr<PjRtBuffer>>& buffers) {
+  std::vector<PjRtBuffer*> pointers;
+  pointers.reserve(buffers.size());
+  for (const auto& buffer : buffers) pointers.push_back(buffer.get());
+  return pointers;
+}
+
+static ExecuteOptions GetExecuteOptions(bool async) {
+  ExecuteOptions options;
+  options.untuple_result = true;
+  options.execution_mode =
+      async ? ExecutionMode::kAsynchronous : ExecutionMode::kSynchronous;
+  return options;
+}
+
+// Executes `executable` and waits for all results to become ready.
+static std::vector<std::unique_ptr<PjRtBuffer>> ExecuteAndAwait(
+    PjRtLoadedExecutable* executable, absl::Span<PjRtBuffer* const> args,
+    const ExecuteOptions& options) {
+  auto results = executable->Execute({{args.begin(), args.end()}}, options);
+  CHECK_OK(results);
+  for (const auto& result : (*results)[0]) {
+    CHECK_OK(result->GetReadyFuture().Await());
+  }
+  return std::move((*results)[0]);
+}
+
+static void BM_AddScalars(benchmark::State& state) {
+  bool async = state.range(0);
+  bool bound = state.range(1);
+
+  static constexpr absl::string_view kProgram = R"(
+    HloModule add_scalars
+    ENTRY e {
+      p0 = f32[] parameter(0)
+      p1 = f32[] parameter(1)
+      ROOT add = f32[] add(p0, p1)
+    })";
+
+  auto client = CreateClient();
+  auto executable = Compile(client.get(), kProgram);
+  auto args = CreateScalars(client.get(), 2);
+  std::vector<PjRtBuffer*> arg_ptrs = Pointers(args);
+  ExecuteOptions options = GetExecuteOptions(async);
+
+  if (bound) {
+    Shape shape = ShapeUtil::MakeShape(F32, {});
+    auto bound_call =
+        tensorflow::down_cast<TfrtCpuExecutable*>(executable.get())
+            ->Bind({shape, shape}, client->addressable_devices().front(),
+                   options);
+    CHECK_OK(bound_call);
+
+    for (auto _ : state) {
+      auto results = (*bound_call)->Execute(arg_ptrs);
+      CHECK_OK(results);
+      CHECK_OK((*results)[0]->GetReadyFuture().Await());
+    }
+    return;
+  }
+
+  for (auto _ : state) {
+    auto results = ExecuteAndAwait(executable.get(), arg_ptrs, options);
+    benchmark::DoNotOptimize(results);
+  }
+}
+
+// Returns a program that returns its `num_args` scalar parameters as a tuple.
+// If `donate` is true, every output aliases the parameter it returns.
+static std::string IdentityProgram(int64_t num_args, bool donate) {
+  std::vector<std::string> params, names, aliases;
+  for (int64_t i = 0; i < num_args; ++i) {
+    params.push_back(absl::StrCat("p", i, " = f32[] parameter(", i, ")"));
+    names.push_back(absl::StrCat("p", i));
+    aliases.push_back(absl::StrCat("{", i, "}: (", i, ", {}, may-alias)"));
+  }
+
+  std::string alias_config =
+      donate ? absl::StrCat(", input_output_alias={ ",
+                            absl::StrJoin(aliases, ", "), " }")
+             : "";
+
+  return absl::StrCat("HloModule identity", alias_config, "\nENTRY e {\n  ",
+                      absl::StrJoin(params, "\n  "), "\n  ROOT t = (",
+                      absl::StrJoin(std::vector<std::string>(num_args, "f32[]"),
+                                    ", "),
+                      ") tuple(", absl::StrJoin(names, ", "), ")\n}");
+}
+
+static void BM_Identity(benchmark::State& state) {
+  int64_t num_args = state.range(0);
+  bool donate = state.range(1);
+  bool async = state.range(2);
+
+  auto client = CreateClient();
+  auto executable = Compile(client.get(), IdentityProgram(num_args, donate));
+  auto args = CreateScalars(client.get(), num_args);
+  ExecuteOptions options = GetExecuteOptions(async);
+
+  for (auto _ : state) {
+    auto results = ExecuteAndAwait(executable.get(), Pointers(args), options);
+    // Donated arguments are consumed by the execution, feed the results that
+    // alias them into the next one.
+    if (donate) args = std::move(results);
+  }
+}
+
+static void BM_TupleOutputs(benchmark::State& state) {
+  int64_t num_outputs = state.range(0);
+  bool async = state.range(1);
+
+  std::vector<std::string> outputs, names;
+  for (int64_t i = 0; i < num_outputs; ++i) {
+    outputs.push_back(absl::StrCat("c", i, " = f32[] constant(", i, ")\n  o",
+                                   i, " = f32[] add(p0, c", i, ")"));
+    names.push_back(absl::StrCat("o", i));
+  }
+  std::string program = absl::StrCat(
+      "HloModule tuple_outputs\nENTRY e {\n  p0 = f32[] parameter(0)\n  ",
+      absl::StrJoin(outputs, "\n  "), "\n  ROOT t = (",
+      absl::StrJoin(std::vector<std::string>(num_outputs, "f32[]"), ", "),
+      ") tuple(", absl::StrJoin(names, ", "), ")\n}");
+
+  auto client = CreateClient();
+  auto executable = Compile(client.get(), program);
+  auto args = CreateScalars(client.get(), 1);
+  std::vector<PjRtBuffer*> arg_ptrs = Pointers(args);
+  ExecuteOptions options = GetExecuteOptions(async);
+
+  for (auto _ : state) {
+    auto results = ExecuteAndAwait(executable.get(), arg_ptrs, options);
+    benchmark::DoNotOptimize(results);
+  }
+}
+
+static void BM_ExecuteWithBufferPool(benchmark::State& state) {
+  static constexpr absl::string_view kProgram = R"(
+    HloModule add
+    ENTRY e {
+      x = f32[256] parameter(0)
+      y = f32[256] multiply(x, x)
+      ROOT add = f32[256] add(x, y)
+    })";
+
+  CpuClientOptions options;
+  options.cpu_device_count = 1;
+  options.buffer_pool_max_bytes = state.range(0);
+  auto client = GetTfrtCpuClient(std::move(options));
+  CHECK_OK(client);
+  auto executable = Compile(client->get(), kProgram);
+
+  auto x = (*client)->BufferFromHostLiteral(
+      LiteralUtil::CreateR1<float>(std::vector<float>(256, 1.0f)),
+      (*client)->addressable_devices().front());
+  CHECK_OK(x);
+  CHECK_OK((*x)->GetReadyFuture().Await());
+  std::vector<PjRtBuffer*> arg_ptrs = {x->get()};
+  ExecuteOptions execute_options = GetExecuteOptions(/*async=*/false);
+
+  for (auto _ : state) {
+    auto results = ExecuteAndAwait(executable.get(), arg_ptrs, execute_options);
+    benchmark::DoNotOptimize(results);
+  }
+}
+
+BENCHMARK(BM_AddScalars)
+    ->MeasureProcessCPUTime()
+    ->ArgNames({"async", "bound"})
+    ->ArgsProduct({{0, 1}, {0, 1}});
+
+BENCHMARK(BM_Identity)
+    ->MeasureProcessCPUTime()
+    ->ArgNames({"num_args", "donate", "async"})
+    ->ArgsProduct({{1, 4, 16, 64, 256}, {0, 1}, {0, 1}});
+
+BENCHMARK(BM_TupleOutputs)
+    ->MeasureProcessCPUTime()
+    ->ArgNames({"num_outputs", "async"})
+    ->ArgsProduct({{1, 4, 16, 64, 256}, {0, 1}});
+
+BENCHMARK(BM_ExecuteWithBufferPool)
+    ->MeasureProcessCPUTime()
+    ->ArgNames({"max_pooled_bytes"})
+    ->Arg(0)
+    ->Arg(1024 * 1024);
+
+}  // namespace
+}  // namespace xla
@@ -23,13 +23,16 @@ limitations under the License.
 #include <cstdint>
 #include <cstring>
 #include <memory>
+#include <numeric>
 #include <optional>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/blocking_counter.h"
 #include "absl/synchronization/notification.h"
 #include "xla/ffi/ffi.h"
 #include "xla/ffi/ffi_api.h"
@@ -49,10 +52,12 @@ limitations under the License.
 #include "xla/types.h"
 #include "xla/util.h"
 #include "xla/xla_data.pb.h"
+#include "tsl/platform/casts.h"
 #include "tsl/platform/env.h"
 #include "tsl/platform/errors.h"
 #include "tsl/platform/file_system.h"
 #include "tsl/platform/logging.h"
+#include "tsl/platform/path.h"
 #include "tsl/platform/status_matchers.h"
 #include "tsl/platform/statusor.h"
 #include "tsl/platform/test.h"
@@ -213,6 +218,260 @@ TEST(TfrtCpuClientTest, HloSnapshot) {
       LiteralUtil::CreateR2<float>({{11.0, 22.0}, {33.0, 44.0}, {55.0, 66.0}}));
 }
 
+TEST(TfrtCpuClientTest, ExecutableCache) {
+  static constexpr char kProgram[] = R"(
+    HloModule add
+    ENTRY add {
+      x = f32[3] parameter(0)
+      y = f32[3] parameter(1)
+      ROOT add = f32[3] add(x, y)
+    })";
+
+  std::string cache_dir =
+      tsl::io::JoinPath(tsl::testing::TmpDir(), "executable_cache");
+  ASSERT_TRUE(tsl::Env::Default()->CreateUniqueFileName(&cache_dir, ""));
+
+  TF_ASSERT_OK_AND_ASSIGN(auto hlo_module,
+                          ParseAndReturnUnverifiedModule(kProgram, {}));
+  XlaComputation xla_computation(hlo_module->ToProto());
+
+  auto compile_and_run = [&](PjRtClient& client) -> absl::StatusOr<Literal> {
+    TF_ASSIGN_OR_RETURN(auto executable, client.Compile(xla_computation, {}));
+    Literal x = LiteralUtil::CreateR1<float>({1.0f, 2.0f, 3.0f});
+    Literal y = LiteralUtil::CreateR1<float>({10.0f, 20.0f, 30.0f});
+    PjRtDevice* device = client.addressable_devices()[0];
+    TF_ASSIGN_OR_RETURN(auto x_buffer, client.BufferFromHostLiteral(x, device));
+    TF_ASSIGN_OR_RETURN(auto y_buffer, client.BufferFromHostLiteral(y, device));
+    TF_ASSIGN_OR_RETURN(
+        auto result,
+        executable->Execute({{x_buffer.get(), y_buffer.get()}}, {}));
+    TF_ASSIGN_OR_RETURN(auto literal, result[0][0]->ToLiteralSync());
+    return std::move(*literal);
+  };
+
+  Literal expected = LiteralUtil::CreateR1<float>({11.0f, 22.0f, 33.0f});
+
+  // The first client compiles the module and populates the cache.
+  CpuClientOptions options;
+  options.executable_cache_dir = cache_dir;
+  TF_ASSERT_OK_AND_ASSIGN(auto client, GetTfrtCpuClient(options));
+  TF_ASSERT_OK_AND_ASSIGN(Literal result, compile_and_run(*client));
+  EXPECT_TRUE(LiteralTestUtil::Equal(expected, result));
+
+  auto* cache =
+      tensorflow::down_cast<TfrtCpuClient*>(client.get())->executable_cache();
+  ASSERT_NE(cache, nullptr);
+  EXPECT_EQ(cache->stats().misses, 1);
+  EXPECT_EQ(cache->stats().insertions, 1);
+
+  // The second client loads the executable from the cache.
+  TF_ASSERT_OK_AND_ASSIGN(auto cached_client, GetTfrtCpuClient(options));
+  TF_ASSERT_OK_AND_ASSIGN(Literal cached_result,
+                          compile_and_run(*cached_client));
+  EXPECT_TRUE(LiteralTestUtil::Equal(expected, cached_result));
+
+  auto* cached_cache =
+      tensorflow::down_cast<TfrtCpuClient*>(cached_client.get())
+          ->executable_cache();
+  EXPECT_EQ(cached_cache->stats().hits, 1);
+  EXPECT_EQ(cached_cache->stats().insertions, 0);
+}
+
+TEST(TfrtCpuClientTest, ZeroCopyWithRelaxedParameterAlignment) {
+  static constexpr char kProgram[] = R"(
+    HloModule add
+    ENTRY add {
+      x = f32[1024] parameter(0)
+      ROOT add = f32[1024] add(x, x)
+    })";
+
+  CpuClientOptions options;
+  options.parameter_alignment = 16;
+  TF_ASSERT_OK_AND_ASSIGN(auto client, GetTfrtCpuClient(options));
+  TF_ASSERT_OK_AND_ASSIGN(auto hlo_module,
+                          ParseAndReturnUnverifiedModule(kProgram, {}));
+  XlaComputation xla_computation(hlo_module->ToProto());
+  TF_ASSERT_OK_AND_ASSIGN(auto executable,
+                          client->Compile(xla_computation, {}));
+
+  // Place the data at a 16-byte boundary that is not 64-byte aligned.
+  std::vector<float> storage(1024 + 16);
+  float* data = storage.data();
+  while (reinterpret_cast<uintptr_t>(data) % 64 != 16) ++data;
+  std::iota(data, data + 1024, 0.0f);
+
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto buffer,
+      client->BufferFromHostBuffer(
+          data, F32, {1024}, /*byte_strides=*/std::nullopt,
+          PjRtClient::HostBufferSemantics::kImmutableZeroCopy, nullptr,
+          client->addressable_devices()[0]));
+  EXPECT_THAT(client->UnsafeBufferPointer(buffer.get()),
+              IsOkAndHolds(reinterpret_cast<uintptr_t>(data)));
+
+  TF_ASSERT_OK_AND_ASSIGN(auto result,
+                          executable->Execute({{buffer.get()}}, {}));
+  TF_ASSERT_OK_AND_ASSIGN(auto literal, result[0][0]->ToLiteralSync());
+
+  std::vector<float> expected(1024);
+  for (int i = 0; i < 1024; ++i) expected[i] = 2.0f * i;
+  EXPECT_TRUE(LiteralTestUtil::Equal(LiteralUtil::CreateR1<float>(expected),
+                                     *literal));
+}
+
+TEST(TfrtCpuClientTest, ZeroCopyArgumentIsCopiedWhenUnderAligned) {
+  static constexpr char kProgram[] = R"(
+    HloModule add
+    ENTRY add {
+      x = f32[1024] parameter(0)
+      ROOT add = f32[1024] add(x, x)
+    })";
+
+  CpuClientOptions options;
+  options.parameter_alignment = 16;
+  TF_ASSERT_OK_AND_ASSIGN(auto client, GetTfrtCpuClient(options));
+  TF_ASSERT_OK_AND_ASSIGN(auto hlo_module,
+                          ParseAndReturnUnverifiedModule(kProgram, {}));
+  XlaComputation xla_computation(hlo_module->ToProto());
+
+  // The executable assumes a stricter alignment than the client guarantees
+  // for buffers adopted from the host.
+  CompileOptions compile_options;
+  compile_options.executable_build_options.mutable_debug_options()
+      ->set_xla_cpu_parameter_alignment(64);
+  TF_ASSERT_OK_AND_ASSIGN(auto executable,
+                          client->Compile(xla_computation, compile_options));
+
+  // Place the data at a 16-byte boundary that is not 64-byte aligned.
+  std::vector<float> storage(1024 + 16);
+  float* data = storage.data();
+  while (reinterpret_cast<uintptr_t>(data) % 64 != 16) ++data;
+  std::iota(data, data + 1024, 0.0f);
+
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto buffer,
+      client->BufferFromHostBuffer(
+          data, F32, {1024}, /*byte_strides=*/std::nullopt,
+          PjRtClient::HostBufferSemantics::kImmutableZeroCopy, nullptr,
+          client->addressable_devices()[0]));
+  EXPECT_THAT(client->UnsafeBufferPointer(buffer.get()),
+              IsOkAndHolds(reinterpret_cast<uintptr_t>(data)));
+
+  // The argument is copied into an aligned allocation instead of rejected.
+  TF_ASSERT_OK_AND_ASSIGN(auto result,
+                          executable->Execute({{buffer.get()}}, {}));
+  TF_ASSERT_OK_AND_ASSIGN(auto literal, result[0][0]->ToLiteralSync());
+
+  std::vector<float> expected(1024);
+  for (int i = 0; i < 1024; ++i) expected[i] = 2.0f * i;
+  EXPECT_TRUE(LiteralTestUtil::Equal(LiteralUtil::CreateR1<float>(expected),
+                                     *literal));
+  EXPECT_EQ(data[1], 1.0f);
+}
+
+TEST(TfrtCpuClientTest, BufferPool) {
+  static constexpr char kProgram[] = R"(
+    HloModule add
+    ENTRY add {
+      x = f32[1024] parameter(0)
+      ROOT add = f32[1024] add(x, x)
+    })";
+
+  CpuClientOptions options;
+  options.buffer_pool_max_bytes = 1024 * 1024;
+  TF_ASSERT_OK_AND_ASSIGN(auto client, GetTfrtCpuClient(options));
+  TF_ASSERT_OK_AND_ASSIGN(auto hlo_module,
+                          ParseAndReturnUnverifiedModule(kProgram, {}));
+  XlaComputation xla_computation(hlo_module->ToProto());
+  TF_ASSERT_OK_AND_ASSIGN(auto executable,
+                          client->Compile(xla_computation, {}));
+
+  std::vector<float> data(1024), expected(1024);
+  std::iota(data.begin(), data.end(), 0.0f);
+  for (int i = 0; i < 1024; ++i) expected[i] = 2.0f * i;
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto x, client->BufferFromHostLiteral(LiteralUtil::CreateR1<float>(data),
+                                            client->addressable_devices()[0]));
+
+  ExecuteOptions execute_options;
+  execute_options.execution_mode = ExecuteOptions::ExecutionMode::kSynchronous;
+
+  // Results are dropped after every execution, so that later executions can
+  // reuse their memory.
+  for (int i = 0; i < 3; ++i) {
+    TF_ASSERT_OK_AND_ASSIGN(auto result,
+                            executable->Execute({{x.get()}}, execute_options));
+    TF_ASSERT_OK_AND_ASSIGN(auto literal, result[0][0]->ToLiteralSync());
+    EXPECT_TRUE(LiteralTestUtil::Equal(LiteralUtil::CreateR1<float>(expected),
+                                       *literal));
+  }
+
+  auto stats = tensorflow::down_cast<TfrtCpuExecutable*>(executable.get())
+                   ->buffer_pool_stats();
+  ASSERT_TRUE(stats.has_value());
+  EXPECT_GT(stats->hits, 0);
+}
+
+TEST(TfrtCpuClientTest, BoundCall) {
+  static constexpr char kProgram[] = R"(
+    HloModule add
+    ENTRY add {
+      x = f32[3] parameter(0)
+      y = f32[3] parameter(1)
+      c = f32[3] constant({100, 200, 300})
+      add = f32[3] add(x, y)
+      ROOT sum = f32[3] add(add, c)
+    })";
+
+  TF_ASSERT_OK_AND_ASSIGN(auto client, GetTfrtCpuClient(CpuClientOptions()));
+  TF_ASSERT_OK_AND_ASSIGN(auto hlo_module,
+                          ParseAndReturnUnverifiedModule(kProgram, {}));
+  XlaComputation xla_computation(hlo_module->ToProto());
+  TF_ASSERT_OK_AND_ASSIGN(auto executable,
+                          client->Compile(xla_computation, {}));
+  auto* cpu_executable =
+      tensorflow::down_cast<TfrtCpuExecutable*>(executable.get());
+  PjRtDevice* device = client->addressable_devices()[0];
+
+  Shape shape = ShapeUtil::MakeShape(F32, {3});
+  EXPECT_THAT(cpu_executable->Bind({shape}, device),
+              tsl::testing::StatusIs(absl::StatusCode::kInvalidArgument,
+                                     HasSubstr("expects 2")));
+  EXPECT_THAT(
+      cpu_executable->Bind({shape, ShapeUtil::MakeShape(F32, {4})}, device),
+      tsl::testing::StatusIs(absl::StatusCode::kInvalidArgument,
+                             HasSubstr("argument 1 has shape f32[4]")));
+
+  TF_ASSERT_OK_AND_ASSIGN(auto bound_call,
+                          cpu_executable->Bind({shape, shape}, device));
+  EXPECT_EQ(bound_call->device(), device);
+
+  for (float i = 0; i < 3; ++i) {
+    TF_ASSERT_OK_AND_ASSIGN(
+        auto x, client->BufferFromHostLiteral(
+                    LiteralUtil::CreateR1<float>({i, i, i}), device));
+    TF_ASSERT_OK_AND_ASSIGN(
+        auto y, client->BufferFromHostLiteral(
+                    LiteralUtil::CreateR1<float>({1.0f, 2.0f, 3.0f}), device));
+
+    TF_ASSERT_OK_AND_ASSIGN(auto result,
+                            bound_call->Execute({x.get(), y.get()}));
+    ASSERT_EQ(result.size(), 1);
+    TF_ASSERT_OK_AND_ASSIGN(auto literal, result[0]->ToLiteralSync());
+    EXPECT_TRUE(LiteralTestUtil::Equal(
+        LiteralUtil::CreateR1<float>({101 + i, 202 + i, 303 + i}), *literal));
+  }
+
+  // Argument buffers are still checked on every call.
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto scalar,
+      client->BufferFromHostLiteral(LiteralUtil::CreateR0<float>(1.0f),
+                                    device));
+  EXPECT_THAT(bound_call->Execute({scalar.get(), scalar.get()}),
+              tsl::testing::StatusIs(absl::StatusCode::kInvalidArgument,
+                                     HasSubstr("incompatible size")));
+}
+
 TEST(TfrtCpuClientTest, AsyncTransferRawData) {
   TF_ASSERT_OK_AND_ASSIGN(auto client, GetTfrtCpuClient(CpuClientOptions()));
   xla::Shape shape = ShapeUtil::MakeShape(U32, {3, 2});
@@ -277,6 +536,61 @@ TEST(TfrtCpuClientTest, BufferFromLiteralInt4) {
               ElementsAreArray(literal.data<s4>()));
 }
 
+TEST(TfrtCpuClientTest, BufferFromHostBufferTransposesLargeArrays) {
+  TF_ASSERT_OK_AND_ASSIGN(auto client, GetTfrtCpuClient(CpuClientOptions()));
+  auto* thread_pool = tensorflow::down_cast<TfrtCpuClient*>(client.get())
+                          ->pjrt_client_thread_pool();
+
+  // A 2 MiB array in column-major layout, large enough for the transpose to
+  // be split across the threads of the client.
+  constexpr int64_t kRows = 512;
+  constexpr int64_t kCols = 1024;
+  std::vector<float> data(kRows * kCols);
+  std::iota(data.begin(), data.end(), 0.0f);
+  std::vector<int64_t> byte_strides = {sizeof(float), kRows * sizeof(float)};
+
+  std::vector<float> expected(kRows * kCols);
+  for (int64_t i = 0; i < kRows; ++i) {
+    for (int64_t j = 0; j < kCols; ++j) {
+      expected[i * kCols + j] = data[j * kRows + i];
+    }
+  }
+  TF_ASSERT_OK_AND_ASSIGN(
+      Literal expected_literal,
+      LiteralUtil::CreateR1<float>(expected).Reshape({kRows, kCols}));
+
+  auto transfer = [&]() {
+    return client->BufferFromHostBuffer(
+        data.data(), F32, {kRows, kCols}, byte_strides,
+        PjRtClient::HostBufferSemantics::kImmutableOnlyDuringCall, nullptr,
+        client->addressable_devices()[0]);
+  };
+
+  TF_ASSERT_OK_AND_ASSIGN(auto buffer, transfer());
+  TF_ASSERT_OK_AND_ASSIGN(auto literal, buffer->ToLiteralSync());
+  EXPECT_TRUE(LiteralTestUtil::Equal(expected_literal, *literal));
+
+  // Transfers issued from every thread of the client's pool at once must not
+  // wait for transpose chunks that no free thread can pick up.
+  int num_threads = thread_pool->NumThreads();
+  std::vector<absl::StatusOr<std::unique_ptr<PjRtBuffer>>> buffers(
+      num_threads);
+  absl::BlockingCounter counter(num_threads);
+  for (int i = 0; i < num_threads; ++i) {
+    thread_pool->Schedule([&, i] {
+      buffers[i] = transfer();
+      counter.DecrementCount();
+    });
+  }
+  counter.Wait();
+
+  for (auto& pool_buffer : buffers) {
+    TF_ASSERT_OK(pool_buffer.status());
+    TF_ASSERT_OK_AND_ASSIGN(auto pool_literal, (*pool_buffer)->ToLiteralSync());
+    EXPECT_TRUE(LiteralTestUtil::Equal(expected_literal, *pool_literal));
+  }
+}
+
 TEST(TfrtCpuClientTest, AsyncTransferCallsOnDone) {
   TF_ASSERT_OK_AND_ASSIGN(auto client, GetTfrtCpuClient(CpuClientOptions()));
   xla::Shape shape = ShapeUtil::MakeShape(F32, {3, 2});
@@ -0,0 +1,248 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/pjrt/cpu/cpu_executable_cache.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "absl/base/internal/endian.h"
+#include "absl/log/log.h"
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/str_join.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
+#include "xla/hlo/ir/hlo_module.h"
+#include "xla/tsl/lib/strings/proto_serialization.h"
+#include "xla/util.h"
+#include "tsl/platform/env.h"
+#include "tsl/platform/errors.h"
+#include "tsl/platform/file_system.h"
+#include "tsl/platform/fingerprint.h"
+#include "tsl/platform/path.h"
+
+namespace xla::cpu {
+
+// Bump the version every time the serialized executable format changes in an
+// incompatible way, so that stale entries are never loaded.
+static constexpr absl::string_view kCacheVersion = "v1";
+
+static constexpr absl::string_view kEntrySuffix = ".xla_cpu_executable";
+static constexpr absl::string_view kTempSuffix = ".tmp";
+
+// Every entry starts with a magic string followed by a 64-bit fingerprint of
+// the payload, which detects truncated or corrupted files.
+static constexpr absl::string_view kEntryMagic = "XLACPUEX";
+static constexpr size_t kEntryHeaderSize =
+    kEntryMagic.size() + sizeof(uint64_t);
+
+// Lookups refresh the modification time of entries that were not touched for
+// this long. Refreshing rewrites the entry, so we do it rarely.
+static constexpr uint64_t kRefreshIntervalNanos = 10ull * 60 * 1000000000;
+
+// Temporary files left behind by crashed writers are removed after this long.
+static constexpr uint64_t kStaleTempFileNanos = 60ull * 60 * 1000000000;
+
+absl::StatusOr<std::unique_ptr<CpuExecutableCache>> CpuExecutableCache::Create(
+    Options options, tsl::Env* env) {
+  if (options.directory.empty()) {
+    return InvalidArgument("Executable cache directory must not be empty");
+  }
+  TF_RETURN_IF_ERROR(env->RecursivelyCreateDir(options.directory));
+  return absl::WrapUnique(new CpuExecutableCache(std::move(options), env));
+}
+
+CpuExecutableCache::CpuExecutableCache(Options options, tsl::Env* env)
+    : options_(std::move(options)), env_(env) {}
+
+std::string CpuExecutableCache::Key(
+    const HloModule& module, absl::Span<const std::string> target_features) {
+  std::string fingerprint = absl::StrCat(
+      kCacheVersion, ":", module.GetFingerprint128(), ":",
+      tsl::DeterministicProtoHash64(module.config().ToProto()), ":",
+      absl::StrJoin(target_features, ","));
+  tsl::Fprint128 key = tsl::Fingerprint128(fingerprint);
+  return absl::StrFormat("%016x%016x", key.high64, key.low64);
+}
+
+std::string CpuExecutableCache::EntryPath(absl::string_view key) const {
+  return tsl::io::JoinPath(options_.directory, absl::StrCat(key, kEntrySuffix));
+}
+
+absl::StatusOr<std::optional<std::string>> CpuExecutableCache::Lookup(
+    absl::string_view key) {
+  std::string path = EntryPath(key);
+
+  auto miss = [&]() -> std::optional<std::string> {
+    absl::MutexLock lock(&mu_);
+    ++stats_.misses;
+    return std::nullopt;
+  };
+
+  tsl::FileStatistics stat;
+  if (!env_->Stat(path, &stat).ok()) return miss();
+
+  std::string data;
+  if (absl::Status read = tsl::ReadFileToString(env_, path, &data);
+      !read.ok()) {
+    // The entry might have been evicted by a concurrent writer.
+    if (absl::IsNotFound(read)) return miss();
+    return read;
+  }
+
+  // Drop entries that are truncated or corrupted.
+  if (data.size() < kEntryHeaderSize ||
+      !absl::StartsWith(data, kEntryMagic) ||
+      absl::big_endian::Load64(data.data() + kEntryMagic.size()) !=
+          tsl::Fingerprint64(
+              absl::string_view(data).substr(kEntryHeaderSize))) {
+    LOG(WARNING) << "Removing corrupted executable cache entry " << path;
+    env_->DeleteFile(path).IgnoreError();
+    return miss();
+  }
+
+  data.erase(0, kEntryHeaderSize);
+
+  // Keep recently used entries from being evicted.
+  uint64_t now_nanos = env_->NowNanos();
+  if (now_nanos > stat.mtime_nanos &&
+      now_nanos - stat.mtime_nanos > kRefreshIntervalNanos) {
+    if (absl::Status refreshed = WriteEntry(key, data); !refreshed.ok()) {
+      VLOG(1) << "Failed to refresh executable cache entry " << path << ": "
+              << refreshed;
+    }
+  }
+
+  absl::MutexLock lock(&mu_);
+  ++stats_.hits;
+  return data;
+}
+
+absl::Status CpuExecutableCache::Insert(absl::string_view key,
+                                        absl::string_view serialized) {
+  TF_RETURN_IF_ERROR(WriteEntry(key, serialized));
+  {
+    absl::MutexLock lock(&mu_);
+    ++stats_.insertions;
+  }
+  return EvictIfNeeded(key);
+}
+
+absl::Status CpuExecutableCache::WriteEntry(absl::string_view key,
+                                            absl::string_view serialized) {
+  std::string header(kEntryHeaderSize, '\0');
+  std::memcpy(header.data(), kEntryMagic.data(), kEntryMagic.size());
+  absl::big_endian::Store64(header.data() + kEntryMagic.size(),
+                            tsl::Fingerprint64(serialized));
+
+  std::string temp_path = EntryPath(key);
+  if (!env_->CreateUniqueFileName(&temp_path, std::string(kTempSuffix))) {
+    return Internal("Failed to create a temporary file name for %s",
+                    EntryPath(key));
+  }
+
+  std::unique_ptr<tsl::WritableFile> file;
+  TF_RETURN_IF_ERROR(env_->NewWritableFile(temp_path, &file));
+  absl::Status written = file->Append(header);
+  if (written.ok()) written = file->Append(serialized);
+  if (written.ok()) written = file->Close();
+  if (written.ok()) written = env_->RenameFile(temp_path, EntryPath(key));
+
+  if (!written.ok()) env_->DeleteFile(temp_path).IgnoreError();
+  return written;
+}
+
+absl::Status CpuExecutableCache::EvictIfNeeded(absl::string_view keep_key) {
+  if (options_.max_size_bytes <= 0) return absl::OkStatus();
+
+  struct Entry {
+    uint64_t mtime_nanos;
+    int64_t size;
+    std::string path;
+  };
+
+  std::vector<std::string> children;
+  TF_RETURN_IF_ERROR(env_->GetChildren(options_.directory, &children));
+
+  std::string keep_path = EntryPath(keep_key);
+  uint64_t now_nanos = env_->NowNanos();
+
+  std::vector<Entry> entries;
+  int64_t total_size = 0;
+
+  for (const std::string& child : children) {
+    std::string path = tsl::io::JoinPath(options_.directory, child);
+    tsl::FileStatistics stat;
+    // Other processes might delete entries concurrently with us.
+    if (!env_->Stat(path, &stat).ok() || stat.is_directory) continue;
+
+    if (absl::EndsWith(child, kTempSuffix)) {
+      if (now_nanos > stat.mtime_nanos &&
+          now_nanos - stat.mtime_nanos > kStaleTempFileNanos) {
+        env_->DeleteFile(path).IgnoreError();
+      }
+      continue;
+    }
+
+    if (!absl::EndsWith(child, kEntrySuffix)) continue;
+    total_size += stat.length;
+    if (path != keep_path) {
+      entries.push_back({stat.mtime_nanos, stat.length, std::move(path)});
+    }
+  }
+
+  if (total_size <= options_.max_size_bytes) return absl::OkStatus();
+
+  std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+    return std::tie(a.mtime_nanos, a.path) < std::tie(b.mtime_nanos, b.path);
+  });
+
+  int64_t num_evicted = 0;
+  for (const Entry& entry : entries) {
+    if (total_size <= options_.max_size_bytes) break;
+    if (env_->DeleteFile(entry.path).ok()) ++num_evicted;
+    // If deletion failed the entry most likely was already evicted by another
+    // process, in both cases it no longer takes space in the cache.
+    total_size -= entry.size;
+  }
+
+  VLOG(2) << "Evicted " << num_evicted << " entries from executable cache "
+          << options_.directory;
+
+  absl::MutexLock lock(&mu_);
+  stats_.evictions += num_evicted;
+  return absl::OkStatus();
+}
+
+CpuExecutableCache::Stats CpuExecutableCache::stats() const {
+  absl::MutexLock lock(&mu_);
+  return stats_;
+}
+
+}  // namespace xla::cpu
@@ -0,0 +1,104 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef XLA_PJRT_CPU_CPU_EXECUTABLE_CACHE_H_
+#define XLA_PJRT_CPU_CPU_EXECUTABLE_CACHE_H_
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
+#include "xla/hlo/ir/hlo_module.h"
+#include "tsl/platform/env.h"
+
+namespace xla::cpu {
+
+// A persistent on-disk cache of serialized CPU executables.
+//
+// Every entry is stored in its own file named after the cache key. Entries are
+// written to a temporary file first and then atomically renamed into place, so
+// multiple clients (and multiple processes) can safely share one directory:
+// readers always observe either a missing or a complete entry. Each entry
+// carries a fingerprint of its payload, and corrupted entries are dropped on
+// lookup.
+//
+// If `max_size_bytes` is positive, the total size of all entries is kept below
+// that limit by evicting the least recently used entries after each insertion.
+// Recency is tracked with file modification times, which lookups refresh when
+// they become stale.
+class CpuExecutableCache {
+ public:
+  struct Options {
+    std::string directory;
+    int64_t max_size_bytes = 0;  // <= 0 means unbounded
+  };
+
+  struct Stats {
+    int64_t hits = 0;
+    int64_t misses = 0;
+    int64_t insertions = 0;
+    int64_t evictions = 0;
+  };
+
+  static absl::StatusOr<std::unique_ptr<CpuExecutableCache>> Create(
+      Options options, tsl::Env* env = tsl::Env::Default());
+
+  // Returns a cache key for an unoptimized HLO module. The key covers the
+  // module fingerprint, its config (including debug options and layouts) and
+  // the target features of the machine we compile for.
+  static std::string Key(const HloModule& module,
+                         absl::Span<const std::string> target_features);
+
+  // Returns the serialized executable stored under `key` or std::nullopt if
+  // the cache doesn't have a valid entry for it.
+  absl::StatusOr<std::optional<std::string>> Lookup(absl::string_view key);
+
+  // Stores the serialized executable under `key` and evicts old entries if
+  // the cache grew above its size limit.
+  absl::Status Insert(absl::string_view key, absl::string_view serialized);
+
+  Stats stats() const;
+
+  const std::string& directory() const { return options_.directory; }
+
+ private:
+  CpuExecutableCache(Options options, tsl::Env* env);
+
+  std::string EntryPath(absl::string_view key) const;
+
+  // Atomically writes `serialized` to the entry file for `key`.
+  absl::Status WriteEntry(absl::string_view key, absl::string_view serialized);
+
+  // Evicts least recently used entries until the cache fits into the size
+  // limit. Never evicts the entry for `keep_key`.
+  absl::Status EvictIfNeeded(absl::string_view keep_key);
+
+  Options options_;
+  tsl::Env* env_;
+
+  mutable absl::Mutex mu_;
+  Stats stats_ ABSL_GUARDED_BY(mu_);
+};
+
+}  // namespace xla::cpu
+
+#endif  // XLA_PJRT_CPU_CPU_EXECUTABLE_CACHE_H_
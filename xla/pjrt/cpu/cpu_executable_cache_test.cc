@@ -0,0 +1,150 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/pjrt/cpu/cpu_executable_cache.h"
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "absl/log/check.h"
+#include "absl/strings/str_cat.h"
+#include "xla/hlo/parser/hlo_parser.h"
+#include "xla/tsl/lib/core/status_test_util.h"
+#include "xla/xla.pb.h"
+#include "tsl/platform/env.h"
+#include "tsl/platform/path.h"
+#include "tsl/platform/status_matchers.h"
+#include "tsl/platform/statusor.h"
+#include "tsl/platform/test.h"
+
+namespace xla::cpu {
+namespace {
+
+using ::testing::Optional;
+
+static std::string CreateCacheDir() {
+  std::string dir =
+      tsl::io::JoinPath(tsl::testing::TmpDir(), "cpu_executable_cache");
+  CHECK(tsl::Env::Default()->CreateUniqueFileName(&dir, ""));
+  return dir;
+}
+
+TEST(CpuExecutableCacheTest, InsertAndLookup) {
+  TF_ASSERT_OK_AND_ASSIGN(auto cache,
+                          CpuExecutableCache::Create({CreateCacheDir()}));
+
+  TF_ASSERT_OK_AND_ASSIGN(auto missing, cache->Lookup("foo"));
+  EXPECT_EQ(missing, std::nullopt);
+
+  TF_ASSERT_OK(cache->Insert("foo", "executable"));
+  EXPECT_THAT(cache->Lookup("foo"),
+              tsl::testing::IsOkAndHolds(Optional(std::string("executable"))));
+
+  CpuExecutableCache::Stats stats = cache->stats();
+  EXPECT_EQ(stats.hits, 1);
+  EXPECT_EQ(stats.misses, 1);
+  EXPECT_EQ(stats.insertions, 1);
+  EXPECT_EQ(stats.evictions, 0);
+}
+
+TEST(CpuExecutableCacheTest, SharedDirectory) {
+  std::string dir = CreateCacheDir();
+  TF_ASSERT_OK_AND_ASSIGN(auto writer, CpuExecutableCache::Create({dir}));
+  TF_ASSERT_OK_AND_ASSIGN(auto reader, CpuExecutableCache::Create({dir}));
+
+  TF_ASSERT_OK(writer->Insert("foo", "executable"));
+  EXPECT_THAT(reader->Lookup("foo"),
+              tsl::testing::IsOkAndHolds(Optional(std::string("executable"))));
+}
+
+TEST(CpuExecutableCacheTest, CorruptedEntry) {
+  std::string dir = CreateCacheDir();
+  TF_ASSERT_OK_AND_ASSIGN(auto cache, CpuExecutableCache::Create({dir}));
+  TF_ASSERT_OK(cache->Insert("foo", "executable"));
+
+  // Truncate the only entry in the cache directory.
+  std::vector<std::string> children;
+  TF_ASSERT_OK(tsl::Env::Default()->GetChildren(dir, &children));
+  ASSERT_EQ(children.size(), 1);
+  std::string path = tsl::io::JoinPath(dir, children[0]);
+  TF_ASSERT_OK(tsl::WriteStringToFile(tsl::Env::Default(), path, "XLA"));
+
+  TF_ASSERT_OK_AND_ASSIGN(auto corrupted, cache->Lookup("foo"));
+  EXPECT_EQ(corrupted, std::nullopt);
+  EXPECT_FALSE(tsl::Env::Default()->FileExists(path).ok());
+}
+
+TEST(CpuExecutableCacheTest, Eviction) {
+  std::string dir = CreateCacheDir();
+  std::string executable(1024, 'x');
+
+  // The cache fits only two executables (plus entry headers).
+  TF_ASSERT_OK_AND_ASSIGN(auto cache,
+                          CpuExecutableCache::Create({dir, 2 * 1024 + 100}));
+
+  for (int i = 0; i < 4; ++i) {
+    TF_ASSERT_OK(cache->Insert(absl::StrCat("key", i), executable));
+  }
+
+  std::vector<std::string> children;
+  TF_ASSERT_OK(tsl::Env::Default()->GetChildren(dir, &children));
+  EXPECT_EQ(children.size(), 2);
+  EXPECT_EQ(cache->stats().evictions, 2);
+
+  // The most recently inserted executable is never evicted.
+  EXPECT_THAT(cache->Lookup("key3"),
+              tsl::testing::IsOkAndHolds(Optional(executable)));
+}
+
+TEST(CpuExecutableCacheTest, Key) {
+  static constexpr char kAdd[] = R"(
+    HloModule add
+    ENTRY add {
+      x = f32[3] parameter(0)
+      ROOT add = f32[3] add(x, x)
+    })";
+
+  static constexpr char kMul[] = R"(
+    HloModule mul
+    ENTRY mul {
+      x = f32[3] parameter(0)
+      ROOT mul = f32[3] multiply(x, x)
+    })";
+
+  TF_ASSERT_OK_AND_ASSIGN(auto add, ParseAndReturnUnverifiedModule(kAdd));
+  TF_ASSERT_OK_AND_ASSIGN(auto mul, ParseAndReturnUnverifiedModule(kMul));
+
+  std::vector<std::string> avx = {"+avx"};
+  std::vector<std::string> avx512 = {"+avx", "+avx512f"};
+
+  EXPECT_EQ(CpuExecutableCache::Key(*add, avx),
+            CpuExecutableCache::Key(*add, avx));
+  EXPECT_NE(CpuExecutableCache::Key(*add, avx),
+            CpuExecutableCache::Key(*mul, avx));
+  EXPECT_NE(CpuExecutableCache::Key(*add, avx),
+            CpuExecutableCache::Key(*add, avx512));
+
+  // Debug options affect the compiled executable and must change the key.
+  std::string key = CpuExecutableCache::Key(*add, avx);
+  DebugOptions& debug_options = add->mutable_config().mutable_debug_options();
+  debug_options.set_xla_cpu_enable_fast_math(
+      !debug_options.xla_cpu_enable_fast_math());
+  EXPECT_NE(CpuExecutableCache::Key(*add, avx), key);
+}
+
+}  // namespace
+}  // namespace xla::cpu
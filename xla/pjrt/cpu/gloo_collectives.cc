@@ -24,6 +24,7 @@ limitations under the License.
 #include <optional>
 #include <string>
 #include <tuple>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -35,6 +36,7 @@ limitations under the License.
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
 #include "absl/types/span.h"
+#include "Eigen/Core"
 #include "gloo/algorithm.h"
 #include "gloo/allgather.h"
 #include "gloo/allreduce.h"
@@ -64,6 +66,78 @@ GlooCollectivesCommunicator::GlooCollectivesCommunicator(
     : context_(std::move(context)) {}
 GlooCollectivesCommunicator::~GlooCollectivesCommunicator() = default;
 
+using ReductionFn = void (*)(void*, const void*, const void*, size_t);
+
+// All-reduce of messages up to this size uses the bcube algorithm, which
+// finishes in log(N) communication steps and is latency optimal for small
+// messages. Larger messages use the bandwidth optimal ring algorithm.
+static constexpr size_t kMaxBcubeAllReduceBytes = 64 * 1024;
+
+// The ring algorithm splits every rank's chunk into segments of at most this
+// size and pipelines them, so that sending one segment overlaps with
+// receiving and reducing the next one.
+static constexpr size_t kMaxRingSegmentBytes = 256 * 1024;
+
+static gloo::AllreduceOptions::Algorithm GetAllReduceAlgorithm(
+    size_t num_bytes, size_t num_elements, int context_size) {
+  // Bcube groups ranks into a hypercube, which requires a power of two number
+  // of ranks, and every rank to own at least one element.
+  bool is_power_of_two = (context_size & (context_size - 1)) == 0;
+  if (num_bytes <= kMaxBcubeAllReduceBytes && is_power_of_two &&
+      num_elements >= static_cast<size_t>(context_size)) {
+    return gloo::AllreduceOptions::Algorithm::BCUBE;
+  }
+  return gloo::AllreduceOptions::Algorithm::RING;
+}
+
+// Eigen type with the same layout as the element type `T` used with gloo.
+template <typename T>
+using EigenType =
+    std::conditional_t<std::is_same_v<T, gloo::float16>, Eigen::half, T>;
+
+template <typename T>
+static constexpr bool kIsHalfPrecision =
+    std::is_same_v<T, gloo::float16> || std::is_same_v<T, bfloat16>;
+
+// Computes `c = a op b` for F16 and BF16 buffers with Eigen, which reduces
+// whole packets of half precision values at once, using native half precision
+// instructions where the target has them. Gloo's generic reductions convert
+// every element to float and back one at a time.
+template <typename T, ReductionKind reduction_kind>
+static void EigenReduce(void* c, const void* a, const void* b, size_t n) {
+  using E = EigenType<T>;
+  using Array = Eigen::Array<E, Eigen::Dynamic, 1>;
+
+  Eigen::Map<Array> out(static_cast<E*>(c), n);
+  Eigen::Map<const Array> lhs(static_cast<const E*>(a), n);
+  Eigen::Map<const Array> rhs(static_cast<const E*>(b), n);
+
+  if constexpr (reduction_kind == ReductionKind::SUM) {
+    out = lhs + rhs;
+  } else if constexpr (reduction_kind == ReductionKind::PRODUCT) {
+    out = lhs * rhs;
+  } else if constexpr (reduction_kind == ReductionKind::MIN) {
+    out = lhs.min(rhs);
+  } else if constexpr (reduction_kind == ReductionKind::MAX) {
+    out = lhs.max(rhs);
+  }
+}
+
+template <typename T, ReductionKind reduction_kind>
+static ReductionFn GetReductionFn() {
+  if constexpr (kIsHalfPrecision<T>) {
+    return &EigenReduce<T, reduction_kind>;
+  } else if constexpr (reduction_kind == ReductionKind::SUM) {
+    return static_cast<ReductionFn>(&gloo::sum<T>);
+  } else if constexpr (reduction_kind == ReductionKind::PRODUCT) {
+    return static_cast<ReductionFn>(&gloo::product<T>);
+  } else if constexpr (reduction_kind == ReductionKind::MIN) {
+    return static_cast<ReductionFn>(&gloo::min<T>);
+  } else {
+    return static_cast<ReductionFn>(&gloo::max<T>);
+  }
+}
+
 template <typename T>
 static absl::Status SetAllReduceOptions(ReductionKind reduction_kind,
                                         const void* input_buffer,
@@ -75,18 +149,16 @@ static absl::Status SetAllReduceOptions(ReductionKind reduction_kind,
   options.setOutput(reinterpret_cast<T*>(const_cast<void*>(output_buffer)),
                     num_elements);
 
-  using ReductionFn = void (*)(void*, const void*, const void*, size_t);
-
   switch (reduction_kind) {
     case ReductionKind::SUM:
-      options.setReduceFunction(static_cast<ReductionFn>(&gloo::sum<T>));
+      options.setReduceFunction(GetReductionFn<T, ReductionKind::SUM>());
       break;
     case ReductionKind::PRODUCT:
-      options.setReduceFunction(static_cast<ReductionFn>(&gloo::product<T>));
+      options.setReduceFunction(GetReductionFn<T, ReductionKind::PRODUCT>());
       break;
     case ReductionKind::MIN:
       if constexpr (!is_complex_v<T>) {
-        options.setReduceFunction(static_cast<ReductionFn>(&gloo::min<T>));
+        options.setReduceFunction(GetReductionFn<T, ReductionKind::MIN>());
       } else {
         return absl::InvalidArgumentError(
             "MIN reduction not supported for complex types");
@@ -94,7 +166,7 @@ static absl::Status SetAllReduceOptions(ReductionKind reduction_kind,
       break;
     case ReductionKind::MAX:
       if constexpr (!is_complex_v<T>) {
-        options.setReduceFunction(static_cast<ReductionFn>(&gloo::max<T>));
+        options.setReduceFunction(GetReductionFn<T, ReductionKind::MAX>());
       } else {
         return absl::InvalidArgumentError(
             "MAX reduction not supported for complex types");
@@ -172,7 +244,13 @@ absl::Status GlooCollectivesCommunicator::AllReduce(
     default:
       return absl::InvalidArgumentError("Unknown datatype in allreduce");
   }
-  options.setAlgorithm(gloo::AllreduceOptions::Algorithm::RING);
+  size_t num_bytes = num_elements * primitive_util::ByteWidth(element_type);
+  auto algorithm =
+      GetAllReduceAlgorithm(num_bytes, num_elements, context_->size);
+  options.setAlgorithm(algorithm);
+  if (algorithm == gloo::AllreduceOptions::Algorithm::RING) {
+    options.setMaxSegmentSize(kMaxRingSegmentBytes);
+  }
   options.setTimeout(absl::ToChronoMilliseconds(timeout));
 
   try {
@@ -22,9 +22,13 @@ limitations under the License.
 #include <memory>
 #include <vector>
 
+#include "absl/log/check.h"
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/synchronization/blocking_counter.h"
 #include "absl/time/time.h"
 #include "absl/types/span.h"
+#include "Eigen/Core"
 #if defined(__linux__)
 #include "gloo/transport/tcp/attr.h"
 #include "gloo/transport/tcp/device.h"
@@ -39,11 +43,13 @@ limitations under the License.
 #include "xla/service/cpu/collectives_interface.h"
 #include "xla/service/global_device_id.h"
 #include "xla/tsl/lib/core/status_test_util.h"
+#include "xla/types.h"
 #include "xla/xla_data.pb.h"
 #include "tsl/platform/env.h"
 #include "tsl/platform/errors.h"
 #include "tsl/platform/statusor.h"
 #include "tsl/platform/test.h"
+#include "tsl/platform/test_benchmark.h"
 #include "tsl/platform/threadpool.h"
 
 namespace xla::cpu {
@@ -70,7 +76,8 @@ absl::StatusOr<std::shared_ptr<CollectivesCommunicator>> GetCommunicator(
 }
 
 RendezvousKey MakeRendezvousKey(std::vector<GlobalDeviceId> global_devices) {
-  return RendezvousKey(RunId(0), global_devices, kNumParticipants,
+  int num_participants = global_devices.size();
+  return RendezvousKey(RunId(0), global_devices, num_participants,
                        RendezvousKey::CollectiveOpKind::kCrossModule,
                        /*op_id=*/0);
 }
@@ -132,5 +139,168 @@ TEST(GlooCollectives, AllReduce) {
                 Each(Eq(kNumParticipants * (kNumParticipants + 1) / 2)));
   }
 }
+
+// Creates communicators for `num_participants` ranks connected over loopback.
+absl::StatusOr<std::vector<std::shared_ptr<CollectivesCommunicator>>>
+CreateCommunicators(int num_participants,
+                    const std::vector<GlobalDeviceId>& global_devices) {
+  auto kv_store = std::make_shared<xla::InMemoryKeyValueStore>();
+  std::vector<absl::StatusOr<std::shared_ptr<CollectivesCommunicator>>>
+      communicators(num_participants);
+  {
+    tsl::thread::ThreadPool thread_pool(tsl::Env::Default(), "Communicators",
+                                        num_participants);
+    for (int rank = 0; rank < num_participants; ++rank) {
+      thread_pool.Schedule([&, rank] {
+        communicators[rank] =
+            GetCommunicator(num_participants, global_devices, kv_store, rank);
+      });
+    }
+  }
+
+  std::vector<std::shared_ptr<CollectivesCommunicator>> result;
+  for (auto& communicator : communicators) {
+    TF_RETURN_IF_ERROR(communicator.status());
+    result.push_back(*std::move(communicator));
+  }
+  return result;
+}
+
+// Runs an all-reduce with every participant in a separate thread of the
+// `thread_pool` and waits for all of them to finish.
+absl::Status AllReduce(
+    tsl::thread::ThreadPool& thread_pool,
+    absl::Span<const std::shared_ptr<CollectivesCommunicator>> communicators,
+    const std::vector<GlobalDeviceId>& global_devices,
+    PrimitiveType element_type, size_t num_elements,
+    absl::Span<const void* const> inputs, absl::Span<void* const> outputs) {
+  RendezvousKey rendezvous_key = MakeRendezvousKey(global_devices);
+  std::vector<absl::Status> statuses(communicators.size());
+  absl::BlockingCounter counter(communicators.size());
+
+  for (int rank = 0; rank < communicators.size(); ++rank) {
+    thread_pool.Schedule([&, rank] {
+      statuses[rank] = communicators[rank]->AllReduce(
+          rendezvous_key, xla::ReductionKind::SUM, element_type, num_elements,
+          inputs[rank], outputs[rank], kTimeout);
+      counter.DecrementCount();
+    });
+  }
+
+  counter.Wait();
+  for (const absl::Status& status : statuses) {
+    TF_RETURN_IF_ERROR(status);
+  }
+  return absl::OkStatus();
+}
+
+std::vector<GlobalDeviceId> MakeGlobalDevices(int num_participants) {
+  std::vector<GlobalDeviceId> global_devices;
+  for (int rank = 0; rank < num_participants; ++rank) {
+    global_devices.push_back(GlobalDeviceId(rank));
+  }
+  return global_devices;
+}
+
+template <typename T>
+void TestAllReduce(PrimitiveType element_type, int num_participants,
+                   size_t num_elements) {
+  std::vector<GlobalDeviceId> global_devices =
+      MakeGlobalDevices(num_participants);
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto communicators,
+      CreateCommunicators(num_participants, global_devices));
+
+  std::vector<std::vector<T>> inputs(num_participants);
+  std::vector<std::vector<T>> outputs(num_participants);
+  std::vector<const void*> input_ptrs;
+  std::vector<void*> output_ptrs;
+  for (int rank = 0; rank < num_participants; ++rank) {
+    inputs[rank].assign(num_elements, static_cast<T>(rank + 1));
+    outputs[rank].resize(num_elements);
+    input_ptrs.push_back(inputs[rank].data());
+    output_ptrs.push_back(outputs[rank].data());
+  }
+
+  tsl::thread::ThreadPool thread_pool(
+      tsl::Env::Default(), "AllReduceParticipants", num_participants);
+  TF_ASSERT_OK(AllReduce(thread_pool, communicators, global_devices,
+                         element_type, num_elements, input_ptrs, output_ptrs));
+
+  T expected = static_cast<T>(num_participants * (num_participants + 1) / 2);
+  for (int rank = 0; rank < num_participants; ++rank) {
+    EXPECT_THAT(outputs[rank], Each(Eq(expected)));
+  }
+}
+
+// Small messages use the bcube algorithm if the number of participants is a
+// power of two, and large messages use the pipelined ring algorithm.
+TEST(GlooCollectives, AllReduceF32) {
+  for (int num_participants : {2, 3, 4}) {
+    for (size_t num_elements : {8, 100, 1 << 20}) {
+      TestAllReduce<float>(F32, num_participants, num_elements);
+    }
+  }
+}
+
+TEST(GlooCollectives, AllReduceBF16) {
+  for (int num_participants : {2, 3}) {
+    for (size_t num_elements : {100, 1 << 20}) {
+      TestAllReduce<bfloat16>(BF16, num_participants, num_elements);
+    }
+  }
+}
+
+TEST(GlooCollectives, AllReduceF16) {
+  for (int num_participants : {2, 3}) {
+    for (size_t num_elements : {100, 1 << 20}) {
+      TestAllReduce<Eigen::half>(F16, num_participants, num_elements);
+    }
+  }
+}
+
+//===----------------------------------------------------------------------===//
+// Performance benchmarks below
+//===----------------------------------------------------------------------===//
+
+// Every participant has its own gloo context connected to all other
+// participants over loopback TCP, like separate processes on the same host.
+static void BM_GlooAllReduce(benchmark::State& state) {
+  int num_participants = state.range(0);
+  size_t num_elements = state.range(1);
+
+  std::vector<GlobalDeviceId> global_devices =
+      MakeGlobalDevices(num_participants);
+  auto communicators =
+      CreateCommunicators(num_participants, global_devices).value();
+
+  std::vector<std::vector<float>> inputs(num_participants,
+                                         std::vector<float>(num_elements, 1));
+  std::vector<std::vector<float>> outputs(num_participants,
+                                          std::vector<float>(num_elements));
+  std::vector<const void*> input_ptrs;
+  std::vector<void*> output_ptrs;
+  for (int rank = 0; rank < num_participants; ++rank) {
+    input_ptrs.push_back(inputs[rank].data());
+    output_ptrs.push_back(outputs[rank].data());
+  }
+
+  tsl::thread::ThreadPool thread_pool(
+      tsl::Env::Default(), "AllReduceParticipants", num_participants);
+  for (auto _ : state) {
+    CHECK_OK(AllReduce(thread_pool, communicators, global_devices, F32,
+                       num_elements, input_ptrs, output_ptrs));
+  }
+
+  state.SetBytesProcessed(state.iterations() * num_participants *
+                          num_elements * sizeof(float));
+}
+
+BENCHMARK(BM_GlooAllReduce)
+    ->MeasureProcessCPUTime()
+    ->UseRealTime()
+    ->ArgNames({"participants", "elements"})
+    ->ArgsProduct({{2, 4, 8}, {256, 16384, 262144, 4194304}});
+
 }  // namespace
 }  // namespace xla::cpu
@@ -38,7 +38,37 @@ namespace xla {
 
 class MaybeOwningCpuMemory {
  public:
-  using OwnedDataPtr = std::unique_ptr<uint8_t[], void (*)(void*)>;
+  // Deleter of owned memory. It is either a plain function like `free`, or a
+  // function that releases the memory to the `context` it was allocated from,
+  // e.g. a buffer pool, together with an `index` chosen by that context.
+  class Deleter {
+   public:
+    using ReleaseFn = void (*)(void* context, int64_t index, void* data);
+
+    Deleter() = default;
+    Deleter(void (*free)(void*)) : fn_(free) {}  // NOLINT
+    Deleter(ReleaseFn release, void* context, int64_t index)
+        : fn_(reinterpret_cast<void (*)(void*)>(release)),
+          context_(context),
+          index_(index) {}
+
+    void operator()(void* data) const {
+      if (context_ == nullptr) {
+        fn_(data);
+      } else {
+        reinterpret_cast<ReleaseFn>(fn_)(context_, index_, data);
+      }
+    }
+
+   private:
+    // Holds a `ReleaseFn` if `context_` is set. Converting a function pointer
+    // back to its original type is well defined.
+    void (*fn_)(void*) = nullptr;
+    void* context_ = nullptr;
+    int64_t index_ = 0;
+  };
+
+  using OwnedDataPtr = std::unique_ptr<uint8_t[], Deleter>;
 
   MaybeOwningCpuMemory() = default;
 
@@ -16,9 +16,11 @@ limitations under the License.
 #ifndef XLA_PJRT_PLUGIN_XLA_CPU_CPU_CLIENT_OPTIONS_H_
 #define XLA_PJRT_PLUGIN_XLA_CPU_CPU_CLIENT_OPTIONS_H_
 
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <optional>
+#include <string>
 
 #include "xla/service/cpu/collectives_interface.h"
 #include "xla/service/hlo_module_config.h"
@@ -50,6 +52,28 @@ struct CpuClientOptions {
   // If defined this function will be called on the HloModuleConfig before
   // compilation, and allows users to set custom flags.
   std::function<void(HloModuleConfig&)> customize_hlo_module_config;
+
+  // If not empty, compiled executables are persisted in this directory and
+  // reused by later compilations of the same module, including compilations
+  // in other processes that share the directory.
+  std::string executable_cache_dir;
+
+  // Upper bound on the total size of the executable cache. Least recently used
+  // executables are evicted when the cache grows above it. If not positive,
+  // the cache size is unbounded.
+  int64_t executable_cache_max_size_bytes = 0;
+
+  // Alignment in bytes that executables compiled by this client assume for
+  // their parameters (see `xla_cpu_parameter_alignment`, which takes
+  // precedence if set explicitly). If positive, host buffers aligned to this
+  // boundary are used without a copy by BufferFromHostBuffer with zero-copy
+  // semantics. If not positive, the default XLA:CPU alignment is used.
+  int64_t parameter_alignment = 0;
+
+  // If positive, every executable keeps up to this many bytes of released temp
+  // and output buffers and reuses them in later executions instead of calling
+  // the system allocator.
+  int64_t buffer_pool_max_bytes = 0;
 };
 
 }  // namespace xla
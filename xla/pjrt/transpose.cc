@@ -70,6 +70,7 @@ limitations under the License.
 #include "xla/pjrt/transpose.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cstdint>
 #include <cstdlib>
 #include <cstring>
@@ -87,13 +88,14 @@ limitations under the License.
 
 #include "absl/algorithm/container.h"
 #include "absl/base/optimization.h"
+#include "absl/base/thread_annotations.h"
 #include "absl/container/inlined_vector.h"
 #include "absl/functional/function_ref.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
-#include "absl/synchronization/blocking_counter.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/types/span.h"
 #include "absl/types/variant.h"
 #include "xla/ef57.h"
@@ -508,17 +510,41 @@ void TransposePlan::Execute(
       execute_by_type(nodes);
     }
   } else {
-    absl::BlockingCounter counter(nodes_.size() - 1);
+    // Chunks are claimed dynamically and the calling thread keeps claiming
+    // chunks until none are left, so it only ever waits for chunks that are
+    // already running on another thread. This avoids deadlocks if `Execute` is
+    // called from a thread that `schedule_work` dispatches to, e.g. when all
+    // threads of a pool are busy. Work items that start after all chunks were
+    // claimed return without touching `this` or the arrays, which may be gone
+    // by then.
+    struct ParallelState {
+      explicit ParallelState(size_t num_chunks)
+          : num_chunks(num_chunks), remaining(num_chunks) {}
+      const size_t num_chunks;
+      std::atomic<size_t> next_chunk = 0;
+      absl::Mutex mu;
+      size_t remaining ABSL_GUARDED_BY(mu);
+    };
+    auto state = std::make_shared<ParallelState>(nodes_.size());
+    auto run_chunks = [this, state, &execute_by_type]() {
+      size_t num_executed = 0;
+      for (size_t i = state->next_chunk.fetch_add(1); i < state->num_chunks;
+           i = state->next_chunk.fetch_add(1)) {
+        execute_by_type(nodes_[i]);
+        ++num_executed;
+      }
+      if (num_executed > 0) {
+        absl::MutexLock lock(&state->mu);
+        state->remaining -= num_executed;
+      }
+    };
     for (size_t i = 1; i < nodes_.size(); ++i) {
-      absl::Span<Node const> nodes = nodes_[i];
-      (*schedule_work)([&, nodes]() {
-        execute_by_type(nodes);
-        counter.DecrementCount();
-      });
+      (*schedule_work)(run_chunks);
     }
-    // Run the first chunk inline in this thread.
-    execute_by_type(nodes_[0]);
-    counter.Wait();
+    run_chunks();
+    absl::MutexLock lock(&state->mu);
+    state->mu.Await(absl::Condition(
+        +[](size_t* remaining) { return *remaining == 0; }, &state->remaining));
   }
 }
 
@@ -923,6 +949,7 @@ absl::StatusOr<std::unique_ptr<TransposePlan>> TransposePlan::Create(
 
   auto plan = std::make_unique<TransposePlan>();
   plan->num_threads_requested_ = o.num_threads;
+  plan->min_bytes_per_thread_ = o.min_bytes_per_thread;
   plan->elem_size_in_bytes_ = o.elem_size_in_bytes;
   switch (o.elem_size_in_bytes) {
     case 1:
@@ -1273,9 +1300,12 @@ std::vector<int> TransposePlan::ChooseParallelizationStrategy(
     const Loop& loop = loop_order_[i];
     CHECK_GE(available_parallelism, 1);
     int64_t iterations = loop_iterations(loop);
-    int kMinBytesPerThread = inner_kernel_is_memcpy_ ? (1 << 20) : (1 << 26);
+    int64_t min_bytes_per_thread = min_bytes_per_thread_;
+    if (min_bytes_per_thread <= 0) {
+      min_bytes_per_thread = inner_kernel_is_memcpy_ ? (1 << 20) : (1 << 26);
+    }
     int64_t min_iterations_per_thread =
-        CeilOfRatio<int64_t>(kMinBytesPerThread, work_in_bytes[i]);
+        CeilOfRatio<int64_t>(min_bytes_per_thread, work_in_bytes[i]);
     int64_t parallel_work = CeilOfRatio(iterations, min_iterations_per_thread);
 
     VLOG(8) << "iterations=" << iterations << " parallel_work=" << parallel_work
@@ -1348,15 +1378,16 @@ bool TransposePlanCacheKey::operator==(
          input_layout == other.input_layout &&
          output_tiling == other.output_tiling &&
          transformation == other.transformation &&
-         num_threads == other.num_threads;
+         num_threads == other.num_threads &&
+         min_bytes_per_thread == other.min_bytes_per_thread;
 }
 
 template <typename H>
 H AbslHashValue(H h, const TransposePlanCacheKey& key) {
   return H::combine(std::move(h), key.elem_size_in_bytes,
                     key.input_layout_is_tiling, key.num_threads,
-                    key.transformation, key.dims, key.permutation,
-                    key.input_layout, key.output_tiling);
+                    key.min_bytes_per_thread, key.transformation, key.dims,
+                    key.permutation, key.input_layout, key.output_tiling);
 }
 
 TransposePlanCache::TransposePlanCache(int capacity)
@@ -1389,6 +1420,7 @@ absl::StatusOr<std::shared_ptr<TransposePlan>> TransposePlanCache::GetOrCreate(
   absl::c_copy(o.output_tiling.tiling, key.output_tiling.begin());
   key.transformation = o.transformation;
   key.num_threads = o.num_threads;
+  key.min_bytes_per_thread = o.min_bytes_per_thread;
   return cache_.GetOrCreateIfAbsent(
       key,
       [&](const TransposePlanCacheKey& key)
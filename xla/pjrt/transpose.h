@@ -75,6 +75,10 @@ class TransposePlan {
   //
   // num_threads: is the number of threads requested. The actual number of
   //   threads used may be smaller if there isn't enough work per thread.
+  //
+  // min_bytes_per_thread: is the minimum number of bytes each thread should
+  //   process. If zero, a default tuned for the inner kernel of the plan is
+  //   used. Smaller values split smaller transposes across threads.
   struct Tiling {
     absl::Span<int64_t const> tiling;
   };
@@ -98,6 +102,7 @@ class TransposePlan {
     Tiling output_tiling;
     Transformation transformation = Transformation::kNone;
     int num_threads = 1;
+    int64_t min_bytes_per_thread = 0;
   };
 
   static absl::StatusOr<std::unique_ptr<TransposePlan>> Create(
@@ -174,6 +179,7 @@ class TransposePlan {
 
   // Number of threads requested.
   int num_threads_requested_ = 1;
+  int64_t min_bytes_per_thread_ = 0;
 
   // Size of each element in bytes.
   int64_t elem_size_in_bytes_;
@@ -262,6 +268,7 @@ struct TransposePlanCacheKey {
   absl::InlinedVector<int64_t, 4> output_tiling;
   TransposePlan::Transformation transformation;
   int num_threads;
+  int64_t min_bytes_per_thread;
 
   bool operator==(const TransposePlanCacheKey& other) const;
 };
@@ -365,7 +365,7 @@ std::vector<TransposeTestCase> GetTransposeTestCases() {
 class TransposeTest : public ::testing::TestWithParam<TransposeTestCase> {
  protected:
   template <typename T>
-  void TestTranspose(int parallelism) {
+  void TestTranspose(int parallelism, int64_t min_bytes_per_thread = 0) {
     const TransposeTestCase test = GetParam();
     tsl::thread::ThreadPool threadpool(tsl::Env::Default(), "Transpose",
                                        parallelism);
@@ -378,6 +378,7 @@ class TransposeTest : public ::testing::TestWithParam<TransposeTestCase> {
     options.output_tiling = TransposePlan::Tiling{test.output_tiling};
     options.transformation = TransposePlan::Transformation::kNone;
     options.num_threads = parallelism;
+    options.min_bytes_per_thread = min_bytes_per_thread;
     TF_ASSERT_OK_AND_ASSIGN(auto plan, TransposePlan::Create(options));
     VLOG(1) << plan->ToString();
     xla::Array<T> untiled_input(test.dims);
@@ -408,6 +409,9 @@ TEST_P(TransposeTest, TransposeInt128) { TestTranspose<absl::int128>(1); }
 
 TEST_P(TransposeTest, ParallelTransposeInt8) { TestTranspose<int8_t>(16); }
 TEST_P(TransposeTest, ParallelTransposeInt32) { TestTranspose<int32_t>(16); }
+TEST_P(TransposeTest, FineGrainedParallelTransposeInt32) {
+  TestTranspose<int32_t>(16, /*min_bytes_per_thread=*/64);
+}
 
 INSTANTIATE_TEST_SUITE_P(TransposeTestInstance, TransposeTest,
                          ::testing::ValuesIn(GetTransposeTestCases()));
@@ -491,6 +495,28 @@ static std::vector<TransposeTestCase> BenchmarkCases() {
                         /*permutation=*/{1, 2, 3, 0}),
       TransposeTestCase(/*dims=*/{256, 64, 64, 3},
                         /*permutation=*/{1, 3, 2, 0}),
+      // NHWC -> NCHW and NCHW -> NHWC.
+      TransposeTestCase(/*dims=*/{8, 224, 224, 3},
+                        /*permutation=*/{0, 3, 1, 2}),
+      TransposeTestCase(/*dims=*/{8, 3, 224, 224},
+                        /*permutation=*/{0, 2, 3, 1}),
+      TransposeTestCase(/*dims=*/{32, 56, 56, 64},
+                        /*permutation=*/{0, 3, 1, 2}),
+      TransposeTestCase(/*dims=*/{32, 64, 56, 56},
+                        /*permutation=*/{0, 2, 3, 1}),
+      // Tiled layouts.
+      TransposeTestCase(/*dims=*/{1024, 1024},
+                        /*permutation=*/{1, 0},
+                        /*input_tiling=*/{},
+                        /*output_tiling=*/{8, 128}),
+      TransposeTestCase(/*dims=*/{1024, 1024},
+                        /*permutation=*/{1, 0},
+                        /*input_tiling=*/{8, 128},
+                        /*output_tiling=*/{}),
+      TransposeTestCase(/*dims=*/{32, 64, 56, 56},
+                        /*permutation=*/{0, 2, 3, 1},
+                        /*input_tiling=*/{},
+                        /*output_tiling=*/{8, 128}),
   };
 }
 
@@ -498,6 +524,10 @@ template <typename T>
 void BM_Eigen(const TransposeTestCase& bm, int parallelism,
               ::testing::benchmark::State& state) {
   CHECK_EQ(parallelism, 1);
+  if (!bm.input_tiling.empty() || !bm.output_tiling.empty()) {
+    state.SkipWithError("Eigen doesn't support tiled layouts");
+    return;
+  }
   Array<T> input(bm.dims);
   input.FillIota(0);
   std::vector<int64_t> output_dims = Permute(bm.dims, bm.permutation);
@@ -519,20 +549,23 @@ static void BM_Eigen_float(const TransposeTestCase& bm, int parallelism,
 
 template <typename T>
 void BM_Transpose(const TransposeTestCase& bm, int parallelism,
+                  int64_t min_bytes_per_thread,
                   ::testing::benchmark::State& state) {
   TransposePlan::Options options;
   options.elem_size_in_bytes = sizeof(T);
   options.dims = bm.dims;
   options.permutation = bm.permutation;
-  options.input_layout = TransposePlan::Tiling{};
-  options.output_tiling = TransposePlan::Tiling{};
+  options.input_layout = TransposePlan::Tiling{bm.input_tiling};
+  options.output_tiling = TransposePlan::Tiling{bm.output_tiling};
   options.transformation = TransposePlan::Transformation::kNone;
   options.num_threads = parallelism;
+  options.min_bytes_per_thread = min_bytes_per_thread;
   TF_ASSERT_OK_AND_ASSIGN(auto plan, TransposePlan::Create(options));
-  Array<T> input(bm.dims);
-  input.FillIota(0);
-  std::vector<int64_t> output_dims = Permute(bm.dims, bm.permutation);
-  Array<T> output(output_dims);
+  std::vector<T> input(SizeOfTiledArray(bm.dims, bm.input_tiling));
+  absl::c_iota(input, T{0});
+  std::vector<T> output(
+      SizeOfTiledArray(plan->OutputDims(), bm.output_tiling));
+  state.counters["threads_used"] = plan->Parallelism();
   tsl::thread::ThreadPool threadpool(tsl::Env::Default(), "Transpose",
                                      parallelism);
   for (auto s : state) {
@@ -544,11 +577,19 @@ void BM_Transpose(const TransposeTestCase& bm, int parallelism,
 }
 static void BM_Transpose_uint8(const TransposeTestCase& bm, int parallelism,
                                ::testing::benchmark::State& state) {
-  BM_Transpose<uint8_t>(bm, parallelism, state);
+  BM_Transpose<uint8_t>(bm, parallelism, /*min_bytes_per_thread=*/0, state);
 }
 static void BM_Transpose_float(const TransposeTestCase& bm, int parallelism,
                                ::testing::benchmark::State& state) {
-  BM_Transpose<float>(bm, parallelism, state);
+  BM_Transpose<float>(bm, parallelism, /*min_bytes_per_thread=*/0, state);
+}
+// Splits the transpose into chunks of at least 256 KiB, which is what the PJRT
+// CPU client uses for host buffer transposes.
+static void BM_FineGrainedTranspose_float(const TransposeTestCase& bm,
+                                          int parallelism,
+                                          ::testing::benchmark::State& state) {
+  BM_Transpose<float>(bm, parallelism, /*min_bytes_per_thread=*/256 << 10,
+                      state);
 }
 
 static void* benchmarks = []() {
@@ -560,6 +601,9 @@ static void* benchmarks = []() {
           {"BM_Transpose_uint8", BM_Transpose_uint8, {1, 4, 8}},  //
           {"BM_Eigen_float", BM_Eigen_float, {1}},
           {"BM_Transpose_float", BM_Transpose_float, {1, 4, 8}},  //
+          {"BM_FineGrainedTranspose_float",
+           BM_FineGrainedTranspose_float,
+           {4, 8}},  //
   };
   auto benchmark_cases = BenchmarkCases();
   for (const auto& benchmark_case : benchmark_cases) {
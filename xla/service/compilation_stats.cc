@@ -15,21 +15,75 @@ limitations under the License.
 
 #include "xla/service/compilation_stats.h"
 
+#if defined(__linux__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+#include <cstdint>
 #include <iostream>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
+#include "absl/strings/str_join.h"
 #include "xla/types.h"
 #include "tsl/platform/env.h"
 
 namespace xla {
+namespace {
+
+// Returns `raw` as a quoted JSON string. Unlike absl::CEscape this escapes
+// control characters as \uXXXX and leaves bytes >= 0x80 alone, so UTF-8 pass
+// names stay valid JSON.
+std::string JsonQuote(absl::string_view raw) {
+  std::string quoted = "\"";
+  for (char c : raw) {
+    switch (c) {
+      case '"':
+        quoted += "\\\"";
+        break;
+      case '\\':
+        quoted += "\\\\";
+        break;
+      case '\b':
+        quoted += "\\b";
+        break;
+      case '\f':
+        quoted += "\\f";
+        break;
+      case '\n':
+        quoted += "\\n";
+        break;
+      case '\r':
+        quoted += "\\r";
+        break;
+      case '\t':
+        quoted += "\\t";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          absl::StrAppendFormat(&quoted, "\\u%04x",
+                                static_cast<unsigned char>(c));
+        } else {
+          quoted += c;
+        }
+    }
+  }
+  quoted += "\"";
+  return quoted;
+}
+
+}  // namespace
 
 class NoopStats : public CompilationStats {
  public:
   NoopStats() = default;
 
+  bool IsEnabled() const override { return false; }
+
   void StartPass(absl::string_view pass_name) override {}
 
   void EndPass(absl::string_view pass_name) override {}
@@ -40,12 +94,26 @@ class NoopStats : public CompilationStats {
 
   void RecordPassError(absl::string_view pass_name,
                        absl::string_view err) override{};
+
+  void RecordPassParallelism(absl::string_view pass_name,
+                             int64_t num_computations,
+                             double computations_duration_ms) override {}
+
+  void RecordPassInstructionCounts(absl::string_view pass_name,
+                                   int64_t instruction_count_before,
+                                   int64_t instruction_count_after) override {}
+
+  std::vector<PassRecord> GetPassRecords() override { return {}; }
+
+  std::string CompilationReportJson() override { return "[]"; }
 };
 
 class Stats : public CompilationStats {
  public:
   Stats() = default;
 
+  bool IsEnabled() const override { return true; }
+
   void StartPass(absl::string_view pass_name) override;
 
   void EndPass(absl::string_view pass_name) override;
@@ -57,6 +125,18 @@ class Stats : public CompilationStats {
   void RecordPassError(absl::string_view pass_name,
                        absl::string_view err) override{};
 
+  void RecordPassParallelism(absl::string_view pass_name,
+                             int64_t num_computations,
+                             double computations_duration_ms) override;
+
+  void RecordPassInstructionCounts(absl::string_view pass_name,
+                                   int64_t instruction_count_before,
+                                   int64_t instruction_count_after) override;
+
+  std::vector<PassRecord> GetPassRecords() override;
+
+  std::string CompilationReportJson() override;
+
  private:
   struct PassInfo {
     PassInfo(absl::string_view name, double duration)
@@ -65,6 +145,14 @@ class Stats : public CompilationStats {
     std::string name;
     int num_runs = 1;
     double duration_ms;
+    // Wall time of the runs that processed computations concurrently, and the
+    // time spent on the computations in those runs summed over all threads.
+    double parallel_duration_ms = 0;
+    double computations_duration_ms = 0;
+    // Profile of a single run, see PassRecord. Not aggregated in the summary.
+    int64_t instruction_count_before = -1;
+    int64_t instruction_count_after = -1;
+    int64_t peak_rss_bytes = 0;
   };
 
   // Info about the passes that have been run so far.
@@ -74,6 +162,13 @@ class Stats : public CompilationStats {
   std::string current_pass_;
   // The start time of the currently running pass.
   uint64_t start_micros_;
+  // Computation time recorded by RecordPassParallelism for the currently
+  // running pass, if any.
+  double current_computations_duration_ms_ = 0;
+  // Instruction counts recorded by RecordPassInstructionCounts for the
+  // currently running pass, if any.
+  int64_t current_instruction_count_before_ = -1;
+  int64_t current_instruction_count_after_ = -1;
 };
 
 /* static */
@@ -86,11 +181,29 @@ std::unique_ptr<CompilationStats> CompilationStats::MakeStats() {
   return std::make_unique<Stats>();
 }
 
+/* static */
+int64_t CompilationStats::PeakRssBytes() {
+#if defined(__linux__) || defined(__APPLE__)
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+#if defined(__APPLE__)
+  return usage.ru_maxrss;  // In bytes on macOS.
+#else
+  return int64_t{usage.ru_maxrss} * 1024;  // In kilobytes on Linux.
+#endif
+#else
+  return 0;
+#endif
+}
+
 void Stats::StartPass(absl::string_view pass_name) {
   CHECK(!pass_running_) << "Can't start " << pass_name << " while running "
                         << current_pass_;
   pass_running_ = true;
   current_pass_ = std::string(pass_name);
+  current_computations_duration_ms_ = 0;
+  current_instruction_count_before_ = -1;
+  current_instruction_count_after_ = -1;
   start_micros_ = tsl::Env::Default()->NowMicros();
 }
 
@@ -101,6 +214,62 @@ void Stats::EndPass(absl::string_view pass_name) {
   uint64_t end_micros = tsl::Env::Default()->NowMicros();
   double duration_ms = (end_micros - start_micros_) / 1000.0;
   passes_.push_back(PassInfo(current_pass_, duration_ms));
+  passes_.back().instruction_count_before = current_instruction_count_before_;
+  passes_.back().instruction_count_after = current_instruction_count_after_;
+  passes_.back().peak_rss_bytes = PeakRssBytes();
+  if (current_computations_duration_ms_ > 0) {
+    passes_.back().parallel_duration_ms = duration_ms;
+    passes_.back().computations_duration_ms =
+        current_computations_duration_ms_;
+  }
+}
+
+void Stats::RecordPassParallelism(absl::string_view pass_name,
+                                  int64_t num_computations,
+                                  double computations_duration_ms) {
+  CHECK(pass_running_);
+  CHECK_EQ(current_pass_, std::string(pass_name));
+  current_computations_duration_ms_ += computations_duration_ms;
+}
+
+void Stats::RecordPassInstructionCounts(absl::string_view pass_name,
+                                        int64_t instruction_count_before,
+                                        int64_t instruction_count_after) {
+  CHECK(pass_running_);
+  CHECK_EQ(current_pass_, std::string(pass_name));
+  current_instruction_count_before_ = instruction_count_before;
+  current_instruction_count_after_ = instruction_count_after;
+}
+
+std::vector<CompilationStats::PassRecord> Stats::GetPassRecords() {
+  std::vector<PassRecord> records;
+  records.reserve(passes_.size());
+  for (const PassInfo& pass_run : passes_) {
+    records.push_back({pass_run.name, pass_run.duration_ms,
+                       pass_run.instruction_count_before,
+                       pass_run.instruction_count_after,
+                       pass_run.peak_rss_bytes});
+  }
+  return records;
+}
+
+std::string Stats::CompilationReportJson() {
+  CHECK(!pass_running_) << "EndPass never called for " << current_pass_;
+  return absl::StrCat(
+      "[",
+      absl::StrJoin(
+          GetPassRecords(), ",\n",
+          [](std::string* out, const PassRecord& record) {
+            absl::StrAppendFormat(
+                out,
+                "{\"pass_name\": %s, \"duration_ms\": %.3f, "
+                "\"instruction_count_before\": %d, "
+                "\"instruction_count_after\": %d, \"peak_rss_bytes\": %d}",
+                JsonQuote(record.pass_name), record.duration_ms,
+                record.instruction_count_before,
+                record.instruction_count_after, record.peak_rss_bytes);
+          }),
+      "]");
 }
 
 void Stats::CompilationReport() {
@@ -117,6 +286,10 @@ void Stats::CompilationReport() {
     } else {
       ++summary.at(pass_name).num_runs;
       summary.at(pass_name).duration_ms += pass_run.duration_ms;
+      summary.at(pass_name).parallel_duration_ms +=
+          pass_run.parallel_duration_ms;
+      summary.at(pass_name).computations_duration_ms +=
+          pass_run.computations_duration_ms;
     }
   }
 
@@ -136,6 +309,15 @@ void Stats::CompilationReport() {
     LOG(INFO) << pass_info.name << ", " << pass_info.num_runs << ", "
               << pass_info.duration_ms;
   }
+
+  // Passes that ran on computations concurrently, with the speedup over the
+  // (estimated) sequential time of the runs in which they did so.
+  for (auto& pass_info : sorted_summary) {
+    if (pass_info.parallel_duration_ms <= 0) continue;
+    LOG(INFO) << "Parallel speedup of " << pass_info.name << ": "
+              << pass_info.computations_duration_ms /
+                     pass_info.parallel_duration_ms;
+  }
 }
 
 int Stats::GetPassesSize() { return passes_.size(); }
@@ -16,8 +16,10 @@ limitations under the License.
 #ifndef XLA_SERVICE_COMPILATION_STATS_H_
 #define XLA_SERVICE_COMPILATION_STATS_H_
 
+#include <cstdint>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "absl/strings/str_format.h"
 #include "absl/strings/string_view.h"
@@ -26,17 +28,33 @@ namespace xla {
 
 // This class is used to collect information about HLO passes and print some
 // statistics at the end of compilation. From HloPassPipeline, we call StartPass
-// before the execution of a pass, and EndPass after. Currently, we only collect
-// timing information and how many times each pass was run. In the future, we
-// can add more things, such as the size of the HLO graph after each pass.
+// before the execution of a pass, and EndPass after. For every run of a pass we
+// collect its wall time, the number of instructions before and after the pass
+// and the peak resident set size of the process when the pass finished.
 class CompilationStats {
  public:
+  // Profile of a single run of a pass. Fixed point iterations of a pass
+  // pipeline show up as separate runs of the passes in the pipeline.
+  struct PassRecord {
+    std::string pass_name;
+    double duration_ms = 0;
+    // -1 if the pipeline did not record instruction counts for the pass.
+    int64_t instruction_count_before = -1;
+    int64_t instruction_count_after = -1;
+    // 0 if not available on the platform.
+    int64_t peak_rss_bytes = 0;
+  };
+
   virtual ~CompilationStats() = default;
 
   static std::unique_ptr<CompilationStats> MakeNoopStats();
 
   static std::unique_ptr<CompilationStats> MakeStats();
 
+  // Returns false if the stats drop everything recorded into them, so that
+  // callers can skip collecting it.
+  virtual bool IsEnabled() const = 0;
+
   virtual void StartPass(absl::string_view pass_name) = 0;
 
   virtual void EndPass(absl::string_view pass_name) = 0;
@@ -47,6 +65,32 @@ class CompilationStats {
 
   virtual void RecordPassError(absl::string_view pass_name,
                                absl::string_view err) = 0;
+
+  // Records that the currently running pass processed `num_computations`
+  // computations concurrently, which took `computations_duration_ms` summed
+  // over all computations. Together with the duration of the pass this gives
+  // the speedup from running the pass in parallel.
+  virtual void RecordPassParallelism(absl::string_view pass_name,
+                                     int64_t num_computations,
+                                     double computations_duration_ms) = 0;
+
+  // Records the number of instructions in the module(s) before and after the
+  // currently running pass.
+  virtual void RecordPassInstructionCounts(absl::string_view pass_name,
+                                           int64_t instruction_count_before,
+                                           int64_t instruction_count_after) = 0;
+
+  // Returns the records of all passes that finished so far, in the order in
+  // which they ran.
+  virtual std::vector<PassRecord> GetPassRecords() = 0;
+
+  // Returns the pass records as a JSON array with one object per record, so
+  // that compile time and memory can be tracked by tools.
+  virtual std::string CompilationReportJson() = 0;
+
+  // Returns the peak resident set size of the process in bytes, or 0 if it is
+  // not available on the platform.
+  static int64_t PeakRssBytes();
 };
 
 }  // namespace xla
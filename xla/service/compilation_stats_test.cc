@@ -0,0 +1,48 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/service/compilation_stats.h"
+
+#include <memory>
+#include <string>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+namespace xla {
+namespace {
+
+using ::testing::HasSubstr;
+
+TEST(CompilationStatsTest, ReportJsonEscapesPassNames) {
+  std::unique_ptr<CompilationStats> stats = CompilationStats::MakeStats();
+  const std::string pass_name = "a\"b\\c\nd\x01";
+  stats->StartPass(pass_name);
+  stats->EndPass(pass_name);
+
+  std::string json = stats->CompilationReportJson();
+  EXPECT_THAT(json, HasSubstr(R"("pass_name": "a\"b\\c\nd\u0001")"));
+  EXPECT_THAT(json, HasSubstr(R"("instruction_count_before": -1)"));
+}
+
+TEST(CompilationStatsTest, NoopStatsReportIsEmptyArray) {
+  std::unique_ptr<CompilationStats> stats = CompilationStats::MakeNoopStats();
+  stats->StartPass("pass");
+  stats->EndPass("pass");
+  EXPECT_EQ(stats->CompilationReportJson(), "[]");
+}
+
+}  // namespace
+}  // namespace xla
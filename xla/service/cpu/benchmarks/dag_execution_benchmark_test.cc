@@ -15,22 +15,34 @@ limitations under the License.
 
 #include <cstdint>
 #include <random>
+#include <string>
 #include <string_view>
 #include <vector>
 
 #include "absl/strings/str_cat.h"
+#include "absl/strings/str_replace.h"
 #include "absl/types/span.h"
 #include "xla/literal.h"
 #include "xla/literal_util.h"
 #include "xla/service/cpu/benchmarks/hlo_benchmark_runner.h"
 #include "xla/shape_util.h"
+#include "xla/xla.pb.h"
 #include "xla/xla_data.pb.h"
 #include "tsl/platform/logging.h"
 #include "tsl/platform/test_benchmark.h"
 
 namespace xla::cpu {
 
-static void BM_DagExecution(benchmark::State& state) {
+using ReadyQueue = DebugOptions::CpuThunkExecutorReadyQueue;
+
+static constexpr ReadyQueue kFifo =
+    DebugOptions::CPU_THUNK_EXECUTOR_READY_QUEUE_FIFO;
+static constexpr ReadyQueue kPriority =
+    DebugOptions::CPU_THUNK_EXECUTOR_READY_QUEUE_PRIORITY;
+static constexpr ReadyQueue kWorkStealing =
+    DebugOptions::CPU_THUNK_EXECUTOR_READY_QUEUE_WORK_STEALING;
+
+static void BM_DagExecution(benchmark::State& state, ReadyQueue ready_queue) {
   int64_t d0 = state.range(0);
 
   // We use this benchmark to test how well XLA does the scheduling of the HLO
@@ -87,17 +99,94 @@ static void BM_DagExecution(benchmark::State& state) {
   auto shape = ShapeUtil::MakeShape(F32, {1, 2, 1, d0, 256});
   auto p0 = *LiteralUtil::CreateRandomLiteral<F32>(shape, &engine, 1.0f, 0.1f);
 
+  HloBenchmarkOptions benchmark_options;
+  benchmark_options.thunk_executor_ready_queue = ready_queue;
+
+  std::vector<const Literal*> args = {&p0};
+  CHECK_OK(RunHloBenchmark(state, hlo, args, {{"$d0", absl::StrCat(d0)}},
+                           benchmark_options));
+}
+
+static void BM_WideDagExecution(benchmark::State& state,
+                                ReadyQueue ready_queue) {
+  int64_t width = state.range(0);
+  int64_t d0 = state.range(1);
+
+  // We use this benchmark to test how well ThunkExecutor handles wide DAGs with
+  // many small independent kernels, where scheduling overheads dominate the
+  // execution time. Every branch ends with a reduction that becomes a separate
+  // kernel, and all branches are combined together with a chain of small adds.
+  std::string hlo = R"(
+    HloModule wide_dag_$width_$d0
+
+    add {
+      p0 = f32[] parameter(0)
+      p1 = f32[] parameter(1)
+      ROOT add = f32[] add(p0, p1)
+    }
+
+    ENTRY e {
+      p0 = f32[$d0,256] parameter(0)
+      c0 = f32[] constant(0)
+  )";
+
+  for (int64_t i = 0; i < width; ++i) {
+    absl::StrAppend(&hlo, absl::StrReplaceAll(R"(
+      k$i = f32[] constant($i)
+      bcast$i = f32[$d0,256] broadcast(k$i), dimensions={}
+      mul$i = f32[$d0,256] multiply(p0, bcast$i)
+      r$i = f32[$d0] reduce(mul$i, c0), dimensions={1}, to_apply=add
+    )", {{"$i", absl::StrCat(i)}}));
+  }
+
+  absl::StrAppend(&hlo, "  out0 = f32[$d0] add(r0, r0)\n");
+  for (int64_t i = 1; i < width; ++i) {
+    absl::StrAppend(&hlo, "  out", i, " = f32[$d0] add(out", i - 1, ", r", i,
+                    ")\n");
+  }
+  absl::StrAppend(&hlo, "  ROOT out = f32[$d0] copy(out", width - 1, ")\n}");
+
+  std::minstd_rand0 engine;
+
+  auto shape = ShapeUtil::MakeShape(F32, {d0, 256});
+  auto p0 = *LiteralUtil::CreateRandomLiteral<F32>(shape, &engine, 1.0f, 0.1f);
+
+  HloBenchmarkOptions benchmark_options;
+  benchmark_options.thunk_executor_ready_queue = ready_queue;
+
   std::vector<const Literal*> args = {&p0};
-  CHECK_OK(RunHloBenchmark(state, hlo, args, {{"$d0", absl::StrCat(d0)}}));
+  CHECK_OK(RunHloBenchmark(
+      state, hlo, args,
+      {{"$width", absl::StrCat(width)}, {"$d0", absl::StrCat(d0)}},
+      benchmark_options));
 }
 
-BENCHMARK(BM_DagExecution)
-    ->MeasureProcessCPUTime()
-    ->Arg(128)
-    ->Arg(256)
-    ->Arg(512)
-    ->Arg(1024)
-    ->Arg(8192)
-    ->Arg(16384);
+#define BENCHMARK_DAG_EXECUTION(name, ready_queue)      \
+  BENCHMARK_CAPTURE(BM_DagExecution, name, ready_queue) \
+      ->MeasureProcessCPUTime()                         \
+      ->Arg(128)                                        \
+      ->Arg(256)                                        \
+      ->Arg(512)                                        \
+      ->Arg(1024)                                       \
+      ->Arg(8192)                                       \
+      ->Arg(16384)
+
+BENCHMARK_DAG_EXECUTION(fifo, kFifo);
+BENCHMARK_DAG_EXECUTION(priority, kPriority);
+BENCHMARK_DAG_EXECUTION(work_stealing, kWorkStealing);
+
+#define BENCHMARK_WIDE_DAG_EXECUTION(name, ready_queue)     \
+  BENCHMARK_CAPTURE(BM_WideDagExecution, name, ready_queue) \
+      ->MeasureProcessCPUTime()                             \
+      ->ArgNames({"width", "d0"})                           \
+      ->Args({32, 16})                                      \
+      ->Args({128, 16})                                     \
+      ->Args({256, 16})                                     \
+      ->Args({128, 256})                                    \
+      ->Args({256, 256})
+
+BENCHMARK_WIDE_DAG_EXECUTION(fifo, kFifo);
+BENCHMARK_WIDE_DAG_EXECUTION(priority, kPriority);
+BENCHMARK_WIDE_DAG_EXECUTION(work_stealing, kWorkStealing);
 
 }  // namespace xla::cpu
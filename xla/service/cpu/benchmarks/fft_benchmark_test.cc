@@ -0,0 +1,99 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <cstdint>
+#include <random>
+#include <string_view>
+
+#include "absl/log/check.h"
+#include "absl/strings/str_cat.h"
+#include "xla/literal.h"
+#include "xla/literal_util.h"
+#include "xla/service/cpu/benchmarks/hlo_benchmark_runner.h"
+#include "xla/shape_util.h"
+#include "xla/xla_data.pb.h"
+#include "tsl/platform/test_benchmark.h"
+
+namespace xla::cpu {
+
+static void BM_Fft_C64(benchmark::State& state) {
+  int64_t batch = state.range(0);
+  int64_t length = state.range(1);
+
+  std::string_view hlo = R"(
+    HloModule fft_c64
+
+    ENTRY test {
+      x = c64[$batch,$length] parameter(0)
+      ROOT fft = c64[$batch,$length] fft(x), fft_type=FFT, fft_length={$length}
+    }
+  )";
+
+  // Fixed seed to avoid too inconsistent runs
+  std::minstd_rand0 engine(/*seed=*/0xCAFEFEED);
+  auto x = LiteralUtil::CreateRandomLiteral<F32>(
+               ShapeUtil::MakeShape(F32, {batch, length}), &engine, 1.0f, 0.1f)
+               ->Convert(C64)
+               .value();
+
+  CHECK_OK(RunHloBenchmark(
+      state, hlo, {&x},
+      {{"$batch", absl::StrCat(batch)}, {"$length", absl::StrCat(length)}}));
+}
+
+static void BM_Rfft_F32(benchmark::State& state) {
+  int64_t batch = state.range(0);
+  int64_t length = state.range(1);
+
+  std::string_view hlo = R"(
+    HloModule rfft_f32
+
+    ENTRY test {
+      x = f32[$batch,$length] parameter(0)
+      ROOT fft = c64[$batch,$out_length] fft(x), fft_type=RFFT,
+                 fft_length={$length}
+    }
+  )";
+
+  // Fixed seed to avoid too inconsistent runs
+  std::minstd_rand0 engine(/*seed=*/0xCAFEFEED);
+  auto x = LiteralUtil::CreateRandomLiteral<F32>(
+               ShapeUtil::MakeShape(F32, {batch, length}), &engine, 1.0f, 0.1f)
+               .value();
+
+  CHECK_OK(RunHloBenchmark(state, hlo, {&x},
+                           {{"$batch", absl::StrCat(batch)},
+                            {"$length", absl::StrCat(length)},
+                            {"$out_length", absl::StrCat(length / 2 + 1)}}));
+}
+
+// Large batches are transformed in parallel, so we measure real time.
+#define BENCHMARK_FFT(name)           \
+  BENCHMARK(name)                     \
+      ->MeasureProcessCPUTime()       \
+      ->UseRealTime()                 \
+      ->ArgNames({"batch", "length"}) \
+      ->Args({1, 256})                \
+      ->Args({64, 256})               \
+      ->Args({1024, 256})             \
+      ->Args({4096, 64})              \
+      ->Args({16384, 16})             \
+      ->Args({16, 4096})              \
+      ->Args({1, 65536})
+
+BENCHMARK_FFT(BM_Fft_C64);
+BENCHMARK_FFT(BM_Rfft_F32);
+
+}  // namespace xla::cpu
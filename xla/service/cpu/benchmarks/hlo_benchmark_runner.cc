@@ -33,6 +33,7 @@ limitations under the License.
 #include "xla/pjrt/plugin/xla_cpu/xla_cpu_pjrt_client.h"
 #include "xla/service/hlo_module_config.h"
 #include "xla/tests/test_utils.h"
+#include "xla/xla.pb.h"
 #include "tsl/platform/errors.h"
 #include "tsl/platform/statusor.h"
 #include "tsl/platform/test_benchmark.h"
@@ -44,6 +45,18 @@ absl::Status RunHloBenchmark(benchmark::State& state,
                              absl::Span<const Literal* const> args,
                              StrToStrMapping replacements,
                              bool disable_parallel_task_assigner) {
+  HloBenchmarkOptions benchmark_options;
+  benchmark_options.disable_parallel_task_assigner =
+      disable_parallel_task_assigner;
+  return RunHloBenchmark(state, hlo_module, args, replacements,
+                         benchmark_options);
+}
+
+absl::Status RunHloBenchmark(benchmark::State& state,
+                             std::string_view hlo_module,
+                             absl::Span<const Literal* const> args,
+                             StrToStrMapping replacements,
+                             const HloBenchmarkOptions& benchmark_options) {
   xla::CpuClientOptions options;
   TF_ASSIGN_OR_RETURN(std::unique_ptr<PjRtClient> client,
                       xla::GetXlaPjrtCpuClient(options));
@@ -58,9 +71,14 @@ absl::Status RunHloBenchmark(benchmark::State& state,
 
   // Compile HLO module to executable.
   CompileOptions compile_options;
-  if (disable_parallel_task_assigner) {
-    compile_options.executable_build_options.mutable_debug_options()
-        ->add_xla_disable_hlo_passes("cpu-parallel-task-assigner");
+  DebugOptions* debug_options =
+      compile_options.executable_build_options.mutable_debug_options();
+  if (benchmark_options.disable_parallel_task_assigner) {
+    debug_options->add_xla_disable_hlo_passes("cpu-parallel-task-assigner");
+  }
+  if (benchmark_options.thunk_executor_ready_queue.has_value()) {
+    debug_options->set_xla_cpu_thunk_executor_ready_queue(
+        *benchmark_options.thunk_executor_ready_queue);
   }
   TF_ASSIGN_OR_RETURN(std::unique_ptr<PjRtLoadedExecutable> executable,
                       client->Compile(computation, compile_options));
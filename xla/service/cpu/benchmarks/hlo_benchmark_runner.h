@@ -16,12 +16,14 @@ limitations under the License.
 #ifndef XLA_SERVICE_CPU_BENCHMARKS_HLO_BENCHMARK_RUNNER_H_
 #define XLA_SERVICE_CPU_BENCHMARKS_HLO_BENCHMARK_RUNNER_H_
 
+#include <optional>
 #include <string_view>
 
 #include "absl/status/status.h"
 #include "absl/strings/string_view.h"
 #include "absl/types/span.h"
 #include "xla/literal.h"
+#include "xla/xla.pb.h"
 #include "tsl/platform/test_benchmark.h"
 
 namespace xla::cpu {
@@ -30,6 +32,18 @@ namespace xla::cpu {
 using StrToStrMapping =
     std::initializer_list<std::pair<absl::string_view, absl::string_view>>;
 
+// Options that control how HLO benchmarks are compiled and executed.
+struct HloBenchmarkOptions {
+  // If true, the parallel task assigner will not be run on the HLO module
+  // before running the benchmark.
+  bool disable_parallel_task_assigner = false;
+
+  // Ready queue used by the thunk executor to run the compiled module. If not
+  // set, the ready queue is configured by the XLA_FLAGS.
+  std::optional<DebugOptions::CpuThunkExecutorReadyQueue>
+      thunk_executor_ready_queue;
+};
+
 // Runs the given HLO module as a benchmark.
 //
 // The HLO text can be interpolated using the given string replacements. Each
@@ -45,6 +59,13 @@ absl::Status RunHloBenchmark(benchmark::State& state,
                              StrToStrMapping replacements = {},
                              bool disable_parallel_task_assigner = false);
 
+// Runs the given HLO module as a benchmark with the given benchmark options.
+absl::Status RunHloBenchmark(benchmark::State& state,
+                             std::string_view hlo_module,
+                             absl::Span<const Literal* const> args,
+                             StrToStrMapping replacements,
+                             const HloBenchmarkOptions& benchmark_options);
+
 }  // namespace xla::cpu
 
 #endif  // XLA_SERVICE_CPU_BENCHMARKS_HLO_BENCHMARK_RUNNER_H_
@@ -56,6 +56,34 @@ static void BM_TopKCustomCall_F32(benchmark::State& state) {
                             {"$k", absl::StrCat(k)}}));
 }
 
+static void BM_TopKCustomCall_BF16(benchmark::State& state) {
+  int64_t k = state.range(0);
+  int64_t batch = state.range(1);
+  int64_t length = state.range(2);
+  CHECK_LE(k, length);
+
+  std::string_view hlo = R"(
+    HloModule topk_custom_call
+
+    ENTRY test {
+      x = bf16[$batch,$length] parameter(0)
+      ROOT topk = (bf16[$batch,$k], s32[$batch,$k]) custom-call(x),
+            custom_call_target="TopK"
+    }
+  )";
+
+  // Fixed seed to avoid too inconsistent runs
+  std::minstd_rand0 engine(/*seed=*/0xCAFEFEED);
+  auto x = LiteralUtil::CreateRandomLiteral<BF16>(
+               ShapeUtil::MakeShape(BF16, {batch, length}), &engine, 1.0f, 0.1f)
+               .value();
+
+  CHECK_OK(RunHloBenchmark(state, hlo, {&x},
+                           {{"$batch", absl::StrCat(batch)},
+                            {"$length", absl::StrCat(length)},
+                            {"$k", absl::StrCat(k)}}));
+}
+
 static void BM_TopK_BF16(benchmark::State& state) {
   int64_t k = state.range(0);
   int64_t batch = state.range(1);
@@ -97,7 +125,26 @@ static void BM_TopK_BF16(benchmark::State& state) {
       ->Args({64, 16, 64})                 \
       ->Args({64, 64, 64})
 
+// Large batches and inputs are processed in parallel, so we measure real time.
+#define BENCHMARK_TOPK_LARGE(name)         \
+  BENCHMARK(name)                          \
+      ->MeasureProcessCPUTime()            \
+      ->UseRealTime()                      \
+      ->ArgNames({"k", "batch", "length"}) \
+      ->Args({16, 4096, 4096})             \
+      ->Args({128, 4096, 4096})            \
+      ->Args({1024, 4096, 4096})           \
+      ->Args({10, 1024, 32768})            \
+      ->Args({100, 256, 131072})           \
+      ->Args({1000, 64, 131072})           \
+      ->Args({16384, 64, 131072})          \
+      ->Args({100, 1, 1048576})
+
 BENCHMARK_TOPK(BM_TopKCustomCall_F32);
+BENCHMARK_TOPK(BM_TopKCustomCall_BF16);
 BENCHMARK_TOPK(BM_TopK_BF16);
 
+BENCHMARK_TOPK_LARGE(BM_TopKCustomCall_F32);
+BENCHMARK_TOPK_LARGE(BM_TopKCustomCall_BF16);
+
 }  // namespace xla::cpu
@@ -146,6 +146,7 @@ limitations under the License.
 #include "xla/service/call_graph.h"
 #include "xla/service/call_inliner.h"
 #include "xla/service/change_op_data_type.h"
+#include "xla/service/compilation_stats.h"
 #include "xla/service/compiler.h"
 #include "xla/service/conditional_simplifier.h"
 #include "xla/service/conditional_to_select.h"
@@ -472,8 +473,9 @@ void AddHloVerifier(HloPassPipeline* pipeline, HloVerifierOpts&& opts = {},
 
 absl::Status CpuCompiler::RunHloPassesThroughLayoutAssn(
     HloModule* module, bool is_aot_compile,
-    TargetMachineFeatures* target_machine_features, bool is_mlir_compile) {
-  HloPassPipeline pre_sharding_pipeline("pre-spmd-pipeline");
+    TargetMachineFeatures* target_machine_features, bool is_mlir_compile,
+    CompilationStats* compilation_stats) {
+  HloPassPipeline pre_sharding_pipeline("pre-spmd-pipeline", compilation_stats);
   // TODO(b/359982037): Run BatchedGatherScatterNormalizer after partitioning.
   pre_sharding_pipeline.AddPass<BatchedGatherScatterNormalizer>();
   TF_RETURN_IF_ERROR(pre_sharding_pipeline.Run(module).status());
@@ -484,7 +486,7 @@ absl::Status CpuCompiler::RunHloPassesThroughLayoutAssn(
           "num_partitions=%d but SPMD partitioning not enabled.",
           num_partitions);
     }
-    HloPassPipeline spmd_pipeline("spmd-partitioner");
+    HloPassPipeline spmd_pipeline("spmd-partitioner", compilation_stats);
     // Run some IR cleanup passes before running the SPMD partitioning
     // passes.
     AddHloVerifier(&spmd_pipeline);
@@ -503,7 +505,8 @@ absl::Status CpuCompiler::RunHloPassesThroughLayoutAssn(
         num_partitions, module->config().replica_count());
     TF_RETURN_IF_ERROR(spmd_pipeline.Run(module).status());
   } else {
-    HloPassPipeline sharding_removal_pipeline("sharding-removal");
+    HloPassPipeline sharding_removal_pipeline("sharding-removal",
+                                              compilation_stats);
     AddHloVerifier(&sharding_removal_pipeline);
     // Remove redundant sharding ops when partition_count == 1.
     sharding_removal_pipeline.AddPass<ShardingRemover>();
@@ -515,12 +518,14 @@ absl::Status CpuCompiler::RunHloPassesThroughLayoutAssn(
     // SubbytePacker must be run before the rest of the pipeline since it
     // modifies the layout of the entry computation inputs/outputs, which is
     // passed to LayoutAssignment.
-    HloPassPipeline subbyte_packer_pipeline("SubbytePacker pipeline");
+    HloPassPipeline subbyte_packer_pipeline("SubbytePacker pipeline",
+                                            compilation_stats);
     subbyte_packer_pipeline.AddPass<SubByteNormalization>(
         SubByteNormalization::SET_ELEMENT_SIZE);
     TF_RETURN_IF_ERROR(subbyte_packer_pipeline.Run(module).status());
   }
-  HloPassPipeline pipeline("HLO passes through layout assignment");
+  HloPassPipeline pipeline("HLO passes through layout assignment",
+                           compilation_stats);
   AddHloVerifier(&pipeline);
 
   pipeline.AddPass<ResultCaster>();
@@ -723,7 +728,9 @@ absl::Status CpuCompiler::RunHloPassesThroughLayoutAssn(
   // support libcalls. Disable this for now.
   if (!is_mlir_compile) {
     pipeline.AddPass<TopkRewriter>([](const HloSortInstruction* sort, int64_t) {
-      return sort->operand(0)->shape().element_type() == F32;
+      PrimitiveType element_type = sort->operand(0)->shape().element_type();
+      return element_type == F32 || element_type == F16 ||
+             element_type == BF16;
     });
   }
   pipeline.AddPass<IndexedArrayAnalysisPrinterPass>();
@@ -768,8 +775,10 @@ absl::Status CpuCompiler::RunHloPassesThroughLayoutAssn(
 absl::Status CpuCompiler::RunHloPassesAfterLayoutAssn(
     HloModule* module, bool is_aot_compile,
     TargetMachineFeatures* target_machine_features,
-    const CompileOptions& compile_options, bool is_mlir_compile) {
-  HloPassPipeline pipeline("HLO passes after layout assignment");
+    const CompileOptions& compile_options, bool is_mlir_compile,
+    CompilationStats* compilation_stats) {
+  HloPassPipeline pipeline("HLO passes after layout assignment",
+                           compilation_stats);
 
   // CopyInsertion is still needed by BufferAssignment. MLIR passes will handle
   // everything else done by XLA, but CopyInsertion is needed to interface with
@@ -780,7 +789,8 @@ absl::Status CpuCompiler::RunHloPassesAfterLayoutAssn(
   }
 
   {
-    HloPassPipeline normalization_pipeline("hlo normalization");
+    HloPassPipeline normalization_pipeline("hlo normalization",
+                                           compilation_stats);
     normalization_pipeline.AddPass<ReshapeDecomposer>();
     normalization_pipeline.AddPass<ReduceDecomposer>();
     normalization_pipeline.AddPass<BroadcastCanonicalizer>();
@@ -888,12 +898,29 @@ absl::Status CpuCompiler::RunHloPasses(HloModule* module, bool is_aot_compile,
                                        const CompileOptions& compile_options,
                                        bool is_mlir_compile) {
   TargetMachineFeatures target_machine_features(target_machine);
+
+  // With --xla_dump_module_metadata we also write a per-pass profile of the
+  // pipelines as JSON next to the module metadata.
+  const bool dump_compilation_report =
+      module->config().debug_options().xla_dump_module_metadata();
+  std::unique_ptr<CompilationStats> compilation_stats =
+      dump_compilation_report ? CompilationStats::MakeStats()
+                              : CompilationStats::MakeNoopStats();
+
   TF_RETURN_IF_ERROR(RunHloPassesThroughLayoutAssn(
-      module, is_aot_compile, &target_machine_features, is_mlir_compile));
+      module, is_aot_compile, &target_machine_features, is_mlir_compile,
+      compilation_stats.get()));
+
+  TF_RETURN_IF_ERROR(RunHloPassesAfterLayoutAssn(
+      module, is_aot_compile, &target_machine_features, compile_options,
+      is_mlir_compile, compilation_stats.get()));
 
-  return RunHloPassesAfterLayoutAssn(module, is_aot_compile,
-                                     &target_machine_features, compile_options,
-                                     is_mlir_compile);
+  DumpHloModuleMetadataIfEnabled({module});
+  if (dump_compilation_report) {
+    DumpToFileInDir(*module, /*file_prefix=*/"", "compilation_report.json",
+                    compilation_stats->CompilationReportJson());
+  }
+  return absl::OkStatus();
 }
 
 namespace {
@@ -1316,6 +1343,23 @@ static bool HasLargeConstants(llvm::Module& module) {
   return false;
 }
 
+// Runs HLO cost analysis on the module entry computation if thunk executor
+// relies on thunk execution time estimates to prioritize thunks on the critical
+// path. Otherwise returns nullptr, as cost analysis is not free for large
+// modules.
+static absl::StatusOr<std::unique_ptr<HloCostAnalysis>> RunThunkCostAnalysis(
+    const HloModule& module) {
+  const DebugOptions& debug_options = module.config().debug_options();
+  if (!debug_options.xla_cpu_thunk_executor_critical_path_priorities()) {
+    return nullptr;
+  }
+
+  auto cost_analysis =
+      std::make_unique<HloCostAnalysis>(CpuExecutable::ShapeSizeBytes);
+  TF_RETURN_IF_ERROR(module.entry_computation()->Accept(cost_analysis.get()));
+  return cost_analysis;
+}
+
 inline void VlogMaxIsa(absl::string_view max_cpu_isa) {
   if (VLOG_IS_ON(1) && !max_cpu_isa.empty()) {
     if (tsl::port::IsX86CPU()) {
@@ -1496,8 +1540,12 @@ CpuCompiler::CompileLegacyCpuExecutable(std::unique_ptr<HloModule> module) {
     // Thunk emitter is responsible for building a Thunk sequence that will
     // resolved kernels in the compiled LLVM module and execute them together
     // with Thunks implemented as library calls (e.g. oneDNN or Eigen).
+    TF_ASSIGN_OR_RETURN(std::unique_ptr<HloCostAnalysis> cost_analysis,
+                        RunThunkCostAnalysis(*module));
+
     ThunkEmitter thunk_emitter(ir_emitter2, *assignment,
-                               target_machine_features, module->config());
+                               target_machine_features, module->config(),
+                               cost_analysis.get());
     TF_ASSIGN_OR_RETURN(ThunkSequence thunks,
                         thunk_emitter.EmitEntryComputation(*module));
 
@@ -2134,8 +2182,12 @@ CpuExecutableAotCompilationResult::LoadExecutable(
 
     IrEmitter2 ir_emitter2(*module, llvm_module.get(), &nested_ir_emitter);
 
+    TF_ASSIGN_OR_RETURN(std::unique_ptr<HloCostAnalysis> cost_analysis,
+                        RunThunkCostAnalysis(*module));
+
     ThunkEmitter thunk_emitter(ir_emitter2, *buffer_assignment,
-                               target_machine_features, module->config());
+                               target_machine_features, module->config(),
+                               cost_analysis.get());
     TF_ASSIGN_OR_RETURN(ThunkSequence thunks,
                         thunk_emitter.EmitEntryComputation(*module));
 
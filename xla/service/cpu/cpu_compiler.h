@@ -30,6 +30,7 @@ limitations under the License.
 #include "xla/hlo/ir/hlo_module.h"
 #include "xla/hlo/ir/hlo_module_group.h"
 #include "xla/service/buffer_assignment.h"
+#include "xla/service/compilation_stats.h"
 #include "xla/service/compiler.h"
 #include "xla/service/cpu/executable.pb.h"
 #include "xla/service/cpu/xla_framework.h"
@@ -200,17 +201,20 @@ class CpuCompiler : public LLVMCompiler {
                             const CompileOptions& compile_options,
                             bool is_mlir_compile = false);
 
-  // Runs HLO passes up to and including layout assignment.
+  // Runs HLO passes up to and including layout assignment. If
+  // `compilation_stats` is not null, the pipelines record their passes in it.
   absl::Status RunHloPassesThroughLayoutAssn(
       HloModule* module, bool /*is_aot_compile*/,
       TargetMachineFeatures* target_machine_features,
-      bool is_mlir_compile = false);
+      bool is_mlir_compile = false,
+      CompilationStats* compilation_stats = nullptr);
 
   // Runs HLO passes after layout assignment.
   absl::Status RunHloPassesAfterLayoutAssn(
       HloModule* module, bool is_aot_compile,
       TargetMachineFeatures* target_machine_features,
-      const CompileOptions& compile_options, bool is_mlir_compile);
+      const CompileOptions& compile_options, bool is_mlir_compile,
+      CompilationStats* compilation_stats = nullptr);
 
   absl::StatusOr<std::unique_ptr<CpuExecutable>> CompileLegacyCpuExecutable(
       std::unique_ptr<HloModule> module);
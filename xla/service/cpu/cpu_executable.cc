@@ -72,6 +72,7 @@ limitations under the License.
 #include "xla/stream_executor/host/host_stream.h"
 #include "xla/tsl/concurrency/async_value_ref.h"
 #include "xla/util.h"
+#include "xla/xla.pb.h"
 #include "xla/xla_data.pb.h"
 #include "tsl/platform/env.h"
 #include "tsl/platform/logging.h"
@@ -126,6 +127,35 @@ absl::StatusOr<std::unique_ptr<CpuExecutable>> CpuExecutable::Create(
   return executable;
 }
 
+// Returns thunk executor options configured by the module debug options.
+static ThunkExecutor::Options GetThunkExecutorOptions(
+    const DebugOptions& debug_options) {
+  using ReadyQueueType = ThunkExecutor::Options::ReadyQueueType;
+
+  ThunkExecutor::Options options;
+  switch (debug_options.xla_cpu_thunk_executor_ready_queue()) {
+    case DebugOptions::CPU_THUNK_EXECUTOR_READY_QUEUE_PRIORITY:
+      options.ready_queue_type = ReadyQueueType::kPriority;
+      break;
+    case DebugOptions::CPU_THUNK_EXECUTOR_READY_QUEUE_WORK_STEALING:
+      options.ready_queue_type = ReadyQueueType::kWorkStealing;
+      break;
+    default:
+      options.ready_queue_type = ReadyQueueType::kFifo;
+      break;
+  }
+
+  if (debug_options.xla_cpu_thunk_executor_critical_path_priorities()) {
+    options.priority_type =
+        ThunkExecutor::Options::PriorityType::kCriticalPath;
+  }
+
+  int64_t max_lookahead = debug_options.xla_cpu_thunk_executor_max_lookahead();
+  options.max_lookahead = std::max<int64_t>(max_lookahead, 0);
+
+  return options;
+}
+
 absl::StatusOr<std::unique_ptr<CpuExecutable>> CpuExecutable::Create(
     std::unique_ptr<FunctionLibrary> function_library,
     std::unique_ptr<const BufferAssignment> assignment,
@@ -141,8 +171,12 @@ absl::StatusOr<std::unique_ptr<CpuExecutable>> CpuExecutable::Create(
       std::move(hlo_profile_index_map), std::move(assignment)));
   executable->function_library_ = std::move(function_library);
 
-  TF_ASSIGN_OR_RETURN(executable->thunks_,
-                      ThunkExecutor::Create(std::move(thunks)));
+  const DebugOptions& debug_options =
+      executable->module().config().debug_options();
+  TF_ASSIGN_OR_RETURN(
+      executable->thunks_,
+      ThunkExecutor::Create(std::move(thunks),
+                            GetThunkExecutorOptions(debug_options)));
 
   // Re-index constants by their allocation index to allow efficient lookup.
   for (auto& constant : constants) {
@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "xla/service/cpu/cpu_options.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <optional>
 #include <string>
@@ -22,9 +23,11 @@ limitations under the License.
 #include <vector>
 
 #include "absl/log/check.h"
+#include "absl/numeric/bits.h"
 #include "absl/strings/numbers.h"
 #include "absl/strings/str_split.h"
 #include "absl/strings/string_view.h"
+#include "xla/backends/cpu/alignment.h"
 
 namespace {
 
@@ -113,6 +116,19 @@ std::optional<std::tuple<int64_t, int64_t, int64_t>> LlvmIrGemmTileSize(
                                                tile_size_n_in_vector_width);
 }
 
+int64_t ParameterAlignment(const HloModuleConfig& config) {
+  return ParameterAlignment(
+      config.debug_options().xla_cpu_parameter_alignment());
+}
+
+int64_t ParameterAlignment(int64_t alignment) {
+  if (alignment <= 0) {
+    return MinAlign();
+  }
+  return std::clamp<int64_t>(absl::bit_ceil(static_cast<uint64_t>(alignment)),
+                             MinParameterAlign(), MinAlign());
+}
+
 }  // namespace options
 }  // namespace cpu
 }  // namespace xla
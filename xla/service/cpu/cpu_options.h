@@ -37,6 +37,14 @@ std::optional<int64_t> LlvmIrGemvTilingFactor(const HloModuleConfig& config);
 std::optional<std::tuple<int64_t, int64_t, int64_t>> LlvmIrGemmTileSize(
     const HloModuleConfig& config);
 
+// Returns the alignment in bytes that compiled kernels can assume for buffers
+// of entry computation parameters.
+int64_t ParameterAlignment(const HloModuleConfig& config);
+
+// Returns the parameter alignment supported by XLA:CPU that is closest to the
+// requested one (the default alignment if `alignment` is not positive).
+int64_t ParameterAlignment(int64_t alignment);
+
 }  // namespace options
 }  // namespace cpu
 }  // namespace xla
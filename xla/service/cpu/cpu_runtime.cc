@@ -162,6 +162,8 @@ extern const char* const kStatusIsSuccessSymbolName =
 extern const char* const kKeyValueSortSymbolName =
     "__xla_cpu_runtime_KeyValueSort";
 extern const char* const kTopKF32SymbolName = "__xla_cpu_runtime_TopKF32";
+extern const char* const kTopKF16SymbolName = "__xla_cpu_runtime_TopKF16";
+extern const char* const kTopKBF16SymbolName = "__xla_cpu_runtime_TopKBF16";
 extern const char* const kTracingStartSymbolName =
     "__xla_cpu_runtime_TracingStart";
 extern const char* const kTracingEndSymbolName = "__xla_cpu_runtime_TracingEnd";
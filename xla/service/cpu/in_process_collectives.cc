@@ -25,6 +25,7 @@ limitations under the License.
 #include <string>
 #include <vector>
 
+#include "absl/algorithm/container.h"
 #include "absl/log/log.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
@@ -48,6 +49,12 @@ namespace cpu {
 namespace runtime {
 namespace {
 
+// All-reduce of buffers up to this size is computed by every participant
+// independently (see `ReplicatedAllReduce` below).
+constexpr int64_t kMaxReplicatedAllReduceBytes = 16 * 1024;
+
+constexpr int64_t kCacheLineBytes = 64;
+
 void FormatGlobalId(std::string* out, const GlobalDeviceId& device) {
   absl::StrAppend(out, device.value());
 }
@@ -98,35 +105,47 @@ T GetInitialValue(ReductionKind reduction_kind) {
 template <ReductionKind>
 constexpr bool always_false_v = false;
 
+// Number of bytes of the output reduced over all inputs at once. We reduce
+// the output block by block in a small stack buffer that stays in L1 cache
+// while we accumulate all inputs into it, instead of streaming the whole
+// output through memory once per input. Accumulating into a separate buffer
+// also makes the reduction safe when the output aliases one of the inputs.
+constexpr size_t kReduceBlockBytes = 4096;
+
 template <ReductionKind reduction_kind, typename T>
-void ReduceHelper(absl::Span<T> acc, absl::Span<T const* const> inputs) {
-  // TODO(penporn): make sure this gets vectorized.
+T ReduceOp(T acc, T value) {
   if constexpr (reduction_kind == ReductionKind::SUM) {
-    for (size_t j = 0; j < inputs.size(); ++j) {
-      for (size_t i = 0; i < acc.size(); ++i) {
-        acc[i] += inputs[j][i];
-      }
-    }
+    return static_cast<T>(acc + value);
   } else if constexpr (reduction_kind == ReductionKind::PRODUCT) {
-    for (size_t j = 0; j < inputs.size(); ++j) {
-      for (size_t i = 0; i < acc.size(); ++i) {
-        acc[i] *= inputs[j][i];
-      }
-    }
+    return static_cast<T>(acc * value);
   } else if constexpr (reduction_kind == ReductionKind::MIN) {
-    for (size_t j = 0; j < inputs.size(); ++j) {
-      for (size_t i = 0; i < acc.size(); ++i) {
-        acc[i] = std::min(acc[i], inputs[j][i]);
-      }
-    }
+    return std::min(acc, value);
   } else if constexpr (reduction_kind == ReductionKind::MAX) {
+    return std::max(acc, value);
+  } else {
+    static_assert(always_false_v<reduction_kind>, "Unsupported reduction kind");
+  }
+}
+
+template <ReductionKind reduction_kind, typename T>
+void ReduceHelper(absl::Span<T> acc, absl::Span<T const* const> inputs) {
+  constexpr size_t kBlockElems =
+      std::max<size_t>(1, kReduceBlockBytes / sizeof(T));
+
+  T initial_value = GetInitialValue<T>(reduction_kind);
+  T block[kBlockElems];
+
+  for (size_t start = 0; start < acc.size(); start += kBlockElems) {
+    size_t size = std::min(kBlockElems, acc.size() - start);
+    std::fill(block, block + size, initial_value);
+    // Inner loop is a simple element-wise loop that compilers vectorize.
     for (size_t j = 0; j < inputs.size(); ++j) {
-      for (size_t i = 0; i < acc.size(); ++i) {
-        acc[i] = std::max(acc[i], inputs[j][i]);
+      const T* in = inputs[j] + start;
+      for (size_t i = 0; i < size; ++i) {
+        block[i] = ReduceOp<reduction_kind, T>(block[i], in[i]);
       }
     }
-  } else {
-    static_assert(always_false_v<reduction_kind>, "Unsupported reduction kind");
+    std::copy(block, block + size, acc.data() + start);
   }
 }
 
@@ -135,13 +154,9 @@ absl::Status ReduceScatter(ReductionKind reduction_kind,
                            absl::Span<const void* const> inputs, void* output,
                            int64_t num_elems) {
   using T = typename primitive_util::PrimitiveTypeToNative<PT>::type;
-  T initial_value = GetInitialValue<T>(reduction_kind);
 
   absl::Span<T> out_chunk =
       absl::MakeSpan(reinterpret_cast<T*>(output), num_elems);
-  for (int64_t i = 0; i < num_elems; ++i) {
-    out_chunk[i] = initial_value;
-  }
 
   absl::Span<T const* const> input_chunks(
       reinterpret_cast<T const* const*>(inputs.data()), inputs.size());
@@ -173,6 +188,46 @@ absl::Status ReduceScatter(ReductionKind reduction_kind,
   return absl::OkStatus();
 }
 
+// Reduces `num_elems` elements of all `inputs` into `output`.
+absl::Status ReduceScatter(PrimitiveType element_type,
+                           ReductionKind reduction_kind,
+                           absl::Span<const void* const> inputs, void* output,
+                           int64_t num_elems) {
+  switch (element_type) {
+    case S8:
+      return ReduceScatter<S8>(reduction_kind, inputs, output, num_elems);
+    case PRED:
+    case U8:
+      return ReduceScatter<U8>(reduction_kind, inputs, output, num_elems);
+    case S16:
+      return ReduceScatter<S16>(reduction_kind, inputs, output, num_elems);
+    case U16:
+      return ReduceScatter<U16>(reduction_kind, inputs, output, num_elems);
+    case S32:
+      return ReduceScatter<S32>(reduction_kind, inputs, output, num_elems);
+    case U32:
+      return ReduceScatter<U32>(reduction_kind, inputs, output, num_elems);
+    case S64:
+      return ReduceScatter<S64>(reduction_kind, inputs, output, num_elems);
+    case U64:
+      return ReduceScatter<U64>(reduction_kind, inputs, output, num_elems);
+    case F16:
+      return ReduceScatter<F16>(reduction_kind, inputs, output, num_elems);
+    case BF16:
+      return ReduceScatter<BF16>(reduction_kind, inputs, output, num_elems);
+    case F32:
+      return ReduceScatter<F32>(reduction_kind, inputs, output, num_elems);
+    case F64:
+      return ReduceScatter<F64>(reduction_kind, inputs, output, num_elems);
+    case C64:
+      return ReduceScatter<C64>(reduction_kind, inputs, output, num_elems);
+    case C128:
+      return ReduceScatter<C128>(reduction_kind, inputs, output, num_elems);
+    default:
+      return absl::UnimplementedError("Unexpected datatype");
+  }
+}
+
 class CpuAllReduceRendezvous
     : public Rendezvous<AllReduceParticipantData, std::nullptr_t> {
  public:
@@ -183,10 +238,89 @@ class CpuAllReduceRendezvous
   absl::StatusOr<std::nullptr_t> RunCollectiveOp(
       const AllReduceParticipantData& me) override {
     VLOG(3) << me.ToString();
+    auto bytes_per_elem = primitive_util::ByteWidth(me.primitive_type);
+    int64_t num_bytes = me.element_count * bytes_per_elem;
+
+    if (num_bytes <= kMaxReplicatedAllReduceBytes && !HasAliasedBuffers()) {
+      return ReplicatedAllReduce(me);
+    }
+    return ReduceScatterAllGather(me, bytes_per_elem);
+  }
+
+ private:
+  // Returns true if any destination buffer overlaps with any source buffer.
+  // Buffers are visited in the order of their start addresses, so a buffer
+  // overlaps an earlier one of the other kind iff it starts before the largest
+  // end address seen so far for that kind.
+  bool HasAliasedBuffers() const {
+    struct Buffer {
+      uintptr_t begin;
+      uintptr_t end;
+      bool is_destination;
+    };
+
+    std::vector<Buffer> buffers;
+    buffers.reserve(2 * participants_.size());
+    for (const auto& p : participants_) {
+      int64_t num_bytes =
+          p->element_count * primitive_util::ByteWidth(p->primitive_type);
+      if (num_bytes == 0) continue;
+      auto src = reinterpret_cast<uintptr_t>(p->source_data);
+      auto dst = reinterpret_cast<uintptr_t>(p->destination_data);
+      buffers.push_back({src, src + num_bytes, /*is_destination=*/false});
+      buffers.push_back({dst, dst + num_bytes, /*is_destination=*/true});
+    }
+
+    absl::c_sort(buffers, [](const Buffer& a, const Buffer& b) {
+      return a.begin < b.begin;
+    });
+
+    uintptr_t sources_end = 0;
+    uintptr_t destinations_end = 0;
+    for (const Buffer& buffer : buffers) {
+      if (buffer.is_destination) {
+        if (buffer.begin < sources_end) return true;
+        destinations_end = std::max(destinations_end, buffer.end);
+      } else {
+        if (buffer.begin < destinations_end) return true;
+        sources_end = std::max(sources_end, buffer.end);
+      }
+    }
+    return false;
+  }
+
+  // Every participant reduces the full buffer into its own destination. For
+  // small buffers this is cheaper than splitting the work, because
+  // participants never write to each other's buffers and don't contend for
+  // the same cache lines. Requires destination buffers not to alias any of
+  // the sources, as participants read sources while others write results.
+  absl::StatusOr<std::nullptr_t> ReplicatedAllReduce(
+      const AllReduceParticipantData& me) {
+    std::vector<const void*> inputs;
+    inputs.reserve(participants_.size());
+    for (const auto& p : participants_) {
+      inputs.push_back(p->source_data);
+    }
+    TF_RETURN_IF_ERROR(ReduceScatter(me.primitive_type, me.reduction_kind,
+                                     inputs, me.destination_data,
+                                     me.element_count));
+    return nullptr;
+  }
+
+  // Reduce-scatter followed by an all-gather: the buffer is divided into
+  // chunks, rank r reduces the r-th chunk over all participants and then
+  // copies it to all destinations. Every participant reads and writes each
+  // element once, regardless of the number of participants.
+  absl::StatusOr<std::nullptr_t> ReduceScatterAllGather(
+      const AllReduceParticipantData& me, int64_t bytes_per_elem) {
     int64_t world_size = participants_.size();
-    // Divide the buffer up into equal(ish) chunks. Rank r computes the r-th
-    // chunk of the output.
-    int64_t chunk_elems = CeilOfRatio(me.element_count, world_size);
+    // Divide the buffer up into equal(ish) chunks aligned to cache lines, so
+    // that different ranks never write to the same cache line of a
+    // destination buffer. Rank r computes the r-th chunk of the output.
+    int64_t elems_per_cache_line =
+        std::max<int64_t>(1, kCacheLineBytes / bytes_per_elem);
+    int64_t chunk_elems = RoundUpTo(
+        CeilOfRatio(me.element_count, world_size), elems_per_cache_line);
 
     int64_t start_elem = me.local_rank * chunk_elems;
     int64_t end_elem = std::min(start_elem + chunk_elems, me.element_count);
@@ -195,7 +329,6 @@ class CpuAllReduceRendezvous
       return nullptr;
     }
 
-    auto bytes_per_elem = primitive_util::ByteWidth(me.primitive_type);
     int64_t chunk_offset = start_elem * bytes_per_elem;
     int64_t chunk_bytes = chunk_elems * bytes_per_elem;
     void* reduce_output =
@@ -208,63 +341,8 @@ class CpuAllReduceRendezvous
                        chunk_offset);
     }
 
-    switch (me.primitive_type) {
-      case S8:
-        TF_RETURN_IF_ERROR(ReduceScatter<S8>(me.reduction_kind, inputs,
-                                             reduce_output, chunk_elems));
-        break;
-      case PRED:
-      case U8:
-        TF_RETURN_IF_ERROR(ReduceScatter<U8>(me.reduction_kind, inputs,
-                                             reduce_output, chunk_elems));
-        break;
-      case S16:
-        TF_RETURN_IF_ERROR(ReduceScatter<S16>(me.reduction_kind, inputs,
-                                              reduce_output, chunk_elems));
-        break;
-      case U16:
-        TF_RETURN_IF_ERROR(ReduceScatter<U16>(me.reduction_kind, inputs,
-                                              reduce_output, chunk_elems));
-        break;
-      case S32:
-        TF_RETURN_IF_ERROR(ReduceScatter<S32>(me.reduction_kind, inputs,
-                                              reduce_output, chunk_elems));
-        break;
-      case U32:
-        TF_RETURN_IF_ERROR(ReduceScatter<U32>(me.reduction_kind, inputs,
-                                              reduce_output, chunk_elems));
-        break;
-      case S64:
-        TF_RETURN_IF_ERROR(ReduceScatter<S64>(me.reduction_kind, inputs,
-                                              reduce_output, chunk_elems));
-        break;
-      case U64:
-        TF_RETURN_IF_ERROR(ReduceScatter<U64>(me.reduction_kind, inputs,
-                                              reduce_output, chunk_elems));
-        break;
-      case F16:
-        TF_RETURN_IF_ERROR(ReduceScatter<F16>(me.reduction_kind, inputs,
-                                              reduce_output, chunk_elems));
-        break;
-      case F32:
-        TF_RETURN_IF_ERROR(ReduceScatter<F32>(me.reduction_kind, inputs,
-                                              reduce_output, chunk_elems));
-        break;
-      case F64:
-        TF_RETURN_IF_ERROR(ReduceScatter<F64>(me.reduction_kind, inputs,
-                                              reduce_output, chunk_elems));
-        break;
-      case C64:
-        TF_RETURN_IF_ERROR(ReduceScatter<C64>(me.reduction_kind, inputs,
-                                              reduce_output, chunk_elems));
-        break;
-      case C128:
-        TF_RETURN_IF_ERROR(ReduceScatter<C128>(me.reduction_kind, inputs,
-                                               reduce_output, chunk_elems));
-        break;
-      default:
-        return absl::UnimplementedError("Unexpected datatype");
-    }
+    TF_RETURN_IF_ERROR(ReduceScatter(me.primitive_type, me.reduction_kind,
+                                     inputs, reduce_output, chunk_elems));
 
     // All-gather the reduced chunks.
     for (const auto& p : participants_) {
@@ -444,63 +522,9 @@ class CpuReduceScatterRendezvous
                        chunk_offset);
     }
 
-    switch (me.element_type) {
-      case S8:
-        TF_RETURN_IF_ERROR(ReduceScatter<S8>(
-            me.reduction_kind, inputs, me.destination_buffer, me.chunk_elems));
-        break;
-      case PRED:
-      case U8:
-        TF_RETURN_IF_ERROR(ReduceScatter<U8>(
-            me.reduction_kind, inputs, me.destination_buffer, me.chunk_elems));
-        break;
-      case S16:
-        TF_RETURN_IF_ERROR(ReduceScatter<S16>(
-            me.reduction_kind, inputs, me.destination_buffer, me.chunk_elems));
-        break;
-      case U16:
-        TF_RETURN_IF_ERROR(ReduceScatter<U16>(
-            me.reduction_kind, inputs, me.destination_buffer, me.chunk_elems));
-        break;
-      case S32:
-        TF_RETURN_IF_ERROR(ReduceScatter<S32>(
-            me.reduction_kind, inputs, me.destination_buffer, me.chunk_elems));
-        break;
-      case U32:
-        TF_RETURN_IF_ERROR(ReduceScatter<U32>(
-            me.reduction_kind, inputs, me.destination_buffer, me.chunk_elems));
-        break;
-      case S64:
-        TF_RETURN_IF_ERROR(ReduceScatter<S64>(
-            me.reduction_kind, inputs, me.destination_buffer, me.chunk_elems));
-        break;
-      case U64:
-        TF_RETURN_IF_ERROR(ReduceScatter<U64>(
-            me.reduction_kind, inputs, me.destination_buffer, me.chunk_elems));
-        break;
-      case F16:
-        TF_RETURN_IF_ERROR(ReduceScatter<F16>(
-            me.reduction_kind, inputs, me.destination_buffer, me.chunk_elems));
-        break;
-      case F32:
-        TF_RETURN_IF_ERROR(ReduceScatter<F32>(
-            me.reduction_kind, inputs, me.destination_buffer, me.chunk_elems));
-        break;
-      case F64:
-        TF_RETURN_IF_ERROR(ReduceScatter<F64>(
-            me.reduction_kind, inputs, me.destination_buffer, me.chunk_elems));
-        break;
-      case C64:
-        TF_RETURN_IF_ERROR(ReduceScatter<C64>(
-            me.reduction_kind, inputs, me.destination_buffer, me.chunk_elems));
-        break;
-      case C128:
-        TF_RETURN_IF_ERROR(ReduceScatter<C128>(
-            me.reduction_kind, inputs, me.destination_buffer, me.chunk_elems));
-        break;
-      default:
-        return absl::UnimplementedError("Unexpected datatype");
-    }
+    TF_RETURN_IF_ERROR(ReduceScatter(me.element_type, me.reduction_kind,
+                                     inputs, me.destination_buffer,
+                                     me.chunk_elems));
 
     return nullptr;
   }
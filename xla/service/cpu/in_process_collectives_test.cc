@@ -0,0 +1,175 @@
+/* Copyright 2026 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/service/cpu/in_process_collectives.h"
+
+#include <cstddef>
+#include <tuple>
+#include <vector>
+
+#include "absl/log/check.h"
+#include "absl/status/status.h"
+#include "absl/synchronization/blocking_counter.h"
+#include "absl/time/time.h"
+#include "absl/types/span.h"
+#include "xla/service/collective_ops_utils.h"
+#include "xla/service/cpu/collectives_interface.h"
+#include "xla/service/global_device_id.h"
+#include "xla/tsl/lib/core/status_test_util.h"
+#include "xla/xla_data.pb.h"
+#include "tsl/platform/env.h"
+#include "tsl/platform/errors.h"
+#include "tsl/platform/test.h"
+#include "tsl/platform/test_benchmark.h"
+#include "tsl/platform/threadpool.h"
+
+namespace xla::cpu::runtime {
+namespace {
+
+constexpr absl::Duration kTimeout = absl::Seconds(5);
+
+RendezvousKey MakeRendezvousKey(absl::Span<const GlobalDeviceId> devices) {
+  return RendezvousKey(RunId(0),
+                       std::vector<GlobalDeviceId>(devices.begin(),
+                                                   devices.end()),
+                       devices.size(),
+                       RendezvousKey::CollectiveOpKind::kCrossModule,
+                       /*op_id=*/0);
+}
+
+// Runs an all-reduce of F32 buffers with every participant in a separate
+// thread of the `thread_pool`.
+absl::Status AllReduce(tsl::thread::ThreadPool& thread_pool,
+                       InProcessCollectives& collectives,
+                       ReductionKind reduction_kind, size_t num_elements,
+                       absl::Span<const float* const> inputs,
+                       absl::Span<float* const> outputs) {
+  std::vector<GlobalDeviceId> devices;
+  for (int rank = 0; rank < inputs.size(); ++rank) {
+    devices.push_back(GlobalDeviceId(rank));
+  }
+  RendezvousKey key = MakeRendezvousKey(devices);
+
+  std::vector<absl::Status> statuses(inputs.size());
+  absl::BlockingCounter counter(inputs.size());
+
+  for (int rank = 0; rank < inputs.size(); ++rank) {
+    thread_pool.Schedule([&, rank] {
+      auto communicator = collectives.GetCommunicator(devices, rank);
+      statuses[rank] = communicator.status();
+      if (communicator.ok()) {
+        statuses[rank] = (*communicator)
+                             ->AllReduce(key, reduction_kind, F32,
+                                         num_elements, inputs[rank],
+                                         outputs[rank], kTimeout);
+      }
+      counter.DecrementCount();
+    });
+  }
+
+  counter.Wait();
+  for (const absl::Status& status : statuses) {
+    TF_RETURN_IF_ERROR(status);
+  }
+  return absl::OkStatus();
+}
+
+class InProcessCollectivesTest
+    : public ::testing::TestWithParam<std::tuple<int, size_t, bool>> {};
+
+TEST_P(InProcessCollectivesTest, AllReduceSum) {
+  auto [num_participants, num_elements, in_place] = GetParam();
+
+  tsl::thread::ThreadPool thread_pool(tsl::Env::Default(), "all-reduce",
+                                      num_participants);
+  InProcessCollectives collectives;
+
+  std::vector<std::vector<float>> inputs(num_participants);
+  std::vector<std::vector<float>> outputs(num_participants);
+  std::vector<const float*> input_ptrs;
+  std::vector<float*> output_ptrs;
+
+  for (int rank = 0; rank < num_participants; ++rank) {
+    inputs[rank].resize(num_elements);
+    for (size_t i = 0; i < num_elements; ++i) {
+      inputs[rank][i] = rank + i % 7;
+    }
+    outputs[rank].resize(num_elements);
+    input_ptrs.push_back(inputs[rank].data());
+    output_ptrs.push_back(in_place ? inputs[rank].data()
+                                   : outputs[rank].data());
+  }
+
+  TF_ASSERT_OK(AllReduce(thread_pool, collectives, ReductionKind::SUM,
+                         num_elements, input_ptrs, output_ptrs));
+
+  float sum_of_ranks = num_participants * (num_participants - 1) / 2;
+  for (int rank = 0; rank < num_participants; ++rank) {
+    for (size_t i = 0; i < num_elements; ++i) {
+      ASSERT_EQ(output_ptrs[rank][i],
+                sum_of_ranks + num_participants * (i % 7))
+          << "rank=" << rank << " i=" << i;
+    }
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    InProcessCollectives, InProcessCollectivesTest,
+    ::testing::Combine(::testing::Values(1, 3, 8),
+                       // Small buffers are reduced by every participant, and
+                       // large buffers with reduce-scatter + all-gather.
+                       ::testing::Values(1, 17, 1000, 100003),
+                       ::testing::Bool()));
+
+//===----------------------------------------------------------------------===//
+// Performance benchmarks below
+//===----------------------------------------------------------------------===//
+
+static void BM_AllReduce(benchmark::State& state) {
+  int num_participants = state.range(0);
+  size_t num_elements = state.range(1);
+
+  tsl::thread::ThreadPool thread_pool(tsl::Env::Default(), "all-reduce",
+                                      num_participants);
+  InProcessCollectives collectives;
+
+  std::vector<std::vector<float>> inputs(num_participants,
+                                         std::vector<float>(num_elements, 1));
+  std::vector<std::vector<float>> outputs(num_participants,
+                                          std::vector<float>(num_elements));
+  std::vector<const float*> input_ptrs;
+  std::vector<float*> output_ptrs;
+  for (int rank = 0; rank < num_participants; ++rank) {
+    input_ptrs.push_back(inputs[rank].data());
+    output_ptrs.push_back(outputs[rank].data());
+  }
+
+  for (auto _ : state) {
+    CHECK_OK(AllReduce(thread_pool, collectives, ReductionKind::SUM,
+                       num_elements, input_ptrs, output_ptrs));
+  }
+
+  state.SetBytesProcessed(state.iterations() * num_participants *
+                          num_elements * sizeof(float));
+}
+
+BENCHMARK(BM_AllReduce)
+    ->MeasureProcessCPUTime()
+    ->UseRealTime()
+    ->ArgNames({"participants", "elements"})
+    ->ArgsProduct({{2, 4, 8, 16}, {256, 4096, 65536, 1048576}});
+
+}  // namespace
+}  // namespace xla::cpu::runtime
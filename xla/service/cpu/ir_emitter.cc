@@ -2434,7 +2434,21 @@ absl::Status IrEmitter::HandleTopK(HloInstruction* hlo) {
   const HloInstruction* input = hlo->operand(0);
   const int64_t k = hlo->shape().tuple_shapes(0).dimensions().back();
   const bool has_batch = hlo->shape().tuple_shapes(0).dimensions_size() == 2;
-  TF_RET_CHECK(input->shape().element_type() == F32) << hlo->ToString();
+  const char* topk_symbol_name;
+  switch (input->shape().element_type()) {
+    case F32:
+      topk_symbol_name = runtime::kTopKF32SymbolName;
+      break;
+    case F16:
+      topk_symbol_name = runtime::kTopKF16SymbolName;
+      break;
+    case BF16:
+      topk_symbol_name = runtime::kTopKBF16SymbolName;
+      break;
+    default:
+      return Unimplemented("Unsupported TopK element type: %s",
+                           hlo->ToString());
+  }
   TF_RET_CHECK(LayoutUtil::IsMonotonicWithDim0Major(
       hlo->shape().tuple_shapes(0).layout()))
       << hlo->ToString();
@@ -2458,7 +2472,7 @@ absl::Status IrEmitter::HandleTopK(HloInstruction* hlo) {
   llvm::Value* out_indices_ptr =
       EmitBufferPointer(out_indices_slice, hlo->shape().tuple_shapes(1));
   EmitCallToFunc(
-      runtime::kTopKF32SymbolName,
+      topk_symbol_name,
       {b()->getInt64(has_batch ? input->shape().dimensions(0) : 1),
        b()->getInt64(input->shape().dimensions().back()), b()->getInt64(k),
        values_ptr, out_values_ptr, out_indices_ptr},
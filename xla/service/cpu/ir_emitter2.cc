@@ -59,6 +59,7 @@ limitations under the License.
 #include "xla/layout_util.h"
 #include "xla/service/buffer_assignment.h"
 #include "xla/service/cpu/backend_config.pb.h"
+#include "xla/service/cpu/cpu_options.h"
 #include "xla/service/cpu/dot_op_emitter.h"
 #include "xla/service/cpu/elemental_math_emitter.h"
 #include "xla/service/cpu/ir_emitter.h"
@@ -685,7 +686,8 @@ IrEmitter2::KernelThread IrEmitter2::EmitKernelThread(llvm::IRBuilderBase& b,
 llvm_ir::IrArray IrEmitter2::EmitKernelArgument(llvm::IRBuilderBase& b,
                                                 llvm::Value* call_frame,
                                                 int64_t index,
-                                                const Shape& shape) {
+                                                const Shape& shape,
+                                                int64_t alignment) {
   llvm::Type* ptr = llvm::PointerType::get(b.getContext(), 0);
   std::string name = absl::StrCat("arg", index);
 
@@ -696,7 +698,7 @@ llvm_ir::IrArray IrEmitter2::EmitKernelArgument(llvm::IRBuilderBase& b,
 
   // All buffers passed to host kernels are expected to be properly aligned,
   // emit metadata to allow LLVM to use that information for optimization.
-  llvm_ir::SetAlignmentMetadataForLoad(data, cpu_function_runtime::MinAlign());
+  llvm_ir::SetAlignmentMetadataForLoad(data, alignment);
 
   // All buffers pointers passed to host kernels are expected to be
   // dereferenceable.
@@ -806,6 +808,16 @@ absl::StatusOr<IrEmitter2::KernelPrototype> IrEmitter2::EmitKernelPrototype(
 
   int64_t idx = 0;
 
+  // Buffers of entry computation parameters are owned by the caller and might
+  // be aligned to a smaller boundary than buffers allocated by XLA.
+  int64_t parameter_alignment =
+      options::ParameterAlignment(hlo_module_.config());
+  auto alignment = [&](BufferAllocation::Slice slice) -> int64_t {
+    return slice.allocation()->is_entry_computation_parameter()
+               ? parameter_alignment
+               : cpu_function_runtime::MinAlign();
+  };
+
   // A set of invariant (read-only) buffer indices, feeded in the loop array in
   // the next section.
   absl::flat_hash_set<int64_t> invariant_arguments;
@@ -814,7 +826,8 @@ absl::StatusOr<IrEmitter2::KernelPrototype> IrEmitter2::EmitKernelPrototype(
   std::vector<llvm_ir::IrArray> ir_arguments;
   for (int64_t i = 0; i < arguments.size(); ++i) {
     const KernelParameter& argument = arguments[i];
-    auto ir_argument = EmitKernelArgument(b, call_frame, idx++, argument.shape);
+    auto ir_argument = EmitKernelArgument(b, call_frame, idx++, argument.shape,
+                                          alignment(argument.slice));
     if (auto* noalias = get_noalias(argument.slice)) {
       ir_argument.AddNoaliasMetadata(noalias);
     }
@@ -832,7 +845,8 @@ absl::StatusOr<IrEmitter2::KernelPrototype> IrEmitter2::EmitKernelPrototype(
   // IrArrays for the results.
   std::vector<llvm_ir::IrArray> ir_results;
   for (const KernelParameter& result : results) {
-    auto ir_result = EmitKernelArgument(b, call_frame, idx++, result.shape);
+    auto ir_result = EmitKernelArgument(b, call_frame, idx++, result.shape,
+                                        alignment(result.slice));
     if (auto* noalias = get_noalias(result.slice)) {
       ir_result.AddNoaliasMetadata(noalias);
     }
@@ -229,7 +229,7 @@ class IrEmitter2 {
 
   llvm_ir::IrArray EmitKernelArgument(llvm::IRBuilderBase& b,
                                       llvm::Value* call_frame, int64_t index,
-                                      const Shape& shape);
+                                      const Shape& shape, int64_t alignment);
 
   // Returns parallel config for the given instruction or std::nullopt if
   // the instruction has to be compiled to a single threaded loop.
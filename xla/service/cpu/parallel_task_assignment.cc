@@ -18,7 +18,9 @@ limitations under the License.
 #include <algorithm>
 #include <cmath>
 #include <cstdint>
+#include <limits>
 #include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -34,11 +36,15 @@ limitations under the License.
 #include "xla/hlo/ir/hlo_opcode.h"
 #include "xla/service/cpu/backend_config.pb.h"
 #include "xla/service/cpu/ir_emission_utils.h"
+#include "xla/service/cpu/parallel_cost_profile.pb.h"
 #include "xla/service/cpu/shape_partition.h"
 #include "xla/service/hlo_cost_analysis.h"
 #include "xla/service/llvm_ir/dynamic_update_slice_util.h"
 #include "xla/util.h"
+#include "xla/xla.pb.h"
 #include "tsl/platform/cpu_info.h"
+#include "tsl/platform/env.h"
+#include "tsl/platform/errors.h"
 #include "tsl/platform/logging.h"  // IWYU pragma: keep
 #include "tsl/platform/status.h"
 
@@ -124,6 +130,82 @@ class DefaultCostModel : public ParallelCostModel {
   const std::unique_ptr<HloCostAnalysis> cost_analysis_;
 };
 
+// Cost model calibrated with the measured throughput of the host. Every task
+// runs at the single-core compute throughput, while all tasks together share
+// the memory bandwidth of the host, and every additional task adds a fixed
+// launch overhead. The model picks the task count with the lowest estimated
+// latency, preferring fewer tasks on ties.
+class CalibratedCostModel : public ParallelCostModel {
+ public:
+  CalibratedCostModel(const int64_t max_parallelism,
+                      ParallelCostProfile profile,
+                      std::unique_ptr<HloCostAnalysis> cost_analysis)
+      : max_parallelism_(max_parallelism),
+        profile_(std::move(profile)),
+        cost_analysis_(std::move(cost_analysis)) {}
+  ~CalibratedCostModel() override {}
+
+  int64_t GetParallelTaskCount(HloInstruction* instruction) override {
+    const double flops = cost_analysis_->flop_count(*instruction);
+    const double transcendentals =
+        cost_analysis_->transcendental_count(*instruction);
+    const double bytes_accessed = cost_analysis_->bytes_accessed(*instruction);
+
+    // Cycles of a single task to do all the compute of 'instruction'.
+    double compute_cycles;
+    auto it = profile_.ops_per_cycle().find(
+        std::string(HloOpcodeString(instruction->opcode())));
+    if (it != profile_.ops_per_cycle().end() && it->second > 0) {
+      compute_cycles = (flops + transcendentals) / it->second;
+    } else {
+      compute_cycles = flops / profile_.flops_per_cycle() +
+                       transcendentals / profile_.transcendentals_per_cycle();
+    }
+
+    int64_t best_task_count = 1;
+    double best_latency = std::numeric_limits<double>::infinity();
+    for (int64_t n = 1; n <= max_parallelism_; ++n) {
+      double bandwidth = n * profile_.bytes_per_cycle();
+      if (profile_.max_bytes_per_cycle() > 0) {
+        bandwidth = std::min(bandwidth, profile_.max_bytes_per_cycle());
+      }
+      const double latency =
+          (n - 1) * profile_.task_launch_cycles() +
+          std::max(compute_cycles / n, bytes_accessed / bandwidth);
+      if (latency < best_latency) {
+        best_latency = latency;
+        best_task_count = n;
+      }
+    }
+
+    VLOG(3) << "Calibrated parallel task count for " << instruction->name()
+            << ": " << best_task_count << " (estimated " << best_latency
+            << " cycles)";
+    return best_task_count;
+  }
+
+ private:
+  const int64_t max_parallelism_;
+  const ParallelCostProfile profile_;
+  const std::unique_ptr<HloCostAnalysis> cost_analysis_;
+};
+
+absl::StatusOr<ParallelCostProfile> LoadParallelCostProfile(
+    absl::string_view path) {
+  ParallelCostProfile profile;
+  TF_RETURN_IF_ERROR(tsl::ReadTextOrBinaryProto(tsl::Env::Default(),
+                                                std::string(path), &profile));
+  if (profile.bytes_per_cycle() <= 0 || profile.flops_per_cycle() <= 0 ||
+      profile.transcendentals_per_cycle() <= 0 ||
+      profile.task_launch_cycles() < 0) {
+    return InvalidArgument(
+        "Parallel cost profile %s must have positive bytes, flops and "
+        "transcendentals per cycle and non-negative task launch cycles",
+        path);
+  }
+  return profile;
+}
+
 ParallelTaskAssignment::ParallelTaskAssignment(
     const int64_t max_parallelism,
     const HloCostAnalysis::ShapeSizeFunction& shape_size, HloModule* module,
@@ -135,6 +217,22 @@ ParallelTaskAssignment::ParallelTaskAssignment(
   HloComputation* computation = module->entry_computation();
   absl::Status status =
       computation->root_instruction()->Accept(cost_analysis.get());
+
+  // Use the calibrated cost model if the module has a profile of the host.
+  const std::string& profile_path =
+      module->config().debug_options().xla_cpu_parallel_cost_profile();
+  if (status.ok() && !profile_path.empty()) {
+    absl::StatusOr<ParallelCostProfile> profile =
+        LoadParallelCostProfile(profile_path);
+    if (profile.ok()) {
+      cost_model_ = std::make_unique<CalibratedCostModel>(
+          max_parallelism, *std::move(profile), std::move(cost_analysis));
+      return;
+    }
+    LOG(WARNING) << "Failed to load parallel cost profile: "
+                 << profile.status() << ". Using the default cost model.";
+  }
+
   if (status.ok()) {
     // Set default cost model based on 'cost_analysis'.
     cost_model_ = std::make_unique<DefaultCostModel>(
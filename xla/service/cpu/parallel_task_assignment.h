@@ -28,6 +28,7 @@ limitations under the License.
 #include "xla/hlo/ir/hlo_instruction.h"
 #include "xla/hlo/ir/hlo_module.h"
 #include "xla/hlo/pass/hlo_pass_interface.h"
+#include "xla/service/cpu/parallel_cost_profile.pb.h"
 #include "xla/service/hlo_cost_analysis.h"
 #include "xla/util.h"
 
@@ -41,7 +42,16 @@ class ParallelCostModel {
   virtual int64_t GetParallelTaskCount(HloInstruction* instruction) = 0;
 };
 
+// Reads a ParallelCostProfile from a text or binary proto file at 'path' and
+// checks that it has all rates required by the calibrated cost model.
+absl::StatusOr<ParallelCostProfile> LoadParallelCostProfile(
+    absl::string_view path);
+
 // ParallelTaskAssignment computes parallel task counts for HLOs in 'module'.
+//
+// If the module enables `xla_cpu_parallel_cost_profile`, task counts minimize
+// the latency estimated from the measured throughput of the host. Otherwise
+// they are derived from HloCostAnalysis with fixed thresholds.
 class ParallelTaskAssignment {
  public:
   // 'max_parallelism': the maximum parallel task count per instruction.
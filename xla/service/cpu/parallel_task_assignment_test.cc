@@ -25,10 +25,14 @@ limitations under the License.
 #include "xla/hlo/ir/hlo_opcode.h"
 #include "xla/service/cpu/backend_config.pb.h"
 #include "xla/service/cpu/cpu_executable.h"
+#include "xla/service/cpu/parallel_cost_profile.pb.h"
 #include "xla/service/cpu/target_machine_features_stub.h"
 #include "xla/service/hlo_cost_analysis.h"
 #include "xla/test.h"
 #include "xla/tests/hlo_test_base.h"
+#include "xla/tsl/lib/core/status_test_util.h"
+#include "tsl/platform/env.h"
+#include "tsl/platform/path.h"
 #include "tsl/platform/statusor.h"
 
 namespace xla {
@@ -53,6 +57,40 @@ class ParallelTaskAssignmentTest : public HloTestBase {
         .Run(module);
   }
 
+  // Writes `profile` to a file and enables it in the config of `module`.
+  void SetParallelCostProfile(HloModule* module,
+                              const cpu::ParallelCostProfile& profile) {
+    std::string path = tsl::io::JoinPath(tsl::testing::TmpDir(),
+                                         "parallel_cost_profile.pbtxt");
+    TF_ASSERT_OK(tsl::WriteTextProto(tsl::Env::Default(), path, profile));
+    module->mutable_config()
+        .mutable_debug_options()
+        .set_xla_cpu_parallel_cost_profile(path);
+  }
+
+  // A host where a single core gets half of the memory bandwidth.
+  static cpu::ParallelCostProfile TestProfile() {
+    cpu::ParallelCostProfile profile;
+    profile.set_bytes_per_cycle(8);
+    profile.set_max_bytes_per_cycle(16);
+    profile.set_flops_per_cycle(8);
+    profile.set_transcendentals_per_cycle(0.5);
+    profile.set_task_launch_cycles(1000);
+    return profile;
+  }
+
+  // Returns the total number of partitions assigned to the instruction with
+  // `opcode`, or 1 if it was not partitioned.
+  int64_t GetPartitionCount(HloModule* module, HloOpcode opcode) {
+    auto backend_config =
+        FindInstruction(module, opcode)->backend_config<cpu::BackendConfig>();
+    int64_t count = 1;
+    for (int64_t partitions : backend_config->outer_dimension_partitions()) {
+      count *= partitions;
+    }
+    return count;
+  }
+
   const HloCostAnalysis::ShapeSizeFunction shape_size_func_ =
       cpu::CpuExecutable::ShapeSizeBytes;
 };
@@ -245,5 +283,63 @@ TEST_F(ParallelTaskAssignmentTest, ConstantNotParallelized) {
   EXPECT_FALSE(changed);
 }
 
+TEST_F(ParallelTaskAssignmentTest, CalibratedMemoryBoundInstruction) {
+  constexpr char hlo_string[] = R"(
+    HloModule m
+    ENTRY e {
+      p0 = f32[1048576] parameter(0)
+      p1 = f32[1048576] parameter(1)
+      ROOT add = f32[1048576] add(p0, p1)
+    }
+  )";
+
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<HloModule> m,
+                          ParseAndReturnVerifiedModule(hlo_string));
+  SetParallelCostProfile(m.get(), TestProfile());
+  TF_ASSERT_OK_AND_ASSIGN(bool changed, RunParallelTaskAssigner(m.get()));
+  EXPECT_TRUE(changed);
+
+  // Two tasks saturate the memory bandwidth, more tasks only add overhead.
+  EXPECT_EQ(GetPartitionCount(m.get(), HloOpcode::kAdd), 2);
+}
+
+TEST_F(ParallelTaskAssignmentTest, CalibratedComputeBoundInstruction) {
+  constexpr char hlo_string[] = R"(
+    HloModule m
+    ENTRY e {
+      p0 = f32[1048576] parameter(0)
+      ROOT exp = f32[1048576] exponential(p0)
+    }
+  )";
+
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<HloModule> m,
+                          ParseAndReturnVerifiedModule(hlo_string));
+  SetParallelCostProfile(m.get(), TestProfile());
+  TF_ASSERT_OK_AND_ASSIGN(bool changed, RunParallelTaskAssigner(m.get()));
+  EXPECT_TRUE(changed);
+
+  // Compute scales up to the point where the instruction becomes memory bound.
+  EXPECT_EQ(GetPartitionCount(m.get(), HloOpcode::kExp), 4);
+
+  // A measured rate for the opcode takes precedence over the default rates.
+  TF_ASSERT_OK_AND_ASSIGN(m, ParseAndReturnVerifiedModule(hlo_string));
+  cpu::ParallelCostProfile profile = TestProfile();
+  (*profile.mutable_ops_per_cycle())["exponential"] = 2;
+  SetParallelCostProfile(m.get(), profile);
+  TF_ASSERT_OK_AND_ASSIGN(changed, RunParallelTaskAssigner(m.get()));
+  EXPECT_TRUE(changed);
+  EXPECT_EQ(GetPartitionCount(m.get(), HloOpcode::kExp), 2);
+}
+
+TEST_F(ParallelTaskAssignmentTest, InvalidParallelCostProfile) {
+  cpu::ParallelCostProfile profile = TestProfile();
+  profile.set_bytes_per_cycle(0);
+  std::string path =
+      tsl::io::JoinPath(tsl::testing::TmpDir(), "invalid_profile.pbtxt");
+  TF_ASSERT_OK(tsl::WriteTextProto(tsl::Env::Default(), path, profile));
+  EXPECT_FALSE(cpu::LoadParallelCostProfile(path).ok());
+  EXPECT_FALSE(cpu::LoadParallelCostProfile(path + ".missing").ok());
+}
+
 }  // namespace
 }  // namespace xla
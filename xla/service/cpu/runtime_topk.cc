@@ -17,58 +17,185 @@ limitations under the License.
 
 #include <algorithm>
 #include <cstdint>
-#include <cstring>
-#include <limits>
-#include <numeric>
+#include <functional>
+#include <type_traits>
 #include <vector>
 
 #include "absl/base/attributes.h"
 #include "absl/base/casts.h"
 #include "absl/base/dynamic_annotations.h"
 
+namespace {
+
+// Unsigned integer type with the same width as the floating point type `T`.
+template <typename T>
+using BitsOf = std::conditional_t<sizeof(T) == 4, uint32_t, uint16_t>;
+
+// Maps the bits of a floating point value to an unsigned integer, so that
+// integer comparison implements the total order of the original values:
+// -NaN < -Inf < -0 < +0 < +Inf < +NaN. Negative values get all bits flipped,
+// positive values get only the sign bit flipped. The mapping is branchless, so
+// loops over it vectorize well.
+template <typename Bits>
+inline Bits ToOrderedKey(Bits bits) {
+  constexpr int kSignShift = sizeof(Bits) * 8 - 1;
+  Bits sign_mask = static_cast<Bits>(Bits{0} - (bits >> kSignShift));
+  return static_cast<Bits>(bits ^ (sign_mask | (Bits{1} << kSignShift)));
+}
+
+// Top-k candidates are packed into 64-bit integers with the ordered key in the
+// high bits and the inverted index in the low bits, so that a single integer
+// comparison orders candidates by larger value first and by smaller index for
+// equal values.
+inline uint64_t PackCandidate(uint32_t key, int64_t index) {
+  return (uint64_t{key} << 32) | (0xFFFFFFFFu - static_cast<uint32_t>(index));
+}
+
+inline int32_t CandidateIndex(uint64_t candidate) {
+  return static_cast<int32_t>(0xFFFFFFFFu - static_cast<uint32_t>(candidate));
+}
+
+inline uint32_t CandidateKey(uint64_t candidate) {
+  return static_cast<uint32_t>(candidate >> 32);
+}
+
+// Replaces the smallest candidate in a binary min-heap with `candidate` and
+// restores the heap property. This is a single sift down instead of the pop
+// and push pair required by the standard heap algorithms.
+void ReplaceHeapTop(uint64_t* heap, int64_t size, uint64_t candidate) {
+  int64_t pos = 0;
+  while (true) {
+    int64_t child = 2 * pos + 1;
+    if (child >= size) break;
+    if (child + 1 < size && heap[child + 1] < heap[child]) ++child;
+    if (candidate <= heap[child]) break;
+    heap[pos] = heap[child];
+    pos = child;
+  }
+  heap[pos] = candidate;
+}
+
+// If `k` is a large fraction of the input, selecting from all candidates is
+// cheaper than maintaining a heap, as most of the elements end up being heap
+// insertions anyway.
+constexpr int64_t kSelectRatio = 8;
+
+// Number of elements tested against the heap threshold at once. The test is
+// a branchless reduction over the block that compilers vectorize, and only
+// blocks with at least one element above the threshold are inserted into the
+// heap one by one.
+constexpr int64_t kFilterBlockSize = 64;
+
+// Writes top `k` candidates for a row of `input_size` values to `candidates`
+// sorted from the best to the worst candidate.
+template <typename T>
+void SelectTopK(int64_t input_size, int64_t k, const T* values,
+                std::vector<uint64_t>& candidates) {
+  using Bits = BitsOf<T>;
+
+  candidates.resize(input_size);
+  for (int64_t i = 0; i < input_size; ++i) {
+    candidates[i] =
+        PackCandidate(ToOrderedKey(absl::bit_cast<Bits>(values[i])), i);
+  }
+
+  auto kth = candidates.begin() + k;
+  if (k < input_size) {
+    std::nth_element(candidates.begin(), kth - 1, candidates.end(),
+                     std::greater<>());
+  }
+  std::sort(candidates.begin(), kth, std::greater<>());
+}
+
 template <typename T>
-static void TopK(int64_t batch_size, int64_t input_size, int64_t k,
-                 const T* values, T* out_values, int32_t* out_indices) {
+void HeapTopK(int64_t input_size, int64_t k, const T* values,
+              std::vector<uint64_t>& candidates) {
+  using Bits = BitsOf<T>;
+
+  // Seed the heap with the first `k` elements.
+  candidates.resize(k);
+  for (int64_t i = 0; i < k; ++i) {
+    candidates[i] =
+        PackCandidate(ToOrderedKey(absl::bit_cast<Bits>(values[i])), i);
+  }
+  std::make_heap(candidates.begin(), candidates.end(), std::greater<>());
+
+  // Elements are visited in the increasing index order, so an element with a
+  // key equal to the threshold always loses to the heap top, and it's enough
+  // to check for keys strictly above the threshold.
+  uint64_t* heap = candidates.data();
+  Bits threshold = static_cast<Bits>(CandidateKey(heap[0]));
+
+  for (int64_t i = k; i < input_size; i += kFilterBlockSize) {
+    int64_t block_end = std::min(i + kFilterBlockSize, input_size);
+
+    int32_t num_above = 0;
+    for (int64_t j = i; j < block_end; ++j) {
+      num_above += ToOrderedKey(absl::bit_cast<Bits>(values[j])) > threshold;
+    }
+    if (num_above == 0) continue;
+
+    for (int64_t j = i; j < block_end; ++j) {
+      Bits key = ToOrderedKey(absl::bit_cast<Bits>(values[j]));
+      if (key > threshold) {
+        ReplaceHeapTop(heap, k, PackCandidate(key, j));
+        threshold = static_cast<Bits>(CandidateKey(heap[0]));
+      }
+    }
+  }
+
+  std::sort_heap(candidates.begin(), candidates.end(), std::greater<>());
+}
+
+template <typename T>
+void TopK(int64_t batch_size, int64_t input_size, int64_t k, const T* values,
+          T* out_values, int32_t* out_indices) {
   // 'values' is managed by the JIT code, so msan can't tell they are
   // initialized.
   ABSL_ANNOTATE_MEMORY_IS_INITIALIZED(values,
                                       input_size * batch_size * sizeof(T));
-  static constexpr auto convert_to_int = [](T value) {
-    uint32_t x = absl::bit_cast<uint32_t>(value);
-    return static_cast<int32_t>(x) < 0 ? std::numeric_limits<int32_t>::max() - x
-                                       : x;
-  };
+  if (k == 0) return;
 
-  std::vector<int32_t> temp_indices(input_size);
-  for (int64_t batch = 0; batch != batch_size; ++batch) {
-    std::iota(temp_indices.begin(), temp_indices.end(), 0);
+  // Candidates buffer is reused for all rows in a batch.
+  std::vector<uint64_t> candidates;
 
+  for (int64_t batch = 0; batch != batch_size; ++batch) {
     const T* values_batch = values + batch * input_size;
 
-    auto kth_element = temp_indices.begin() + k;
-    std::partial_sort(temp_indices.begin(), kth_element, temp_indices.end(),
-                      [values_batch](size_t i1, size_t i2) {
-                        // Do the comparison in integers to enforce a total
-                        // order of -NaN < -Inf < -0 < +0 < +Inf < +NaN.
-                        int32_t v1 = convert_to_int(values_batch[i1]);
-                        int32_t v2 = convert_to_int(values_batch[i2]);
-                        if (v1 == v2) {
-                          return i1 < i2;  // Stabilize sorting.
-                        }
-                        return v1 > v2;
-                      });
+    if (k * kSelectRatio >= input_size) {
+      SelectTopK(input_size, k, values_batch, candidates);
+    } else {
+      HeapTopK(input_size, k, values_batch, candidates);
+    }
 
     T* out_values_batch = out_values + batch * k;
     int32_t* out_indices_batch = out_indices + batch * k;
-    std::copy(temp_indices.begin(), kth_element, out_indices_batch);
-    for (int64_t i = 0; i < k; i++) {
-      out_values_batch[i] = values_batch[temp_indices[i]];
+    for (int64_t i = 0; i < k; ++i) {
+      int32_t index = CandidateIndex(candidates[i]);
+      out_indices_batch[i] = index;
+      out_values_batch[i] = values_batch[index];
     }
   }
 }
 
+}  // namespace
+
 ABSL_ATTRIBUTE_NO_SANITIZE_MEMORY void __xla_cpu_runtime_TopKF32(
     int64_t batch_size, int64_t input_size, int64_t k, const float* values,
     float* out_values, int32_t* out_indices) {
   TopK(batch_size, input_size, k, values, out_values, out_indices);
 }
+
+// F16 and BF16 share the sign-magnitude layout of F32, so the ordered keys of
+// both formats can be computed from the raw bits alone.
+ABSL_ATTRIBUTE_NO_SANITIZE_MEMORY void __xla_cpu_runtime_TopKF16(
+    int64_t batch_size, int64_t input_size, int64_t k, const uint16_t* values,
+    uint16_t* out_values, int32_t* out_indices) {
+  TopK(batch_size, input_size, k, values, out_values, out_indices);
+}
+
+ABSL_ATTRIBUTE_NO_SANITIZE_MEMORY void __xla_cpu_runtime_TopKBF16(
+    int64_t batch_size, int64_t input_size, int64_t k, const uint16_t* values,
+    uint16_t* out_values, int32_t* out_indices) {
+  TopK(batch_size, input_size, k, values, out_values, out_indices);
+}
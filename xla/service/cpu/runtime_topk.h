@@ -21,10 +21,23 @@ limitations under the License.
 extern "C" {
 
 // Calculates `batch_size` topk operations with `input_size` inputs each. The
-// outputs are written to `out_values` and `out_indices`.
+// outputs are written to `out_values` and `out_indices`. Values are compared
+// in the total order -NaN < -Inf < -0 < +0 < +Inf < +NaN, and equal values are
+// ordered by their index. F16 and BF16 values are passed as their raw bits and
+// compared natively, without converting them to F32.
 extern void __xla_cpu_runtime_TopKF32(int64_t batch_size, int64_t input_size,
                                       int64_t k, const float* values,
                                       float* out_values, int32_t* out_indices);
+
+extern void __xla_cpu_runtime_TopKF16(int64_t batch_size, int64_t input_size,
+                                      int64_t k, const uint16_t* values,
+                                      uint16_t* out_values,
+                                      int32_t* out_indices);
+
+extern void __xla_cpu_runtime_TopKBF16(int64_t batch_size, int64_t input_size,
+                                       int64_t k, const uint16_t* values,
+                                       uint16_t* out_values,
+                                       int32_t* out_indices);
 }
 
 #endif  // XLA_SERVICE_CPU_RUNTIME_TOPK_H_
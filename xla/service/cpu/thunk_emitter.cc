@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "xla/service/cpu/thunk_emitter.h"
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <memory>
@@ -65,10 +66,12 @@ limitations under the License.
 #include "xla/service/buffer_assignment.h"
 #include "xla/service/collective_ops_utils.h"
 #include "xla/service/cpu/backend_config.pb.h"
+#include "xla/service/cpu/cpu_options.h"
 #include "xla/service/cpu/dot_op_emitter.h"
 #include "xla/service/cpu/ir_emission_utils.h"
 #include "xla/service/cpu/ir_emitter2.h"
 #include "xla/service/hlo.pb.h"
+#include "xla/service/hlo_cost_analysis.h"
 #include "xla/service/hlo_module_config.h"
 #include "xla/service/pattern_matcher.h"
 #include "xla/shape.h"
@@ -85,18 +88,39 @@ namespace xla::cpu {
 ThunkEmitter::ThunkEmitter(IrEmitter2& ir_emitter,
                            const BufferAssignment& buffer_assignment,
                            const TargetMachineFeatures& target_machine_features,
-                           const HloModuleConfig& hlo_module_config)
+                           const HloModuleConfig& hlo_module_config,
+                           const HloCostAnalysis* cost_analysis)
     : ir_emitter_(ir_emitter),
       buffer_assignment_(buffer_assignment),
       target_machine_features_(target_machine_features),
       hlo_module_config_(hlo_module_config),
+      cost_analysis_(cost_analysis),
       communicator_resource_(
           Resource::Create(Resource::kCollectiveCommunicator)) {}
 
-static Thunk::Info ThunkInfo(const HloInstruction* instruction) {
+// Returns the estimated execution time of the instruction in nanoseconds on a
+// single CPU core. This is a very rough roofline-style estimate that is only
+// used to compare thunks with each other, so we don't try to be precise.
+static int64_t EstimateCostNs(const HloCostAnalysis& cost_analysis,
+                              const HloInstruction* instruction) {
+  static constexpr double kFlopsPerNs = 16.0;
+  static constexpr double kBytesPerNs = 8.0;
+  static constexpr double kTranscendentalsPerNs = 1.0;
+
+  double compute_ns =
+      cost_analysis.flop_count(*instruction) / kFlopsPerNs +
+      cost_analysis.transcendental_count(*instruction) / kTranscendentalsPerNs;
+  double memory_ns = cost_analysis.bytes_accessed(*instruction) / kBytesPerNs;
+
+  return static_cast<int64_t>(std::max(compute_ns, memory_ns));
+}
+
+Thunk::Info ThunkEmitter::ThunkInfo(const HloInstruction* instruction) const {
   const HloModule* module = instruction->GetModule();
-  return Thunk::Info{std::string(instruction->name()),
-                     std::string(module->name()), module->unique_id()};
+  return Thunk::Info{
+      std::string(instruction->name()), std::string(module->name()),
+      module->unique_id(),
+      cost_analysis_ ? EstimateCostNs(*cost_analysis_, instruction) : 0};
 }
 
 absl::StatusOr<ThunkSequence> ThunkEmitter::EmitEntryComputation(
@@ -520,7 +544,7 @@ absl::StatusOr<ThunkSequence> ThunkEmitter::EmitConcatenateKernelThunk(
 
   return MakeKernelThunkSequence(
       instruction, buffers, kernel,
-      /*min_alignment=*/cpu_function_runtime::MinAlign());
+      /*min_alignment=*/GetMinAlignment(buffers));
 }
 
 absl::StatusOr<ThunkSequence> ThunkEmitter::EmitGetDimensionSizeThunk(
@@ -613,7 +637,7 @@ absl::StatusOr<ThunkSequence> ThunkEmitter::EmitElementalKernelThunk(
 
   return MakeKernelThunkSequence(
       instruction, buffers, kernel,
-      /*min_alignment=*/cpu_function_runtime::MinAlign());
+      /*min_alignment=*/GetMinAlignment(buffers));
 }
 
 absl::StatusOr<ThunkSequence> ThunkEmitter::EmitPadKernelThunk(
@@ -624,7 +648,7 @@ absl::StatusOr<ThunkSequence> ThunkEmitter::EmitPadKernelThunk(
 
   return MakeKernelThunkSequence(
       padInstr, buffers, kernel,
-      /*min_alignment=*/cpu_function_runtime::MinAlign());
+      /*min_alignment=*/GetMinAlignment(buffers));
 }
 
 absl::StatusOr<ThunkSequence> ThunkEmitter::EmitFusionKernelThunk(
@@ -635,7 +659,7 @@ absl::StatusOr<ThunkSequence> ThunkEmitter::EmitFusionKernelThunk(
 
   return MakeKernelThunkSequence(
       instruction, buffers, kernel,
-      /*min_alignment=*/cpu_function_runtime::MinAlign());
+      /*min_alignment=*/GetMinAlignment(buffers));
 }
 
 absl::StatusOr<ThunkSequence> ThunkEmitter::EmitReductionKernelThunk(
@@ -646,7 +670,7 @@ absl::StatusOr<ThunkSequence> ThunkEmitter::EmitReductionKernelThunk(
 
   return MakeKernelThunkSequence(
       instruction, buffers, kernel,
-      /*min_alignment=*/cpu_function_runtime::MinAlign());
+      /*min_alignment=*/GetMinAlignment(buffers));
 }
 
 absl::StatusOr<ThunkSequence> ThunkEmitter::EmitRngThunk(
@@ -824,8 +848,10 @@ absl::StatusOr<ThunkSequence> ThunkEmitter::EmitTopKThunk(
     const HloCustomCallInstruction* custom_call) {
   const auto& result_shape = custom_call->shape();
   const HloInstruction* input = custom_call->operand(0);
-  TF_RET_CHECK(input->shape().element_type() == F32)
-      << "TopK expects F32 data type for input";
+  const PrimitiveType element_type = input->shape().element_type();
+  TF_RET_CHECK(element_type == F32 || element_type == F16 ||
+               element_type == BF16)
+      << "TopK expects F32, F16 or BF16 data type for input";
   TF_RET_CHECK(LayoutUtil::IsMonotonicWithDim0Major(
       result_shape.tuple_shapes(0).layout()))
       << custom_call->ToString();
@@ -848,9 +874,9 @@ absl::StatusOr<ThunkSequence> ThunkEmitter::EmitTopKThunk(
                       GetAllocationSlice(custom_call, {0}));
   TF_ASSIGN_OR_RETURN(BufferAllocation::Slice output_slice,
                       GetAllocationSlice(custom_call, {1}));
-  return ThunkSequence::Of<TopKThunk>(ThunkInfo(custom_call), values_slice,
-                                      indices_slice, output_slice, batch_size,
-                                      input_size, k);
+  return ThunkSequence::Of<TopKThunk>(ThunkInfo(custom_call), element_type,
+                                      values_slice, indices_slice, output_slice,
+                                      batch_size, input_size, k);
 }
 
 absl::StatusOr<ThunkSequence> ThunkEmitter::EmitReplicaIdThunk(
@@ -993,7 +1019,7 @@ absl::StatusOr<ThunkSequence> ThunkEmitter::EmitSliceToDynamicThunk(
 
   return MakeKernelThunkSequence(
       instruction, buffers, kernel,
-      /*min_alignment=*/cpu_function_runtime::MinAlign());
+      /*min_alignment=*/GetMinAlignment(buffers));
 }
 
 absl::StatusOr<ThunkSequence> ThunkEmitter::EmitSliceThunk(
@@ -1125,6 +1151,22 @@ ThunkEmitter::GetHostKernelAllocationSlices(const HloInstruction* instruction) {
   return slices;
 }
 
+uint64_t ThunkEmitter::GetMinAlignment(
+    const HostKernelAllocationSlices& buffers) const {
+  uint64_t min_alignment = cpu_function_runtime::MinAlign();
+  auto update = [&](absl::Span<const BufferAllocation::Slice> slices) {
+    for (const BufferAllocation::Slice& slice : slices) {
+      if (slice.allocation()->is_entry_computation_parameter()) {
+        min_alignment = std::min<uint64_t>(
+            min_alignment, options::ParameterAlignment(hlo_module_config_));
+      }
+    }
+  };
+  update(buffers.arguments);
+  update(buffers.results);
+  return min_alignment;
+}
+
 absl::Status ThunkEmitter::ElementTypesSameAndSupported(
     const HloInstruction& instruction,
     absl::Span<const HloInstruction* const> operands,
@@ -35,6 +35,7 @@ limitations under the License.
 #include "xla/hlo/ir/hlo_module.h"
 #include "xla/service/buffer_assignment.h"
 #include "xla/service/cpu/ir_emitter2.h"
+#include "xla/service/hlo_cost_analysis.h"
 #include "xla/service/hlo_module_config.h"
 #include "xla/shape_util.h"
 #include "xla/xla_data.pb.h"
@@ -50,10 +51,13 @@ namespace xla::cpu {
 // multiple LLVM modules compiled to object files).
 class ThunkEmitter {
  public:
+  // If `cost_analysis` is not null, thunk emitter uses it to estimate thunk
+  // execution times (see `Thunk::Info::estimated_cost_ns`).
   ThunkEmitter(IrEmitter2& ir_emitter,
                const BufferAssignment& buffer_assignment,
                const TargetMachineFeatures& target_machine_features,
-               const HloModuleConfig& hlo_module_config);
+               const HloModuleConfig& hlo_module_config,
+               const HloCostAnalysis* cost_analysis = nullptr);
 
   // Emits HLO module entry computation as a sequence of thunks.
   absl::StatusOr<ThunkSequence> EmitEntryComputation(const HloModule& module);
@@ -64,6 +68,9 @@ class ThunkEmitter {
     std::vector<BufferAllocation::Slice> results;
   };
 
+  // Returns thunk info for the thunk emitted for the given instruction.
+  Thunk::Info ThunkInfo(const HloInstruction* instruction) const;
+
   std::optional<SortThunk::SortDirection> MatchSortDirection(
       const HloComputation* hlo_comparator) const;
 
@@ -192,6 +199,11 @@ class ThunkEmitter {
   absl::StatusOr<HostKernelAllocationSlices> GetHostKernelAllocationSlices(
       const HloInstruction* instruction);
 
+  // Returns the alignment that the host kernel can assume for all of the given
+  // buffers: entry computation parameters might be less aligned than buffers
+  // allocated by XLA (see `xla_cpu_parameter_alignment`).
+  uint64_t GetMinAlignment(const HostKernelAllocationSlices& buffers) const;
+
   // Verifies that the element types of all of the given operand instructions
   // match and are of one of the given supported types.
   absl::Status ElementTypesSameAndSupported(
@@ -211,6 +223,7 @@ class ThunkEmitter {
 
   const TargetMachineFeatures& target_machine_features_;
   const HloModuleConfig& hlo_module_config_;
+  const HloCostAnalysis* cost_analysis_;
 
   // A global resource that is used to order all collective operations.
   std::shared_ptr<Resource> communicator_resource_;
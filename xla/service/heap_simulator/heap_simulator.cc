@@ -39,6 +39,7 @@ limitations under the License.
 #include "absl/functional/any_invocable.h"
 #include "absl/log/check.h"
 #include "absl/log/log.h"
+#include "absl/numeric/bits.h"
 #include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_join.h"
@@ -1041,6 +1042,64 @@ int64_t BufferIntervalTree::HeapSizeInInterval(const int64_t start,
   return max_memory_used;
 }
 
+BufferIntervalSegmentTree::BufferIntervalSegmentTree(int64_t num_times)
+    : num_leaves_(absl::bit_ceil(static_cast<uint64_t>(
+          std::max<int64_t>(num_times, 1)))),
+      subtree_end_(2 * num_leaves_, -1),
+      buckets_(num_times) {}
+
+void BufferIntervalSegmentTree::Add(int64_t start, int64_t end,
+                                    const Chunk& chunk) {
+  // Buffers that are never freed have an end time of -1. Like in
+  // BufferIntervalTree, they don't overlap with any time interval.
+  if (end < start) {
+    return;
+  }
+  CHECK_GE(start, 0);
+  CHECK_LT(end, static_cast<int64_t>(buckets_.size()));
+
+  buckets_[start].emplace(end, chunk);
+
+  for (int64_t node = num_leaves_ + start; node >= 1; node /= 2) {
+    if (subtree_end_[node] >= end) {
+      break;
+    }
+    subtree_end_[node] = end;
+  }
+}
+
+std::vector<Chunk> BufferIntervalSegmentTree::ChunksOverlappingInTime(
+    int64_t start, int64_t end) const {
+  std::vector<Chunk> chunks;
+  end = std::min<int64_t>(end, buckets_.size() - 1);
+  if (start <= end) {
+    CollectChunks(/*node=*/1, /*node_start=*/0, /*node_size=*/num_leaves_,
+                  start, end, chunks);
+  }
+  return chunks;
+}
+
+void BufferIntervalSegmentTree::CollectChunks(
+    int64_t node, int64_t node_start, int64_t node_size, int64_t start,
+    int64_t end, std::vector<Chunk>& chunks) const {
+  if (node_start > end || subtree_end_[node] < start) {
+    return;
+  }
+  if (node_size == 1) {
+    for (const auto& [buffer_end, chunk] : buckets_[node_start]) {
+      if (buffer_end < start) {
+        break;
+      }
+      chunks.push_back(chunk);
+    }
+    return;
+  }
+  int64_t child_size = node_size / 2;
+  CollectChunks(2 * node, node_start, child_size, start, end, chunks);
+  CollectChunks(2 * node + 1, node_start + child_size, child_size, start, end,
+                chunks);
+}
+
 template <typename BufferType>
 std::string
 GlobalDecreasingSizeBestFitHeap<BufferType>::BufferInterval::ToString() const {
@@ -2292,6 +2351,15 @@ GlobalDecreasingSizeBestFitHeap<BufferType>::Finish() {
   std::vector<BufferInterval> sorted_buffer_intervals =
       GetSortedBufferIntervals();
 
+  // All buffers are known at this point, so we can index the committed chunks
+  // over a fixed time range, which is much faster than interval_tree_ for
+  // large numbers of buffers.
+  int64_t num_times = 0;
+  for (const auto& entry : buffer_intervals_) {
+    num_times = std::max(num_times, entry.second.end + 1);
+  }
+  segment_tree_.emplace(num_times);
+
   for (auto& buffer_interval : sorted_buffer_intervals) {
     if (!buffer_interval.need_allocation) {
       continue;
@@ -2301,6 +2369,7 @@ GlobalDecreasingSizeBestFitHeap<BufferType>::Finish() {
     // maximum heap size, so it just commits.
     CommitChunk(buffer_interval, FindChunkCandidate(buffer_interval));
   }
+  segment_tree_.reset();
   VLOG(1) << "result heap_size: " << result_.heap_size;
   Result result;
   result.heap_size = result_.heap_size;
@@ -2380,8 +2449,8 @@ GlobalDecreasingSizeBestFitHeap<BufferType>::MakeFreeChunks(
     }
   };
 
-  subtract_used_chunks(interval_tree_.ChunksOverlappingInTime(
-      buffer_interval.start, buffer_interval.end));
+  subtract_used_chunks(
+      ChunksOverlappingInTime(buffer_interval.start, buffer_interval.end));
 
   for (const BufferType* colocation :
        GetTransitiveColocations(buffer_interval)) {
@@ -2389,8 +2458,7 @@ GlobalDecreasingSizeBestFitHeap<BufferType>::MakeFreeChunks(
     VLOG(1) << "  Alias size " << interval.size << ", start " << interval.start
             << ", end " << interval.end << " " << interval.buffer->ToString();
 
-    subtract_used_chunks(
-        interval_tree_.ChunksOverlappingInTime(interval.start, interval.end));
+    subtract_used_chunks(ChunksOverlappingInTime(interval.start, interval.end));
   }
 
   return free_chunks;
@@ -2488,7 +2556,7 @@ void GlobalDecreasingSizeBestFitHeap<BufferType>::CommitChunk(
     GlobalDecreasingSizeBestFitHeap<BufferType>::Chunk chunk) {
   CHECK_EQ(chunk.size, buffer_interval.size);
   result_.heap_size = result_.UpdatedHeapSize(chunk);
-  interval_tree_.Add(buffer_interval.start, buffer_interval.end, chunk);
+  AddToIntervalIndex(buffer_interval.start, buffer_interval.end, chunk);
   for (auto colocation : GetTransitiveColocations(buffer_interval)) {
     auto colocation_interval = buffer_intervals_[colocation];
     // Create a colocation chunk with the same offset but with the correct size
@@ -2496,7 +2564,7 @@ void GlobalDecreasingSizeBestFitHeap<BufferType>::CommitChunk(
     Chunk colocation_chunk =
         Chunk::FromOffsetSize(chunk.offset, colocation_interval.size);
     result_.heap_size = result_.UpdatedHeapSize(colocation_chunk);
-    interval_tree_.Add(colocation_interval.start, colocation_interval.end,
+    AddToIntervalIndex(colocation_interval.start, colocation_interval.end,
                        colocation_chunk);
     AddToChunkMap(colocation, colocation_chunk);
   }
@@ -2504,6 +2572,26 @@ void GlobalDecreasingSizeBestFitHeap<BufferType>::CommitChunk(
   AddToChunkMap(buffer_interval.buffer, chunk);
 }
 
+template <typename BufferType>
+void GlobalDecreasingSizeBestFitHeap<BufferType>::AddToIntervalIndex(
+    int64_t start, int64_t end, const Chunk& chunk) {
+  if (segment_tree_.has_value()) {
+    segment_tree_->Add(start, end, chunk);
+  } else {
+    interval_tree_.Add(start, end, chunk);
+  }
+}
+
+template <typename BufferType>
+std::vector<typename GlobalDecreasingSizeBestFitHeap<BufferType>::Chunk>
+GlobalDecreasingSizeBestFitHeap<BufferType>::ChunksOverlappingInTime(
+    int64_t start, int64_t end) const {
+  if (segment_tree_.has_value()) {
+    return segment_tree_->ChunksOverlappingInTime(start, end);
+  }
+  return interval_tree_.ChunksOverlappingInTime(start, end);
+}
+
 template <typename BufferType>
 void GlobalDecreasingSizeBestFitHeap<BufferType>::AddToChunkMap(
     const BufferType* buffer, Chunk chunk) {
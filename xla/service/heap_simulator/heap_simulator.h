@@ -426,6 +426,56 @@ class BufferIntervalTree {
   std::list<BufferIntervalTreeNode> node_storage_;
 };
 
+// An index of buffers over a fixed range of time steps [0, num_times) that can
+// query buffers overlapping in time, like BufferIntervalTree.
+//
+// BufferIntervalTree is an unbalanced binary search tree keyed by start time.
+// When buffers are added in the order of their start times, which is common
+// for buffers of the same size, it degenerates into a list and each query
+// visits every buffer that starts before the end of the queried interval. This
+// segment tree buckets buffers by start time and keeps the latest end time of
+// the buffers in every subtree, so queries only descend into subtrees that
+// hold an overlapping buffer. A query returning k chunks takes
+// O((k + 1) * log(num_times)) time. Buffers can't be removed.
+class BufferIntervalSegmentTree {
+ public:
+  using Chunk = HeapSimulator::Chunk;
+
+  explicit BufferIntervalSegmentTree(int64_t num_times);
+
+  // Adds a buffer that is live in the time interval [start, end], which must be
+  // within [0, num_times).
+  void Add(int64_t start, int64_t end, const Chunk& chunk);
+
+  // Returns vector of allocated chunks that overlap with the given time
+  // interval, ordered by their start times.
+  std::vector<Chunk> ChunksOverlappingInTime(int64_t start, int64_t end) const;
+
+ private:
+  // Buffers that start at the same time, ordered by decreasing end time so
+  // that queries can stop at the first buffer that ends too early. Buffers
+  // with equal end times keep the order in which they were added. A btree
+  // keeps inserts logarithmic when many buffers share a start time, e.g. all
+  // entry parameters start at time 0.
+  using Bucket = absl::btree_multimap<int64_t, Chunk, std::greater<int64_t>>;
+
+  // Appends the chunks of buffers that start within [node_start, end] and end
+  // at or after `start` to `chunks`. The node covers the time steps
+  // [node_start, node_start + node_size).
+  void CollectChunks(int64_t node, int64_t node_start, int64_t node_size,
+                     int64_t start, int64_t end,
+                     std::vector<Chunk>& chunks) const;
+
+  // Number of leaves, rounded up to a power of two.
+  int64_t num_leaves_;
+  // Latest end time of the buffers that start within the time range of each
+  // node, or -1 if there are none. Node 1 is the root and the children of node
+  // i are nodes 2i and 2i + 1.
+  std::vector<int64_t> subtree_end_;
+  // Buffers bucketed by their start time.
+  std::vector<Bucket> buckets_;
+};
+
 // An iterator that is passed to
 // GlobalDecreasingSizeBestFitHeap::CreateSlicedAllocationFinder() when trying
 // to place a buffer, telling the finder which permutations of starting slice
@@ -953,6 +1003,18 @@ class GlobalDecreasingSizeBestFitHeap : public HeapAlgorithm<BufferType> {
   SliceTimePermutationIterator::Ty slice_time_permutation_iteration_type_ =
       SliceTimePermutationIterator::Ty::kAll;
 
+  // Indexes the chunks committed while Finish() runs. Subclasses with their
+  // own Finish() add chunks to interval_tree_ directly, so outside of Finish()
+  // chunks are kept in interval_tree_ instead.
+  std::optional<BufferIntervalSegmentTree> segment_tree_;
+
+  // Adds a committed chunk to segment_tree_ if it is set and to interval_tree_
+  // otherwise.
+  void AddToIntervalIndex(int64_t start, int64_t end, const Chunk& chunk);
+
+  // Returns committed chunks that overlap with the given time interval.
+  std::vector<Chunk> ChunksOverlappingInTime(int64_t start, int64_t end) const;
+
  protected:
   // Returns all transitive colocated buffers of this buffer interval. I.e., If
   // a buffer A is colocated with B and B is colocated with C, this function
@@ -15,15 +15,19 @@ limitations under the License.
 
 #include "xla/service/heap_simulator/heap_simulator.h"
 
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <memory>
 #include <optional>
+#include <random>
 #include <string>
 #include <tuple>
 #include <utility>
 #include <vector>
 
+#include "absl/algorithm/container.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/inlined_vector.h"
 #include "absl/strings/str_format.h"
@@ -50,6 +54,7 @@ limitations under the License.
 #include "tsl/platform/logging.h"
 #include "tsl/platform/statusor.h"
 #include "tsl/platform/test.h"
+#include "tsl/platform/test_benchmark.h"
 
 namespace xla {
 namespace {
@@ -2097,6 +2102,54 @@ TEST_F(IntervalTreeTest, BufferIntervalTreeHeapSize) {
   EXPECT_THAT(tree.HeapSizeInInterval(25, 26), 16);
 }
 
+TEST_F(IntervalTreeTest, BufferIntervalSegmentTreeMatchesBufferIntervalTree) {
+  BufferIntervalTree tree;
+  BufferIntervalSegmentTree segment_tree(/*num_times=*/32);
+  for (int64_t i = 0; i < 48; ++i) {
+    int64_t start = (i * 7) % 32;
+    int64_t end = std::min<int64_t>(start + (i % 5) * 3, 31);
+    HeapSimulator::Chunk chunk = HeapSimulator::Chunk::FromOffsetSize(i, 1);
+    tree.Add(start, end, chunk);
+    segment_tree.Add(start, end, chunk);
+  }
+  // Buffers that are never freed don't overlap with anything.
+  tree.Add(5, -1, HeapSimulator::Chunk::FromOffsetSize(100, 1));
+  segment_tree.Add(5, -1, HeapSimulator::Chunk::FromOffsetSize(100, 1));
+
+  auto offsets = [](const std::vector<HeapSimulator::Chunk>& chunks) {
+    std::vector<int64_t> offsets;
+    for (const HeapSimulator::Chunk& chunk : chunks) {
+      offsets.push_back(chunk.offset);
+    }
+    absl::c_sort(offsets);
+    return offsets;
+  };
+  for (int64_t start = 0; start < 32; ++start) {
+    for (int64_t end = start; end < 36; ++end) {
+      EXPECT_EQ(offsets(segment_tree.ChunksOverlappingInTime(start, end)),
+                offsets(tree.ChunksOverlappingInTime(start, end)))
+          << "start: " << start << ", end: " << end;
+    }
+  }
+}
+
+TEST_F(IntervalTreeTest, BufferIntervalSegmentTreeSharedStartTime) {
+  // Many buffers starting at the same time, like entry parameters, added in
+  // increasing order of their end times.
+  BufferIntervalSegmentTree segment_tree(/*num_times=*/1024);
+  for (int64_t i = 0; i < 1024; ++i) {
+    segment_tree.Add(0, i, HeapSimulator::Chunk::FromOffsetSize(i, 1));
+  }
+
+  std::vector<HeapSimulator::Chunk> chunks =
+      segment_tree.ChunksOverlappingInTime(1000, 1023);
+  ASSERT_EQ(chunks.size(), 24);
+  // Buffers that start at the same time are returned by decreasing end time.
+  for (int64_t i = 0; i < 24; ++i) {
+    EXPECT_EQ(chunks[i].offset, 1023 - i);
+  }
+}
+
 class SlicedBufferIntervalTest : public ::testing::Test {
  public:
   using HeapTy = GlobalDecreasingSizeBestFitHeap<HloValue>;
@@ -3771,5 +3824,58 @@ TEST_F(SliceTimePermutationIteratorTest, Repacks) {
   }
 }
 
+// Allocates `num_buffers` buffers with sizes drawn from `num_sizes` size
+// classes. After each allocation random buffers are freed until at most
+// kMaxLiveBuffers are live, so most buffers are short-lived like in large
+// models. With a single size class the buffers are committed in the order of
+// their start times.
+void BM_GlobalDecreasingSizeBestFitHeap(::testing::benchmark::State& state) {
+  constexpr int64_t kMaxLiveBuffers = 64;
+  const int64_t num_buffers = state.range(0);
+  const int64_t num_sizes = state.range(1);
+
+  std::minstd_rand rng(42);
+  std::vector<AllocationBlock> blocks(num_buffers);
+  // Allocation and free events, the second element is true for allocations.
+  std::vector<std::pair<AllocationBlock*, bool>> events;
+  std::vector<AllocationBlock*> live;
+  for (int64_t i = 0; i < num_buffers; ++i) {
+    blocks[i].id = i;
+    blocks[i].size = 64 * (1 + rng() % num_sizes);
+    events.push_back({&blocks[i], true});
+    live.push_back(&blocks[i]);
+    size_t max_live = 1 + rng() % kMaxLiveBuffers;
+    while (live.size() > max_live) {
+      std::swap(live[rng() % live.size()], live.back());
+      events.push_back({live.back(), false});
+      live.pop_back();
+    }
+  }
+  for (AllocationBlock* block : live) {
+    events.push_back({block, false});
+  }
+
+  for (auto s : state) {
+    state.PauseTiming();
+    GlobalDecreasingSizeBestFitHeap<AllocationBlock> heap(/*alignment=*/64);
+    for (const auto& [block, is_alloc] : events) {
+      if (is_alloc) {
+        heap.Alloc(block, block->size);
+      } else {
+        heap.Free(block, block->size);
+      }
+    }
+    state.ResumeTiming();
+    CHECK(heap.Finish().ok());
+  }
+  state.SetItemsProcessed(state.iterations() * num_buffers);
+}
+
+BENCHMARK(BM_GlobalDecreasingSizeBestFitHeap)
+    ->ArgPair(100000, 1)
+    ->ArgPair(100000, 16)
+    ->ArgPair(1000000, 1)
+    ->ArgPair(1000000, 16);
+
 }  // namespace
 }  // namespace xla
@@ -222,20 +222,24 @@ struct CseKey {
 
 }  // namespace
 
-absl::StatusOr<bool> HloCSE::Run(
-    HloModule* module,
-    const absl::flat_hash_set<absl::string_view>& execution_threads) {
+absl::StatusOr<bool> HloCSE::RunOnComputation(HloComputation* computation) {
   bool changed = false;
-
-  for (auto* computation : module->computations(execution_threads)) {
-    TF_ASSIGN_OR_RETURN(bool computation_changed,
-                        RunOnComputation(computation));
-    changed |= computation_changed;
+  // Fusion computations go first, so that their duplicate roots are commoned
+  // before the fusions themselves are compared.
+  for (HloInstruction* instruction : computation->MakeInstructionPostOrder()) {
+    if (instruction->opcode() != HloOpcode::kFusion) continue;
+    TF_ASSIGN_OR_RETURN(
+        bool fusion_changed,
+        RunOnComputation(instruction->fused_instructions_computation()));
+    changed |= fusion_changed;
   }
-  return changed;
+  TF_ASSIGN_OR_RETURN(bool computation_changed,
+                      RunOnSingleComputation(computation));
+  return changed || computation_changed;
 }
 
-absl::StatusOr<bool> HloCSE::RunOnComputation(HloComputation* computation) {
+absl::StatusOr<bool> HloCSE::RunOnSingleComputation(
+    HloComputation* computation) {
   if (only_fusion_computations_ && !computation->IsFusionComputation()) {
     return false;
   }
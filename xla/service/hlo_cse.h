@@ -25,7 +25,10 @@ namespace xla {
 // and identical instructions with the same operands are commoned. The pass
 // iterates over the instructions in topological order which enables the pass to
 // find arbitrarily large common expressions.
-class HloCSE : public HloModulePass {
+//
+// Computations are processed independently of each other, so the pass can run
+// on multiple computations concurrently.
+class HloCSE : public HloComputationPass {
  public:
   // If is_layout_sensitive is true, then the simplifier preserves layout during
   // transformation. Otherwise, layout is ignored.
@@ -42,18 +45,15 @@ class HloCSE : public HloModulePass {
   ~HloCSE() override = default;
   absl::string_view name() const override { return "cse"; }
 
-  // Run CSE on the given module. Returns whether the module was changed (common
-  // subexpressions were found and eliminated).
-  using HloPassInterface::Run;
-  absl::StatusOr<bool> Run(
-      HloModule* module,
-      const absl::flat_hash_set<absl::string_view>& execution_threads) override;
-
-  // Run CSE on the given computation. Returns whether the computation was
-  // changed.
-  absl::StatusOr<bool> RunOnComputation(HloComputation* computation);
+  // Run CSE on the given computation and the computations of its fusions.
+  // Returns whether any of them was changed (common subexpressions were found
+  // and eliminated).
+  absl::StatusOr<bool> RunOnComputation(HloComputation* computation) override;
 
  private:
+  // Run CSE on the given computation only.
+  absl::StatusOr<bool> RunOnSingleComputation(HloComputation* computation);
+
   const bool is_layout_sensitive_;
   const bool only_fusion_computations_;
   const bool ignore_control_dependencies_;
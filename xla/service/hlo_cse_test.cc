@@ -21,11 +21,13 @@ limitations under the License.
 
 #include <gmock/gmock.h>
 #include "absl/algorithm/container.h"
+#include "absl/status/statusor.h"
 #include "absl/strings/substitute.h"
 #include "xla/hlo/ir/hlo_computation.h"
 #include "xla/hlo/ir/hlo_instruction.h"
 #include "xla/hlo/ir/hlo_opcode.h"
 #include "xla/hlo/parser/hlo_parser.h"
+#include "xla/hlo/pass/hlo_pass_pipeline.h"
 #include "xla/hlo/utils/hlo_matchers.h"
 #include "xla/layout_util.h"
 #include "xla/literal.h"
@@ -36,6 +38,8 @@ limitations under the License.
 #include "xla/tests/literal_test_util.h"
 #include "xla/util.h"
 #include "xla/xla_data.pb.h"
+#include "tsl/platform/status_matchers.h"
+#include "tsl/platform/statusor.h"
 
 namespace xla {
 namespace {
@@ -43,6 +47,8 @@ namespace {
 namespace op = xla::testing::opcode_matchers;
 namespace m = xla::match;
 
+using ::tsl::testing::IsOkAndHolds;
+
 class HloCseTest : public HloTestBase {
  protected:
   HloCseTest() {}
@@ -949,6 +955,70 @@ TEST_F(HloCseTest, MultiOutputFusion) {
   EXPECT_EQ(add0, add1);
 }
 
+TEST_F(HloCseTest, ConcurrentRunMatchesSequentialRun) {
+  const char* const hlo_string = R"(
+    HloModule m
+
+    add_a {
+      p0 = f32[] parameter(0)
+      p1 = f32[] parameter(1)
+      n0 = f32[] negate(p1)
+      n1 = f32[] negate(p1)
+      s = f32[] subtract(n0, n1)
+      ROOT add = f32[] add(p0, s)
+    }
+
+    add_b {
+      q0 = f32[] parameter(0)
+      q1 = f32[] parameter(1)
+      m0 = f32[] negate(q1)
+      d = f32[] subtract(m0, m0)
+      ROOT sum = f32[] add(q0, d)
+    }
+
+    fused {
+      f0 = f32[8] parameter(0)
+      e0 = f32[8] exponential(f0)
+      e1 = f32[8] exponential(f0)
+      ROOT ft = (f32[8], f32[8]) tuple(e0, e1)
+    }
+
+    ENTRY test {
+      p = f32[8] parameter(0)
+      zero = f32[] constant(0)
+      r0 = f32[] reduce(p, zero), dimensions={0}, to_apply=add_a
+      r1 = f32[] reduce(p, zero), dimensions={0}, to_apply=add_b
+      f = (f32[8], f32[8]) fusion(p), kind=kLoop, calls=fused
+      g0 = f32[8] get-tuple-element(f), index=0
+      g1 = f32[8] get-tuple-element(f), index=1
+      ROOT t = (f32[], f32[], f32[8], f32[8]) tuple(r0, r1, g0, g1)
+    }
+  )";
+
+  auto run = [&](int parallelism) -> absl::StatusOr<std::string> {
+    TF_ASSIGN_OR_RETURN(auto module, ParseAndReturnVerifiedModule(hlo_string));
+    module->mutable_config()
+        .mutable_debug_options()
+        .set_xla_hlo_pass_computation_parallelism(parallelism);
+    HloPassPipeline pipeline("cse");
+    pipeline.AddPass<HloCSE>(/*is_layout_sensitive=*/false);
+    TF_ASSIGN_OR_RETURN(bool changed, pipeline.Run(module.get()));
+    EXPECT_TRUE(changed);
+    // add_a and add_b are identical after CSE, so the reduces are commoned,
+    // and so are the fusion roots.
+    const HloInstruction* root =
+        module->entry_computation()->root_instruction();
+    EXPECT_EQ(root->operand(0), root->operand(1));
+    EXPECT_EQ(root->operand(2)->tuple_index(), root->operand(3)->tuple_index());
+    return module->ToString();
+  };
+
+  TF_ASSERT_OK_AND_ASSIGN(std::string sequential, run(/*parallelism=*/1));
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_THAT(run(/*parallelism=*/4), IsOkAndHolds(sequential));
+  }
+}
+
 class HloCseCommutativeOpTest
     : public HloCseTest,
       public ::testing::WithParamInterface<std::string /*op*/> {};
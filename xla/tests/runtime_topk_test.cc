@@ -13,16 +13,19 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <cstdint>
 #include <string_view>
 #include <utility>
 #include <vector>
 
 #include <gtest/gtest.h>
+#include "xla/array2d.h"
 #include "xla/literal.h"
 #include "xla/literal_util.h"
 #include "xla/tests/hlo_test_base.h"
 #include "xla/tests/literal_test_util.h"
 #include "xla/tests/test_macros.h"
+#include "xla/xla_data.pb.h"
 #include "tsl/platform/statusor.h"
 
 namespace xla::cpu {
@@ -80,5 +83,88 @@ XLA_TEST_F(TopkTest, CustomCallTarget) {
                                  results[1]);
 }
 
+XLA_TEST_F(TopkTest, CustomCallTargetBF16) {
+  std::string_view hlo_text_module = R"(
+  HloModule topk
+
+  ENTRY TopK {
+    x = bf16[2,6] parameter(0)
+    ROOT topk = (bf16[2,3], s32[2,3]) custom-call(x), custom_call_target="TopK"
+  }
+  )";
+  TF_ASSERT_OK_AND_ASSIGN(auto module,
+                          ParseAndReturnVerifiedModule(hlo_text_module));
+
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto input, LiteralUtil::CreateR2<float>({{1, -0.0, 7, 0, 7, -3},
+                                                {-1, -2, -3, -4, -5, -6}})
+                      .Convert(BF16));
+  TF_ASSERT_OK_AND_ASSIGN(auto result, Execute(std::move(module), {&input}));
+  std::vector<Literal> results = result.DecomposeTuple();
+  ASSERT_EQ(results.size(), 2);
+  TF_ASSERT_OK_AND_ASSIGN(auto values, results[0].Convert(F32));
+  LiteralTestUtil::ExpectR2Equal<float>({{7, 7, 1}, {-1, -2, -3}}, values);
+  LiteralTestUtil::ExpectR2Equal({{2, 4, 0}, {0, 1, 2}}, results[1]);
+}
+
+XLA_TEST_F(TopkTest, CustomCallTargetF16) {
+  std::string_view hlo_text_module = R"(
+  HloModule topk
+
+  ENTRY TopK {
+    x = f16[2,6] parameter(0)
+    ROOT topk = (f16[2,3], s32[2,3]) custom-call(x), custom_call_target="TopK"
+  }
+  )";
+  TF_ASSERT_OK_AND_ASSIGN(auto module,
+                          ParseAndReturnVerifiedModule(hlo_text_module));
+
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto input, LiteralUtil::CreateR2<float>({{1, -0.0, 7, 0, 7, -3},
+                                                {-1, -2, -3, -4, -5, -6}})
+                      .Convert(F16));
+  TF_ASSERT_OK_AND_ASSIGN(auto result, Execute(std::move(module), {&input}));
+  std::vector<Literal> results = result.DecomposeTuple();
+  ASSERT_EQ(results.size(), 2);
+  TF_ASSERT_OK_AND_ASSIGN(auto values, results[0].Convert(F32));
+  LiteralTestUtil::ExpectR2Equal<float>({{7, 7, 1}, {-1, -2, -3}}, values);
+  LiteralTestUtil::ExpectR2Equal({{2, 4, 0}, {0, 1, 2}}, results[1]);
+}
+
+XLA_TEST_F(TopkTest, CustomCallTargetLargeBatch) {
+  std::string_view hlo_text_module = R"(
+  HloModule topk
+
+  ENTRY TopK {
+    x = f32[64,4096] parameter(0)
+    ROOT topk = (f32[64,2], s32[64,2]) custom-call(x), custom_call_target="TopK"
+  }
+  )";
+  TF_ASSERT_OK_AND_ASSIGN(auto module,
+                          ParseAndReturnVerifiedModule(hlo_text_module));
+
+  // Every row is a different permutation of [0, 4096) values.
+  Array2D<float> input_array(64, 4096);
+  Array2D<float> expected_values(64, 2);
+  Array2D<int32_t> expected_indices(64, 2);
+  for (int64_t row = 0; row < 64; ++row) {
+    for (int64_t i = 0; i < 4096; ++i) {
+      int64_t value = (i * 17 + row) % 4096;
+      input_array(row, i) = value;
+      if (value >= 4094) {
+        expected_values(row, 4095 - value) = value;
+        expected_indices(row, 4095 - value) = i;
+      }
+    }
+  }
+
+  auto input = LiteralUtil::CreateR2FromArray2D<float>(input_array);
+  TF_ASSERT_OK_AND_ASSIGN(auto result, Execute(std::move(module), {&input}));
+  std::vector<Literal> results = result.DecomposeTuple();
+  ASSERT_EQ(results.size(), 2);
+  LiteralTestUtil::ExpectR2EqualArray2D(expected_values, results[0]);
+  LiteralTestUtil::ExpectR2EqualArray2D(expected_indices, results[1]);
+}
+
 }  // namespace
 }  // namespace xla::cpu
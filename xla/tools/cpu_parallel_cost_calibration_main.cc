@@ -0,0 +1,415 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Measures the throughput of the host CPU and writes an XLA:CPU parallel cost
+// profile (see xla/service/cpu/parallel_cost_profile.proto) that can be passed
+// to the compiler with --xla_cpu_parallel_cost_profile.
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_replace.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/blocking_counter.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "absl/types/span.h"
+#include "xla/hlo/builder/xla_computation.h"
+#include "xla/hlo/parser/hlo_parser.h"
+#include "xla/literal_util.h"
+#include "xla/pjrt/pjrt_client.h"
+#include "xla/pjrt/pjrt_executable.h"
+#include "xla/pjrt/plugin/xla_cpu/cpu_client_options.h"
+#include "xla/pjrt/plugin/xla_cpu/xla_cpu_pjrt_client.h"
+#include "xla/service/cpu/parallel_cost_profile.pb.h"
+#include "xla/service/cpu/parallel_task_assignment.h"
+#include "xla/service/hlo_module_config.h"
+#include "xla/tsl/util/command_line_flags.h"
+#include "tsl/platform/cpu_info.h"
+#include "tsl/platform/env.h"
+#include "tsl/platform/errors.h"
+#include "tsl/platform/init_main.h"
+#include "tsl/platform/logging.h"
+#include "tsl/platform/statusor.h"
+#include "tsl/platform/threadpool.h"
+
+namespace xla::cpu {
+namespace {
+
+const char* const kUsage = R"(
+This tool measures memory bandwidth, per-opcode throughput and task launch
+overhead of the host CPU, and prints an XLA:CPU parallel cost profile in text
+proto format to stdout or to a file.
+
+The profile is used by the parallel task assignment pass to decide how many
+tasks to split each instruction into:
+
+  XLA_FLAGS=--xla_cpu_parallel_cost_profile=path/to/profile.pbtxt
+
+Run the tool on an otherwise idle machine of the same type as the one the
+compiled programs will run on.
+
+Usage:
+
+  cpu_parallel_cost_calibration [--output_file=path/to/profile.pbtxt]
+)";
+
+// Cache resident sizes (in elements) used to measure compute throughput. The
+// throughput is computed from the difference of the two measurements, which
+// cancels out the fixed per-execution overhead.
+constexpr int64_t kSmallComputeSize = 16 * 1024;
+constexpr int64_t kLargeComputeSize = 64 * 1024;
+
+// Number of elements used to measure memory bandwidth, large enough to not
+// fit into the last level cache.
+constexpr int64_t kMemoryBoundSize = 32 * 1024 * 1024;
+constexpr int64_t kMinMemoryBoundSizePerThread = 4 * 1024 * 1024;
+
+constexpr absl::string_view kUnaryOpcodes[] = {
+    "negate",   "exponential", "log",  "tanh",   "logistic",
+    "sqrt",     "rsqrt",       "sine", "cosine", "exponential-minus-one",
+    "log-plus-one"};
+
+constexpr absl::string_view kBinaryOpcodes[] = {
+    "add", "subtract", "multiply", "divide", "maximum", "minimum", "power"};
+
+struct Options {
+  std::string output_file;
+  int64_t num_threads = tsl::port::MaxParallelism();
+  float min_seconds = 0.5;
+};
+
+class Calibrator {
+ public:
+  static absl::StatusOr<Calibrator> Create(const Options& options);
+
+  absl::StatusOr<ParallelCostProfile> Run();
+
+ private:
+  Calibrator(const Options& options, std::unique_ptr<PjRtClient> client)
+      : options_(options), client_(std::move(client)) {}
+
+  // Compiles an elementwise `opcode` over f32[num_elements] operands.
+  absl::StatusOr<std::unique_ptr<PjRtLoadedExecutable>> CompileElementwise(
+      absl::string_view opcode, int64_t arity, int64_t num_elements);
+
+  // Creates `arity` f32[num_elements] buffers filled with a value that is in
+  // the domain of all calibrated opcodes.
+  absl::StatusOr<std::vector<std::unique_ptr<PjRtBuffer>>> CreateArguments(
+      int64_t arity, int64_t num_elements);
+
+  // Returns the average wall time in seconds of a single execution of
+  // `opcode`, running it repeatedly for at least `min_seconds`.
+  absl::StatusOr<double> SecondsPerExecution(absl::string_view opcode,
+                                             int64_t arity,
+                                             int64_t num_elements);
+
+  // Returns the aggregate number of bytes per second read and written by
+  // `num_threads` concurrent memory bound executions.
+  absl::StatusOr<double> BytesPerSecond(int64_t num_threads);
+
+  // Returns the number of processor cycles it takes to launch one more task
+  // on a thread pool, which is the fixed cost of splitting an instruction.
+  double TaskLaunchCycles(double cycles_per_second);
+
+  Options options_;
+  std::unique_ptr<PjRtClient> client_;
+};
+
+absl::StatusOr<Calibrator> Calibrator::Create(const Options& options) {
+  CpuClientOptions client_options;
+  client_options.cpu_device_count = 1;
+  // Compile every program into a single task, calibration measures the
+  // throughput of one thread.
+  client_options.customize_hlo_module_config = [](HloModuleConfig& config) {
+    config.set_intra_op_parallelism_threads(1);
+  };
+  TF_ASSIGN_OR_RETURN(auto client,
+                      GetXlaPjrtCpuClient(std::move(client_options)));
+  return Calibrator(options, std::move(client));
+}
+
+static ExecuteOptions GetExecuteOptions() {
+  ExecuteOptions options;
+  options.untuple_result = true;
+  options.execution_mode = ExecuteOptions::ExecutionMode::kSynchronous;
+  return options;
+}
+
+static std::vector<PjRtBuffer*> Pointers(
+    const std::vector<std::unique_ptr<PjRtBuffer>>& buffers) {
+  std::vector<PjRtBuffer*> pointers;
+  pointers.reserve(buffers.size());
+  for (const auto& buffer : buffers) pointers.push_back(buffer.get());
+  return pointers;
+}
+
+// Executes `executable` once and waits for the results to become ready.
+static absl::Status ExecuteAndAwait(PjRtLoadedExecutable* executable,
+                                    absl::Span<PjRtBuffer* const> args) {
+  TF_ASSIGN_OR_RETURN(
+      auto results,
+      executable->Execute({{args.begin(), args.end()}}, GetExecuteOptions()));
+  for (const auto& result : results[0]) {
+    TF_RETURN_IF_ERROR(result->GetReadyFuture().Await());
+  }
+  return absl::OkStatus();
+}
+
+absl::StatusOr<std::unique_ptr<PjRtLoadedExecutable>>
+Calibrator::CompileElementwise(absl::string_view opcode, int64_t arity,
+                               int64_t num_elements) {
+  static constexpr absl::string_view kUnary = R"(
+    HloModule calibrate
+    ENTRY e {
+      p0 = f32[$n] parameter(0)
+      ROOT r = f32[$n] $op(p0)
+    })";
+
+  static constexpr absl::string_view kBinary = R"(
+    HloModule calibrate
+    ENTRY e {
+      p0 = f32[$n] parameter(0)
+      p1 = f32[$n] parameter(1)
+      ROOT r = f32[$n] $op(p0, p1)
+    })";
+
+  std::string hlo = absl::StrReplaceAll(
+      arity == 1 ? kUnary : kBinary,
+      {{"$n", absl::StrCat(num_elements)}, {"$op", opcode}});
+
+  TF_ASSIGN_OR_RETURN(auto module, ParseAndReturnUnverifiedModule(hlo));
+  return client_->Compile(XlaComputation(module->ToProto()), CompileOptions());
+}
+
+absl::StatusOr<std::vector<std::unique_ptr<PjRtBuffer>>>
+Calibrator::CreateArguments(int64_t arity, int64_t num_elements) {
+  PjRtDevice* device = client_->addressable_devices().front();
+  Literal literal =
+      LiteralUtil::CreateR1<float>(std::vector<float>(num_elements, 0.75f));
+
+  std::vector<std::unique_ptr<PjRtBuffer>> buffers;
+  for (int64_t i = 0; i < arity; ++i) {
+    TF_ASSIGN_OR_RETURN(auto buffer,
+                        client_->BufferFromHostLiteral(literal, device));
+    TF_RETURN_IF_ERROR(buffer->GetReadyFuture().Await());
+    buffers.push_back(std::move(buffer));
+  }
+  return buffers;
+}
+
+absl::StatusOr<double> Calibrator::SecondsPerExecution(
+    absl::string_view opcode, int64_t arity, int64_t num_elements) {
+  TF_ASSIGN_OR_RETURN(auto executable,
+                      CompileElementwise(opcode, arity, num_elements));
+  TF_ASSIGN_OR_RETURN(auto args, CreateArguments(arity, num_elements));
+  std::vector<PjRtBuffer*> arg_ptrs = Pointers(args);
+
+  // Warm up caches and lazily initialized runtime state.
+  TF_RETURN_IF_ERROR(ExecuteAndAwait(executable.get(), arg_ptrs));
+
+  absl::Duration min_duration = absl::Seconds(options_.min_seconds);
+  absl::Time start = absl::Now();
+  int64_t num_executions = 0;
+  do {
+    TF_RETURN_IF_ERROR(ExecuteAndAwait(executable.get(), arg_ptrs));
+    ++num_executions;
+  } while (absl::Now() - start < min_duration);
+
+  return absl::ToDoubleSeconds(absl::Now() - start) / num_executions;
+}
+
+absl::StatusOr<double> Calibrator::BytesPerSecond(int64_t num_threads) {
+  int64_t num_elements =
+      std::max(kMinMemoryBoundSizePerThread, kMemoryBoundSize / num_threads);
+  TF_ASSIGN_OR_RETURN(auto executable,
+                      CompileElementwise("negate", 1, num_elements));
+
+  std::vector<std::vector<std::unique_ptr<PjRtBuffer>>> args(num_threads);
+  for (auto& thread_args : args) {
+    TF_ASSIGN_OR_RETURN(thread_args, CreateArguments(1, num_elements));
+    TF_RETURN_IF_ERROR(
+        ExecuteAndAwait(executable.get(), Pointers(thread_args)));
+  }
+
+  // Every execution reads and writes `num_elements` floats.
+  constexpr int64_t kExecutionsPerThread = 8;
+  double bytes =
+      2.0 * sizeof(float) * num_elements * kExecutionsPerThread * num_threads;
+
+  tsl::thread::ThreadPool pool(tsl::Env::Default(), "calibration",
+                               num_threads);
+  std::vector<absl::Status> statuses(num_threads);
+  absl::BlockingCounter counter(num_threads);
+
+  absl::Time start = absl::Now();
+  for (int64_t i = 0; i < num_threads; ++i) {
+    pool.Schedule([&, i] {
+      std::vector<PjRtBuffer*> arg_ptrs = Pointers(args[i]);
+      for (int64_t n = 0; n < kExecutionsPerThread && statuses[i].ok(); ++n) {
+        statuses[i] = ExecuteAndAwait(executable.get(), arg_ptrs);
+      }
+      counter.DecrementCount();
+    });
+  }
+  counter.Wait();
+  absl::Duration elapsed = absl::Now() - start;
+
+  for (const absl::Status& status : statuses) TF_RETURN_IF_ERROR(status);
+  return bytes / absl::ToDoubleSeconds(elapsed);
+}
+
+double Calibrator::TaskLaunchCycles(double cycles_per_second) {
+  int64_t num_threads = std::max<int64_t>(2, options_.num_threads);
+  tsl::thread::ThreadPool pool(tsl::Env::Default(), "calibration",
+                               num_threads);
+
+  // Returns the wall time of a fork-join of `num_tasks` empty tasks.
+  auto fork_join = [&](int64_t num_tasks) {
+    absl::BlockingCounter counter(num_tasks);
+    absl::Time start = absl::Now();
+    for (int64_t i = 0; i < num_tasks; ++i) {
+      pool.Schedule([&] { counter.DecrementCount(); });
+    }
+    counter.Wait();
+    return absl::ToDoubleSeconds(absl::Now() - start);
+  };
+
+  // Take the best of many runs to filter out preemptions.
+  constexpr int64_t kNumRuns = 1000;
+  double single = fork_join(1), multiple = fork_join(num_threads);
+  for (int64_t i = 0; i < kNumRuns; ++i) {
+    single = std::min(single, fork_join(1));
+    multiple = std::min(multiple, fork_join(num_threads));
+  }
+
+  double seconds_per_task =
+      std::max(0.0, (multiple - single) / (num_threads - 1));
+  return seconds_per_task * cycles_per_second;
+}
+
+absl::StatusOr<ParallelCostProfile> Calibrator::Run() {
+  ParallelCostProfile profile;
+
+  double cycles_per_second = tsl::port::NominalCPUFrequency();
+  if (cycles_per_second <= 1.0) {
+    return absl::UnavailableError(
+        "Failed to detect the nominal CPU frequency");
+  }
+  profile.set_cycles_per_second(cycles_per_second);
+
+  // Memory bandwidth of a single task, and of all cores together.
+  TF_ASSIGN_OR_RETURN(double single_bytes_per_second, BytesPerSecond(1));
+  TF_ASSIGN_OR_RETURN(double max_bytes_per_second,
+                      BytesPerSecond(options_.num_threads));
+  profile.set_bytes_per_cycle(single_bytes_per_second / cycles_per_second);
+  profile.set_max_bytes_per_cycle(
+      std::max(single_bytes_per_second, max_bytes_per_second) /
+      cycles_per_second);
+
+  // Per-opcode throughput, measured on cache resident operands.
+  auto calibrate = [&](absl::string_view opcode,
+                       int64_t arity) -> absl::Status {
+    TF_ASSIGN_OR_RETURN(double small,
+                        SecondsPerExecution(opcode, arity, kSmallComputeSize));
+    TF_ASSIGN_OR_RETURN(double large,
+                        SecondsPerExecution(opcode, arity, kLargeComputeSize));
+    if (large <= small) {
+      LOG(WARNING) << "Skipping " << opcode
+                   << ": execution time does not grow with the input size";
+      return absl::OkStatus();
+    }
+    double ops_per_second = (kLargeComputeSize - kSmallComputeSize) /
+                            (large - small);
+    (*profile.mutable_ops_per_cycle())[opcode] =
+        ops_per_second / cycles_per_second;
+    return absl::OkStatus();
+  };
+
+  for (absl::string_view opcode : kUnaryOpcodes) {
+    TF_RETURN_IF_ERROR(calibrate(opcode, 1));
+  }
+  for (absl::string_view opcode : kBinaryOpcodes) {
+    TF_RETURN_IF_ERROR(calibrate(opcode, 2));
+  }
+
+  // Opcodes without a calibrated entry are costed by their flop and
+  // transcendental counts, use the throughput of add and exp for them.
+  const auto& ops_per_cycle = profile.ops_per_cycle();
+  if (ops_per_cycle.count("add") == 0 ||
+      ops_per_cycle.count("exponential") == 0) {
+    return absl::InternalError(
+        "Failed to calibrate the throughput of add and exponential");
+  }
+  profile.set_flops_per_cycle(ops_per_cycle.at("add"));
+  profile.set_transcendentals_per_cycle(ops_per_cycle.at("exponential"));
+
+  profile.set_task_launch_cycles(TaskLaunchCycles(cycles_per_second));
+  return profile;
+}
+
+absl::Status RealMain(const Options& options) {
+  TF_ASSIGN_OR_RETURN(Calibrator calibrator, Calibrator::Create(options));
+  TF_ASSIGN_OR_RETURN(ParallelCostProfile profile, calibrator.Run());
+
+  if (options.output_file.empty()) {
+    std::cout << profile.DebugString();
+    return absl::OkStatus();
+  }
+
+  TF_RETURN_IF_ERROR(
+      tsl::WriteTextProto(tsl::Env::Default(), options.output_file, profile));
+  // Make sure the compiler accepts the profile we just wrote.
+  return LoadParallelCostProfile(options.output_file).status();
+}
+
+}  // namespace
+}  // namespace xla::cpu
+
+int main(int argc, char** argv) {
+  xla::cpu::Options options;
+  std::vector<tsl::Flag> flag_list = {
+      tsl::Flag("output_file", &options.output_file,
+                "The file to write the profile to. Prints to stdout if empty."),
+      tsl::Flag("num_threads", &options.num_threads,
+                "The number of threads used to measure the aggregate memory "
+                "bandwidth and the task launch overhead."),
+      tsl::Flag("min_seconds", &options.min_seconds,
+                "The minimum time to run every throughput measurement for."),
+  };
+
+  const std::string kUsageString = absl::StrCat(
+      xla::cpu::kUsage, "\n\n", tsl::Flags::Usage(argv[0], flag_list));
+  bool parse_ok = tsl::Flags::Parse(&argc, argv, flag_list);
+  tsl::port::InitMain(kUsageString.c_str(), &argc, &argv);
+  if (!parse_ok || argc != 1 || options.num_threads < 1) {
+    LOG(QFATAL) << kUsageString;
+  }
+
+  absl::Status status = xla::cpu::RealMain(options);
+  if (!status.ok()) {
+    LOG(ERROR) << status;
+    return 1;
+  }
+  return 0;
+}